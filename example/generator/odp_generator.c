@@ -1193,6 +1193,7 @@ int main(int argc, char *argv[])
 		EXAMPLE_ERR("Error: get timer capacity failed.\n");
 		exit(EXIT_FAILURE);
 	}
+	odp_timer_pool_param_init(&tparams);
 	tparams.res_ns = MAX(1 * ODP_TIME_MSEC_IN_NS,
 			     timer_capa.highest_res_ns);
 	tparams.min_tmo = 0;
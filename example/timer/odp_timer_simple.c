@@ -68,6 +68,7 @@ int main(int argc ODP_UNUSED, char *argv[] ODP_UNUSED)
 		ret += 1;
 		goto err_tp;
 	}
+	odp_timer_pool_param_init(&tparams);
 	tparams.res_ns = MAX(10 * ODP_TIME_MSEC_IN_NS,
 			     timer_capa.highest_res_ns);
 	tparams.min_tmo = 10 * ODP_TIME_MSEC_IN_NS;
@@ -619,12 +619,10 @@ static int traffic_generator(uint32_t pkts_to_send)
 	uint32_t         pkts_from_tm, pkt_cnt, millisecs, odp_tm_enq_errs;
 	int              rc;
 
-	memset(&pool_params, 0, sizeof(odp_pool_param_t));
+	odp_pool_param_init(&pool_params);
 	pool_params.type           = ODP_POOL_PACKET;
 	pool_params.pkt.num        = pkts_to_send + 10;
 	pool_params.pkt.len        = 1600;
-	pool_params.pkt.seg_len    = 0;
-	pool_params.pkt.uarea_size = 0;
 
 	odp_pool        = odp_pool_create("MyPktPool", &pool_params);
 	odp_tm_enq_errs = 0;
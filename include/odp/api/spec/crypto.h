@@ -613,6 +613,49 @@ typedef struct odp_crypto_auth_capability_t {
 
 } odp_crypto_auth_capability_t;
 
+/**
+ * Crypto statistics
+ *
+ * Statistics of ASYNC mode packet operations (odp_crypto_op_enq()) that are
+ * processed outside of the calling thread. All values are zero when the
+ * implementation processes operations in the calling thread.
+ */
+typedef struct odp_crypto_stats_t {
+	/** Number of threads processing operations */
+	uint32_t num_threads;
+
+	/** Number of operations waiting to be processed */
+	uint32_t queue_depth;
+
+	/** Maximum number of operations waiting for a single thread */
+	uint32_t queue_depth_max;
+
+	/** Maximum number of operations processed in a batch */
+	uint32_t batch_max;
+
+	/** Number of operations processed */
+	uint64_t ops;
+
+	/** Number of batches processed */
+	uint64_t batches;
+
+	/** Number of operations not accepted due to a full queue */
+	uint64_t queue_full;
+
+	/** Number of completion events freed due to a failed completion
+	 *  queue enqueue */
+	uint64_t compl_drop;
+
+	/** Average latency in nsec from odp_crypto_op_enq() to completion
+	 *  event enqueue */
+	uint64_t latency_avg_ns;
+
+	/** Maximum latency in nsec from odp_crypto_op_enq() to completion
+	 *  event enqueue */
+	uint64_t latency_max_ns;
+
+} odp_crypto_stats_t;
+
 /**
  * Query crypto capabilities
  *
@@ -877,6 +920,24 @@ int odp_crypto_op_enq(const odp_packet_t pkt_in[],
 		      const odp_crypto_packet_op_param_t param[],
 		      int num_pkt);
 
+/**
+ * Read crypto statistics
+ *
+ * @param[out] stats  Pointer to statistics structure for output
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_crypto_stats(odp_crypto_stats_t *stats);
+
+/**
+ * Print crypto debug information
+ *
+ * Print implementation defined information about crypto configuration and
+ * statistics to the ODP log.
+ */
+void odp_crypto_print(void);
+
 /**
  * @}
  */
@@ -44,6 +44,9 @@ extern "C" {
 /** Maximum number of packet pool subparameters */
 #define ODP_POOL_MAX_SUBPARAMS  7
 
+/** No preferred NUMA node for pool memory */
+#define ODP_POOL_NUMA_ANY       (-1)
+
 /**
  * Pool capabilities
  */
@@ -70,6 +73,12 @@ typedef struct odp_pool_capability_t {
 		 * The value of zero means that limited only by the available
 		 * memory size for the pool. */
 		uint32_t max_num;
+
+		/** Minimum size of thread local cache */
+		uint32_t min_cache_size;
+
+		/** Maximum size of thread local cache */
+		uint32_t max_cache_size;
 	} buf;
 
 	/** Packet pool capabilities  */
@@ -143,6 +152,12 @@ typedef struct odp_pool_capability_t {
 		 *  Maximum number of packet pool subparameters. Valid range is
 		 *  0 ... ODP_POOL_MAX_SUBPARAMS. */
 		uint8_t max_num_subparam;
+
+		/** Minimum size of thread local cache */
+		uint32_t min_cache_size;
+
+		/** Maximum size of thread local cache */
+		uint32_t max_cache_size;
 	} pkt;
 
 	/** Timeout pool capabilities  */
@@ -155,6 +170,12 @@ typedef struct odp_pool_capability_t {
 		 * The value of zero means that limited only by the available
 		 * memory size for the pool. */
 		uint32_t max_num;
+
+		/** Minimum size of thread local cache */
+		uint32_t min_cache_size;
+
+		/** Maximum size of thread local cache */
+		uint32_t max_cache_size;
 	} tmo;
 
 } odp_pool_capability_t;
@@ -210,6 +231,20 @@ typedef struct odp_pool_param_t {
 		 *  Default will always be a multiple of 8.
 		 */
 		uint32_t align;
+
+		/** Maximum number of buffers cached locally per thread
+		 *
+		 *  A non-zero value allows implementation to cache buffers
+		 *  locally per each thread. Thread local caching may improve
+		 *  performance, but requires application to take account that
+		 *  some buffers may be stored locally per thread and thus are
+		 *  not available for allocation from other threads.
+		 *
+		 *  The value must not be less than 'min_cache_size' or exceed
+		 *  'max_cache_size' capability. The default value is
+		 *  implementation specific and set by odp_pool_param_init().
+		 */
+		uint32_t cache_size;
 	} buf;
 
 	/** Parameters for packet pools */
@@ -291,14 +326,64 @@ typedef struct odp_pool_param_t {
 		 *  simultaneously (e.g. due to subpool design).
 		 */
 		odp_pool_pkt_subparam_t sub[ODP_POOL_MAX_SUBPARAMS];
+
+		/** Maximum number of packets cached locally per thread
+		 *
+		 *  A non-zero value allows implementation to cache packets
+		 *  locally per each thread. Thread local caching may improve
+		 *  performance, but requires application to take account that
+		 *  some packets may be stored locally per thread and thus are
+		 *  not available for allocation from other threads.
+		 *
+		 *  The value must not be less than 'min_cache_size' or exceed
+		 *  'max_cache_size' capability. The default value is
+		 *  implementation specific and set by odp_pool_param_init().
+		 */
+		uint32_t cache_size;
 	} pkt;
 
 	/** Parameters for timeout pools */
 	struct {
 		/** Number of timeouts in the pool */
 		uint32_t num;
+
+		/** Maximum number of timeouts cached locally per thread
+		 *
+		 *  A non-zero value allows implementation to cache timeouts
+		 *  locally per each thread. Thread local caching may improve
+		 *  performance, but requires application to take account that
+		 *  some timeouts may be stored locally per thread and thus are
+		 *  not available for allocation from other threads.
+		 *
+		 *  The value must not be less than 'min_cache_size' or exceed
+		 *  'max_cache_size' capability. The default value is
+		 *  implementation specific and set by odp_pool_param_init().
+		 */
+		uint32_t cache_size;
 	} tmo;
 
+	/** NUMA placement of pool memory */
+	struct {
+		/** Preferred NUMA node
+		 *
+		 *  Pool memory is allocated from this NUMA node when
+		 *  possible. Use ODP_POOL_NUMA_ANY for no preference. The
+		 *  default value is ODP_POOL_NUMA_ANY.
+		 */
+		int node;
+
+		/** Per NUMA node pool partitions
+		 *
+		 *  When true, the pool is split evenly between all NUMA nodes
+		 *  of the system. A thread allocates from the partition of
+		 *  its own node and from other partitions only when the local
+		 *  one has run out. Freed elements return to the partition
+		 *  they were allocated from. Overrides 'node'. The default
+		 *  value is false.
+		 */
+		odp_bool_t per_node;
+	} numa;
+
 } odp_pool_param_t;
 
 /** Packet pool*/
@@ -504,6 +504,42 @@ typedef struct odp_queue_info_t {
  */
 int odp_queue_info(odp_queue_t queue, odp_queue_info_t *info);
 
+/**
+ * Queue statistics
+ *
+ * Counters are collected per thread and reset on queue create. Events of
+ * scheduled queues are counted also when dequeued by the scheduler.
+ */
+typedef struct odp_queue_stats_t {
+	/** Number of events enqueued */
+	uint64_t enq;
+
+	/** Number of events that did not fit into the queue */
+	uint64_t enq_fail;
+
+	/** Number of events dequeued */
+	uint64_t deq;
+
+	/** Number of dequeues that found the queue empty */
+	uint64_t deq_empty;
+
+} odp_queue_stats_t;
+
+/**
+ * Read queue statistics
+ *
+ * Outputs the sum of statistics counters of all threads. Statistics are
+ * optional: the call fails when the implementation does not collect those.
+ * Not intended for fast path use.
+ *
+ * @param      queue   Queue handle
+ * @param[out] stats   Pointer to statistics for output
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_queue_stats(odp_queue_t queue, odp_queue_stats_t *stats);
+
 /**
  * @}
  */
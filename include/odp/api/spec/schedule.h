@@ -187,6 +187,72 @@ void odp_schedule_prefetch(int num);
  */
 int odp_schedule_num_prio(void);
 
+/**
+ * Print scheduler debug information
+ *
+ * Print implementation defined information about the scheduler to the ODP
+ * log. The information may include e.g. scheduler configuration and
+ * statistics of threads waiting for events.
+ */
+void odp_schedule_print(void);
+
+/**
+ * Scheduler statistics
+ *
+ * Counters are collected per thread. Times are in nanoseconds.
+ */
+typedef struct odp_schedule_stats_t {
+	/** Number of scheduling rounds */
+	uint64_t polls;
+
+	/** Number of scheduling rounds that found no events */
+	uint64_t empty_polls;
+
+	/** Number of events scheduled */
+	uint64_t events;
+
+	/** Number of atomic scheduling contexts released */
+	uint64_t atomic_ctx;
+
+	/** Total time atomic contexts were held */
+	uint64_t atomic_hold_ns;
+
+	/** Number of ordered lock acquisitions */
+	uint64_t ord_lock;
+
+	/** Total time spent waiting for ordered locks */
+	uint64_t ord_lock_wait_ns;
+
+	/** Number of packet input polls */
+	uint64_t pktin_polls;
+
+	/** Number of packet input polls that received packets */
+	uint64_t pktin_hits;
+
+} odp_schedule_stats_t;
+
+/**
+ * Read scheduler statistics
+ *
+ * Outputs the sum of statistics counters of all threads. Statistics are
+ * optional: the call fails when the implementation does not collect those.
+ * Not intended for fast path use.
+ *
+ * @param[out] stats   Pointer to statistics for output
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_schedule_stats(odp_schedule_stats_t *stats);
+
+/**
+ * Print scheduler statistics
+ *
+ * Print statistics counters of each thread and their sum to the ODP log.
+ * Nothing is printed when statistics are not collected.
+ */
+void odp_schedule_stats_print(void);
+
 /**
  * Schedule group create
  *
@@ -44,6 +44,25 @@ typedef enum {
 	/* Platform dependent which other clock sources exist */
 } odp_timer_clk_src_t;
 
+/**
+ * Timer expiration processing methods
+ */
+typedef enum {
+	/** Implementation selects the expiration processing method */
+	ODP_TIMER_EXPIRE_DEFAULT = 0,
+
+	/** All allocated timers are checked for expiration on every timer
+	 *  pool tick. Processing cost is proportional to the number of
+	 *  allocated timers. */
+	ODP_TIMER_EXPIRE_SCAN,
+
+	/** Active timers are kept sorted in a hierarchical timing wheel.
+	 *  Processing cost per timer pool tick is proportional to the number
+	 *  of expiring timers, which suits pools with a large number of
+	 *  mostly idle timers. */
+	ODP_TIMER_EXPIRE_WHEEL
+} odp_timer_expire_t;
+
 /**
  * @typedef odp_timer_t
  * ODP timer handle
@@ -129,6 +148,12 @@ typedef struct {
 	/** Clock source for timers */
 	odp_timer_clk_src_t clk_src;
 
+	/** Expiration processing method. This is a hint, an implementation
+	 *  may not support all methods and may fall back to a method of its
+	 *  own choice. Timer set, cancel and free semantics are the same for
+	 *  all methods. The default value is ODP_TIMER_EXPIRE_DEFAULT. */
+	odp_timer_expire_t expire;
+
 } odp_timer_pool_param_t;
 
 /**
@@ -158,6 +183,15 @@ typedef struct {
 int odp_timer_capability(odp_timer_clk_src_t clk_src,
 			 odp_timer_capability_t *capa);
 
+/**
+ * Initialize timer pool parameters
+ *
+ * Initialize an odp_timer_pool_param_t to its default values for all fields.
+ *
+ * @param param   Pointer to odp_timer_pool_param_t to be initialized
+ */
+void odp_timer_pool_param_init(odp_timer_pool_param_t *param);
+
 /**
  * Create a timer pool
  *
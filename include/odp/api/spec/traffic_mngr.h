@@ -1612,6 +1612,24 @@ int odp_tm_enq(odp_tm_queue_t tm_queue, odp_packet_t pkt);
  */
 int odp_tm_enq_with_cnt(odp_tm_queue_t tm_queue, odp_packet_t pkt);
 
+/** Send multiple packets to a tm_queue
+ *
+ * Like odp_tm_enq(), but enqueues a burst of packets to the same tm_queue.
+ * Packets are enqueued in array order and the ones accepted are always the
+ * first ones of the array. Packets not enqueued (e.g. due to WRED drop or a
+ * full input queue) remain owned by the caller. Zero is returned when the
+ * first packet cannot be enqueued.
+ *
+ * @param tm_queue  Specifies the tm_queue (and indirectly the TM system).
+ * @param packets   Array of packet handles
+ * @param num       Number of packets in the array
+ *
+ * @return Number of packets enqueued (0 ... num)
+ * @retval <0 on failure (e.g. invalid tm_queue)
+ */
+int odp_tm_enq_multi(odp_tm_queue_t tm_queue, const odp_packet_t packets[],
+		     int num);
+
 /* Dynamic state query functions */
 
 /** The odp_tm_node_info_t record type  is used to return various bits of
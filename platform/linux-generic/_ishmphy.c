@@ -31,6 +31,8 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
 #include <_ishmphy_internal.h>
 
 static void *common_va_address;
@@ -207,3 +209,37 @@ int _odp_ishmphy_unmap(void *start, uint64_t len, int flags)
 		ODP_ERR("_ishmphy_free failure: %s\n", strerror(errno));
 	return ret;
 }
+
+/* Set the preferred NUMA node of a mapping:
+ * Pages of the range are allocated from the given node when they are first
+ * touched, falling back to other nodes when the node runs out of memory.
+ * For shared mappings the policy is stored to the shared memory object, so
+ * the range must not have been touched yet. The start address is rounded
+ * down and the end rounded up to the page size of the mapping.
+ * return 0 on success or -1 on error.
+ */
+int _odp_ishmphy_numa_bind(void *start, uint64_t len, uint64_t page_sz,
+			   int numa_node)
+{
+	unsigned long nodemask[CONFIG_NUMA_NODES_MAX / (8 * sizeof(long)) + 1];
+	uintptr_t first, last;
+
+	if (numa_node < 0 || numa_node >= CONFIG_NUMA_NODES_MAX)
+		return -1;
+
+	first = (uintptr_t)start & ~(page_sz - 1);
+	last  = ((uintptr_t)start + len + page_sz - 1) & ~(page_sz - 1);
+
+	memset(nodemask, 0, sizeof(nodemask));
+	nodemask[numa_node / (8 * sizeof(long))] |=
+		1UL << (numa_node % (8 * sizeof(long)));
+
+	if (syscall(__NR_mbind, first, last - first, MPOL_PREFERRED, nodemask,
+		    8 * sizeof(nodemask), 0)) {
+		ODP_DBG("mbind to node %d failed: %s\n", numa_node,
+			strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,42 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_arch_chksum_internal.h>
+
+#include <arm_neon.h>
+
+static uint64_t chksum_sum_neon(const void *p, uint32_t len)
+{
+	const uint8_t *data = p;
+	uint64x2_t acc0 = vdupq_n_u64(0);
+	uint64x2_t acc1 = vdupq_n_u64(0);
+
+	/* Pairwise add 32-bit words into 64-bit accumulators */
+	while (len >= 32) {
+		acc0 = vpadalq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(data)));
+		acc1 = vpadalq_u32(acc1,
+				   vreinterpretq_u32_u8(vld1q_u8(data + 16)));
+		data += 32;
+		len  -= 32;
+	}
+
+	if (len >= 16) {
+		acc0 = vpadalq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(data)));
+		data += 16;
+		len  -= 16;
+	}
+
+	acc0 = vaddq_u64(acc0, acc1);
+
+	return vgetq_lane_u64(acc0, 0) + vgetq_lane_u64(acc0, 1) +
+	       chksum_sum_scalar(data, len);
+}
+
+/* Advanced SIMD is mandatory on ARMv8-A, so no run time check is needed */
+chksum_sum_fn_t cpu_chksum_sum_fn(void)
+{
+	return chksum_sum_neon;
+}
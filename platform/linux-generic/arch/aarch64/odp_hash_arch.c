@@ -0,0 +1,76 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "config.h"
+
+#include <odp_arch_hash_internal.h>
+
+#include <stddef.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#include <arm_acle.h>
+
+static inline uint64_t load_u64(const uint8_t *data)
+{
+	uint64_t word;
+
+	memcpy(&word, data, 8);
+	return word;
+}
+
+/* Three independent streams hide the latency of the crc32c instructions.
+ * Stream results are combined by shifting CRC state over the following
+ * stream. */
+#define CRC32C_BLOCK(c0, data, len, stream, table) do {			\
+	while (len >= 3 * (stream)) {					\
+		const uint8_t *end = data + (stream);			\
+		uint32_t c1 = 0, c2 = 0;				\
+									\
+		do {							\
+			c0 = __crc32cd(c0, load_u64(data));		\
+			c1 = __crc32cd(c1, load_u64(data + (stream)));	\
+			c2 = __crc32cd(c2,				\
+				       load_u64(data + 2 * (stream)));	\
+			data += 8;					\
+		} while (data < end);					\
+									\
+		c0 = crc32c_shift(table, c0) ^ c1;			\
+		c0 = crc32c_shift(table, c0) ^ c2;			\
+		data += 2 * (stream);					\
+		len  -= 3 * (stream);					\
+	}								\
+} while (0)
+
+__attribute__((target("+crc")))
+static uint32_t crc32c_armv8(const void *p, uint32_t len, uint32_t init_val)
+{
+	const uint8_t *data = p;
+	uint32_t crc = init_val;
+
+	CRC32C_BLOCK(crc, data, len, CRC32C_LONG, _odp_crc32c_shift_long);
+	CRC32C_BLOCK(crc, data, len, CRC32C_SHORT, _odp_crc32c_shift_short);
+
+	while (len >= 8) {
+		crc = __crc32cd(crc, load_u64(data));
+		data += 8;
+		len  -= 8;
+	}
+
+	if (len > 4)
+		crc = __crc32cd(crc, crc32c_tail(data, len));
+	else if (len > 0)
+		crc = __crc32cw(crc, crc32c_tail(data, len));
+
+	return crc;
+}
+
+crc32c_fn_t cpu_crc32c_fn(void)
+{
+	if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+		return crc32c_armv8;
+
+	return NULL;
+}
@@ -0,0 +1,12 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_arch_chksum_internal.h>
+
+chksum_sum_fn_t cpu_chksum_sum_fn(void)
+{
+	return NULL;
+}
@@ -0,0 +1,14 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_arch_hash_internal.h>
+
+#include <stddef.h>
+
+crc32c_fn_t cpu_crc32c_fn(void)
+{
+	return NULL;
+}
@@ -0,0 +1,76 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#ifndef ODP_ARCH_CHKSUM_INTERNAL_H_
+#define ODP_ARCH_CHKSUM_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+/* Sum data as 16-bit words in CPU byte order. An odd trailing byte is padded
+ * with a zero byte. Returns an unfolded 64-bit sum. Uses the function
+ * selected by _odp_chksum_init_global(). */
+uint64_t cpu_chksum_sum(const void *p, uint32_t len);
+
+typedef uint64_t (*chksum_sum_fn_t)(const void *p, uint32_t len);
+
+/* Returns sum function which processes the bulk of the data with vector
+ * instructions, or NULL when the CPU does not support those */
+chksum_sum_fn_t cpu_chksum_sum_fn(void);
+
+/* Scalar sum of 32-bit words, also used for data which does not fill
+ * a vector register */
+static inline uint64_t chksum_sum_scalar(const uint8_t *data, uint32_t len)
+{
+	uint64_t sum = 0;
+	uint32_t word;
+	uint16_t half;
+
+	while (len >= 4) {
+		memcpy(&word, data, 4);
+		sum += word;
+		data += 4;
+		len  -= 4;
+	}
+
+	if (len >= 2) {
+		memcpy(&half, data, 2);
+		sum += half;
+		data += 2;
+		len  -= 2;
+	}
+
+	/* Add left-over byte, if any */
+	if (len > 0) {
+		half = 0;
+		*(uint8_t *)&half = *data;
+		sum += half;
+	}
+
+	return sum;
+}
+
+/* Fold 64-bit sum to 16 bits */
+static inline uint16_t chksum_fold(uint64_t sum)
+{
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return sum;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
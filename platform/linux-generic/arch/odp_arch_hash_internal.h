@@ -0,0 +1,64 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#ifndef ODP_ARCH_HASH_INTERNAL_H_
+#define ODP_ARCH_HASH_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+/* Stream lengths in bytes of long and short interleaved CRC32C blocks. Three
+ * streams of a block are processed in parallel. */
+#define CRC32C_LONG  8192
+#define CRC32C_SHORT 256
+
+/* Tables which shift CRC32C state over CRC32C_LONG or CRC32C_SHORT zero
+ * bytes. Initialized by _odp_hash_init_global(). */
+extern uint32_t _odp_crc32c_shift_long[4][256];
+extern uint32_t _odp_crc32c_shift_short[4][256];
+
+typedef uint32_t (*crc32c_fn_t)(const void *data, uint32_t data_len,
+				uint32_t init_val);
+
+/* Returns CRC32C function which uses CRC instructions, or NULL when the CPU
+ * does not support those */
+crc32c_fn_t cpu_crc32c_fn(void);
+
+static inline uint32_t crc32c_shift(uint32_t table[4][256], uint32_t crc)
+{
+	return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+	       table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+/* Load 1-7 trailing bytes. Those are zero padded to a 32-bit word (up to
+ * 4 bytes) or to a 64-bit word (5-7 bytes). */
+static inline uint64_t crc32c_tail(const uint8_t *data, uint32_t len)
+{
+	uint64_t word = 0;
+	uint32_t word32;
+	uint32_t i = 0;
+
+	if (len >= 4) {
+		memcpy(&word32, data, 4);
+		word = word32;
+		i = 4;
+	}
+
+	for (; i < len; i++)
+		word |= (uint64_t)data[i] << (8 * i);
+
+	return word;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -368,3 +368,39 @@ int cpu_has_global_time(void)
 
 	return 0;
 }
+
+int cpu_has_sse2(void)
+{
+	if (cpu_get_flag_enabled(RTE_CPUFLAG_SSE2) > 0)
+		return 1;
+
+	return 0;
+}
+
+int cpu_has_avx2(void)
+{
+	uint32_t xcr0_lo, xcr0_hi;
+
+	if (cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) <= 0 ||
+	    cpu_get_flag_enabled(RTE_CPUFLAG_OSXSAVE) <= 0)
+		return 0;
+
+	/* OS must save YMM registers on context switch */
+	__asm__ __volatile__("xgetbv"
+		 : "=a" (xcr0_lo), "=d" (xcr0_hi)
+		 : "c" (0));
+	(void)xcr0_hi;
+
+	if ((xcr0_lo & 0x6) != 0x6)
+		return 0;
+
+	return 1;
+}
+
+int cpu_has_sse4_2(void)
+{
+	if (cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_2) > 0)
+		return 1;
+
+	return 0;
+}
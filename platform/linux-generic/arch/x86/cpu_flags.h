@@ -12,6 +12,9 @@ extern "C" {
 #endif
 
 void cpu_flags_print_all(void);
+int cpu_has_sse2(void);
+int cpu_has_avx2(void);
+int cpu_has_sse4_2(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,74 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "config.h"
+
+#include "cpu_flags.h"
+#include <odp_arch_chksum_internal.h>
+
+#include <immintrin.h>
+
+/* 32-bit words are zero extended into 64-bit lanes, so that accumulators
+ * cannot overflow with any practical data length */
+__attribute__((target("avx2")))
+static uint64_t chksum_sum_avx2(const void *p, uint32_t len)
+{
+	const uint8_t *data = p;
+	__m256i acc0 = _mm256_setzero_si256();
+	__m256i acc1 = _mm256_setzero_si256();
+	__m256i v;
+	__m256i zero = _mm256_setzero_si256();
+	uint64_t lane[4];
+
+	while (len >= 32) {
+		v = _mm256_loadu_si256((const __m256i *)(uintptr_t)data);
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v, zero));
+		data += 32;
+		len  -= 32;
+	}
+
+	acc0 = _mm256_add_epi64(acc0, acc1);
+	_mm256_storeu_si256((__m256i *)(uintptr_t)lane, acc0);
+
+	return lane[0] + lane[1] + lane[2] + lane[3] +
+	       chksum_sum_scalar(data, len);
+}
+
+__attribute__((target("sse2")))
+static uint64_t chksum_sum_sse2(const void *p, uint32_t len)
+{
+	const uint8_t *data = p;
+	__m128i acc0 = _mm_setzero_si128();
+	__m128i acc1 = _mm_setzero_si128();
+	__m128i v;
+	__m128i zero = _mm_setzero_si128();
+	uint64_t lane[2];
+
+	while (len >= 16) {
+		v = _mm_loadu_si128((const __m128i *)(uintptr_t)data);
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v, zero));
+		data += 16;
+		len  -= 16;
+	}
+
+	acc0 = _mm_add_epi64(acc0, acc1);
+	_mm_storeu_si128((__m128i *)(uintptr_t)lane, acc0);
+
+	return lane[0] + lane[1] + chksum_sum_scalar(data, len);
+}
+
+chksum_sum_fn_t cpu_chksum_sum_fn(void)
+{
+	if (cpu_has_avx2())
+		return chksum_sum_avx2;
+
+	if (cpu_has_sse2())
+		return chksum_sum_sse2;
+
+	return NULL;
+}
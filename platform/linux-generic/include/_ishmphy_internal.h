@@ -17,6 +17,8 @@ void *_odp_ishmphy_book_va(uintptr_t len, intptr_t align);
 int   _odp_ishmphy_unbook_va(void);
 void *_odp_ishmphy_map(int fd, void *start, uint64_t size, int flags);
 int   _odp_ishmphy_unmap(void *start, uint64_t len, int flags);
+int   _odp_ishmphy_numa_bind(void *start, uint64_t len, uint64_t page_sz,
+			     int numa_node);
 
 #ifdef __cplusplus
 }
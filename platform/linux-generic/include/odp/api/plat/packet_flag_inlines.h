@@ -31,6 +31,7 @@ static inline int _odp_packet_has_l2(odp_packet_t pkt)
 {
 	_odp_packet_input_flags_t flags;
 
+	_odp_packet_parse_check(pkt, _ODP_PARSE_LAYER_L2);
 	flags.all = _odp_packet_input_flags(pkt);
 	return flags.l2;
 }
@@ -40,6 +41,7 @@ static inline int _odp_packet_has_eth(odp_packet_t pkt)
 {
 	_odp_packet_input_flags_t flags;
 
+	_odp_packet_parse_check(pkt, _ODP_PARSE_LAYER_L2);
 	flags.all = _odp_packet_input_flags(pkt);
 	return flags.eth;
 }
@@ -49,6 +51,7 @@ static inline int _odp_packet_has_jumbo(odp_packet_t pkt)
 {
 	_odp_packet_input_flags_t flags;
 
+	_odp_packet_parse_check(pkt, _ODP_PARSE_LAYER_L2);
 	flags.all = _odp_packet_input_flags(pkt);
 	return flags.jumbo;
 }
@@ -76,6 +79,7 @@ static inline int _odp_packet_has_ipsec(odp_packet_t pkt)
 {
 	_odp_packet_input_flags_t flags;
 
+	_odp_packet_parse_check(pkt, _ODP_PARSE_LAYER_L4);
 	flags.all = _odp_packet_input_flags(pkt);
 	return flags.ipsec;
 }
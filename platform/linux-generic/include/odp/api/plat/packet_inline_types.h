@@ -61,6 +61,13 @@ typedef struct _odp_packet_inline_offset_t {
 
 } _odp_packet_inline_offset_t;
 
+/** @internal Protocol layers of lazy parsing, equal to odp_proto_layer_t
+ *  values */
+#define _ODP_PARSE_LAYER_L2  1
+#define _ODP_PARSE_LAYER_L3  2
+#define _ODP_PARSE_LAYER_L4  3
+#define _ODP_PARSE_LAYER_ALL 4
+
 /** @internal Packet input & protocol flags */
 typedef union {
 	/** All input flags */
@@ -110,6 +117,11 @@ typedef union {
 		uint64_t l3_chksum_done:1; /**< L3 checksum validation done */
 		uint64_t l4_chksum_done:1; /**< L4 checksum validation done */
 		uint64_t ipsec_udp:1; /**< UDP-encapsulated IPsec packet */
+
+		uint64_t parse_lazy:1;  /**< Higher layers are parsed on
+					     first use */
+		uint64_t parse_layer:3; /**< Layer parsed at packet input,
+					     valid when parse_lazy is set */
 	};
 
 } _odp_packet_input_flags_t;
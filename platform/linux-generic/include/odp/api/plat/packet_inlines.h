@@ -37,6 +37,8 @@ int _odp_packet_copy_from_mem_seg(odp_packet_t pkt, uint32_t offset,
 int _odp_packet_copy_to_mem_seg(odp_packet_t pkt, uint32_t offset,
 				uint32_t len, void *dst);
 
+void _odp_packet_parse_lazy(odp_packet_t pkt);
+
 extern const _odp_packet_inline_offset_t _odp_packet_inline;
 extern const _odp_pool_inline_offset_t   _odp_pool_inline;
 
@@ -119,18 +121,34 @@ static inline uint32_t _odp_packet_user_area_size(odp_packet_t pkt)
 	return _odp_pool_get(pool, uint32_t, uarea_size);
 }
 
+/* Parse remaining layers of a received packet, when packet input did not
+ * parse up to 'layer' */
+static inline void _odp_packet_parse_check(odp_packet_t pkt, uint32_t layer)
+{
+	_odp_packet_input_flags_t flags;
+
+	flags.all = _odp_pkt_get(pkt, uint64_t, input_flags);
+
+	if (odp_unlikely(flags.parse_lazy && flags.parse_layer < layer))
+		_odp_packet_parse_lazy(pkt);
+}
+
 static inline uint32_t _odp_packet_l2_offset(odp_packet_t pkt)
 {
+	_odp_packet_parse_check(pkt, _ODP_PARSE_LAYER_L2);
 	return _odp_pkt_get(pkt, uint16_t, l2_offset);
 }
 
+/* Parsing of a layer sets also offset of the next layer */
 static inline uint32_t _odp_packet_l3_offset(odp_packet_t pkt)
 {
+	_odp_packet_parse_check(pkt, _ODP_PARSE_LAYER_L2);
 	return _odp_pkt_get(pkt, uint16_t, l3_offset);
 }
 
 static inline uint32_t _odp_packet_l4_offset(odp_packet_t pkt)
 {
+	_odp_packet_parse_check(pkt, _ODP_PARSE_LAYER_L3);
 	return _odp_pkt_get(pkt, uint16_t, l4_offset);
 }
 
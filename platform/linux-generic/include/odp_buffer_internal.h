@@ -41,7 +41,13 @@ typedef struct seg_entry_t {
 	uint32_t  len;
 } seg_entry_t;
 
-/* Common buffer header */
+/* Common buffer header
+ *
+ * The header fits into a single cache line. It contains only fields that
+ * are accessed on every alloc, free, enqueue and dequeue. Rarely used
+ * metadata is stored out of line, in the cold part of the pool type
+ * specific header (see odp_packet_hdr_t).
+ */
 struct ODP_ALIGNED_CACHE odp_buffer_hdr_t {
 
 	/* Buffer index in the pool */
@@ -56,6 +62,19 @@ struct ODP_ALIGNED_CACHE odp_buffer_hdr_t {
 	/* Number of seg[] entries used */
 	uint8_t   num_seg;
 
+	/* Reference count */
+	odp_atomic_u32_t ref_cnt;
+
+	/* Event type. Maybe different than pool type (crypto compl event) */
+	int8_t    event_type;
+
+	/* Event subtype */
+	int8_t    event_subtype;
+
+	/* Burst counts */
+	uint8_t   burst_num;
+	uint8_t   burst_first;
+
 	/* Next header which continues the segment list */
 	void *next_seg;
 
@@ -68,50 +87,17 @@ struct ODP_ALIGNED_CACHE odp_buffer_hdr_t {
 	/* Pool pointer */
 	void *pool_ptr;
 
-	/* --- 40 bytes --- */
-
-	/* Segments */
-	seg_entry_t seg[CONFIG_PACKET_SEGS_PER_HDR];
-
-	/* Burst counts */
-	uint8_t   burst_num;
-	uint8_t   burst_first;
-
 	/* Next buf in a list */
 	struct odp_buffer_hdr_t *next;
 
-	/* Burst table */
-	struct odp_buffer_hdr_t *burst[BUFFER_BURST_SIZE];
-
-	/* --- Mostly read only data --- */
-
-	/* User context pointer or u64 */
-	union {
-		uint64_t    buf_u64;
-		void       *buf_ctx;
-		const void *buf_cctx; /* const alias for ctx */
-	};
-
-	/* Reference count */
-	odp_atomic_u32_t ref_cnt;
-
-	/* Event type. Maybe different than pool type (crypto compl event) */
-	int8_t    event_type;
-
-	/* Initial buffer tail pointer */
-	uint8_t  *buf_end;
-
-	/* User area pointer */
-	void    *uarea_addr;
-
-	/* ipc mapped process can not walk over pointers,
-	 * offset has to be used */
-	uint64_t ipc_data_offset;
-
-	/* Data or next header */
-	uint8_t data[0];
+	/* Burst table. Points to the cold part of the header, the table is
+	 * accessed only when burst_num is non-zero. */
+	struct odp_buffer_hdr_t **burst;
 };
 
+ODP_STATIC_ASSERT(sizeof(odp_buffer_hdr_t) == ODP_CACHE_LINE_SIZE,
+		  "BUFFER_HDR_SIZE_ERROR");
+
 ODP_STATIC_ASSERT(CONFIG_PACKET_SEGS_PER_HDR < 256,
 		  "CONFIG_PACKET_SEGS_PER_HDR_TOO_LARGE");
 
@@ -30,11 +30,17 @@ extern "C" {
 /* Maximum Class Of Service Entry */
 #define CLS_COS_MAX_ENTRY		64
 /* Maximum PMR Entry */
-#define CLS_PMR_MAX_ENTRY		256
+#define CLS_PMR_MAX_ENTRY		4096
 /* Maximum PMR Terms in a PMR Set */
 #define CLS_PMRTERM_MAX			8
 /* Maximum PMRs attached in PKTIO Level */
-#define CLS_PMR_PER_COS_MAX		8
+#define CLS_PMR_PER_COS_MAX		2048
+/* Maximum distinct term and mask combinations in a compiled PMR table */
+#define CLS_TUPLE_MAX			32
+/* Compiled PMR table hash size, must be a power of two */
+#define CLS_TUPLE_HASH_SIZE		(2 * CLS_PMR_PER_COS_MAX)
+/* Empty hash slot and no matching rule marker */
+#define CLS_RULE_NONE			0xffff
 /* L2 Priority Bits */
 #define CLS_COS_L2_QOS_BITS		3
 /* Max L2 QoS value */
@@ -152,6 +158,80 @@ typedef union _cls_queue_grp_tbl_t {
 	uint8_t pad[ROUNDUP_CACHE_LINE(sizeof(_cls_queue_grp_tbl_s))];
 } _cls_queue_grp_tbl_t;
 
+/**
+Compiled PMR Field
+
+One term of a tuple. Holds the term, its mask and, for custom frame terms,
+the offset and size of the matched value. Non-IPv6 terms use only the
+first mask word.
+**/
+typedef struct cls_field {
+	odp_cls_pmr_term_t term;
+	uint32_t offset;
+	uint32_t val_sz;
+	uint64_t mask[2];
+} cls_field_t;
+
+/**
+Compiled PMR Tuple
+
+Set of PMRs which match the same terms with the same masks. A packet is
+looked up from a tuple by hashing its masked field values.
+**/
+typedef struct cls_tuple {
+	uint16_t num_field;		/* Number of fields in the tuple */
+	uint16_t first_rule;		/* Lowest rule index in the tuple */
+	cls_field_t field[CLS_PMRTERM_MAX];
+} cls_tuple_t;
+
+/**
+Compiled PMR Hash Entry
+**/
+typedef struct cls_hash_ent {
+	uint32_t hash;			/* Hash of the rule key */
+	uint16_t rule;			/* Rule index or CLS_RULE_NONE */
+	uint16_t tuple;			/* Tuple of the rule */
+} cls_hash_ent_t;
+
+/**
+Compiled PMR Table
+
+Flattened copy of the PMRs attached to a CoS. Rule index is the position of
+the PMR in the CoS and the lowest index matching rule is selected. Rules
+which cannot be expressed as a tuple are checked one by one from
+the linear list.
+**/
+typedef struct cls_rule_tbl {
+	odp_atomic_u32_t seq;		/* Odd while the table is rebuilt */
+	uint32_t num_rule;		/* Number of rules */
+	uint32_t num_tuple;		/* Number of tuples */
+	uint32_t num_linear;		/* Number of linear rules */
+	pmr_t *pmr[CLS_PMR_PER_COS_MAX];	/* Rule PMRs */
+	cos_t *cos[CLS_PMR_PER_COS_MAX];	/* Rule destination CoSes */
+	uint16_t linear[CLS_PMR_PER_COS_MAX];	/* Linear rule indexes */
+	cls_tuple_t tuple[CLS_TUPLE_MAX];	/* Tuples by first_rule */
+	cls_hash_ent_t hash[CLS_TUPLE_HASH_SIZE];	/* Rule hash */
+} cls_rule_tbl_t;
+
+/**
+Compiled PMR Tables of a CoS
+
+PMR create and destroy rebuild the inactive table and then switch the fast
+path to it. Readers detect a concurrent rebuild from the table sequence
+number and retry.
+**/
+typedef struct cls_cos_rule {
+	odp_atomic_u32_t cur;		/* Table used by the fast path */
+	cls_rule_tbl_t tbl[2];
+} cls_cos_rule_t;
+
+/**
+Compiled PMR table of all CoSes
+**/
+typedef struct cos_rule_tbl {
+	cls_cos_rule_t cos[CLS_COS_MAX_ENTRY];
+} cos_rule_tbl_t;
+
 /**
 L2 QoS and CoS Map
 
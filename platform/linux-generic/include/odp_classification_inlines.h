@@ -373,6 +373,132 @@ static inline int verify_pmr_eth_type_x(const uint8_t *pkt_addr,
 
 	return 0;
 }
+
+/* Read the packet field of a compiled PMR term
+Stores the masked field value into key[0..1] and returns 1, or returns 0
+when the packet does not have the field. Field presence checks are the same
+as in the verification functions above.
+*/
+static inline int cls_field_key(const uint8_t *pkt_addr,
+				odp_packet_hdr_t *pkt_hdr,
+				const cls_field_t *field, uint64_t key[2])
+{
+	const _odp_ethhdr_t *eth;
+	const _odp_vlanhdr_t *vlan;
+	const _odp_ipv4hdr_t *ip;
+	const _odp_ipv6hdr_t *ipv6;
+	const uint8_t *l4;
+	uint64_t val = 0;
+	uint64_t val_be = 0;
+
+	eth = (const _odp_ethhdr_t *)(pkt_addr + pkt_hdr->p.l2_offset);
+	vlan = (const _odp_vlanhdr_t *)(eth + 1);
+	ip = (const _odp_ipv4hdr_t *)(pkt_addr + pkt_hdr->p.l3_offset);
+	ipv6 = (const _odp_ipv6hdr_t *)(pkt_addr + pkt_hdr->p.l3_offset);
+	l4 = pkt_addr + pkt_hdr->p.l4_offset;
+
+	switch (field->term) {
+	case ODP_PMR_LEN:
+		val = packet_len(pkt_hdr);
+		break;
+	case ODP_PMR_ETHTYPE_0:
+		if (!pkt_hdr->p.input_flags.vlan_qinq)
+			return 0;
+		val = _odp_be_to_cpu_16(eth->type);
+		break;
+	case ODP_PMR_ETHTYPE_X:
+		if (!pkt_hdr->p.input_flags.vlan_qinq)
+			return 0;
+		val = _odp_be_to_cpu_16(vlan->type);
+		break;
+	case ODP_PMR_VLAN_ID_0:
+		if (!pkt_hdr->p.input_flags.vlan_qinq)
+			return 0;
+		val = _odp_be_to_cpu_16(vlan->tci) & 0x0fff;
+		break;
+	case ODP_PMR_VLAN_ID_X:
+		if (!pkt_hdr->p.input_flags.vlan_qinq)
+			return 0;
+		val = _odp_be_to_cpu_16(vlan[1].tci) & 0x0fff;
+		break;
+	case ODP_PMR_DMAC:
+		if (!packet_hdr_has_eth(pkt_hdr))
+			return 0;
+		memcpy(&val_be, eth->dst.addr, _ODP_ETHADDR_LEN);
+		val = _odp_be_to_cpu_64(val_be);
+		if (val_be != val)
+			val = val >> (64 - (_ODP_ETHADDR_LEN * 8));
+		break;
+	case ODP_PMR_IPPROTO:
+		if (!pkt_hdr->p.input_flags.ipv4)
+			return 0;
+		val = ip->proto;
+		break;
+	case ODP_PMR_UDP_DPORT:
+		if (!pkt_hdr->p.input_flags.udp)
+			return 0;
+		val = _odp_be_to_cpu_16(((const _odp_udphdr_t *)l4)->dst_port);
+		break;
+	case ODP_PMR_TCP_DPORT:
+		if (!pkt_hdr->p.input_flags.tcp)
+			return 0;
+		val = _odp_be_to_cpu_16(((const _odp_tcphdr_t *)l4)->dst_port);
+		break;
+	case ODP_PMR_UDP_SPORT:
+		if (!pkt_hdr->p.input_flags.udp)
+			return 0;
+		val = _odp_be_to_cpu_16(((const _odp_udphdr_t *)l4)->src_port);
+		break;
+	case ODP_PMR_TCP_SPORT:
+		if (!pkt_hdr->p.input_flags.tcp)
+			return 0;
+		val = _odp_be_to_cpu_16(((const _odp_tcphdr_t *)l4)->src_port);
+		break;
+	case ODP_PMR_SIP_ADDR:
+		if (!pkt_hdr->p.input_flags.ipv4)
+			return 0;
+		val = _odp_be_to_cpu_32(ip->src_addr);
+		break;
+	case ODP_PMR_DIP_ADDR:
+		if (!pkt_hdr->p.input_flags.ipv4)
+			return 0;
+		val = _odp_be_to_cpu_32(ip->dst_addr);
+		break;
+	case ODP_PMR_SIP6_ADDR:
+		if (!packet_hdr_has_ipv6(pkt_hdr))
+			return 0;
+		key[0] = ipv6->src_addr.u64[0] & field->mask[0];
+		key[1] = ipv6->src_addr.u64[1] & field->mask[1];
+		return 1;
+	case ODP_PMR_DIP6_ADDR:
+		if (!packet_hdr_has_ipv6(pkt_hdr))
+			return 0;
+		key[0] = ipv6->dst_addr.u64[0] & field->mask[0];
+		key[1] = ipv6->dst_addr.u64[1] & field->mask[1];
+		return 1;
+	case ODP_PMR_IPSEC_SPI:
+		if (pkt_hdr->p.input_flags.ipsec_ah)
+			val = ((const _odp_ahhdr_t *)l4)->spi;
+		else if (pkt_hdr->p.input_flags.ipsec_esp)
+			val = ((const _odp_esphdr_t *)l4)->spi;
+		else
+			return 0;
+		val = _odp_be_to_cpu_32(val);
+		break;
+	case ODP_PMR_CUSTOM_FRAME:
+		if (field->val_sz > sizeof(val) ||
+		    packet_len(pkt_hdr) <= field->offset + field->val_sz)
+			return 0;
+		memcpy(&val, pkt_addr + field->offset, field->val_sz);
+		break;
+	default:
+		return 0;
+	}
+
+	key[0] = val & field->mask[0];
+	key[1] = 0;
+	return 1;
+}
 #ifdef __cplusplus
 }
 #endif
@@ -26,6 +26,13 @@ extern "C" {
 #include <odp_packet_io_internal.h>
 #include <odp_classification_datamodel.h>
 
+/* Number of packets prefetched ahead in cls_classify_packet_multi() */
+#define CLS_PREFETCH 4
+
+/* Maximum burst size of pktio receive paths which classify packets into
+ * temporary packet headers */
+#define CLS_BURST_MAX 16
+
 /** Classification Internal function **/
 
 /**
@@ -41,6 +48,27 @@ int cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 			uint16_t pkt_len, uint32_t seg_len, odp_pool_t *pool,
 			odp_packet_hdr_t *pkt_hdr);
 
+/**
+@internal
+
+Packet Classifier for a burst of packets
+
+Burst version of cls_classify_packet(). Data of the following packets is
+prefetched while a packet is parsed and classified. Pool of a packet which
+fails classification is set to ODP_POOL_INVALID.
+
+When 'order' is not NULL, indexes of the classified packets are stored into
+it grouped by destination pool: packets of the same pool are consecutive and
+keep their receive order. 'num' must not exceed CLS_BURST_MAX in that case.
+
+Returns the number of successfully classified packets
+**/
+int cls_classify_packet_multi(pktio_entry_t *entry, const uint8_t *base[],
+			      const uint32_t pkt_len[],
+			      const uint32_t seg_len[], odp_pool_t pool[],
+			      odp_packet_hdr_t *pkt_hdr[], uint16_t order[],
+			      int num);
+
 /**
 Packet IO classifier init
 
@@ -28,6 +28,22 @@ extern "C" {
  */
 #define CONFIG_QUEUE_SIZE 4096
 
+/*
+ * Default size of a ring based queue
+ *
+ * Queues created with a non-zero size up to the ring size store events on a
+ * lock-free ring. Other queues use a lock protected linked list, which has no
+ * size limit. ODP_QUEUE_RING_SIZE environment variable overrides the default.
+ * Ring memory of all queues is reserved at global init. Must be a power of
+ * two.
+ */
+#define CONFIG_QUEUE_RING_SIZE 1024
+
+/*
+ * Maximum value of ODP_QUEUE_RING_SIZE
+ */
+#define CONFIG_QUEUE_MAX_RING_SIZE (64 * 1024)
+
 /*
  * Maximum number of ordered locks per queue
  */
@@ -154,8 +170,191 @@ extern "C" {
 /*
  * Maximum number of events in a thread local pool cache
  */
+#define CONFIG_POOL_CACHE_MAX_SIZE 256
+
+/*
+ * Default number of events in a thread local pool cache
+ *
+ * Pool cache_size parameter defaults to this value. Caches are allocated per
+ * pool and per thread, sized by the parameter.
+ */
 #define CONFIG_POOL_CACHE_SIZE 256
 
+/*
+ * Maximum number of NUMA nodes
+ *
+ * Pools with per NUMA node buffer rings support up to this many nodes.
+ */
+#define CONFIG_NUMA_NODES_MAX 8
+
+/*
+ * Scheduler idle spin time in nanoseconds
+ *
+ * A thread waiting for events (ODP_SCHED_WAIT or a wait time) polls the
+ * scheduler this long before it goes to sleep.
+ */
+#define CONFIG_SCHED_IDLE_SPIN_NS 100000
+
+/*
+ * Maximum scheduler sleep time in nanoseconds
+ *
+ * A sleeping thread is woken up when a queue becomes schedulable, or at the
+ * latest after this time. Zero disables sleeping, threads spin while waiting
+ * for events.
+ */
+#define CONFIG_SCHED_IDLE_SLEEP_NS 10000000
+
+/*
+ * Maximum scheduler sleep time in nanoseconds when packet input or inline
+ * timers are polled by the scheduler
+ *
+ * Packet input and timer expiration do not wake up sleeping threads, so
+ * the sleep time limits their latency. The first sleep of a wait is also
+ * limited to this, since a wake up may be missed while a thread starts to
+ * sleep.
+ */
+#define CONFIG_SCHED_IDLE_POLL_NS 50000
+
+/*
+ * Default scheduler prefetch depth
+ *
+ * Maximum number of events odp_schedule_prefetch() pulls ahead from the next
+ * queue. ODP_SCHED_PREFETCH environment variable overrides the default. Zero
+ * disables pulling ahead. The depth is limited to CONFIG_BURST_SIZE.
+ */
+#define CONFIG_SCHED_PREFETCH CONFIG_BURST_SIZE
+
+/*
+ * Default number of scheduling groups
+ *
+ * Includes the predefined groups. ODP_SCHED_GROUPS environment variable
+ * overrides the default. Priority queues are reserved per group at global
+ * init.
+ */
+#define CONFIG_SCHED_GROUPS 32
+
+/*
+ * Default number of priority queues per priority
+ *
+ * Scheduled queues are spread over this many priority queues. More queues
+ * reduce contention between threads, fewer improve load balance on low thread
+ * counts. ODP_SCHED_SPREAD environment variable overrides the default. Must
+ * be a power of two, maximum is 8.
+ */
+#define CONFIG_SCHED_SPREAD 4
+
+/*
+ * Default scheduler preferred queue poll ratio
+ *
+ * A thread polls other than its preferred priority queue once in this many
+ * schedule calls. ODP_SCHED_PREFER_RATIO environment variable overrides the
+ * default.
+ */
+#define CONFIG_SCHED_PREFER_RATIO 64
+
+/*
+ * Default depth of the ordered queue enqueue stash
+ *
+ * Maximum number of out-of-order enqueue operations a thread stashes per
+ * ordered context before it waits for its turn. ODP_SCHED_ORDERED_STASH
+ * environment variable overrides the default. A stash is reserved per reorder
+ * context (see CONFIG_SCHED_REORDER_CTX) at global init. The default keeps
+ * per thread stash memory (4 contexts x 128 operations) equal to the earlier
+ * single 512 operation stash. An enqueue call stashes one operation, so 128
+ * covers a full schedule burst (CONFIG_BURST_SIZE) with up to eight enqueue
+ * calls per event.
+ */
+#define CONFIG_SCHED_ORDERED_STASH 128
+
+/*
+ * Default number of reorder contexts per thread
+ *
+ * An ordered context released out of order is left into a reorder window
+ * together with its stashed enqueue operations. The thread that releases the
+ * preceding context performs the operations later on. A thread holds a
+ * reorder context until then, and waits for its turn when all of its contexts
+ * are in use. ODP_SCHED_REORDER_CTX environment variable overrides the
+ * default, maximum is 32. Contexts are reserved per thread (see
+ * odp_thread_count_max()) at global init.
+ */
+#define CONFIG_SCHED_REORDER_CTX 4
+
+/*
+ * Scheduler and queue statistics
+ *
+ * Enabled with --enable-schedule-stats configure option. Per thread counters
+ * are compiled out when disabled, and odp_schedule_stats() and
+ * odp_queue_stats() calls fail.
+ */
+#ifdef ODP_SCHEDULE_STATS
+#define CONFIG_SCHED_STATS 1
+#else
+#define CONFIG_SCHED_STATS 0
+#endif
+
+/*
+ * Default number of scheduler packet input poll command queues
+ *
+ * ODP_SCHED_PKTIO_CMD_QUEUES environment variable overrides the default. Must
+ * be a power of two.
+ */
+#define CONFIG_SCHED_PKTIO_CMD_QUEUES 4
+
+/*
+ * Default number of crypto sessions
+ *
+ * ODP_CRYPTO_MAX_SESSIONS environment variable overrides the default. Session
+ * memory is reserved at global init, unless odp_init_t not_used marks both
+ * crypto and IPsec unused.
+ */
+#define CONFIG_CRYPTO_SESSIONS (32 * 1024)
+
+/*
+ * Maximum value of ODP_CRYPTO_MAX_SESSIONS
+ */
+#define CONFIG_CRYPTO_MAX_SESSIONS (1024 * 1024)
+
+/*
+ * Number of OpenSSL context slots per thread
+ *
+ * Each thread creates OpenSSL contexts on first use of a slot. Slots are
+ * organized as a 4-way set associative cache indexed by session. A thread
+ * using more sessions than this initializes contexts again when sessions
+ * alternate. Must be a power of two.
+ */
+#define CONFIG_CRYPTO_CTX_CACHE_SIZE 256
+
+/*
+ * Maximum number of crypto worker threads
+ *
+ * ODP_CRYPTO_ASYNC_THREADS environment variable selects the number of threads
+ * that process odp_crypto_op_enq() operations. By default operations are
+ * processed in the calling thread.
+ */
+#define CONFIG_CRYPTO_ASYNC_THREADS_MAX 8
+
+/*
+ * Number of thread ids reserved for internal threads
+ *
+ * Traffic manager service threads and crypto worker threads call
+ * odp_init_local(). When the application limits the number of threads with
+ * odp_init_t num_worker and num_control, this many thread ids are added on
+ * top of the limit for internal threads.
+ */
+#define CONFIG_INTERNAL_THREADS (CONFIG_CRYPTO_ASYNC_THREADS_MAX + 8)
+
+/*
+ * Maximum number of asynchronous crypto operations in flight
+ *
+ * This must be a power of two.
+ */
+#define CONFIG_CRYPTO_ASYNC_OPS 1024
+
+/*
+ * Maximum number of operations a crypto worker thread processes in a batch
+ */
+#define CONFIG_CRYPTO_ASYNC_BURST_MAX 32
+
 #ifdef __cplusplus
 }
 #endif
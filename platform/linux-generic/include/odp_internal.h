@@ -34,6 +34,9 @@ typedef struct {
 	int      cpu_count;
 	char     cpu_arch_str[128];
 	char     model_str[MAX_CPU_NUMBER][128];
+	int      numa_node_count;
+	int      numa_node_fake; /*< node count from ODP_NUMA_NODES */
+	uint8_t  cpu_numa_node[MAX_CPU_NUMBER];
 } system_info_t;
 
 typedef struct {
@@ -55,6 +58,7 @@ struct odp_global_data_s {
 	odp_cpumask_t control_cpus;
 	odp_cpumask_t worker_cpus;
 	int num_cpus_installed;
+	int parse_burst; /*< burst parser selected (ODP_PACKET_PARSE_BURST) */
 };
 
 enum init_stage {
@@ -62,6 +66,8 @@ enum init_stage {
 	CPUMASK_INIT,
 	TIME_INIT,
 	SYSINFO_INIT,
+	HASH_INIT,
+	CHKSUM_INIT,
 	ISHM_INIT,
 	FDSERVER_INIT,
 	THREAD_INIT,
@@ -90,7 +96,13 @@ int odp_cpumask_term_global(void);
 int odp_system_info_init(void);
 int odp_system_info_term(void);
 
-int odp_thread_init_global(void);
+int _odp_hash_init_global(void);
+int _odp_hash_term_global(void);
+
+int _odp_chksum_init_global(void);
+int _odp_chksum_term_global(void);
+
+int odp_thread_init_global(const odp_init_t *params);
 int odp_thread_init_local(odp_thread_type_t type);
 int odp_thread_term_local(void);
 int odp_thread_term_global(void);
@@ -110,7 +122,7 @@ int odp_classification_term_global(void);
 int odp_queue_init_global(void);
 int odp_queue_term_global(void);
 
-int odp_crypto_init_global(void);
+int odp_crypto_init_global(const odp_init_t *params);
 int odp_crypto_term_global(void);
 int _odp_crypto_init_local(void);
 int _odp_crypto_term_local(void);
@@ -147,6 +159,8 @@ uint64_t odp_cpufreq_id(const char *filename, int id);
 uint64_t odp_cpu_hz_current(int id);
 uint64_t odp_cpu_arch_hz_current(int id);
 void sys_info_print_arch(void);
+int _odp_numa_node_count(void);
+int _odp_numa_node_self(void);
 
 #ifdef __cplusplus
 }
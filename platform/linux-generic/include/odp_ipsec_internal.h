@@ -124,6 +124,10 @@ struct ipsec_sa_s {
 	uint32_t	salt_length;
 	odp_ipsec_lookup_mode_t lookup_mode;
 
+	/* Next SA in the lookup hash chain */
+	odp_atomic_u32_t hash_next;
+	odp_bool_t	hashed;
+
 	union {
 		unsigned flags;
 		struct {
@@ -24,6 +24,7 @@ extern "C" {
 #include <odp_buffer_inlines.h>
 #include <odp/api/packet.h>
 #include <odp/api/plat/packet_inline_types.h>
+#include <odp/api/plat/packet_inlines.h>
 #include <odp/api/packet_io.h>
 #include <odp/api/crypto.h>
 #include <odp_ipsec_internal.h>
@@ -112,6 +113,11 @@ typedef struct {
 /**
  * Internal Packet header
  *
+ * The header is split into a hot and a cold part. The hot part (the common
+ * buffer header and the first cache line after it) holds all metadata that
+ * is accessed when a packet is received, forwarded and transmitted. Cold
+ * metadata follows the first segment table entry.
+ *
  * To optimize fast path performance this struct is not initialized to zero in
  * packet_init(). Because of this any new fields added must be reviewed for
  * initialization requirements.
@@ -133,13 +139,45 @@ typedef struct {
 	uint16_t headroom;
 	uint16_t tailroom;
 
-	/* Event subtype */
-	int8_t subtype;
+	/* Segments. The first entry is in the hot part, the rest of the table
+	 * extends to the cold part. */
+	seg_entry_t seg[CONFIG_PACKET_SEGS_PER_HDR];
 
 	/*
 	 * Members below are not initialized by packet_init()
 	 */
 
+	/* Burst table of the common buffer header. All pool types use
+	 * the packet header layout. */
+	odp_buffer_hdr_t *burst[BUFFER_BURST_SIZE];
+
+	/* User context pointer or u64 */
+	union {
+		uint64_t    buf_u64;
+		void       *buf_ctx;
+		const void *buf_cctx; /* const alias for ctx */
+	};
+
+	/* User area pointer */
+	void *uarea_addr;
+
+	/* Initial buffer tail pointer */
+	uint8_t *buf_end;
+
+	/* ipc mapped process can not walk over pointers,
+	 * offset has to be used */
+	uint64_t ipc_data_offset;
+
+	/* IPC zero-copy packet: receive state of the interface, which holds
+	 * the ring for returning the remote buffer to its owner. NULL for
+	 * local data. */
+	void *ipc_zc;
+
+	/* IPC zero-copy packet: offset of the remote packet header and
+	 * local base data pointer to be restored on free */
+	uint64_t ipc_hdr_offset;
+	uint8_t *ipc_base_data;
+
 	/* Flow hash value */
 	uint32_t flow_hash;
 
@@ -166,6 +204,11 @@ typedef struct {
 	uint8_t data[0];
 } odp_packet_hdr_t;
 
+/* Common buffer header and the first segment entry fit into two cache
+ * lines */
+ODP_STATIC_ASSERT(offsetof(odp_packet_hdr_t, seg[1]) <=
+		  2 * ODP_CACHE_LINE_SIZE, "PACKET_HDR_HOT_PART_TOO_LARGE");
+
 /**
  * Return the packet header
  */
@@ -196,17 +239,17 @@ static inline seg_entry_t *seg_entry_last(odp_packet_hdr_t *hdr)
 
 	last     = hdr->buf_hdr.last_seg;
 	last_seg = last->buf_hdr.num_seg - 1;
-	return &last->buf_hdr.seg[last_seg];
+	return &last->seg[last_seg];
 }
 
 static inline odp_event_subtype_t packet_subtype(odp_packet_t pkt)
 {
-	return packet_hdr(pkt)->subtype;
+	return packet_hdr(pkt)->buf_hdr.event_subtype;
 }
 
 static inline void packet_subtype_set(odp_packet_t pkt, int ev)
 {
-	packet_hdr(pkt)->subtype = ev;
+	packet_hdr(pkt)->buf_hdr.event_subtype = ev;
 }
 
 /**
@@ -220,7 +263,7 @@ static inline void packet_init(odp_packet_hdr_t *pkt_hdr, uint32_t len)
 
 	if (odp_likely(CONFIG_PACKET_SEG_DISABLED || num == 1)) {
 		seg_len = len;
-		pkt_hdr->buf_hdr.seg[0].len = len;
+		pkt_hdr->seg[0].len = len;
 	} else {
 		seg_entry_t *last;
 
@@ -248,8 +291,9 @@ static inline void packet_init(odp_packet_hdr_t *pkt_hdr, uint32_t len)
 	pkt_hdr->headroom  = CONFIG_PACKET_HEADROOM;
 	pkt_hdr->tailroom  = pool->seg_len - seg_len + CONFIG_PACKET_TAILROOM;
 
-	if (odp_unlikely(pkt_hdr->subtype != ODP_EVENT_PACKET_BASIC))
-		pkt_hdr->subtype = ODP_EVENT_PACKET_BASIC;
+	if (odp_unlikely(pkt_hdr->buf_hdr.event_subtype !=
+			 ODP_EVENT_PACKET_BASIC))
+		pkt_hdr->buf_hdr.event_subtype = ODP_EVENT_PACKET_BASIC;
 
 	pkt_hdr->input = ODP_PKTIO_INVALID;
 }
@@ -295,13 +339,41 @@ int _odp_packet_copy_md_to_packet(odp_packet_t srcpkt, odp_packet_t dstpkt);
 int packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 		       odp_packet_t pkt[], int max_num);
 
-/* Perform packet parse up to a given protocol layer */
+/* IPC zero-copy receive is enabled */
+extern int _odp_ipc_zero_copy;
+
+/* Return the remote buffer of an IPC zero-copy packet to its owner */
+void _odp_ipc_free_zero_copy(odp_packet_hdr_t *pkt_hdr);
+
+/* Perform packet input parse up to a given protocol layer. Higher layers
+ * are parsed on first use. */
 int packet_parse_layer(odp_packet_hdr_t *pkt_hdr,
 		       odp_proto_layer_t layer);
 
+/* Parse several packets up to a given protocol layer */
+void packet_parse_layer_multi(odp_packet_hdr_t *pkt_hdr[], int num,
+			      odp_proto_layer_t layer);
+
 /* Reset parser metadata for a new parse */
 void packet_parse_reset(odp_packet_hdr_t *pkt_hdr);
 
+/* Parse remaining layers of a received packet before parser metadata of
+ * 'layer' is read */
+static inline void packet_parse_lazy(odp_packet_hdr_t *pkt_hdr,
+				     odp_proto_layer_t layer)
+{
+	if (odp_unlikely(pkt_hdr->p.input_flags.parse_lazy &&
+			 pkt_hdr->p.input_flags.parse_layer < layer))
+		_odp_packet_parse_lazy(packet_handle(pkt_hdr));
+}
+
+/* Parse remaining layers before parser metadata is modified or packet
+ * head is moved */
+static inline void packet_parse_finish(odp_packet_hdr_t *pkt_hdr)
+{
+	packet_parse_lazy(pkt_hdr, ODP_PROTO_LAYER_ALL);
+}
+
 static inline int packet_hdr_has_l2(odp_packet_hdr_t *pkt_hdr)
 {
 	return pkt_hdr->p.input_flags.l2;
@@ -340,6 +412,11 @@ static inline void packet_set_ts(odp_packet_hdr_t *pkt_hdr, odp_time_t *ts)
 int packet_parse_common(packet_parser_t *pkt_hdr, const uint8_t *ptr,
 			uint32_t pkt_len, uint32_t seg_len, int layer);
 
+void packet_parse_common_multi(packet_parser_t *prs[], const uint8_t *ptr[],
+			       const uint32_t frame_len[],
+			       const uint32_t seg_len[], int ret[], int num,
+			       int layer);
+
 int _odp_cls_parse(odp_packet_hdr_t *pkt_hdr, const uint8_t *parseptr);
 
 int _odp_packet_set_data(odp_packet_t pkt, uint32_t offset,
@@ -348,6 +425,11 @@ int _odp_packet_set_data(odp_packet_t pkt, uint32_t offset,
 int _odp_packet_cmp_data(odp_packet_t pkt, uint32_t offset,
 			 const void *s, uint32_t len);
 
+/* Calculate and insert L3/L4 checksums in software, as requested by pktout
+ * config and per packet overrides */
+void _odp_packet_chksum_insert(odp_packet_hdr_t *pkt_hdr,
+			       const odp_pktout_config_opt_t *cfg);
+
 #ifdef __cplusplus
 }
 #endif
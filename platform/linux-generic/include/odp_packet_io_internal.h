@@ -285,6 +285,10 @@ int sock_stats_fd(pktio_entry_t *pktio_entry,
 		  int fd);
 int sock_stats_reset_fd(pktio_entry_t *pktio_entry, int fd);
 
+/* Insert checksums in software on pktios without checksum offload */
+void _odp_pktio_chksum_insert(pktio_entry_t *pktio_entry,
+			      const odp_packet_t pkt_table[], int num);
+
 /**
  * Try interrupt-driven receive
  *
@@ -20,6 +20,7 @@
 #include <odp/api/pool.h>
 #include <odp/api/packet.h>
 #include <odp/api/packet_io.h>
+#include <odp/api/ticketlock.h>
 
 #include <linux/version.h>
 
@@ -37,6 +38,21 @@
 #define PACKET_FANOUT_HASH	0
 #endif /* PACKET_FANOUT */
 
+#ifndef PACKET_FANOUT_CPU
+#define PACKET_FANOUT_CPU	2
+#endif
+
+#ifndef PACKET_FANOUT_QM
+#define PACKET_FANOUT_QM	5
+#endif
+
+#ifndef PACKET_QDISC_BYPASS
+#define PACKET_QDISC_BYPASS	20
+#endif
+
+/* Maximum number of pktin and pktout queues with socket mmap */
+#define PKT_MMAP_MAX_QUEUES	32
+
 typedef struct {
 	int sockfd; /**< socket descriptor */
 	odp_pool_t pool; /**< pool to alloc packets from */
@@ -58,28 +74,44 @@ struct ring {
 	size_t rd_len;
 	int flen;
 
-	struct tpacket_req req;
+	/* TPACKET_V3: packets left in the current block and the next one */
+	unsigned block_pkts;
+	uint8_t *next_pkt;
+
+	union {
+		struct tpacket_req req;
+		struct tpacket_req3 req3;
+	};
 };
 
 ODP_STATIC_ASSERT(offsetof(struct ring, mm_space) <= ODP_CACHE_LINE_SIZE,
 		  "ERR_STRUCT_RING");
 
-/** Packet socket using mmap rings for both Rx and Tx */
+/** Packet socket with an mmap ring for one pktin or pktout queue */
+typedef struct ODP_ALIGNED_CACHE {
+	struct ring ring;
+	int sockfd;
+	odp_ticketlock_t lock;
+} pkt_mmap_queue_t;
+
+/** Packet sockets using mmap rings for Rx and Tx */
 typedef struct {
-	/** Packet mmap ring for Rx */
-	struct ring ODP_ALIGNED_CACHE rx_ring;
-	/** Packet mmap ring for Tx */
-	struct ring ODP_ALIGNED_CACHE tx_ring;
+	/** Rx socket per pktin queue. Rx sockets share a fanout group. */
+	pkt_mmap_queue_t rx_queue[PKT_MMAP_MAX_QUEUES];
+	/** Tx socket per pktout queue */
+	pkt_mmap_queue_t tx_queue[PKT_MMAP_MAX_QUEUES];
 
-	int ODP_ALIGNED_CACHE sockfd;
+	int ODP_ALIGNED_CACHE sockfd; /**< control socket */
 	odp_pool_t pool;
 	int mtu; /**< maximum transmission unit */
 	size_t frame_offset; /**< frame start offset from start of pkt buf */
-	uint8_t *mmap_base;
-	unsigned mmap_len;
 	unsigned char if_mac[ETH_ALEN];
-	struct sockaddr_ll ll;
-	int fanout;
+	int if_idx;
+	int fanout_mode; /**< PACKET_FANOUT_xxx of rx queue sockets */
+	unsigned num_rx_queues;
+	unsigned num_tx_queues;
+	odp_bool_t lockless_rx; /**< no locking for rx */
+	odp_bool_t lockless_tx; /**< no locking for tx */
 } pkt_sock_mmap_t;
 
 static inline void
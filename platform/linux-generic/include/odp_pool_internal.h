@@ -26,20 +26,20 @@ extern "C" {
 #include <odp_ring_internal.h>
 #include <odp/api/plat/strong_types.h>
 
+/* Thread local cache of buffer indexes. The array is sized by the pool
+ * cache_size parameter at pool create. */
 typedef struct ODP_ALIGNED_CACHE pool_cache_t {
 	uint32_t num;
-	uint32_t buf_index[CONFIG_POOL_CACHE_SIZE];
+	uint32_t buf_index[];
 
 } pool_cache_t;
 
-/* Buffer header ring */
+/* Buffer header ring. Ring data (buffer indexes) follows the header and is
+ * sized to the number of buffers in the pool at pool create. */
 typedef struct ODP_ALIGNED_CACHE {
 	/* Ring header */
 	ring_t   hdr;
 
-	/* Ring data: buffer handles */
-	uint32_t buf[CONFIG_POOL_MAX_NUM];
-
 } pool_ring_t;
 
 /* Callback function for pool destroy */
@@ -75,10 +75,21 @@ typedef struct pool_t {
 	pool_destroy_cb_fn ext_destroy;
 	void            *ext_desc;
 
-	pool_cache_t     local_cache[ODP_THREAD_COUNT_MAX];
+	/* Per thread caches, cache_stride bytes apart */
+	uint8_t         *local_cache;
+	uint32_t         cache_size;
+	uint32_t         cache_stride;
+	uint32_t         cache_burst;
+	uint32_t         num_cache;
 
+	/* Buffer rings, one per NUMA node with per node partitions,
+	 * ring_stride bytes apart. Buffers of block index range
+	 * [n * node_blocks, (n + 1) * node_blocks) belong to ring n. */
 	odp_shm_t        ring_shm;
 	pool_ring_t     *ring;
+	uint32_t         ring_stride;
+	uint32_t         num_rings;
+	uint32_t         node_blocks;
 
 } pool_t;
 
@@ -99,11 +110,41 @@ static inline pool_t *pool_entry_from_hdl(odp_pool_t pool_hdl)
 	return &pool_tbl->pool[_odp_typeval(pool_hdl)];
 }
 
+static inline pool_ring_t *pool_ring(pool_t *pool, uint32_t ring_idx)
+{
+	uint8_t *ring = (uint8_t *)pool->ring;
+
+	/* clang requires cast to uintptr_t */
+	return (pool_ring_t *)(uintptr_t)&ring[ring_idx * pool->ring_stride];
+}
+
+static inline pool_cache_t *pool_local_cache(pool_t *pool, int thr_id)
+{
+	uint8_t *cache = &pool->local_cache[thr_id * pool->cache_stride];
+
+	/* clang requires cast to uintptr_t */
+	return (pool_cache_t *)(uintptr_t)cache;
+}
+
 static inline odp_buffer_hdr_t *buf_hdl_to_hdr(odp_buffer_t buf)
 {
 	return (odp_buffer_hdr_t *)(uintptr_t)buf;
 }
 
+static inline odp_buffer_hdr_t *buf_hdr_from_index(pool_t *pool,
+						   uint32_t buffer_idx)
+{
+	uint32_t block_offset;
+	odp_buffer_hdr_t *buf_hdr;
+
+	block_offset = buffer_idx * pool->block_size;
+
+	/* clang requires cast to uintptr_t */
+	buf_hdr = (odp_buffer_hdr_t *)(uintptr_t)&pool->base_addr[block_offset];
+
+	return buf_hdr;
+}
+
 int buffer_alloc_multi(pool_t *pool, odp_buffer_hdr_t *buf_hdr[], int num);
 void buffer_free_multi(odp_buffer_hdr_t *buf_hdr[], int num_free);
 
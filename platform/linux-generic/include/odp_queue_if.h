@@ -42,6 +42,9 @@ typedef struct {
 	uint64_t (*queue_to_u64)(odp_queue_t hdl);
 	void (*queue_param_init)(odp_queue_param_t *param);
 	int (*queue_info)(odp_queue_t queue, odp_queue_info_t *info);
+
+	/* Optional, NULL when the queue does not collect statistics */
+	int (*queue_stats)(odp_queue_t queue, odp_queue_stats_t *stats);
 } queue_api_t;
 
 /* Internal abstract queue handle */
@@ -28,7 +28,9 @@ extern "C" {
 #include <odp/api/align.h>
 #include <odp/api/hints.h>
 #include <odp/api/ticketlock.h>
+#include <odp/api/thread.h>
 #include <odp_config_internal.h>
+#include <odp_ring_internal.h>
 
 #define QUEUE_STATUS_FREE         0
 #define QUEUE_STATUS_DESTROYED    1
@@ -36,6 +38,14 @@ extern "C" {
 #define QUEUE_STATUS_NOTSCHED     3
 #define QUEUE_STATUS_SCHED        4
 
+/* Queue statistics of a thread */
+typedef struct ODP_ALIGNED_CACHE {
+	uint64_t enq;
+	uint64_t enq_fail;
+	uint64_t deq;
+	uint64_t deq_empty;
+} queue_stat_t;
+
 struct queue_entry_s {
 	odp_ticketlock_t  ODP_ALIGNED_CACHE lock;
 
@@ -48,6 +58,10 @@ struct queue_entry_s {
 	queue_enq_multi_fn_t enqueue_multi;
 	queue_deq_multi_fn_t dequeue_multi;
 
+	/* Event ring of a bounded queue, NULL when events are on the list */
+	ring_t           *ring;
+	uint32_t          ring_mask;
+
 	uint32_t          index;
 	odp_queue_t       handle;
 	odp_queue_type_t  type;
@@ -55,6 +69,11 @@ struct queue_entry_s {
 	odp_pktin_queue_t pktin;
 	odp_pktout_queue_t pktout;
 	char              name[ODP_QUEUE_NAME_LEN];
+
+#if CONFIG_SCHED_STATS
+	/* Per thread statistics */
+	queue_stat_t      stat[ODP_THREAD_COUNT_MAX];
+#endif
 };
 
 union queue_entry_u {
@@ -169,6 +169,63 @@ static inline void ring_enq_multi(ring_t *ring, uint32_t mask, uint32_t data[],
 	odp_atomic_store_rel_u32(&ring->w_tail, old_head + num);
 }
 
+/* Enqueue multiple data into the ring tail, but only as many as there is free
+ * space in the ring. Ring size is mask + 1. Returns the number of data
+ * enqueued. */
+static inline uint32_t ring_enq_multi_bounded(ring_t *ring, uint32_t mask,
+					      uint32_t data[], uint32_t num)
+{
+	uint32_t old_head, new_head, tail, num_free, i;
+
+	old_head = odp_atomic_load_u32(&ring->w_head);
+
+	/* Move writer head. This thread owns data slots after the old head. */
+	do {
+		/* Slots are free after all readers are done with them */
+		tail = odp_atomic_load_acq_u32(&ring->r_tail);
+		num_free = mask + 1 - (old_head - tail);
+
+		/* Ring is full */
+		if (num_free == 0)
+			return 0;
+
+		if (num > num_free)
+			num = num_free;
+
+		new_head = old_head + num;
+
+	} while (odp_unlikely(odp_atomic_cas_acq_u32(&ring->w_head, &old_head,
+			      new_head) == 0));
+
+	/* Write data */
+	for (i = 0; i < num; i++)
+		ring->data[(old_head + 1 + i) & mask] = data[i];
+
+	/* Wait until other writers have updated the tail */
+	while (odp_unlikely(odp_atomic_load_acq_u32(&ring->w_tail) != old_head))
+		odp_cpu_pause();
+
+	/* Now update the writer tail */
+	odp_atomic_store_rel_u32(&ring->w_tail, new_head);
+
+	return num;
+}
+
+/* Number of data items in the ring. The value is approximate while other
+ * threads enqueue or dequeue. */
+static inline uint32_t ring_count(ring_t *ring)
+{
+	return odp_atomic_load_acq_u32(&ring->w_tail) -
+	       odp_atomic_load_u32(&ring->r_tail);
+}
+
+/* Check if ring is empty */
+static inline int ring_is_empty(ring_t *ring)
+{
+	return odp_atomic_load_acq_u32(&ring->w_tail) ==
+	       odp_atomic_load_u32(&ring->r_head);
+}
+
 #ifdef __cplusplus
 }
 #endif
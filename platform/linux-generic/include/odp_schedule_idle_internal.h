@@ -0,0 +1,194 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#ifndef ODP_SCHEDULE_IDLE_INTERNAL_H_
+#define ODP_SCHEDULE_IDLE_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/api/atomic.h>
+#include <odp/api/hints.h>
+#include <odp/api/sync.h>
+#include <odp/api/time.h>
+#include <odp/api/thread.h>
+#include <odp_config_internal.h>
+#include <odp_align_internal.h>
+
+/* Idle statistics of a thread */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Number of times the thread started to wait for events */
+	uint64_t idle;
+
+	/* Number of waits that ended with events during the spin time */
+	uint64_t spin_hit;
+
+	/* Number of sleeps */
+	uint64_t sleep;
+
+	/* Number of sleeps that ended by a wake up */
+	uint64_t wakeup;
+
+	/* Sum and maximum of wake up latencies in nsec */
+	uint64_t wakeup_ns;
+	uint64_t wakeup_max_ns;
+
+} sched_idle_stat_t;
+
+/* Scheduler idle state
+ *
+ * Threads waiting for events spin for CONFIG_SCHED_IDLE_SPIN_NS and then
+ * sleep on a futex. Schedulers call sched_idle_wake() after a queue becomes
+ * schedulable. A thread registers as a sleeper before its last scheduling
+ * round and stays registered until the wait ends, so either it sees the new
+ * work or the waker sees the sleeper. The waker checks the sleeper count
+ * without a barrier, so a wake up may be missed while a thread registers. The
+ * first sleep after registration is short to bound the latency of that case.
+ *
+ * One thread is woken up per wake up. The work may be visible only to some
+ * threads (e.g. due to schedule groups), so a woken thread that does not find
+ * events passes the wake up on to another sleeper. */
+typedef struct {
+	/* Futex word, incremented on every wake up */
+	odp_atomic_u32_t ODP_ALIGNED_CACHE seq;
+
+	/* Number of threads that may be sleeping */
+	odp_atomic_u32_t sleepers;
+
+	/* Number of times the latest wake up may still be passed on */
+	odp_atomic_u32_t hops;
+
+	/* Time of the latest wake up (for statistics) */
+	odp_atomic_u64_t wakeup_time;
+
+	/* Per thread statistics */
+	sched_idle_stat_t stat[ODP_THREAD_COUNT_MAX];
+
+} sched_idle_t;
+
+/* Wait state of a schedule call */
+typedef struct {
+	odp_time_t spin_end;
+	uint32_t seq;
+	uint8_t started;
+	uint8_t sleep;
+	uint8_t registered;
+	uint8_t slept;
+	uint8_t woken;
+} sched_idle_wait_t;
+
+void sched_idle_init(sched_idle_t *idle);
+void _sched_idle_wake(sched_idle_t *idle);
+void _sched_idle_wake_next(sched_idle_t *idle);
+void _sched_idle_sleep(sched_idle_t *idle, sched_idle_wait_t *w,
+		       uint64_t tmo_ns, int poll);
+void sched_idle_print(sched_idle_t *idle);
+
+/* Wake up a sleeping thread after new work has been made visible */
+static inline void sched_idle_wake(sched_idle_t *idle)
+{
+	if (CONFIG_SCHED_IDLE_SLEEP_NS == 0)
+		return;
+
+	/* Fast path without a barrier. Sleepers stay registered while they
+	 * sleep, so only a thread that is just registering may be missed. */
+	if (odp_likely(odp_atomic_load_u32(&idle->sleepers) == 0))
+		return;
+
+	/* Order work store before seq update. Pairs with the acquire load
+	 * in sched_idle_prepare(). */
+	odp_mb_full();
+
+	_sched_idle_wake(idle);
+}
+
+static inline void sched_idle_wait_init(sched_idle_wait_t *w)
+{
+	w->started    = 0;
+	w->sleep      = 0;
+	w->registered = 0;
+	w->slept      = 0;
+	w->woken      = 0;
+}
+
+/* Call before every scheduling round. Registers the thread as a sleeper
+ * when its spin time has passed. */
+static inline void sched_idle_prepare(sched_idle_t *idle,
+				      sched_idle_wait_t *w)
+{
+	if (odp_likely(w->sleep == 0))
+		return;
+
+	/* Wake ups after this load end the next sleep */
+	w->seq = odp_atomic_load_acq_u32(&idle->seq);
+
+	if (w->registered)
+		return;
+
+	odp_atomic_inc_u32(&idle->sleepers);
+	w->registered = 1;
+
+	/* Order sleepers store before work load */
+	odp_mb_full();
+}
+
+/* Call when the wait ends with or without events */
+static inline void sched_idle_done(sched_idle_t *idle, sched_idle_wait_t *w,
+				   int found)
+{
+	if (odp_likely(w->started == 0))
+		return;
+
+	if (w->registered)
+		odp_atomic_dec_u32(&idle->sleepers);
+
+	if (found && !w->slept)
+		idle->stat[odp_thread_id()].spin_hit++;
+}
+
+/* Call after a scheduling round without events. Starts spinning, or sleeps
+ * at most 'tmo_ns' nanoseconds when the spin time has passed. When 'poll' is
+ * set, packet input or timers need polling and the sleep is kept short. */
+static inline void sched_idle_wait(sched_idle_t *idle, sched_idle_wait_t *w,
+				   uint64_t tmo_ns, int poll)
+{
+	if (CONFIG_SCHED_IDLE_SLEEP_NS == 0)
+		return;
+
+	if (odp_unlikely(w->started == 0)) {
+		odp_time_t spin;
+
+		spin = odp_time_local_from_ns(CONFIG_SCHED_IDLE_SPIN_NS);
+		w->started  = 1;
+		w->spin_end = odp_time_sum(odp_time_local(), spin);
+		idle->stat[odp_thread_id()].idle++;
+		return;
+	}
+
+	if (w->sleep == 0) {
+		/* Register as a sleeper on the next round */
+		if (odp_time_cmp(odp_time_local(), w->spin_end) >= 0)
+			w->sleep = 1;
+		return;
+	}
+
+	if (w->registered) {
+		/* Woken up, but events were not found */
+		if (odp_unlikely(w->woken)) {
+			w->woken = 0;
+			_sched_idle_wake_next(idle);
+		}
+
+		_sched_idle_sleep(idle, w, tmo_ns, poll);
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
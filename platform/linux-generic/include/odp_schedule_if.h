@@ -92,6 +92,7 @@ typedef struct {
 	void (*schedule_release_ordered)(void);
 	void (*schedule_prefetch)(int);
 	int (*schedule_num_prio)(void);
+	void (*schedule_print)(void);
 	odp_schedule_group_t (*schedule_group_create)(const char *,
 						      const odp_thrmask_t *);
 	int (*schedule_group_destroy)(odp_schedule_group_t);
@@ -106,6 +107,10 @@ typedef struct {
 	void (*schedule_order_unlock)(uint32_t);
 	void (*schedule_order_unlock_lock)(uint32_t, uint32_t);
 
+	/* Optional, NULL when the scheduler does not collect statistics */
+	int (*schedule_stats)(odp_schedule_stats_t *);
+	void (*schedule_stats_print)(void);
+
 } schedule_api_t;
 
 #ifdef __cplusplus
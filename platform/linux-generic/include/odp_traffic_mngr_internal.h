@@ -31,10 +31,12 @@ extern "C" {
 #include <odp_buffer_internal.h>
 #include <odp_queue_if.h>
 #include <odp_packet_internal.h>
+#include <odp_align_internal.h>
 
 typedef struct stat  file_stat_t;
 
 #define INPUT_WORK_RING_SIZE  (16 * 1024)
+#define TM_ENQ_MULTI_BURST    32
 
 #define TM_QUEUE_MAGIC_NUM   0xBABEBABE
 #define TM_NODE_MAGIC_NUM    0xBEEFBEEF
@@ -309,16 +311,22 @@ typedef struct {
 	uint32_t     queue_num;
 } input_work_item_t;
 
-typedef struct {
-	uint64_t          total_enqueues;
-	uint64_t          enqueue_fail_cnt;
-	uint64_t          total_dequeues;
-	odp_atomic_u64_t  queue_cnt;
+/* Multi-producer, single consumer ring of input work items. Producers
+ * reserve slots by moving w_head with CAS and then publish them in
+ * reservation order by moving w_tail. The TM service thread is the only
+ * consumer, so r_tail is written by it alone. */
+typedef struct ODP_ALIGNED_CACHE {
+	odp_atomic_u32_t  w_head;
+	odp_atomic_u32_t  w_tail;
+	odp_atomic_u64_t  enqueue_fail_cnt;
+	uint8_t           pad[ODP_CACHE_LINE_SIZE -
+			      2 * sizeof(odp_atomic_u32_t) -
+			      sizeof(odp_atomic_u64_t)];
+
+	odp_atomic_u32_t  r_tail;
 	uint32_t          peak_cnt;
-	uint32_t          head_idx;
-	uint32_t          tail_idx;
-	odp_ticketlock_t  lock;
-	input_work_item_t work_ring[INPUT_WORK_RING_SIZE];
+	uint64_t          total_dequeues;
+	input_work_item_t work_ring[INPUT_WORK_RING_SIZE] ODP_ALIGNED_CACHE;
 } input_work_queue_t;
 
 typedef struct {
@@ -396,6 +404,7 @@ struct tm_system_s {
 	uint64_t   current_time;
 	uint8_t    tm_idx;
 	uint8_t    first_enq;
+	uint8_t    timer_wheel_started;
 	odp_bool_t is_idle;
 
 	uint64_t shaper_green_cnt;
@@ -415,7 +424,10 @@ struct tm_system_group_s {
 	odp_barrier_t  tm_group_barrier;
 	tm_system_t   *first_tm_system;
 	uint32_t       num_tm_systems;
-	uint32_t       first_enq;
+	/* Service thread has unlinked the last tm_system and is exiting, no
+	 * new tm_systems may join. Protected by tm_create_lock. */
+	odp_bool_t     exiting;
+	odp_atomic_u32_t first_enq;
 	pthread_t      thread;
 	pthread_attr_t attr;
 };
@@ -21,10 +21,16 @@ AC_CONFIG_FILES([platform/linux-generic/Makefile
 		 platform/linux-generic/test/Makefile
 		 platform/linux-generic/test/example/Makefile
 		 platform/linux-generic/test/example/generator/Makefile
+		 platform/linux-generic/test/validation/api/crypto/Makefile
 		 platform/linux-generic/test/validation/api/shmem/Makefile
+		 platform/linux-generic/test/validation/api/packet/Makefile
+		 platform/linux-generic/test/validation/api/pool/Makefile
 		 platform/linux-generic/test/validation/api/pktio/Makefile
+		 platform/linux-generic/test/validation/api/traffic_mngr/Makefile
 		 platform/linux-generic/test/mmap_vlan_ins/Makefile
 		 platform/linux-generic/test/pktio_ipc/Makefile
 		 platform/linux-generic/test/ring/Makefile
+		 platform/linux-generic/test/sched_idle/Makefile
+		 platform/linux-generic/test/sched_stress/Makefile
 		 platform/linux-generic/test/performance/Makefile])
 ])
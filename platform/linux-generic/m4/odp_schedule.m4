@@ -21,3 +21,23 @@ AC_ARG_ENABLE([schedule_scalable],
 	AC_DEFINE([ODP_SCHEDULE_SCALABLE], [1],
 		  [Define to 1 to enable scalable scheduler])
     fi])
+
+AC_ARG_ENABLE([schedule_ws],
+    [  --enable-schedule-ws    enable work-stealing scheduler],
+    [if test x$enableval = xyes; then
+	schedule_ws_enabled=yes
+	AC_DEFINE([ODP_SCHEDULE_WS], [1],
+		  [Define to 1 to enable work-stealing scheduler])
+    fi])
+
+AC_ARG_ENABLE([schedule_stats],
+    [  --enable-schedule-stats enable scheduler and queue statistics],
+    [if test x$enableval = xyes; then
+	AC_DEFINE([ODP_SCHEDULE_STATS], [1],
+		  [Define to 1 to enable scheduler and queue statistics])
+    fi])
+
+AC_CONFIG_COMMANDS_PRE([dnl
+AM_CONDITIONAL([ODP_SCHEDULE_DEFAULT],
+	       [test "x$schedule_sp_enabled$schedule_iquery_enabled$schedule_scalable_enabled$schedule_ws_enabled" = x])
+])
@@ -4,33 +4,51 @@
  * SPDX-License-Identifier:     BSD-3-Clause
  */
 
+#include "config.h"
+
 #include <odp/api/chksum.h>
 #include <odp/api/std_types.h>
+#include <odp_arch_chksum_internal.h>
+#include <odp_internal.h>
+#include <odp_debug_internal.h>
+
+static uint64_t chksum_sum_generic(const void *p, uint32_t len)
+{
+	return chksum_sum_scalar(p, len);
+}
+
+/* Scalar version is used until CPU features have been checked */
+static chksum_sum_fn_t chksum_sum_fn = chksum_sum_generic;
+
+uint64_t cpu_chksum_sum(const void *p, uint32_t len)
+{
+	return chksum_sum_fn(p, len);
+}
 
-/* Simple implementation of ones complement sum.
- * Based on RFC1071 and its errata.
+/* Ones complement sum based on RFC1071 and its errata. Data is summed as
+ * 32-bit words (vectorized when the CPU supports it) and the result is folded
+ * to 16 bits, which gives the same result as summing 16-bit words.
  */
 uint16_t odp_chksum_ones_comp16(const void *p, uint32_t len)
 {
-	uint32_t sum = 0;
-	const uint16_t *data = p;
-
-	while (len > 1) {
-		sum += *data++;
-		len -= 2;
-	}
+	return chksum_fold(cpu_chksum_sum(p, len));
+}
 
-	/* Add left-over byte, if any */
-	if (len > 0) {
-		uint16_t left_over = 0;
+int _odp_chksum_init_global(void)
+{
+	chksum_sum_fn_t fn = cpu_chksum_sum_fn();
 
-		*(uint8_t *)&left_over = *(const uint8_t *)data;
-		sum += left_over;
+	if (fn != NULL) {
+		ODP_DBG("Checksum: using vector instructions\n");
+		chksum_sum_fn = fn;
 	}
 
-	/* Fold 32-bit sum to 16 bits */
-	while (sum >> 16)
-		sum = (sum & 0xffff) + (sum >> 16);
+	return 0;
+}
+
+int _odp_chksum_term_global(void)
+{
+	chksum_sum_fn = chksum_sum_generic;
 
-	return sum;
+	return 0;
 }
@@ -19,6 +19,9 @@
 #include <odp_classification_inlines.h>
 #include <odp_classification_internal.h>
 #include <odp/api/shared_memory.h>
+#include <odp/api/hash.h>
+#include <odp/api/sync.h>
+#include <odp/api/cpu.h>
 #include <protocols/thash.h>
 #include <protocols/eth.h>
 #include <protocols/ip.h>
@@ -34,6 +37,7 @@
 static cos_tbl_t *cos_tbl;
 static pmr_tbl_t	*pmr_tbl;
 static _cls_queue_grp_tbl_t *queue_grp_tbl;
+static cos_rule_tbl_t *cos_rule_tbl;
 
 static const rss_key default_rss = {
 	.u8 = {
@@ -62,6 +66,7 @@ int odp_classification_init_global(void)
 	odp_shm_t cos_shm;
 	odp_shm_t pmr_shm;
 	odp_shm_t queue_grp_shm;
+	odp_shm_t rule_shm;
 	int i;
 
 	cos_shm = odp_shm_reserve("shm_odp_cos_tbl",
@@ -118,6 +123,18 @@ int odp_classification_init_global(void)
 	queue_grp_tbl = odp_shm_addr(queue_grp_shm);
 	memset(queue_grp_tbl, 0, sizeof(_cls_queue_grp_tbl_t));
 
+	rule_shm = odp_shm_reserve("shm_odp_cls_rule_tbl",
+				   sizeof(cos_rule_tbl_t),
+				   ODP_CACHE_LINE_SIZE, 0);
+
+	if (rule_shm == ODP_SHM_INVALID) {
+		ODP_ERR("shm allocation failed for shm_odp_cls_rule_tbl");
+		goto error_queue_grp;
+	}
+
+	cos_rule_tbl = odp_shm_addr(rule_shm);
+	memset(cos_rule_tbl, 0, sizeof(cos_rule_tbl_t));
+
 	return 0;
 
 error_queue_grp:
@@ -153,6 +170,12 @@ int odp_classification_term_global(void)
 		rc = -1;
 	}
 
+	ret = odp_shm_free(odp_shm_lookup("shm_odp_cls_rule_tbl"));
+	if (ret < 0) {
+		ODP_ERR("shm free failed for shm_odp_cls_rule_tbl");
+		rc = -1;
+	}
+
 	return rc;
 }
 
@@ -213,6 +236,8 @@ static void _odp_cls_update_hash_proto(cos_t *cos,
 		cos->s.hash_proto.udp = 1;
 }
 
+static void cls_rule_tbl_build(cos_t *cos);
+
 static inline void _cls_queue_unwind(uint32_t tbl_index, uint32_t j)
 {
 	while (j > 0)
@@ -282,6 +307,7 @@ odp_cos_t odp_cls_cos_create(const char *name, odp_cls_cos_param_t *param)
 			cos->s.drop_policy = drop_policy;
 			odp_atomic_init_u32(&cos->s.num_rule, 0);
 			cos->s.index = i;
+			cls_rule_tbl_build(cos);
 			UNLOCK(&cos->s.lock);
 			return _odp_cast_scalar(odp_cos_t, i);
 		}
@@ -633,12 +659,170 @@ static int odp_pmr_create_term(pmr_term_value_t *value,
 	return 0;
 }
 
+/*
+ * Convert a PMR to a tuple field list and a rule key. Fields are sorted so
+ * that PMRs with the same terms and masks map to the same tuple.
+ * Returns 0 on success and -1 if the PMR needs to be checked linearly.
+ */
+static int cls_pmr_tuple(pmr_t *pmr, cls_tuple_t *tuple,
+			 uint64_t key[2 * CLS_PMRTERM_MAX])
+{
+	pmr_term_value_t *term_value;
+	cls_field_t field;
+	uint64_t val[2];
+	uint32_t num_pmr = pmr->s.num_pmr;
+	uint32_t i, j;
+
+	memset(tuple, 0, sizeof(cls_tuple_t));
+
+	if (num_pmr > CLS_PMRTERM_MAX)
+		return -1;
+
+	for (i = 0; i < num_pmr; i++) {
+		term_value = &pmr->s.pmr_term_value[i];
+
+		if (term_value->range_term)
+			return -1;
+
+		memset(&field, 0, sizeof(cls_field_t));
+		field.term = term_value->term;
+
+		switch (term_value->term) {
+		case ODP_PMR_INNER_HDR_OFF:
+			/* Does not restrict the match */
+			continue;
+		case ODP_PMR_LD_VNI:
+			return -1;
+		case ODP_PMR_SIP6_ADDR:
+		case ODP_PMR_DIP6_ADDR:
+			field.mask[0] = term_value->match_ipv6.mask.u64[0];
+			field.mask[1] = term_value->match_ipv6.mask.u64[1];
+			val[0] = term_value->match_ipv6.addr.u64[0];
+			val[1] = term_value->match_ipv6.addr.u64[1];
+			break;
+		case ODP_PMR_CUSTOM_FRAME:
+			if (term_value->val_sz > sizeof(uint64_t))
+				return -1;
+			field.offset = term_value->offset;
+			field.val_sz = term_value->val_sz;
+			/* fall through */
+		default:
+			field.mask[0] = term_value->match.mask;
+			val[0] = term_value->match.value;
+			val[1] = 0;
+			break;
+		}
+
+		/* Insertion sort by field content */
+		j = tuple->num_field;
+		while (j > 0 && memcmp(&tuple->field[j - 1], &field,
+				       sizeof(cls_field_t)) > 0) {
+			memcpy(&tuple->field[j], &tuple->field[j - 1],
+			       sizeof(cls_field_t));
+			key[2 * j] = key[2 * (j - 1)];
+			key[2 * j + 1] = key[2 * (j - 1) + 1];
+			j--;
+		}
+		memcpy(&tuple->field[j], &field, sizeof(cls_field_t));
+		key[2 * j] = val[0];
+		key[2 * j + 1] = val[1];
+		tuple->num_field++;
+	}
+
+	return 0;
+}
+
+static inline uint32_t cls_key_hash(const uint64_t *key, uint32_t num_field,
+				    uint32_t tuple)
+{
+	return odp_hash_crc32c(key, num_field * 2 * sizeof(uint64_t), tuple);
+}
+
+/*
+ * Add a rule to the tuple space of a compiled table. Rules must be added in
+ * rule index order. Returns -1 if the rule needs to be checked linearly.
+ */
+static int cls_rule_insert(cls_rule_tbl_t *tbl, uint32_t rule)
+{
+	cls_tuple_t shape;
+	cls_tuple_t *tuple;
+	uint64_t key[2 * CLS_PMRTERM_MAX];
+	uint32_t t, i, hash;
+
+	if (cls_pmr_tuple(tbl->pmr[rule], &shape, key))
+		return -1;
+
+	for (t = 0; t < tbl->num_tuple; t++) {
+		tuple = &tbl->tuple[t];
+		if (tuple->num_field == shape.num_field &&
+		    !memcmp(tuple->field, shape.field,
+			    shape.num_field * sizeof(cls_field_t)))
+			break;
+	}
+
+	if (t == tbl->num_tuple) {
+		if (t == CLS_TUPLE_MAX)
+			return -1;
+		shape.first_rule = rule;
+		memcpy(&tbl->tuple[t], &shape, sizeof(cls_tuple_t));
+		tbl->num_tuple++;
+	}
+
+	/* Rules with equal keys are probed in insertion order, so the lowest
+	 * index one is found first. */
+	hash = cls_key_hash(key, shape.num_field, t);
+	i = hash & (CLS_TUPLE_HASH_SIZE - 1);
+	while (tbl->hash[i].rule != CLS_RULE_NONE)
+		i = (i + 1) & (CLS_TUPLE_HASH_SIZE - 1);
+
+	tbl->hash[i].hash = hash;
+	tbl->hash[i].tuple = t;
+	tbl->hash[i].rule = rule;
+	return 0;
+}
+
+/*
+ * Rebuild the compiled PMR table of a CoS from its PMR list and switch
+ * the fast path to it. CoS lock must be held.
+ */
+static void cls_rule_tbl_build(cos_t *cos)
+{
+	cls_cos_rule_t *cos_rule = &cos_rule_tbl->cos[cos->s.index];
+	uint32_t idx = odp_atomic_load_u32(&cos_rule->cur) ^ 1;
+	cls_rule_tbl_t *tbl = &cos_rule->tbl[idx];
+	uint32_t seq = odp_atomic_load_u32(&tbl->seq);
+	uint32_t num_rule = odp_atomic_load_u32(&cos->s.num_rule);
+	uint32_t i;
+
+	/* Readers still using this table will retry */
+	odp_atomic_store_u32(&tbl->seq, seq + 1);
+	odp_mb_full();
+
+	tbl->num_rule = num_rule;
+	tbl->num_tuple = 0;
+	tbl->num_linear = 0;
+
+	for (i = 0; i < CLS_TUPLE_HASH_SIZE; i++)
+		tbl->hash[i].rule = CLS_RULE_NONE;
+
+	for (i = 0; i < num_rule; i++) {
+		tbl->pmr[i] = cos->s.pmr[i];
+		tbl->cos[i] = cos->s.linked_cos[i];
+
+		if (cls_rule_insert(tbl, i))
+			tbl->linear[tbl->num_linear++] = i;
+	}
+
+	odp_atomic_store_rel_u32(&tbl->seq, seq + 2);
+	odp_atomic_store_rel_u32(&cos_rule->cur, idx);
+}
+
 int odp_cls_pmr_destroy(odp_pmr_t pmr_id)
 {
 	cos_t *src_cos;
 	uint32_t loc;
 	pmr_t *pmr;
-	uint8_t i;
+	uint32_t i, j;
 
 	pmr = get_pmr_entry(pmr_id);
 	if (pmr == NULL || pmr->s.src_cos == NULL)
@@ -649,13 +833,16 @@ int odp_cls_pmr_destroy(odp_pmr_t pmr_id)
 	loc = odp_atomic_load_u32(&src_cos->s.num_rule);
 	if (loc == 0)
 		goto no_rule;
-	loc -= 1;
-	for (i = 0; i <= loc; i++)
-		if (src_cos->s.pmr[i] == pmr) {
-			src_cos->s.pmr[i] = src_cos->s.pmr[loc];
-			src_cos->s.linked_cos[i] = src_cos->s.linked_cos[loc];
-		}
-	odp_atomic_dec_u32(&src_cos->s.num_rule);
+	/* Keep the creation order of the remaining rules */
+	for (i = 0, j = 0; i < loc; i++) {
+		if (src_cos->s.pmr[i] == pmr)
+			continue;
+		src_cos->s.pmr[j] = src_cos->s.pmr[i];
+		src_cos->s.linked_cos[j] = src_cos->s.linked_cos[i];
+		j++;
+	}
+	odp_atomic_store_u32(&src_cos->s.num_rule, j);
+	cls_rule_tbl_build(src_cos);
 
 no_rule:
 	pmr->s.valid = 0;
@@ -684,7 +871,7 @@ odp_pmr_t odp_cls_pmr_create(const odp_pmr_param_t *terms, int num_terms,
 		return ODP_PMR_INVAL;
 	}
 
-	if (CLS_PMR_PER_COS_MAX == odp_atomic_load_u32(&cos_src->s.num_rule))
+	if (odp_atomic_load_u32(&cos_src->s.num_rule) >= CLS_PMR_PER_COS_MAX)
 		return ODP_PMR_INVAL;
 
 	id = alloc_pmr(&pmr);
@@ -706,10 +893,20 @@ odp_pmr_t odp_cls_pmr_create(const odp_pmr_param_t *terms, int num_terms,
 		}
 	}
 
-	loc = odp_atomic_fetch_inc_u32(&cos_src->s.num_rule);
+	LOCK(&cos_src->s.lock);
+	loc = odp_atomic_load_u32(&cos_src->s.num_rule);
+	if (loc >= CLS_PMR_PER_COS_MAX) {
+		UNLOCK(&cos_src->s.lock);
+		pmr->s.valid = 0;
+		UNLOCK(&pmr->s.lock);
+		return ODP_PMR_INVAL;
+	}
 	cos_src->s.pmr[loc] = pmr;
 	cos_src->s.linked_cos[loc] = cos_dst;
+	odp_atomic_store_u32(&cos_src->s.num_rule, loc + 1);
 	pmr->s.src_cos = cos_src;
+	cls_rule_tbl_build(cos_src);
+	UNLOCK(&cos_src->s.lock);
 
 	UNLOCK(&pmr->s.lock);
 	return id;
@@ -862,44 +1059,129 @@ int verify_pmr(pmr_t *pmr, const uint8_t *pkt_addr, odp_packet_hdr_t *pkt_hdr)
 		if (pmr_failure)
 			return false;
 	}
-	odp_atomic_inc_u32(&pmr->s.count);
 	return true;
 }
 
 /*
- * Match a PMR chain with a Packet and return matching CoS
- * This function gets called recursively to check the chained PMR Term value
- * with the packet.
+ * Find the lowest index rule of a compiled table that matches the packet.
+ * Tuples are sorted by their first rule, so the search stops at the first
+ * tuple which cannot contain a better match than the one found already.
+ * The table may be rebuilt concurrently, thus all indexes read from it are
+ * bounds checked. The caller validates the result against the sequence
+ * number.
  */
-static
-cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, pmr_t *pmr,
-		     odp_packet_hdr_t *hdr)
+static inline uint32_t cls_rule_lookup(cls_rule_tbl_t *tbl,
+				       const uint8_t *pkt_addr,
+				       odp_packet_hdr_t *pkt_hdr)
 {
-	cos_t *retcos;
-	uint32_t i;
+	uint64_t key[2 * CLS_PMRTERM_MAX];
+	uint32_t best = CLS_RULE_NONE;
+	uint32_t num_tuple = tbl->num_tuple;
+	uint32_t num_linear = tbl->num_linear;
+	uint32_t t, f, i, n, hash, rule, num_field;
+	cls_tuple_t *tuple;
+	cls_hash_ent_t *ent;
+
+	if (odp_unlikely(num_tuple > CLS_TUPLE_MAX))
+		num_tuple = CLS_TUPLE_MAX;
+
+	for (t = 0; t < num_tuple; t++) {
+		tuple = &tbl->tuple[t];
+		if (tuple->first_rule >= best)
+			break;
 
-	retcos  = NULL;
+		num_field = tuple->num_field;
+		if (odp_unlikely(num_field > CLS_PMRTERM_MAX))
+			break;
 
-	if (cos == NULL || pmr == NULL)
-		return NULL;
+		for (f = 0; f < num_field; f++)
+			if (!cls_field_key(pkt_addr, pkt_hdr, &tuple->field[f],
+					   &key[2 * f]))
+				break;
 
-	if (!cos->s.valid)
-		return NULL;
+		if (f < num_field)
+			continue;
 
-	if (verify_pmr(pmr, pkt_addr, hdr)) {
-		/** This gets called recursively to check all the PMRs in
-		 * a PMR chain */
-		if (0 == odp_atomic_load_u32(&cos->s.num_rule))
-			return cos;
+		hash = cls_key_hash(key, num_field, t);
+		i = hash & (CLS_TUPLE_HASH_SIZE - 1);
+
+		for (n = 0; n < CLS_TUPLE_HASH_SIZE; n++) {
+			ent = &tbl->hash[i];
+			rule = ent->rule;
+
+			if (rule == CLS_RULE_NONE)
+				break;
 
-		for (i = 0; i < odp_atomic_load_u32(&cos->s.num_rule); i++) {
-			retcos = match_pmr_cos(cos->s.linked_cos[i], pkt_addr,
-					       cos->s.pmr[i], hdr);
-			if (!retcos)
-				return cos;
+			if (ent->hash == hash && ent->tuple == t &&
+			    rule < best &&
+			    verify_pmr(tbl->pmr[rule], pkt_addr, pkt_hdr)) {
+				best = rule;
+				break;
+			}
+
+			i = (i + 1) & (CLS_TUPLE_HASH_SIZE - 1);
 		}
 	}
-	return retcos;
+
+	if (odp_unlikely(num_linear > CLS_PMR_PER_COS_MAX))
+		num_linear = CLS_PMR_PER_COS_MAX;
+
+	for (i = 0; i < num_linear; i++) {
+		rule = tbl->linear[i];
+		if (rule >= best)
+			break;
+
+		if (verify_pmr(tbl->pmr[rule], pkt_addr, pkt_hdr)) {
+			best = rule;
+			break;
+		}
+	}
+
+	return best;
+}
+
+/*
+ * Match the packet against the PMRs attached to a CoS and return
+ * the destination CoS of the first matching PMR, or NULL when no PMR
+ * matches.
+ */
+static inline cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr,
+				   odp_packet_hdr_t *pkt_hdr)
+{
+	cls_cos_rule_t *cos_rule = &cos_rule_tbl->cos[cos->s.index];
+	cls_rule_tbl_t *tbl;
+	pmr_t *pmr = NULL;
+	cos_t *dst = NULL;
+	uint32_t seq, rule;
+
+	while (1) {
+		tbl = &cos_rule->tbl[odp_atomic_load_acq_u32(&cos_rule->cur)];
+		seq = odp_atomic_load_acq_u32(&tbl->seq);
+
+		if (odp_unlikely(seq & 1)) {
+			odp_cpu_pause();
+			continue;
+		}
+
+		rule = CLS_RULE_NONE;
+		if (tbl->num_rule)
+			rule = cls_rule_lookup(tbl, pkt_addr, pkt_hdr);
+
+		if (rule != CLS_RULE_NONE) {
+			pmr = tbl->pmr[rule];
+			dst = tbl->cos[rule];
+		}
+
+		odp_mb_acquire();
+		if (odp_likely(odp_atomic_load_u32(&tbl->seq) == seq))
+			break;
+	}
+
+	if (rule == CLS_RULE_NONE)
+		return NULL;
+
+	odp_atomic_inc_u32(&pmr->s.count);
+	return dst;
 }
 
 int pktio_classifier_init(pktio_entry_t *entry)
@@ -937,8 +1219,8 @@ static inline cos_t *cls_select_cos(pktio_entry_t *entry,
 				    const uint8_t *pkt_addr,
 				    odp_packet_hdr_t *pkt_hdr)
 {
-	pmr_t *pmr;
 	cos_t *cos;
+	cos_t *next;
 	cos_t *default_cos;
 	uint32_t i;
 	classifier_t *cls;
@@ -949,15 +1231,20 @@ static inline cos_t *cls_select_cos(pktio_entry_t *entry,
 	/* Return error cos for error packet */
 	if (pkt_hdr->p.error_flags.all)
 		return cls->error_cos;
-	/* Calls all the PMRs attached at the PKTIO level*/
-	for (i = 0; i < odp_atomic_load_u32(&default_cos->s.num_rule); i++) {
-		pmr = default_cos->s.pmr[i];
-		cos = default_cos->s.linked_cos[i];
-		cos = match_pmr_cos(cos, pkt_addr, pmr, pkt_hdr);
-		if (cos)
-			return cos;
+
+	/* Follow the first matching PMR of each CoS, starting from the PMRs
+	 * attached at the PKTIO level. Depth limit breaks CoS loops. */
+	cos = default_cos;
+	for (i = 0; i < CLS_COS_MAX_ENTRY; i++) {
+		next = match_pmr_cos(cos, pkt_addr, pkt_hdr);
+		if (next == NULL || !next->s.valid)
+			break;
+		cos = next;
 	}
 
+	if (cos != default_cos)
+		return cos;
+
 	cos = match_qos_cos(entry, pkt_addr, pkt_hdr);
 	if (cos)
 		return cos;
@@ -969,35 +1256,14 @@ static uint32_t packet_rss_hash(odp_packet_hdr_t *pkt_hdr,
 				odp_cls_hash_proto_t hash_proto,
 				const uint8_t *base);
 
-/**
- * Classify packet
- *
- * @param pktio_entry	Ingress pktio
- * @param base		Packet data
- * @param pkt_len	Packet length
- * @param seg_leg	Segment length
- * @param pool[out]	Packet pool
- * @param pkt_hdr[out]	Packet header
- *
- * @retval 0 on success
- * @retval -EFAULT Bug
- * @retval -EINVAL Config error
- *
- * @note *base is not released
- */
-int cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
-			uint16_t pkt_len, uint32_t seg_len, odp_pool_t *pool,
-			odp_packet_hdr_t *pkt_hdr)
+/* Select CoS, pool and destination queue of a parsed packet */
+static inline int cls_packet_cos(pktio_entry_t *entry, const uint8_t *base,
+				 odp_pool_t *pool, odp_packet_hdr_t *pkt_hdr)
 {
 	cos_t *cos;
 	uint32_t tbl_index;
 	uint32_t hash;
 
-	packet_parse_reset(pkt_hdr);
-	packet_set_len(pkt_hdr, pkt_len);
-
-	packet_parse_common(&pkt_hdr->p, base, pkt_len, seg_len,
-			    ODP_PROTO_LAYER_ALL);
 	cos = cls_select_cos(entry, base, pkt_hdr);
 
 	if (cos == NULL)
@@ -1027,6 +1293,144 @@ int cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 	return 0;
 }
 
+static inline int cls_packet(pktio_entry_t *entry, const uint8_t *base,
+			     uint32_t pkt_len, uint32_t seg_len,
+			     odp_pool_t *pool, odp_packet_hdr_t *pkt_hdr)
+{
+	packet_parse_reset(pkt_hdr);
+	packet_set_len(pkt_hdr, pkt_len);
+
+	packet_parse_common(&pkt_hdr->p, base, pkt_len, seg_len,
+			    ODP_PROTO_LAYER_ALL);
+
+	return cls_packet_cos(entry, base, pool, pkt_hdr);
+}
+
+/**
+ * Classify packet
+ *
+ * @param pktio_entry	Ingress pktio
+ * @param base		Packet data
+ * @param pkt_len	Packet length
+ * @param seg_leg	Segment length
+ * @param pool[out]	Packet pool
+ * @param pkt_hdr[out]	Packet header
+ *
+ * @retval 0 on success
+ * @retval -EFAULT Bug
+ * @retval -EINVAL Config error
+ *
+ * @note *base is not released
+ */
+int cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
+			uint16_t pkt_len, uint32_t seg_len, odp_pool_t *pool,
+			odp_packet_hdr_t *pkt_hdr)
+{
+	return cls_packet(entry, base, pkt_len, seg_len, pool, pkt_hdr);
+}
+
+/*
+ * Store indexes of classified packets into 'order' so that packets of
+ * the same pool are consecutive and keep their receive order. Maximum 'num'
+ * is CLS_BURST_MAX.
+ */
+static int cls_group_by_pool(const odp_pool_t pool[], uint16_t order[],
+			     int num)
+{
+	uint8_t done[CLS_BURST_MAX];
+	odp_pool_t cur;
+	int i, j;
+	int n = 0;
+
+	ODP_ASSERT(num <= CLS_BURST_MAX);
+	memset(done, 0, sizeof(done));
+
+	for (i = 0; i < num; i++) {
+		if (done[i] || pool[i] == ODP_POOL_INVALID)
+			continue;
+
+		cur = pool[i];
+		for (j = i; j < num; j++) {
+			if (!done[j] && pool[j] == cur) {
+				order[n++] = j;
+				done[j] = 1;
+			}
+		}
+	}
+
+	return n;
+}
+
+int cls_classify_packet_multi(pktio_entry_t *entry, const uint8_t *base[],
+			      const uint32_t pkt_len[],
+			      const uint32_t seg_len[], odp_pool_t pool[],
+			      odp_packet_hdr_t *pkt_hdr[], uint16_t order[],
+			      int num)
+{
+	cos_t *default_cos = entry->s.cls.default_cos;
+	cls_cos_rule_t *cos_rule;
+	cls_rule_tbl_t *tbl;
+	packet_parser_t *prs[CLS_BURST_MAX];
+	int ret[CLS_BURST_MAX];
+	int i, j, n;
+	int num_cls = 0;
+
+	if (odp_unlikely(num <= 0))
+		return 0;
+
+	/* PMR table of the default CoS is used by every packet */
+	if (default_cos) {
+		cos_rule = &cos_rule_tbl->cos[default_cos->s.index];
+		tbl = &cos_rule->tbl[odp_atomic_load_u32(&cos_rule->cur)];
+		odp_prefetch(tbl);
+		odp_prefetch(tbl->tuple);
+	}
+
+	for (i = 0; i < num && i < CLS_PREFETCH; i++) {
+		odp_prefetch(base[i]);
+		odp_prefetch_store(pkt_hdr[i]);
+	}
+
+	/* Parse up to CLS_BURST_MAX packets first, then classify packet by
+	 * packet */
+	for (i = 0; i < num; i += n) {
+		n = num - i;
+		if (n > CLS_BURST_MAX)
+			n = CLS_BURST_MAX;
+
+		for (j = 0; j < n; j++) {
+			if (i + j + CLS_PREFETCH < num) {
+				odp_prefetch(base[i + j + CLS_PREFETCH]);
+				odp_prefetch_store(pkt_hdr[i + j +
+							   CLS_PREFETCH]);
+			}
+
+			packet_parse_reset(pkt_hdr[i + j]);
+			packet_set_len(pkt_hdr[i + j], pkt_len[i + j]);
+			prs[j] = &pkt_hdr[i + j]->p;
+		}
+
+		packet_parse_common_multi(prs, &base[i], &pkt_len[i],
+					  &seg_len[i], ret, n,
+					  ODP_PROTO_LAYER_ALL);
+
+		for (j = 0; j < n; j++) {
+			if (odp_unlikely(cls_packet_cos(entry, base[i + j],
+							&pool[i + j],
+							pkt_hdr[i + j]))) {
+				pool[i + j] = ODP_POOL_INVALID;
+				continue;
+			}
+			num_cls++;
+		}
+	}
+
+	if (order)
+		return cls_group_by_pool(pool, order, num);
+
+	return num_cls;
+}
+
 static uint32_t packet_rss_hash(odp_packet_hdr_t *pkt_hdr,
 				odp_cls_hash_proto_t hash_proto,
 				const uint8_t *base)
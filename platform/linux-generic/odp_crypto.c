@@ -9,7 +9,6 @@
 #include <odp_posix_extensions.h>
 #include <odp/api/crypto.h>
 #include <odp_internal.h>
-#include <odp/api/spinlock.h>
 #include <odp/api/sync.h>
 #include <odp/api/debug.h>
 #include <odp/api/align.h>
@@ -18,16 +17,39 @@
 #include <odp/api/hints.h>
 #include <odp/api/random.h>
 #include <odp/api/plat/packet_inlines.h>
+#include <odp/api/cpumask.h>
+#include <odp/api/queue.h>
+#include <odp/api/time.h>
+#include <odp/api/init.h>
+#include <odp/api/spinlock.h>
 #include <odp_packet_internal.h>
+#include <odp_config_internal.h>
+#include <odp_ring_internal.h>
+#include <odp_schedule_idle_internal.h>
 
 #include <string.h>
 #include <stdlib.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
 
 #include <openssl/rand.h>
 #include <openssl/hmac.h>
 #include <openssl/evp.h>
 
-#define MAX_SESSIONS 32
+/* Thread local cache of free sessions */
+#define SESSION_CACHE_SIZE  32
+#define SESSION_CACHE_BURST 16
+
+/* Thread local OpenSSL context cache is set associative */
+#define CTX_CACHE_WAYS 4
+#define CTX_CACHE_SETS (CONFIG_CRYPTO_CTX_CACHE_SIZE / CTX_CACHE_WAYS)
+
+/* Maximum AAD length copied into an asynchronous operation */
+#define MAX_AAD_LEN 16
+
+/* Maximum number of packets processed together */
+#define MAX_MULTI 32
 
 /*
  * Cipher algorithm capabilities
@@ -99,12 +121,19 @@ odp_crypto_alg_err_t (*crypto_func_t)(odp_packet_t pkt,
 				      odp_crypto_generic_session_t *session);
 typedef void (*crypto_init_func_t)(odp_crypto_generic_session_t *session);
 
+/**
+ * Multi-buffer algorithm handler function prototype
+ */
+typedef
+void (*crypto_multi_func_t)(odp_packet_t pkt[],
+			    const odp_crypto_packet_op_param_t *param[],
+			    odp_crypto_alg_err_t rc[], int num,
+			    odp_crypto_generic_session_t *session);
+
 /**
  * Per crypto session data structure
  */
 struct odp_crypto_generic_session_t {
-	odp_crypto_generic_session_t *next;
-
 	/* Session creation parameters */
 	odp_crypto_session_param_t p;
 
@@ -118,6 +147,10 @@ struct odp_crypto_generic_session_t {
 		const EVP_CIPHER *evp_cipher;
 		crypto_func_t func;
 		crypto_init_func_t init;
+
+		/* Optional handler for several packets of the session */
+		const EVP_CIPHER *evp_ecb;
+		crypto_multi_func_t func_multi;
 	} cipher;
 
 	struct {
@@ -132,64 +165,289 @@ struct odp_crypto_generic_session_t {
 		crypto_init_func_t init;
 	} auth;
 
-	unsigned idx;
+	/* Index in the session table */
+	uint32_t idx;
+
+	/* Incremented when the session is freed. Thread local contexts
+	 * initialized for an older version are not valid. */
+	uint32_t version;
+
+	/* Crypto worker thread of an ASYNC session */
+	uint32_t worker;
+
+	/* Number of ASYNC operations not yet completed */
+	odp_atomic_u32_t inflight;
 };
 
+/* ASYNC operation waiting for a crypto worker thread. IV and AAD are copied,
+ * since the caller may reuse its buffers after odp_crypto_op_enq(). */
+typedef struct {
+	odp_packet_t pkt_in;
+	odp_packet_t pkt_out;
+	odp_crypto_packet_op_param_t param;
+	odp_time_t enq_time;
+	uint8_t iv[EVP_MAX_IV_LENGTH];
+	uint8_t aad[MAX_AAD_LEN];
+} crypto_async_op_t;
+
+/* Ring of operation indexes */
+typedef struct {
+	ring_t hdr;
+	uint32_t data[CONFIG_CRYPTO_ASYNC_OPS];
+} crypto_async_ring_t;
+
+typedef struct ODP_ALIGNED_CACHE {
+	/* Operations submitted to this thread */
+	crypto_async_ring_t ring;
+
+	/* Sleep and wake up of the thread */
+	sched_idle_t idle;
+
+	odp_atomic_u32_t stop;
+	pthread_t thread;
+	pthread_attr_t attr;
+	int cpu;
+
+	/* Number of sessions assigned to the thread */
+	uint32_t num_sessions;
+
+	/* Statistics, written only by the thread */
+	uint64_t ops;
+	uint64_t batches;
+	uint32_t batch_max;
+	uint32_t depth_max;
+	uint64_t latency_ns;
+	uint64_t latency_max_ns;
+	uint64_t compl_drop;
+
+} crypto_worker_t;
+
+/* Free sessions of a thread. Other threads take the lock to flush the cache
+ * when the free ring runs empty. */
+typedef struct ODP_ALIGNED_CACHE {
+	odp_spinlock_t lock;
+	uint32_t num;
+	uint32_t idx[SESSION_CACHE_SIZE];
+} crypto_session_cache_t;
+
 typedef struct odp_crypto_global_s odp_crypto_global_t;
 
 struct odp_crypto_global_s {
-	odp_spinlock_t                lock;
-	odp_crypto_generic_session_t *free;
-	odp_crypto_generic_session_t  sessions[MAX_SESSIONS];
+	/* Session table and the ring of free session indexes. These are
+	 * reserved from a separate shm block, which is sized by the number of
+	 * sessions. */
+	odp_shm_t session_shm;
+	odp_crypto_generic_session_t *sessions;
+	ring_t *free_ring;
+	uint32_t free_mask;
+	uint32_t max_sessions;
+
+	/* Free sessions cached per thread */
+	crypto_session_cache_t cache[ODP_THREAD_COUNT_MAX];
+
+	/* Crypto worker threads for ASYNC operations */
+	struct {
+		/* Serializes worker thread start and stop */
+		odp_ticketlock_t lock;
+		uint32_t num_threads;
+		uint32_t burst;
+		odp_cpumask_t cpumask;
+
+		/* Number of ASYNC sessions. Threads run while there are
+		 * ASYNC sessions. */
+		uint32_t num_sessions;
+
+		/* Number of threads started */
+		uint32_t running;
+
+		odp_atomic_u64_t queue_full;
 
-	/* These flags are cleared at alloc_session() */
-	uint8_t ctx_valid[ODP_THREAD_COUNT_MAX][MAX_SESSIONS];
+		/* Free operations */
+		crypto_async_ring_t free;
+		crypto_async_op_t op[CONFIG_CRYPTO_ASYNC_OPS];
+		crypto_worker_t worker[CONFIG_CRYPTO_ASYNC_THREADS_MAX];
+	} async;
 
 	odp_ticketlock_t              openssl_lock[0];
 };
 
 static odp_crypto_global_t *global;
 
+/* OpenSSL contexts of a thread. A session maps to a set of CTX_CACHE_WAYS
+ * context slots by its index modulo CTX_CACHE_SETS. */
+typedef struct {
+	/* Session the contexts are initialized for */
+	uint32_t idx;
+	uint32_t version;
+
+	HMAC_CTX *hmac_ctx;
+	EVP_CIPHER_CTX *cipher_ctx;
+	/* GMAC, or ECB of multi-buffer CBC encryption */
+	EVP_CIPHER_CTX *mac_cipher_ctx;
+} crypto_ctx_t;
+
 typedef struct crypto_local_t {
-	HMAC_CTX *hmac_ctx[MAX_SESSIONS];
-	EVP_CIPHER_CTX *cipher_ctx[MAX_SESSIONS];
-	EVP_CIPHER_CTX *mac_cipher_ctx[MAX_SESSIONS];
-	uint8_t *ctx_valid;
+	crypto_session_cache_t *cache;
+
+	/* Contexts selected by the latest crypto_init() call */
+	crypto_ctx_t *cur;
+
+	/* Next way to replace in each set */
+	uint8_t next[CTX_CACHE_SETS];
+
+	crypto_ctx_t ctx[CTX_CACHE_SETS][CTX_CACHE_WAYS];
 } crypto_local_t;
 
 static __thread crypto_local_t local;
 
-typedef enum { KIND_HMAC, KIND_CIPHER, KIND_MAC_CIPHER } crypto_kind_t;
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(CONFIG_CRYPTO_CTX_CACHE_SIZE) &&
+		  CONFIG_CRYPTO_CTX_CACHE_SIZE >= CTX_CACHE_WAYS,
+		  "CONFIG_CRYPTO_CTX_CACHE_SIZE is not a power of two");
 
-static inline void crypto_init(odp_crypto_generic_session_t *session)
+static inline crypto_ctx_t *local_ctx(odp_crypto_generic_session_t *session)
 {
-	if (local.ctx_valid[session->idx])
-		return;
+	ODP_ASSERT(local.cur->idx == session->idx);
+
+	return local.cur;
+}
+
+static int crypto_ctx_create(crypto_ctx_t *ctx)
+{
+	if (ctx->hmac_ctx == NULL)
+		ctx->hmac_ctx = HMAC_CTX_new();
+	if (ctx->cipher_ctx == NULL)
+		ctx->cipher_ctx = EVP_CIPHER_CTX_new();
+	if (ctx->mac_cipher_ctx == NULL)
+		ctx->mac_cipher_ctx = EVP_CIPHER_CTX_new();
+
+	if (ctx->hmac_ctx == NULL || ctx->cipher_ctx == NULL ||
+	    ctx->mac_cipher_ctx == NULL) {
+		ODP_ERR("Crypto context create failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Select a slot of the set for re-keying. Slots not used yet and slots of
+ * freed sessions are selected first, otherwise slots are replaced in round
+ * robin order. */
+static crypto_ctx_t *crypto_ctx_replace(uint32_t set)
+{
+	crypto_ctx_t *ctx = local.ctx[set];
+	uint32_t way;
+
+	for (way = 0; way < CTX_CACHE_WAYS; way++) {
+		if (ctx[way].version == 0 ||
+		    global->sessions[ctx[way].idx].version != ctx[way].version)
+			return &ctx[way];
+	}
+
+	way = local.next[set];
+	local.next[set] = (way + 1) & (CTX_CACHE_WAYS - 1);
+
+	return &ctx[way];
+}
+
+/* Prepare thread local contexts for the session and select them for
+ * local_ctx(). Contexts of a slot are created on its first use, and
+ * initialized again when the slot was last used by another session. Returns 0
+ * on success. */
+static inline int crypto_init(odp_crypto_generic_session_t *session)
+{
+	uint32_t set = session->idx & (CTX_CACHE_SETS - 1);
+	crypto_ctx_t *ctx = local.ctx[set];
+	uint32_t way;
+
+	for (way = 0; way < CTX_CACHE_WAYS; way++) {
+		if (odp_likely(ctx[way].idx == session->idx &&
+			       ctx[way].version == session->version)) {
+			local.cur = &ctx[way];
+			return 0;
+		}
+	}
+
+	ctx = crypto_ctx_replace(set);
+
+	if (odp_unlikely(ctx->mac_cipher_ctx == NULL) &&
+	    crypto_ctx_create(ctx))
+		return -1;
+
+	ctx->idx = session->idx;
+	ctx->version = session->version;
+	local.cur = ctx;
 
 	session->cipher.init(session);
 	session->auth.init(session);
 
-	local.ctx_valid[session->idx] = 1;
+	return 0;
+}
+
+/* Return free sessions cached by other threads into the free ring */
+static void session_cache_flush_others(void)
+{
+	crypto_session_cache_t *cache;
+	int i;
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		cache = &global->cache[i];
+
+		if (cache == local.cache || cache->num == 0)
+			continue;
+
+		odp_spinlock_lock(&cache->lock);
+
+		if (cache->num) {
+			ring_enq_multi(global->free_ring, global->free_mask,
+				       cache->idx, cache->num);
+			cache->num = 0;
+		}
+
+		odp_spinlock_unlock(&cache->lock);
+	}
 }
 
 static
 odp_crypto_generic_session_t *alloc_session(void)
 {
-	odp_crypto_generic_session_t *session = NULL;
-	unsigned i;
+	crypto_session_cache_t *cache = local.cache;
+	odp_crypto_generic_session_t *session;
+	uint32_t num;
+
+	if (odp_unlikely(global->max_sessions == 0))
+		return NULL;
 
-	odp_spinlock_lock(&global->lock);
-	session = global->free;
-	if (session) {
-		global->free = session->next;
-		session->next = NULL;
+	odp_spinlock_lock(&cache->lock);
+
+	if (odp_unlikely(cache->num == 0)) {
+		num = ring_deq_multi(global->free_ring, global->free_mask,
+				     cache->idx, SESSION_CACHE_BURST);
+
+		if (num == 0) {
+			/* Remaining free sessions may be cached by other
+			 * threads */
+			odp_spinlock_unlock(&cache->lock);
+			session_cache_flush_others();
+			odp_spinlock_lock(&cache->lock);
+
+			num = ring_deq_multi(global->free_ring,
+					     global->free_mask, cache->idx,
+					     SESSION_CACHE_BURST);
+		}
+
+		cache->num = num;
+
+		if (num == 0) {
+			odp_spinlock_unlock(&cache->lock);
+			return NULL;
+		}
 	}
-	odp_spinlock_unlock(&global->lock);
 
-	session->idx = session - global->sessions;
+	cache->num--;
+	session = &global->sessions[cache->idx[cache->num]];
+	odp_spinlock_unlock(&cache->lock);
 
-	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
-		global->ctx_valid[i][session->idx] = 0;
+	odp_atomic_init_u32(&session->inflight, 0);
 
 	return session;
 }
@@ -197,10 +455,27 @@ odp_crypto_generic_session_t *alloc_session(void)
 static
 void free_session(odp_crypto_generic_session_t *session)
 {
-	odp_spinlock_lock(&global->lock);
-	session->next = global->free;
-	global->free = session;
-	odp_spinlock_unlock(&global->lock);
+	crypto_session_cache_t *cache = local.cache;
+	uint32_t idx = session->idx;
+	uint32_t version = session->version + 1;
+
+	/* Clear keys. A new version invalidates the thread local contexts of
+	 * the session. Zero is the version of an unused context slot. */
+	memset(session, 0, sizeof(*session));
+	session->idx = idx;
+	session->version = version ? version : 1;
+
+	odp_spinlock_lock(&cache->lock);
+
+	if (odp_unlikely(cache->num == SESSION_CACHE_SIZE)) {
+		cache->num -= SESSION_CACHE_BURST;
+		ring_enq_multi(global->free_ring, global->free_mask,
+			       &cache->idx[cache->num], SESSION_CACHE_BURST);
+	}
+
+	cache->idx[cache->num++] = idx;
+
+	odp_spinlock_unlock(&cache->lock);
 }
 
 static odp_crypto_alg_err_t
@@ -237,7 +512,7 @@ static void HMAC_CTX_free(HMAC_CTX *ctx)
 static void
 auth_init(odp_crypto_generic_session_t *session)
 {
-	HMAC_CTX *ctx = local.hmac_ctx[session->idx];
+	HMAC_CTX *ctx = local_ctx(session)->hmac_ctx;
 
 	HMAC_Init_ex(ctx,
 		     session->auth.key,
@@ -252,7 +527,7 @@ void packet_hmac(odp_packet_t pkt,
 		 odp_crypto_generic_session_t *session,
 		 uint8_t *hash)
 {
-	HMAC_CTX *ctx = local.hmac_ctx[session->idx];
+	HMAC_CTX *ctx = local_ctx(session)->hmac_ctx;
 	uint32_t offset = param->auth_range.offset;
 	uint32_t len   = param->auth_range.length;
 
@@ -467,11 +742,18 @@ int internal_decrypt(EVP_CIPHER_CTX *ctx,
 static void
 cipher_encrypt_init(odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->cipher_ctx;
 
 	EVP_EncryptInit_ex(ctx, session->cipher.evp_cipher, NULL,
 			   session->cipher.key_data, NULL);
 	EVP_CIPHER_CTX_set_padding(ctx, 0);
+
+	if (session->cipher.evp_ecb) {
+		ctx = local_ctx(session)->mac_cipher_ctx;
+		EVP_EncryptInit_ex(ctx, session->cipher.evp_ecb, NULL,
+				   session->cipher.key_data, NULL);
+		EVP_CIPHER_CTX_set_padding(ctx, 0);
+	}
 }
 
 static
@@ -479,7 +761,7 @@ odp_crypto_alg_err_t cipher_encrypt(odp_packet_t pkt,
 				    const odp_crypto_packet_op_param_t *param,
 				    odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->cipher_ctx;
 	void *iv_ptr;
 	int ret;
 
@@ -498,10 +780,136 @@ odp_crypto_alg_err_t cipher_encrypt(odp_packet_t pkt,
 			  ODP_CRYPTO_ALG_ERR_NONE;
 }
 
+/* CBC chaining of multiple packets, block_len is a compile time constant */
+static inline __attribute__((always_inline))
+void cipher_cbc_multi(EVP_CIPHER_CTX *ctx, uint8_t *data[],
+		      const uint8_t *prev[], const uint32_t len[], int num,
+		      uint32_t max_len, const uint32_t block_len)
+{
+	uint8_t buf[MAX_MULTI * EVP_MAX_BLOCK_LENGTH];
+	int active[MAX_MULTI];
+	uint32_t pos, j;
+	int i, k, n;
+	int out_len;
+
+	for (pos = 0; pos < max_len; pos += block_len) {
+		uint8_t *blk = buf;
+
+		/* Chain plain text blocks with the previous cipher text */
+		n = 0;
+		for (k = 0; k < num; k++) {
+			if (pos >= len[k])
+				continue;
+
+			for (j = 0; j < block_len; j += 8) {
+				uint64_t a, b;
+
+				memcpy(&a, &data[k][pos + j], 8);
+				memcpy(&b, &prev[k][j], 8);
+				a ^= b;
+				memcpy(&blk[j], &a, 8);
+			}
+
+			blk += block_len;
+			active[n++] = k;
+		}
+
+		EVP_EncryptUpdate(ctx, buf, &out_len, buf, n * block_len);
+
+		blk = buf;
+		for (i = 0; i < n; i++) {
+			k = active[i];
+			memcpy(&data[k][pos], blk, block_len);
+			prev[k] = &data[k][pos];
+			blk += block_len;
+		}
+	}
+}
+
+/*
+ * Multi-buffer CBC encryption
+ *
+ * CBC encryption of a packet is sequential, as every block depends on the
+ * previous one. Blocks of different packets are independent, so block 'pos'
+ * of all packets is encrypted with a single ECB call. This lets the cipher
+ * implementation (AES-NI, VAES, ARMv8 CE, ...) pipeline the blocks, and
+ * saves the per packet IV setup. Packets with a segmented cipher range or a
+ * partial block are encrypted one by one.
+ */
+static void cipher_encrypt_multi(odp_packet_t pkt[],
+				 const odp_crypto_packet_op_param_t *param[],
+				 odp_crypto_alg_err_t rc[], int num,
+				 odp_crypto_generic_session_t *session)
+{
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->mac_cipher_ctx;
+	uint32_t block_len = EVP_CIPHER_block_size(session->cipher.evp_ecb);
+	uint8_t *data[MAX_MULTI];
+	const uint8_t *prev[MAX_MULTI];
+	uint32_t len[MAX_MULTI];
+	uint32_t max_len = 0;
+	int i;
+	int num_mb = 0;
+
+	for (i = 0; i < num; i++) {
+		uint32_t offset = param[i]->cipher_range.offset;
+		uint32_t length = param[i]->cipher_range.length;
+		uint32_t seg_len = 0;
+		const uint8_t *iv;
+		uint8_t *ptr;
+
+		if (param[i]->override_iv_ptr)
+			iv = param[i]->override_iv_ptr;
+		else if (session->p.iv.data)
+			iv = session->cipher.iv_data;
+		else
+			iv = NULL;
+
+		ptr = odp_packet_offset(pkt[i], offset, &seg_len, NULL);
+
+		if (iv == NULL || ptr == NULL || seg_len < length ||
+		    length % block_len) {
+			rc[i] = cipher_encrypt(pkt[i], param[i], session);
+			continue;
+		}
+
+		data[num_mb] = ptr;
+		prev[num_mb] = iv;
+		len[num_mb] = length;
+		num_mb++;
+
+		if (length > max_len)
+			max_len = length;
+
+		rc[i] = ODP_CRYPTO_ALG_ERR_NONE;
+	}
+
+	if (block_len == 16)
+		cipher_cbc_multi(ctx, data, prev, len, num_mb, max_len, 16);
+	else
+		cipher_cbc_multi(ctx, data, prev, len, num_mb, max_len, 8);
+}
+
+/* ECB cipher for multi-buffer encryption of a CBC cipher */
+static const EVP_CIPHER *cipher_cbc_to_ecb(const EVP_CIPHER *cipher)
+{
+	switch (EVP_CIPHER_nid(cipher)) {
+	case NID_des_ede3_cbc:
+		return EVP_des_ede3_ecb();
+	case NID_aes_128_cbc:
+		return EVP_aes_128_ecb();
+	case NID_aes_192_cbc:
+		return EVP_aes_192_ecb();
+	case NID_aes_256_cbc:
+		return EVP_aes_256_ecb();
+	default:
+		return NULL;
+	}
+}
+
 static void
 cipher_decrypt_init(odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->cipher_ctx;
 
 	EVP_DecryptInit_ex(ctx, session->cipher.evp_cipher, NULL,
 			   session->cipher.key_data, NULL);
@@ -513,7 +921,7 @@ odp_crypto_alg_err_t cipher_decrypt(odp_packet_t pkt,
 				    const odp_crypto_packet_op_param_t *param,
 				    odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->cipher_ctx;
 	void *iv_ptr;
 	int ret;
 
@@ -554,6 +962,9 @@ static int process_cipher_param(odp_crypto_generic_session_t *session,
 	if (ODP_CRYPTO_OP_ENCODE == session->p.op) {
 		session->cipher.func = cipher_encrypt;
 		session->cipher.init = cipher_encrypt_init;
+		session->cipher.evp_ecb = cipher_cbc_to_ecb(cipher);
+		if (session->cipher.evp_ecb)
+			session->cipher.func_multi = cipher_encrypt_multi;
 	} else {
 		session->cipher.func = cipher_decrypt;
 		session->cipher.init = cipher_decrypt_init;
@@ -565,7 +976,7 @@ static int process_cipher_param(odp_crypto_generic_session_t *session,
 static void
 aes_gcm_encrypt_init(odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->cipher_ctx;
 
 	EVP_EncryptInit_ex(ctx, session->cipher.evp_cipher, NULL,
 			   session->cipher.key_data, NULL);
@@ -579,7 +990,7 @@ odp_crypto_alg_err_t aes_gcm_encrypt(odp_packet_t pkt,
 				     const odp_crypto_packet_op_param_t *param,
 				     odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->cipher_ctx;
 	const uint8_t *aad_head = param->aad_ptr;
 	uint32_t aad_len = session->p.auth_aad_len;
 	void *iv_ptr;
@@ -615,7 +1026,7 @@ odp_crypto_alg_err_t aes_gcm_encrypt(odp_packet_t pkt,
 static void
 aes_gcm_decrypt_init(odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->cipher_ctx;
 
 	EVP_DecryptInit_ex(ctx, session->cipher.evp_cipher, NULL,
 			   session->cipher.key_data, NULL);
@@ -629,7 +1040,7 @@ odp_crypto_alg_err_t aes_gcm_decrypt(odp_packet_t pkt,
 				     const odp_crypto_packet_op_param_t *param,
 				     odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->cipher_ctx;
 	const uint8_t *aad_head = param->aad_ptr;
 	uint32_t aad_len = session->p.auth_aad_len;
 	int dummy_len = 0;
@@ -690,7 +1101,7 @@ static int process_aes_gcm_param(odp_crypto_generic_session_t *session,
 static void
 aes_gmac_gen_init(odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.mac_cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->mac_cipher_ctx;
 
 	EVP_EncryptInit_ex(ctx, session->auth.evp_cipher, NULL,
 			   session->auth.key, NULL);
@@ -704,7 +1115,7 @@ odp_crypto_alg_err_t aes_gmac_gen(odp_packet_t pkt,
 				  const odp_crypto_packet_op_param_t *param,
 				  odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.mac_cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->mac_cipher_ctx;
 	void *iv_ptr;
 	uint8_t block[EVP_MAX_MD_SIZE];
 	int ret;
@@ -732,7 +1143,7 @@ odp_crypto_alg_err_t aes_gmac_gen(odp_packet_t pkt,
 static void
 aes_gmac_check_init(odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.mac_cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->mac_cipher_ctx;
 
 	EVP_DecryptInit_ex(ctx, session->auth.evp_cipher, NULL,
 			   session->auth.key, NULL);
@@ -746,7 +1157,7 @@ odp_crypto_alg_err_t aes_gmac_check(odp_packet_t pkt,
 				    const odp_crypto_packet_op_param_t *param,
 				    odp_crypto_generic_session_t *session)
 {
-	EVP_CIPHER_CTX *ctx = local.mac_cipher_ctx[session->idx];
+	EVP_CIPHER_CTX *ctx = local_ctx(session)->mac_cipher_ctx;
 	void *iv_ptr;
 	uint8_t block[EVP_MAX_MD_SIZE];
 	int ret;
@@ -856,7 +1267,7 @@ int odp_crypto_capability(odp_crypto_capability_t *capa)
 	capa->auths.bit.aes128_gcm   = 1;
 #endif
 
-	capa->max_sessions = MAX_SESSIONS;
+	capa->max_sessions = global->max_sessions;
 
 	return 0;
 }
@@ -950,6 +1361,10 @@ int odp_crypto_auth_capability(odp_auth_alg_t auth,
 	return num;
 }
 
+static int crypto_async_attach(odp_crypto_generic_session_t *session);
+static void crypto_async_detach(odp_crypto_generic_session_t *session);
+static void crypto_async_stop(void);
+
 int
 odp_crypto_session_create(odp_crypto_session_param_t *param,
 			  odp_crypto_session_t *session_out,
@@ -1132,6 +1547,26 @@ odp_crypto_session_create(odp_crypto_session_param_t *param,
 		goto err;
 	}
 
+	/* GMAC uses the context of the multi-buffer cipher */
+	if (param->auth_alg == ODP_AUTH_ALG_AES_GMAC) {
+		session->cipher.evp_ecb = NULL;
+		session->cipher.func_multi = NULL;
+	}
+
+	if (param->op_mode == ODP_CRYPTO_ASYNC) {
+		/* Worker threads process a copy of the AAD */
+		if (global->async.num_threads &&
+		    param->auth_aad_len > MAX_AAD_LEN) {
+			*status = ODP_CRYPTO_SES_CREATE_ERR_INV_AUTH;
+			goto err;
+		}
+
+		if (crypto_async_attach(session)) {
+			*status = ODP_CRYPTO_SES_CREATE_ERR_ENOMEM;
+			goto err;
+		}
+	}
+
 	/* We're happy */
 	*session_out = (intptr_t)session;
 	*status = ODP_CRYPTO_SES_CREATE_ERR_NONE;
@@ -1150,7 +1585,9 @@ int odp_crypto_session_destroy(odp_crypto_session_t session)
 	odp_crypto_generic_session_t *generic;
 
 	generic = (odp_crypto_generic_session_t *)(intptr_t)session;
-	memset(generic, 0, sizeof(*generic));
+	if (generic->p.op_mode == ODP_CRYPTO_ASYNC)
+		crypto_async_detach(generic);
+
 	free_session(generic);
 	return 0;
 }
@@ -1221,8 +1658,125 @@ static void ODP_UNUSED openssl_lock(int mode, int n,
 		odp_ticketlock_unlock(&global->openssl_lock[n]);
 }
 
+static void crypto_async_init(void)
+{
+	const char *env;
+	uint32_t i;
+
+	odp_ticketlock_init(&global->async.lock);
+	odp_atomic_init_u64(&global->async.queue_full, 0);
+	global->async.burst = CONFIG_CRYPTO_ASYNC_BURST_MAX;
+
+	env = getenv("ODP_CRYPTO_ASYNC_THREADS");
+	if (env) {
+		i = atoi(env);
+		if (i > CONFIG_CRYPTO_ASYNC_THREADS_MAX)
+			i = CONFIG_CRYPTO_ASYNC_THREADS_MAX;
+		global->async.num_threads = i;
+	}
+
+	env = getenv("ODP_CRYPTO_ASYNC_BURST");
+	if (env) {
+		i = atoi(env);
+		if (i >= 1 && i <= CONFIG_CRYPTO_ASYNC_BURST_MAX)
+			global->async.burst = i;
+	}
+
+	env = getenv("ODP_CRYPTO_ASYNC_CPUMASK");
+	if (env)
+		odp_cpumask_from_str(&global->async.cpumask, env);
+	else
+		odp_cpumask_default_control(&global->async.cpumask, 0);
+
+	if (odp_cpumask_count(&global->async.cpumask) == 0)
+		odp_cpumask_default_control(&global->async.cpumask, 0);
+
+	ring_init(&global->async.free.hdr);
+	for (i = 0; i < CONFIG_CRYPTO_ASYNC_OPS; i++)
+		ring_enq(&global->async.free.hdr, CONFIG_CRYPTO_ASYNC_OPS - 1,
+			 i);
+
+	for (i = 0; i < CONFIG_CRYPTO_ASYNC_THREADS_MAX; i++) {
+		crypto_worker_t *worker = &global->async.worker[i];
+
+		ring_init(&worker->ring.hdr);
+		sched_idle_init(&worker->idle);
+		odp_atomic_init_u32(&worker->stop, 0);
+	}
+
+	if (global->async.num_threads)
+		ODP_DBG("Crypto worker threads: %" PRIu32 ", burst %" PRIu32
+			"\n", global->async.num_threads, global->async.burst);
+}
+
+static int crypto_session_init(const odp_init_t *params)
+{
+	const char *env;
+	uint32_t i, num, ring_size;
+	uint64_t ring_len, mem_size;
+	odp_shm_t shm;
+	uint8_t *addr;
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		odp_spinlock_init(&global->cache[i].lock);
+
+	global->session_shm = ODP_SHM_INVALID;
+
+	/* IPsec SAs use crypto sessions. Session table is not reserved when
+	 * the application uses neither. */
+	if (params && params->not_used.feat.crypto &&
+	    params->not_used.feat.ipsec)
+		return 0;
+
+	num = CONFIG_CRYPTO_SESSIONS;
+
+	env = getenv("ODP_CRYPTO_MAX_SESSIONS");
+	if (env) {
+		i = atoi(env);
+		if (i >= 1 && i <= CONFIG_CRYPTO_MAX_SESSIONS)
+			num = i;
+		else
+			ODP_ERR("Bad number of crypto sessions: %s\n", env);
+	}
+
+	ring_size = ROUNDUP_POWER2_U32(num);
+	ring_len = ROUNDUP_CACHE_LINE(sizeof(ring_t) +
+				      ring_size * sizeof(uint32_t));
+	mem_size = ring_len +
+		   (uint64_t)num * sizeof(odp_crypto_generic_session_t);
+
+	shm = odp_shm_reserve("crypto_sessions", mem_size,
+			      ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("Crypto session table reserve failed\n");
+		return -1;
+	}
+
+	addr = odp_shm_addr(shm);
+
+	global->session_shm  = shm;
+	global->free_ring    = (ring_t *)(uintptr_t)addr;
+	global->free_mask    = ring_size - 1;
+	global->sessions     = (odp_crypto_generic_session_t *)
+			       (uintptr_t)(addr + ring_len);
+	global->max_sessions = num;
+
+	ring_init(global->free_ring);
+
+	/* Session versions start from one, contexts of a thread from zero */
+	for (i = 0; i < num; i++) {
+		memset(&global->sessions[i], 0,
+		       sizeof(odp_crypto_generic_session_t));
+		global->sessions[i].idx = i;
+		global->sessions[i].version = 1;
+		ring_enq(global->free_ring, global->free_mask, i);
+	}
+
+	return 0;
+}
+
 int
-odp_crypto_init_global(void)
+odp_crypto_init_global(const odp_init_t *params)
 {
 	size_t mem_size;
 	odp_shm_t shm;
@@ -1242,12 +1796,10 @@ odp_crypto_init_global(void)
 	/* Clear it out */
 	memset(global, 0, mem_size);
 
-	/* Initialize free list and lock */
-	for (idx = 0; idx < MAX_SESSIONS; idx++) {
-		global->sessions[idx].next = global->free;
-		global->free = &global->sessions[idx];
-	}
-	odp_spinlock_init(&global->lock);
+	if (crypto_session_init(params))
+		return -1;
+
+	crypto_async_init();
 
 	if (nlocks > 0) {
 		for (idx = 0; idx < nlocks; idx++)
@@ -1264,19 +1816,35 @@ int odp_crypto_term_global(void)
 {
 	int rc = 0;
 	int ret;
-	int count = 0;
-	odp_crypto_generic_session_t *session;
+	uint32_t count;
+	int i;
+
+	count = 0;
+	if (global->max_sessions)
+		count = ring_count(global->free_ring);
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		count += global->cache[i].num;
 
-	for (session = global->free; session != NULL; session = session->next)
-		count++;
-	if (count != MAX_SESSIONS) {
+	if (count != global->max_sessions) {
 		ODP_ERR("crypto sessions still active\n");
 		rc = -1;
 	}
 
+	if (global->async.running)
+		crypto_async_stop();
+
 	CRYPTO_set_locking_callback(NULL);
 	CRYPTO_set_id_callback(NULL);
 
+	ret = 0;
+	if (global->session_shm != ODP_SHM_INVALID)
+		ret = odp_shm_free(global->session_shm);
+	if (ret < 0) {
+		ODP_ERR("shm free failed for crypto_sessions\n");
+		rc = -1;
+	}
+
 	ret = odp_shm_free(odp_shm_lookup("crypto_pool"));
 	if (ret < 0) {
 		ODP_ERR("shm free failed for crypto_pool\n");
@@ -1286,46 +1854,48 @@ int odp_crypto_term_global(void)
 	return rc;
 }
 
+/* OpenSSL contexts are created on first use, see crypto_init() */
 int _odp_crypto_init_local(void)
 {
-	unsigned i;
-	int id;
-
 	memset(&local, 0, sizeof(local));
 
-	for (i = 0; i < MAX_SESSIONS; i++) {
-		local.hmac_ctx[i] = HMAC_CTX_new();
-		local.cipher_ctx[i] = EVP_CIPHER_CTX_new();
-		local.mac_cipher_ctx[i] = EVP_CIPHER_CTX_new();
-
-		if (local.hmac_ctx[i] == NULL ||
-		    local.cipher_ctx[i] == NULL ||
-		    local.mac_cipher_ctx[i] == NULL) {
-			_odp_crypto_term_local();
-			return -1;
-		}
-	}
-
-	id = odp_thread_id();
-	local.ctx_valid = global->ctx_valid[id];
-	/* No need to clear flags here, alloc_session did the job for us */
+	local.cache = &global->cache[odp_thread_id()];
+	local.cache->num = 0;
 
 	return 0;
 }
 
 int _odp_crypto_term_local(void)
 {
+	crypto_session_cache_t *cache = local.cache;
+	crypto_ctx_t *ctx;
 	unsigned i;
 
-	for (i = 0; i < MAX_SESSIONS; i++) {
-		if (local.hmac_ctx[i] != NULL)
-			HMAC_CTX_free(local.hmac_ctx[i]);
-		if (local.cipher_ctx[i] != NULL)
-			EVP_CIPHER_CTX_free(local.cipher_ctx[i]);
-		if (local.mac_cipher_ctx[i] != NULL)
-			EVP_CIPHER_CTX_free(local.mac_cipher_ctx[i]);
+	for (i = 0; i < CONFIG_CRYPTO_CTX_CACHE_SIZE; i++) {
+		ctx = &local.ctx[i / CTX_CACHE_WAYS][i % CTX_CACHE_WAYS];
+
+		if (ctx->hmac_ctx != NULL)
+			HMAC_CTX_free(ctx->hmac_ctx);
+		if (ctx->cipher_ctx != NULL)
+			EVP_CIPHER_CTX_free(ctx->cipher_ctx);
+		if (ctx->mac_cipher_ctx != NULL)
+			EVP_CIPHER_CTX_free(ctx->mac_cipher_ctx);
+	}
+
+	if (cache != NULL) {
+		odp_spinlock_lock(&cache->lock);
+
+		if (cache->num) {
+			ring_enq_multi(global->free_ring, global->free_mask,
+				       cache->idx, cache->num);
+			cache->num = 0;
+		}
+
+		odp_spinlock_unlock(&cache->lock);
 	}
 
+	memset(&local, 0, sizeof(local));
+
 	return 0;
 }
 
@@ -1454,20 +2024,13 @@ int odp_crypto_result(odp_crypto_packet_result_t *result,
 	return 0;
 }
 
-static
-int odp_crypto_int(odp_packet_t pkt_in,
-		   odp_packet_t *pkt_out,
-		   const odp_crypto_packet_op_param_t *param)
+/* Resolve the output packet of an operation. The input packet is freed when
+ * it is copied to a different output packet. */
+static inline int crypto_pkt_out(odp_packet_t pkt_in, odp_packet_t *pkt_out,
+				 odp_crypto_generic_session_t *session)
 {
-	odp_crypto_alg_err_t rc_cipher = ODP_CRYPTO_ALG_ERR_NONE;
-	odp_crypto_alg_err_t rc_auth = ODP_CRYPTO_ALG_ERR_NONE;
-	odp_crypto_generic_session_t *session;
 	odp_bool_t allocated = false;
 	odp_packet_t out_pkt = *pkt_out;
-	odp_crypto_packet_result_t *op_result;
-	odp_packet_hdr_t *pkt_hdr;
-
-	session = (odp_crypto_generic_session_t *)(intptr_t)param->session;
 
 	/* Resolve output buffer */
 	if (ODP_PACKET_INVALID == out_pkt &&
@@ -1495,23 +2058,28 @@ int odp_crypto_int(odp_packet_t pkt_in,
 
 		_odp_packet_copy_md_to_packet(pkt_in, out_pkt);
 		odp_packet_free(pkt_in);
-		pkt_in = ODP_PACKET_INVALID;
 	}
 
-	crypto_init(session);
+	*pkt_out = out_pkt;
 
-	/* Invoke the functions */
-	if (session->do_cipher_first) {
-		rc_cipher = session->cipher.func(out_pkt, param, session);
-		rc_auth = session->auth.func(out_pkt, param, session);
-	} else {
-		rc_auth = session->auth.func(out_pkt, param, session);
-		rc_cipher = session->cipher.func(out_pkt, param, session);
-	}
+	return 0;
 
-	/* Fill in result */
-	packet_subtype_set(out_pkt, ODP_EVENT_PACKET_CRYPTO);
-	op_result = get_op_result_from_packet(out_pkt);
+err:
+	if (allocated)
+		odp_packet_free(out_pkt);
+
+	return -1;
+}
+
+static inline void crypto_pkt_result(odp_packet_t pkt,
+				     odp_crypto_alg_err_t rc_cipher,
+				     odp_crypto_alg_err_t rc_auth)
+{
+	odp_crypto_packet_result_t *op_result;
+	odp_packet_hdr_t *pkt_hdr;
+
+	packet_subtype_set(pkt, ODP_EVENT_PACKET_CRYPTO);
+	op_result = get_op_result_from_packet(pkt);
 	op_result->cipher_status.alg_err = rc_cipher;
 	op_result->cipher_status.hw_err = ODP_CRYPTO_HW_ERR_NONE;
 	op_result->auth_status.alg_err = rc_auth;
@@ -1520,21 +2088,131 @@ int odp_crypto_int(odp_packet_t pkt_in,
 		(rc_cipher == ODP_CRYPTO_ALG_ERR_NONE) &&
 		(rc_auth == ODP_CRYPTO_ALG_ERR_NONE);
 
-	pkt_hdr = packet_hdr(out_pkt);
+	pkt_hdr = packet_hdr(pkt);
 	pkt_hdr->p.error_flags.crypto_err = !op_result->ok;
+}
+
+static
+int odp_crypto_int(odp_packet_t pkt_in,
+		   odp_packet_t *pkt_out,
+		   const odp_crypto_packet_op_param_t *param)
+{
+	odp_crypto_alg_err_t rc_cipher = ODP_CRYPTO_ALG_ERR_NONE;
+	odp_crypto_alg_err_t rc_auth = ODP_CRYPTO_ALG_ERR_NONE;
+	odp_crypto_generic_session_t *session;
+	odp_packet_t out_pkt = *pkt_out;
+
+	session = (odp_crypto_generic_session_t *)(intptr_t)param->session;
+
+	if (odp_unlikely(crypto_init(session) ||
+			 crypto_pkt_out(pkt_in, &out_pkt, session)))
+		return -1;
+
+	/* Invoke the functions */
+	if (session->do_cipher_first) {
+		rc_cipher = session->cipher.func(out_pkt, param, session);
+		rc_auth = session->auth.func(out_pkt, param, session);
+	} else {
+		rc_auth = session->auth.func(out_pkt, param, session);
+		rc_cipher = session->cipher.func(out_pkt, param, session);
+	}
+
+	/* Fill in result */
+	crypto_pkt_result(out_pkt, rc_cipher, rc_auth);
 
 	/* Synchronous, simply return results */
 	*pkt_out = out_pkt;
 
 	return 0;
+}
 
-err:
-	if (allocated) {
-		odp_packet_free(out_pkt);
-		out_pkt = ODP_PACKET_INVALID;
+/*
+ * Process several operations. Consecutive operations of a session with a
+ * multi-buffer cipher handler are processed together. Returns the number of
+ * operations processed, which is less than num when an output packet cannot
+ * be resolved. Output packets are stored into pkt_out[].
+ */
+static int odp_crypto_int_multi(const odp_packet_t pkt_in[],
+				odp_packet_t pkt_out[],
+				const odp_crypto_packet_op_param_t *param[],
+				int num)
+{
+	odp_crypto_alg_err_t rc_cipher[MAX_MULTI];
+	odp_crypto_alg_err_t rc_auth[MAX_MULTI];
+	odp_crypto_generic_session_t *session;
+	int i, j, n;
+
+	if (num > MAX_MULTI)
+		num = MAX_MULTI;
+
+	for (i = 0; i < num; i++) {
+		session = (odp_crypto_generic_session_t *)
+			  (intptr_t)param[i]->session;
+
+		if (odp_unlikely(crypto_init(session) ||
+				 crypto_pkt_out(pkt_in[i], &pkt_out[i],
+						session)))
+			break;
 	}
 
-	return -1;
+	num = i;
+
+	for (i = 0; i < num; i += n) {
+		odp_crypto_session_t ses = param[i]->session;
+
+		for (n = 1; i + n < num && param[i + n]->session == ses; n++)
+			;
+
+		session = (odp_crypto_generic_session_t *)(intptr_t)ses;
+
+		/* Contexts were created above, another session may have
+		 * initialized them since */
+		crypto_init(session);
+
+		if (n > 1 && session->cipher.func_multi) {
+			if (session->do_cipher_first)
+				session->cipher.func_multi(&pkt_out[i],
+							   &param[i],
+							   &rc_cipher[i], n,
+							   session);
+
+			for (j = i; j < i + n; j++)
+				rc_auth[j] = session->auth.func(pkt_out[j],
+								param[j],
+								session);
+
+			if (!session->do_cipher_first)
+				session->cipher.func_multi(&pkt_out[i],
+							   &param[i],
+							   &rc_cipher[i], n,
+							   session);
+		} else {
+			for (j = i; j < i + n; j++) {
+				crypto_func_t cipher = session->cipher.func;
+				crypto_func_t auth = session->auth.func;
+
+				if (session->do_cipher_first) {
+					rc_cipher[j] = cipher(pkt_out[j],
+							      param[j],
+							      session);
+					rc_auth[j] = auth(pkt_out[j], param[j],
+							  session);
+				} else {
+					rc_auth[j] = auth(pkt_out[j], param[j],
+							  session);
+					rc_cipher[j] = cipher(pkt_out[j],
+							      param[j],
+							      session);
+				}
+			}
+		}
+
+		for (j = i; j < i + n; j++)
+			crypto_pkt_result(pkt_out[j], rc_cipher[j],
+					  rc_auth[j]);
+	}
+
+	return num;
 }
 
 int odp_crypto_op(const odp_packet_t pkt_in[],
@@ -1542,19 +2220,390 @@ int odp_crypto_op(const odp_packet_t pkt_in[],
 		  const odp_crypto_packet_op_param_t param[],
 		  int num_pkt)
 {
-	int i, rc;
+	const odp_crypto_packet_op_param_t *param_ptr[MAX_MULTI];
 	odp_crypto_generic_session_t *session;
+	int i, num, ret;
+	int done = 0;
 
 	session = (odp_crypto_generic_session_t *)(intptr_t)param->session;
 	ODP_ASSERT(ODP_CRYPTO_SYNC == session->p.op_mode);
 
-	for (i = 0; i < num_pkt; i++) {
-		rc = odp_crypto_int(pkt_in[i], &pkt_out[i], &param[i]);
-		if (rc < 0)
+	if (num_pkt == 1)
+		return odp_crypto_int(pkt_in[0], &pkt_out[0], &param[0]) ?
+		       0 : 1;
+
+	while (done < num_pkt) {
+		num = num_pkt - done;
+		if (num > MAX_MULTI)
+			num = MAX_MULTI;
+
+		for (i = 0; i < num; i++)
+			param_ptr[i] = &param[done + i];
+
+		ret = odp_crypto_int_multi(&pkt_in[done], &pkt_out[done],
+					   param_ptr, num);
+		done += ret;
+
+		if (ret < num)
 			break;
 	}
 
-	return i;
+	return done;
+}
+
+/* Complete an operation whose output packet could not be allocated or
+ * copied. The input packet is returned with an error status. The output
+ * packet of the caller is freed, as it was handed over with the operation. */
+static odp_packet_t crypto_async_error(crypto_async_op_t *op)
+{
+	odp_packet_t pkt = op->pkt_in;
+	odp_crypto_packet_result_t *op_result;
+
+	if (op->pkt_out != ODP_PACKET_INVALID && op->pkt_out != pkt)
+		odp_packet_free(op->pkt_out);
+
+	packet_subtype_set(pkt, ODP_EVENT_PACKET_CRYPTO);
+	op_result = get_op_result_from_packet(pkt);
+	op_result->cipher_status.alg_err = ODP_CRYPTO_ALG_ERR_NONE;
+	op_result->cipher_status.hw_err = ODP_CRYPTO_HW_ERR_BP_DEPLETED;
+	op_result->auth_status.alg_err = ODP_CRYPTO_ALG_ERR_NONE;
+	op_result->auth_status.hw_err = ODP_CRYPTO_HW_ERR_BP_DEPLETED;
+	op_result->ok = 0;
+	packet_hdr(pkt)->p.error_flags.crypto_err = 1;
+
+	return pkt;
+}
+
+static void crypto_async_process(crypto_worker_t *worker, uint32_t idx[],
+				 uint32_t num)
+{
+	odp_crypto_generic_session_t *session[CONFIG_CRYPTO_ASYNC_BURST_MAX];
+	const odp_crypto_packet_op_param_t *param[MAX_MULTI];
+	odp_packet_t pkt_in[CONFIG_CRYPTO_ASYNC_BURST_MAX];
+	odp_packet_t pkt[CONFIG_CRYPTO_ASYNC_BURST_MAX];
+	odp_event_t ev[CONFIG_CRYPTO_ASYNC_BURST_MAX];
+	crypto_async_op_t *op;
+	odp_queue_t queue;
+	uint64_t now, enq, lat;
+	uint32_t i, j, n;
+	int ret;
+
+	ODP_STATIC_ASSERT(CONFIG_CRYPTO_ASYNC_BURST_MAX <= MAX_MULTI,
+			  "Crypto burst does not fit into a multi-buffer call");
+
+	for (i = 0; i < num; i++) {
+		op = &global->async.op[idx[i]];
+		pkt_in[i] = op->pkt_in;
+		pkt[i] = op->pkt_out;
+		param[i] = &op->param;
+		session[i] = (odp_crypto_generic_session_t *)
+			     (intptr_t)op->param.session;
+	}
+
+	for (i = 0; i < num; i += ret) {
+		ret = odp_crypto_int_multi(&pkt_in[i], &pkt[i], &param[i],
+					   num - i);
+
+		/* Output packet of the next operation was not resolved */
+		if (odp_unlikely(ret < (int)(num - i))) {
+			op = &global->async.op[idx[i + ret]];
+			pkt[i + ret] = crypto_async_error(op);
+			ret++;
+		}
+	}
+
+	for (i = 0; i < num; i++)
+		ev[i] = odp_packet_to_event(pkt[i]);
+
+	now = odp_time_to_ns(odp_time_global());
+
+	for (i = 0; i < num; i++) {
+		enq = odp_time_to_ns(global->async.op[idx[i]].enq_time);
+		lat = now > enq ? now - enq : 0;
+
+		worker->latency_ns += lat;
+		if (lat > worker->latency_max_ns)
+			worker->latency_max_ns = lat;
+	}
+
+	ring_enq_multi(&global->async.free.hdr, CONFIG_CRYPTO_ASYNC_OPS - 1,
+		       idx, num);
+
+	/* Operations of a session complete in order. The session may be
+	 * destroyed as soon as its inflight count drops, so it is accessed
+	 * only before that. */
+	for (i = 0; i < num; i += n) {
+		queue = session[i]->p.compl_queue;
+
+		for (n = 1; i + n < num && session[i + n] == session[i]; n++)
+			;
+
+		/* Queues may accept less than a batch in one call */
+		for (j = 0; j < n; j += ret) {
+			ret = odp_queue_enq_multi(queue, &ev[i + j], n - j);
+			if (odp_unlikely(ret <= 0))
+				break;
+		}
+
+		if (odp_unlikely(j < n)) {
+			ODP_ERR("Completion enqueue failed, %" PRIu32
+				" events freed\n", n - j);
+			worker->compl_drop += n - j;
+		}
+
+		for (; j < n; j++)
+			odp_event_free(ev[i + j]);
+
+		odp_atomic_sub_rel_u32(&session[i]->inflight, n);
+	}
+
+	worker->ops += num;
+	worker->batches++;
+	if (num > worker->batch_max)
+		worker->batch_max = num;
+}
+
+static void *crypto_worker_thread(void *arg)
+{
+	crypto_worker_t *worker = arg;
+	ring_t *ring = &worker->ring.hdr;
+	uint32_t idx[CONFIG_CRYPTO_ASYNC_BURST_MAX];
+	uint32_t burst = global->async.burst;
+	sched_idle_wait_t wait;
+	uint32_t num, depth;
+
+	if (odp_init_local((odp_instance_t)odp_global_data.main_pid,
+			   ODP_THREAD_CONTROL)) {
+		ODP_ERR("Crypto worker thread init failed\n");
+		return NULL;
+	}
+
+	sched_idle_wait_init(&wait);
+
+	while (1) {
+		sched_idle_prepare(&worker->idle, &wait);
+
+		/* This thread is the only reader of the ring */
+		depth = odp_atomic_load_acq_u32(&ring->w_tail) -
+			odp_atomic_load_u32(&ring->r_head);
+		if (depth > worker->depth_max)
+			worker->depth_max = depth;
+
+		num = ring_deq_multi(ring, CONFIG_CRYPTO_ASYNC_OPS - 1, idx,
+				     burst);
+		if (num) {
+			sched_idle_done(&worker->idle, &wait, 1);
+			sched_idle_wait_init(&wait);
+			crypto_async_process(worker, idx, num);
+			continue;
+		}
+
+		if (odp_atomic_load_acq_u32(&worker->stop))
+			break;
+
+		sched_idle_wait(&worker->idle, &wait,
+				CONFIG_SCHED_IDLE_SLEEP_NS, 0);
+	}
+
+	sched_idle_done(&worker->idle, &wait, 0);
+
+	if (odp_term_local() < 0)
+		ODP_ERR("Crypto worker thread term failed\n");
+
+	return NULL;
+}
+
+static void crypto_async_stop(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < global->async.running; i++) {
+		crypto_worker_t *worker = &global->async.worker[i];
+
+		odp_atomic_store_rel_u32(&worker->stop, 1);
+		sched_idle_wake(&worker->idle);
+	}
+
+	for (i = 0; i < global->async.running; i++) {
+		crypto_worker_t *worker = &global->async.worker[i];
+
+		pthread_join(worker->thread, NULL);
+		pthread_attr_destroy(&worker->attr);
+	}
+
+	global->async.running = 0;
+}
+
+static int crypto_async_start(void)
+{
+	odp_cpumask_t *cpumask = &global->async.cpumask;
+	cpu_set_t cpu_set;
+	uint32_t i;
+	int cpu;
+
+	cpu = odp_cpumask_first(cpumask);
+
+	for (i = 0; i < global->async.num_threads; i++) {
+		crypto_worker_t *worker = &global->async.worker[i];
+
+		odp_atomic_store_u32(&worker->stop, 0);
+		worker->cpu = cpu;
+
+		pthread_attr_init(&worker->attr);
+		CPU_ZERO(&cpu_set);
+		CPU_SET(cpu, &cpu_set);
+		pthread_attr_setaffinity_np(&worker->attr, sizeof(cpu_set_t),
+					    &cpu_set);
+
+		if (pthread_create(&worker->thread, &worker->attr,
+				   crypto_worker_thread, worker)) {
+			ODP_ERR("Failed to start crypto thread on cpu %i\n",
+				cpu);
+			pthread_attr_destroy(&worker->attr);
+			crypto_async_stop();
+			return -1;
+		}
+
+		global->async.running++;
+
+		cpu = odp_cpumask_next(cpumask, cpu);
+		if (cpu < 0)
+			cpu = odp_cpumask_first(cpumask);
+	}
+
+	return 0;
+}
+
+/* Assign an ASYNC session to the least loaded worker thread. Threads are
+ * started with the first ASYNC session. */
+static int crypto_async_attach(odp_crypto_generic_session_t *session)
+{
+	crypto_worker_t *worker;
+	uint32_t i, min = 0;
+
+	if (global->async.num_threads == 0)
+		return 0;
+
+	odp_ticketlock_lock(&global->async.lock);
+
+	if (global->async.running == 0 && crypto_async_start()) {
+		odp_ticketlock_unlock(&global->async.lock);
+		return -1;
+	}
+
+	for (i = 1; i < global->async.num_threads; i++) {
+		if (global->async.worker[i].num_sessions <
+		    global->async.worker[min].num_sessions)
+			min = i;
+	}
+
+	worker = &global->async.worker[min];
+	worker->num_sessions++;
+	session->worker = min;
+	global->async.num_sessions++;
+
+	odp_ticketlock_unlock(&global->async.lock);
+
+	return 0;
+}
+
+/* Wait for operations of the session to complete. Threads are stopped with
+ * the last ASYNC session. */
+static void crypto_async_detach(odp_crypto_generic_session_t *session)
+{
+	if (global->async.num_threads == 0)
+		return;
+
+	while (odp_atomic_load_acq_u32(&session->inflight))
+		sched_yield();
+
+	odp_ticketlock_lock(&global->async.lock);
+
+	global->async.worker[session->worker].num_sessions--;
+	global->async.num_sessions--;
+
+	if (global->async.num_sessions == 0)
+		crypto_async_stop();
+
+	odp_ticketlock_unlock(&global->async.lock);
+}
+
+/* Hand operations over to the worker threads of their sessions. Returns the
+ * number of operations accepted, which is less than num_pkt when all
+ * operation slots are in use. */
+static int crypto_async_enq(const odp_packet_t pkt_in[],
+			    const odp_packet_t pkt_out[],
+			    const odp_crypto_packet_op_param_t param[],
+			    int num_pkt)
+{
+	uint32_t mask = CONFIG_CRYPTO_ASYNC_OPS - 1;
+	uint32_t idx[CONFIG_CRYPTO_ASYNC_BURST_MAX];
+	const odp_crypto_packet_op_param_t *p;
+	odp_crypto_generic_session_t *session;
+	crypto_worker_t *worker;
+	crypto_async_op_t *op;
+	odp_time_t now;
+	int done = 0;
+	int i, n, num;
+
+	while (done < num_pkt) {
+		num = num_pkt - done;
+		if (num > CONFIG_CRYPTO_ASYNC_BURST_MAX)
+			num = CONFIG_CRYPTO_ASYNC_BURST_MAX;
+
+		num = ring_deq_multi(&global->async.free.hdr, mask, idx, num);
+		if (num == 0)
+			break;
+
+		now = odp_time_global();
+
+		for (i = 0; i < num; i++) {
+			p = &param[done + i];
+			session = (odp_crypto_generic_session_t *)
+				  (intptr_t)p->session;
+			op = &global->async.op[idx[i]];
+			op->pkt_in = pkt_in[done + i];
+			op->pkt_out = pkt_out[done + i];
+			op->param = *p;
+			op->enq_time = now;
+
+			if (p->override_iv_ptr) {
+				memcpy(op->iv, p->override_iv_ptr,
+				       session->p.iv.length);
+				op->param.override_iv_ptr = op->iv;
+			}
+
+			if (p->aad_ptr && session->p.auth_aad_len) {
+				memcpy(op->aad, p->aad_ptr,
+				       session->p.auth_aad_len);
+				op->param.aad_ptr = op->aad;
+			}
+		}
+
+		/* Submit runs of operations of the same session */
+		for (i = 0; i < num; i += n) {
+			odp_crypto_session_t ses = param[done + i].session;
+
+			for (n = 1; i + n < num &&
+			     param[done + i + n].session == ses; n++)
+				;
+
+			session = (odp_crypto_generic_session_t *)
+				  (intptr_t)ses;
+			worker = &global->async.worker[session->worker];
+
+			odp_atomic_add_u32(&session->inflight, n);
+			ring_enq_multi(&worker->ring.hdr, mask, &idx[i], n);
+			sched_idle_wake(&worker->idle);
+		}
+
+		done += num;
+	}
+
+	if (odp_unlikely(done < num_pkt))
+		odp_atomic_add_u64(&global->async.queue_full, num_pkt - done);
+
+	return done;
 }
 
 int odp_crypto_op_enq(const odp_packet_t pkt_in[],
@@ -1571,6 +2620,9 @@ int odp_crypto_op_enq(const odp_packet_t pkt_in[],
 	ODP_ASSERT(ODP_CRYPTO_ASYNC == session->p.op_mode);
 	ODP_ASSERT(ODP_QUEUE_INVALID != session->p.compl_queue);
 
+	if (global->async.num_threads)
+		return crypto_async_enq(pkt_in, pkt_out, param, num_pkt);
+
 	for (i = 0; i < num_pkt; i++) {
 		pkt = pkt_out[i];
 		rc = odp_crypto_int(pkt_in[i], &pkt, &param[i]);
@@ -1586,3 +2638,85 @@ int odp_crypto_op_enq(const odp_packet_t pkt_in[],
 
 	return i;
 }
+
+int odp_crypto_stats(odp_crypto_stats_t *stats)
+{
+	uint64_t latency_ns = 0;
+	uint32_t i;
+
+	memset(stats, 0, sizeof(odp_crypto_stats_t));
+
+	stats->num_threads = global->async.num_threads;
+	stats->queue_full = odp_atomic_load_u64(&global->async.queue_full);
+
+	for (i = 0; i < global->async.num_threads; i++) {
+		crypto_worker_t *worker = &global->async.worker[i];
+		ring_t *ring = &worker->ring.hdr;
+
+		stats->queue_depth += odp_atomic_load_u32(&ring->w_tail) -
+				      odp_atomic_load_u32(&ring->r_head);
+		stats->ops += worker->ops;
+		stats->batches += worker->batches;
+		stats->compl_drop += worker->compl_drop;
+		latency_ns += worker->latency_ns;
+
+		if (worker->depth_max > stats->queue_depth_max)
+			stats->queue_depth_max = worker->depth_max;
+		if (worker->batch_max > stats->batch_max)
+			stats->batch_max = worker->batch_max;
+		if (worker->latency_max_ns > stats->latency_max_ns)
+			stats->latency_max_ns = worker->latency_max_ns;
+	}
+
+	if (stats->ops)
+		stats->latency_avg_ns = latency_ns / stats->ops;
+
+	return 0;
+}
+
+void odp_crypto_print(void)
+{
+	odp_crypto_stats_t stats;
+	char str[ODP_CPUMASK_STR_SIZE];
+	uint32_t i;
+
+	odp_crypto_stats(&stats);
+	odp_cpumask_to_str(&global->async.cpumask, str, sizeof(str));
+
+	ODP_PRINT("\nCrypto info\n-----------\n");
+	ODP_PRINT("  Max sessions     %" PRIu32 "\n", global->max_sessions);
+	ODP_PRINT("  Async threads    %" PRIu32 "\n", stats.num_threads);
+
+	if (stats.num_threads == 0) {
+		ODP_PRINT("\n");
+		return;
+	}
+
+	ODP_PRINT("  Async cpumask    %s\n", str);
+	ODP_PRINT("  Async burst      %" PRIu32 "\n", global->async.burst);
+	ODP_PRINT("  Running          %" PRIu32 "\n", global->async.running);
+	ODP_PRINT("  Sessions         %" PRIu32 "\n",
+		  global->async.num_sessions);
+	ODP_PRINT("  Operations       %" PRIu64 "\n", stats.ops);
+	ODP_PRINT("  Batches          %" PRIu64 " (%.1f avg, %" PRIu32
+		  " max)\n", stats.batches,
+		  stats.batches ? (double)stats.ops / stats.batches : 0.0,
+		  stats.batch_max);
+	ODP_PRINT("  Queue depth      %" PRIu32 " (%" PRIu32 " max)\n",
+		  stats.queue_depth, stats.queue_depth_max);
+	ODP_PRINT("  Queue full       %" PRIu64 "\n", stats.queue_full);
+	ODP_PRINT("  Compl dropped    %" PRIu64 "\n", stats.compl_drop);
+	ODP_PRINT("  Latency          %" PRIu64 " nsec avg, %" PRIu64
+		  " nsec max\n", stats.latency_avg_ns, stats.latency_max_ns);
+
+	for (i = 0; i < stats.num_threads; i++) {
+		crypto_worker_t *worker = &global->async.worker[i];
+
+		ODP_PRINT("  Thread %" PRIu32 ": cpu %i, sessions %" PRIu32
+			  ", ops %" PRIu64 "\n", i, worker->cpu,
+			  worker->num_sessions, worker->ops);
+		sched_idle_print(&worker->idle);
+	}
+
+	ODP_PRINT("\n");
+}
@@ -41,6 +41,9 @@
 
 #include <odp/api/hash.h>
 #include <odp/api/std_types.h>
+#include <odp_arch_hash_internal.h>
+#include <odp_debug_internal.h>
+#include <odp_internal.h>
 
 #include <stddef.h>
 
@@ -446,8 +449,11 @@ static inline uint32_t crc32c_u64(uint64_t data, uint32_t init_val)
 	return crc;
 }
 
-uint32_t odp_hash_crc32c(const void *data, uint32_t data_len,
-			 uint32_t init_val)
+uint32_t _odp_crc32c_shift_long[4][256];
+uint32_t _odp_crc32c_shift_short[4][256];
+
+static uint32_t crc32c_table(const void *data, uint32_t data_len,
+			     uint32_t init_val)
 {
 	size_t i;
 	uint64_t temp = 0;
@@ -489,3 +495,68 @@ uint32_t odp_hash_crc32c(const void *data, uint32_t data_len,
 
 	return init_val;
 }
+
+/* Table version is used until hardware support has been checked */
+static crc32c_fn_t crc32c_fn = crc32c_table;
+
+uint32_t odp_hash_crc32c(const void *data, uint32_t data_len,
+			 uint32_t init_val)
+{
+	return crc32c_fn(data, data_len, init_val);
+}
+
+/* Shift CRC state over 'len' zero bytes (a multiple of 8) */
+static uint32_t crc32c_zeros(uint32_t crc, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len / 8; i++)
+		crc = crc32c_u64(0, crc);
+
+	return crc;
+}
+
+/* CRC is linear, so shift of any state is XOR of the shifts of its bits */
+static void crc32c_shift_table_init(uint32_t table[4][256], uint32_t len)
+{
+	uint32_t bit_shift[32];
+	uint32_t n, crc;
+	int i, j;
+
+	for (i = 0; i < 32; i++)
+		bit_shift[i] = crc32c_zeros(1u << i, len);
+
+	for (i = 0; i < 4; i++) {
+		for (n = 0; n < 256; n++) {
+			crc = 0;
+			for (j = 0; j < 8; j++) {
+				if (n & (1u << j))
+					crc ^= bit_shift[8 * i + j];
+			}
+			table[i][n] = crc;
+		}
+	}
+}
+
+int _odp_hash_init_global(void)
+{
+	crc32c_fn_t fn = cpu_crc32c_fn();
+
+	crc32c_shift_table_init(_odp_crc32c_shift_long, CRC32C_LONG);
+	crc32c_shift_table_init(_odp_crc32c_shift_short, CRC32C_SHORT);
+
+	if (fn != NULL) {
+		ODP_DBG("CRC32C: using CRC instructions\n");
+		crc32c_fn = fn;
+	}
+
+	return 0;
+}
+
+int _odp_hash_term_global(void)
+{
+	crc32c_fn = crc32c_table;
+
+	return 0;
+}
+
@@ -66,6 +66,18 @@ int odp_init_global(odp_instance_t *instance,
 	}
 	stage = SYSINFO_INIT;
 
+	if (_odp_hash_init_global()) {
+		ODP_ERR("ODP hash init failed.\n");
+		goto init_failed;
+	}
+	stage = HASH_INIT;
+
+	if (_odp_chksum_init_global()) {
+		ODP_ERR("ODP checksum init failed.\n");
+		goto init_failed;
+	}
+	stage = CHKSUM_INIT;
+
 	if (_odp_ishm_init_global(params)) {
 		ODP_ERR("ODP ishm init failed.\n");
 		goto init_failed;
@@ -78,7 +90,7 @@ int odp_init_global(odp_instance_t *instance,
 	}
 	stage = FDSERVER_INIT;
 
-	if (odp_thread_init_global()) {
+	if (odp_thread_init_global(params)) {
 		ODP_ERR("ODP thread init failed.\n");
 		goto init_failed;
 	}
@@ -114,7 +126,7 @@ int odp_init_global(odp_instance_t *instance,
 	}
 	stage = TIMER_INIT;
 
-	if (odp_crypto_init_global()) {
+	if (odp_crypto_init_global(params)) {
 		ODP_ERR("ODP crypto init failed.\n");
 		goto init_failed;
 	}
@@ -272,6 +284,20 @@ int _odp_term_global(enum init_stage stage)
 		}
 		/* Fall through */
 
+	case CHKSUM_INIT:
+		if (_odp_chksum_term_global()) {
+			ODP_ERR("ODP checksum term failed.\n");
+			rc = -1;
+		}
+		/* Fall through */
+
+	case HASH_INIT:
+		if (_odp_hash_term_global()) {
+			ODP_ERR("ODP hash term failed.\n");
+			rc = -1;
+		}
+		/* Fall through */
+
 	case SYSINFO_INIT:
 		if (odp_system_info_term()) {
 			ODP_ERR("ODP system info term failed.\n");
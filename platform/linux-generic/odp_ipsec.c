@@ -651,6 +651,9 @@ static ipsec_sa_t *ipsec_in_single(odp_packet_t pkt,
 	odp_packet_parse_param_t parse_param;
 	odp_packet_hdr_t *pkt_hdr;
 
+	/* Packet is modified in place, complete any lazy parse first */
+	packet_parse_finish(packet_hdr(pkt));
+
 	state.ip_offset = odp_packet_l3_offset(pkt);
 	ODP_ASSERT(ODP_PACKET_OFFSET_INVALID != state.ip_offset);
 
@@ -1295,6 +1298,9 @@ static ipsec_sa_t *ipsec_out_single(odp_packet_t pkt,
 	odp_packet_hdr_t *pkt_hdr;
 	uint32_t mtu;
 
+	/* Packet is modified in place, complete any lazy parse first */
+	packet_parse_finish(packet_hdr(pkt));
+
 	state.ip_offset = odp_packet_l3_offset(pkt);
 	ODP_ASSERT(ODP_PACKET_OFFSET_INVALID != state.ip_offset);
 
@@ -7,10 +7,14 @@
 #include "config.h"
 
 #include <odp/api/atomic.h>
+#include <odp/api/hash.h>
 #include <odp/api/ipsec.h>
 #include <odp/api/random.h>
 #include <odp/api/shared_memory.h>
+#include <odp/api/spinlock.h>
+#include <odp/api/sync.h>
 
+#include <odp_align_internal.h>
 #include <odp_debug_internal.h>
 #include <odp_ipsec_internal.h>
 
@@ -20,8 +24,33 @@
 #define IPSEC_SA_STATE_FREE	0xc0000000
 #define IPSEC_SA_STATE_RESERVED	0x80000000
 
+/* Number of buckets in each lookup hash table */
+#define IPSEC_SA_HASH_SIZE	ROUNDUP_POWER2_U32(2 * ODP_CONFIG_IPSEC_SAS)
+#define IPSEC_SA_HASH_MASK	(IPSEC_SA_HASH_SIZE - 1)
+#define IPSEC_SA_HASH_NULL	0xffffffff
+
+/* Inbound SA lookup index
+ *
+ * SAs with ODP_IPSEC_LOOKUP_DSTADDR_SPI are hashed on (SPI, protocol,
+ * destination address, IP version) and SAs with ODP_IPSEC_LOOKUP_SPI on
+ * (SPI, protocol). Bucket chains are linked through SA indexes. Writers
+ * serialize on a spinlock and readers walk the chains without locks.
+ * A reader retries a failed lookup when the index has been modified during
+ * the walk, since an SA may have been moved to another chain meanwhile. */
+typedef struct {
+	odp_spinlock_t lock;
+
+	/* Incremented after every modification */
+	odp_atomic_u32_t seq;
+
+	odp_atomic_u32_t dst[IPSEC_SA_HASH_SIZE];
+	odp_atomic_u32_t spi[IPSEC_SA_HASH_SIZE];
+
+} ipsec_sa_hash_t;
+
 typedef struct ipsec_sa_table_t {
 	ipsec_sa_t ipsec_sa[ODP_CONFIG_IPSEC_SAS];
+	ipsec_sa_hash_t hash;
 	odp_shm_t shm;
 } ipsec_sa_table_t;
 
@@ -64,10 +93,21 @@ int _odp_ipsec_sad_init_global(void)
 		ipsec_sa->ipsec_sa_hdl = ipsec_sa_index_to_handle(i);
 		ipsec_sa->ipsec_sa_idx = i;
 		odp_atomic_init_u32(&ipsec_sa->state, IPSEC_SA_STATE_FREE);
+		odp_atomic_init_u32(&ipsec_sa->hash_next, IPSEC_SA_HASH_NULL);
 		odp_atomic_init_u64(&ipsec_sa->bytes, 0);
 		odp_atomic_init_u64(&ipsec_sa->packets, 0);
 	}
 
+	odp_spinlock_init(&ipsec_sa_tbl->hash.lock);
+	odp_atomic_init_u32(&ipsec_sa_tbl->hash.seq, 0);
+
+	for (i = 0; i < IPSEC_SA_HASH_SIZE; i++) {
+		odp_atomic_init_u32(&ipsec_sa_tbl->hash.dst[i],
+				    IPSEC_SA_HASH_NULL);
+		odp_atomic_init_u32(&ipsec_sa_tbl->hash.spi[i],
+				    IPSEC_SA_HASH_NULL);
+	}
+
 	return 0;
 }
 
@@ -163,6 +203,111 @@ static odp_bool_t ipsec_sa_unlock(ipsec_sa_t *ipsec_sa)
 	return state == IPSEC_SA_STATE_DISABLE;
 }
 
+static inline uint32_t ipsec_sa_addr_len(odp_ipsec_ip_version_t ver)
+{
+	return ver == ODP_IPSEC_IPV4 ? _ODP_IPV4ADDR_LEN : _ODP_IPV6ADDR_LEN;
+}
+
+static inline uint32_t ipsec_sa_hash_spi(odp_ipsec_protocol_t proto,
+					 uint32_t spi)
+{
+	uint32_t key[2] = { spi, proto };
+
+	return odp_hash_crc32c(key, sizeof(key), 0) & IPSEC_SA_HASH_MASK;
+}
+
+static inline uint32_t ipsec_sa_hash_dst(odp_ipsec_protocol_t proto,
+					 uint32_t spi,
+					 odp_ipsec_ip_version_t ver,
+					 const void *dst_addr)
+{
+	uint32_t key[2] = { spi, (ver << 8) | proto };
+	uint32_t hash;
+
+	hash = odp_hash_crc32c(key, sizeof(key), 0);
+	hash = odp_hash_crc32c(dst_addr, ipsec_sa_addr_len(ver), hash);
+
+	return hash & IPSEC_SA_HASH_MASK;
+}
+
+static odp_atomic_u32_t *ipsec_sa_hash_bucket(ipsec_sa_t *ipsec_sa)
+{
+	ipsec_sa_hash_t *hash = &ipsec_sa_tbl->hash;
+	uint32_t i;
+
+	if (ODP_IPSEC_LOOKUP_DSTADDR_SPI == ipsec_sa->lookup_mode) {
+		i = ipsec_sa_hash_dst(ipsec_sa->proto, ipsec_sa->spi,
+				      ipsec_sa->in.lookup_ver,
+				      &ipsec_sa->in.lookup_dst_ipv4);
+		return &hash->dst[i];
+	}
+
+	i = ipsec_sa_hash_spi(ipsec_sa->proto, ipsec_sa->spi);
+
+	return &hash->spi[i];
+}
+
+/* Add an inbound SA to the lookup index */
+static void ipsec_sa_hash_insert(ipsec_sa_t *ipsec_sa)
+{
+	ipsec_sa_hash_t *hash = &ipsec_sa_tbl->hash;
+	odp_atomic_u32_t *bucket;
+
+	if (ODP_IPSEC_LOOKUP_DSTADDR_SPI != ipsec_sa->lookup_mode &&
+	    ODP_IPSEC_LOOKUP_SPI != ipsec_sa->lookup_mode)
+		return;
+
+	bucket = ipsec_sa_hash_bucket(ipsec_sa);
+
+	odp_spinlock_lock(&hash->lock);
+
+	odp_atomic_store_u32(&ipsec_sa->hash_next,
+			     odp_atomic_load_u32(bucket));
+	/* Make SA fields visible before the SA itself */
+	odp_atomic_store_rel_u32(bucket, ipsec_sa->ipsec_sa_idx);
+	ipsec_sa->hashed = 1;
+	odp_atomic_add_rel_u32(&hash->seq, 1);
+
+	odp_spinlock_unlock(&hash->lock);
+}
+
+/* Remove an SA from the lookup index. The removed SA keeps its next link, so
+ * that concurrent readers can continue the walk. */
+static void ipsec_sa_hash_remove(ipsec_sa_t *ipsec_sa)
+{
+	ipsec_sa_hash_t *hash = &ipsec_sa_tbl->hash;
+	odp_atomic_u32_t *link;
+	uint32_t idx;
+
+	odp_spinlock_lock(&hash->lock);
+
+	if (!ipsec_sa->hashed) {
+		odp_spinlock_unlock(&hash->lock);
+		return;
+	}
+
+	link = ipsec_sa_hash_bucket(ipsec_sa);
+	idx  = odp_atomic_load_u32(link);
+
+	while (idx != IPSEC_SA_HASH_NULL) {
+		ipsec_sa_t *cur = ipsec_sa_entry(idx);
+
+		if (cur == ipsec_sa) {
+			odp_atomic_store_rel_u32(link, odp_atomic_load_u32(
+						 &ipsec_sa->hash_next));
+			break;
+		}
+
+		link = &cur->hash_next;
+		idx  = odp_atomic_load_u32(link);
+	}
+
+	ipsec_sa->hashed = 0;
+	odp_atomic_add_rel_u32(&hash->seq, 1);
+
+	odp_spinlock_unlock(&hash->lock);
+}
+
 ipsec_sa_t *_odp_ipsec_sa_use(odp_ipsec_sa_t sa)
 {
 	ipsec_sa_t *ipsec_sa;
@@ -449,6 +594,7 @@ odp_ipsec_sa_t odp_ipsec_sa_create(const odp_ipsec_sa_param_t *param)
 				      &ses_create_rc))
 		goto error;
 
+	ipsec_sa_hash_insert(ipsec_sa);
 	ipsec_sa_publish(ipsec_sa);
 
 	return ipsec_sa->ipsec_sa_hdl;
@@ -478,6 +624,9 @@ int odp_ipsec_sa_disable(odp_ipsec_sa_t sa)
 					     state | IPSEC_SA_STATE_DISABLE);
 	}
 
+	/* Disabled SA is not used for new lookups */
+	ipsec_sa_hash_remove(ipsec_sa);
+
 	if (ODP_QUEUE_INVALID != ipsec_sa->queue) {
 		odp_ipsec_warn_t warn = { .all = 0 };
 
@@ -520,6 +669,7 @@ int odp_ipsec_sa_destroy(odp_ipsec_sa_t sa)
 		rc = -1;
 	}
 
+	ipsec_sa_hash_remove(ipsec_sa);
 	ipsec_sa_release(ipsec_sa);
 
 	return rc;
@@ -551,39 +701,76 @@ int odp_ipsec_sa_mtu_update(odp_ipsec_sa_t sa, uint32_t mtu)
 	return 0;
 }
 
-ipsec_sa_t *_odp_ipsec_sa_lookup(const ipsec_sa_lookup_t *lookup)
+/* Walk a hash chain. Returns a matching SA with a reference taken. */
+static ipsec_sa_t *ipsec_sa_hash_find(odp_atomic_u32_t *bucket,
+				      const ipsec_sa_lookup_t *lookup,
+				      odp_ipsec_lookup_mode_t mode)
 {
+	uint32_t idx = odp_atomic_load_acq_u32(bucket);
 	int i;
-	ipsec_sa_t *best = NULL;
 
+	/* Chain length is bounded also when SAs are moved between chains
+	 * during the walk */
 	for (i = 0; i < ODP_CONFIG_IPSEC_SAS; i++) {
-		ipsec_sa_t *ipsec_sa = ipsec_sa_entry(i);
+		ipsec_sa_t *ipsec_sa;
+
+		if (idx == IPSEC_SA_HASH_NULL)
+			break;
+
+		ipsec_sa = ipsec_sa_entry(idx);
+		idx = odp_atomic_load_acq_u32(&ipsec_sa->hash_next);
+
+		/* Prefilter without a reference, check again with it */
+		if (lookup->spi != ipsec_sa->spi)
+			continue;
 
 		if (ipsec_sa_lock(ipsec_sa) < 0)
 			continue;
 
-		if (ODP_IPSEC_LOOKUP_DSTADDR_SPI == ipsec_sa->lookup_mode &&
+		if (mode == ipsec_sa->lookup_mode &&
 		    lookup->proto == ipsec_sa->proto &&
 		    lookup->spi == ipsec_sa->spi &&
-		    lookup->ver == ipsec_sa->in.lookup_ver &&
-		    !memcmp(lookup->dst_addr, &ipsec_sa->in.lookup_dst_ipv4,
-			    lookup->ver == ODP_IPSEC_IPV4 ?
-				    _ODP_IPV4ADDR_LEN :
-				    _ODP_IPV6ADDR_LEN)) {
-			if (NULL != best)
-				_odp_ipsec_sa_unuse(best);
+		    (ODP_IPSEC_LOOKUP_SPI == mode ||
+		     (lookup->ver == ipsec_sa->in.lookup_ver &&
+		      !memcmp(lookup->dst_addr, &ipsec_sa->in.lookup_dst_ipv4,
+			      ipsec_sa_addr_len(lookup->ver)))))
 			return ipsec_sa;
-		} else if (NULL == best &&
-			   ODP_IPSEC_LOOKUP_SPI == ipsec_sa->lookup_mode &&
-			   lookup->proto == ipsec_sa->proto &&
-			   lookup->spi == ipsec_sa->spi) {
-			best = ipsec_sa;
-		} else {
-			_odp_ipsec_sa_unuse(ipsec_sa);
-		}
+
+		_odp_ipsec_sa_unuse(ipsec_sa);
 	}
 
-	return best;
+	return NULL;
+}
+
+ipsec_sa_t *_odp_ipsec_sa_lookup(const ipsec_sa_lookup_t *lookup)
+{
+	ipsec_sa_hash_t *hash = &ipsec_sa_tbl->hash;
+	odp_atomic_u32_t *dst, *spi;
+	ipsec_sa_t *ipsec_sa;
+	uint32_t seq;
+
+	dst = &hash->dst[ipsec_sa_hash_dst(lookup->proto, lookup->spi,
+					   lookup->ver, lookup->dst_addr)];
+	spi = &hash->spi[ipsec_sa_hash_spi(lookup->proto, lookup->spi)];
+
+	do {
+		seq = odp_atomic_load_acq_u32(&hash->seq);
+
+		/* Exact match has precedence over SPI only match */
+		ipsec_sa = ipsec_sa_hash_find(dst, lookup,
+					      ODP_IPSEC_LOOKUP_DSTADDR_SPI);
+		if (ipsec_sa)
+			return ipsec_sa;
+
+		ipsec_sa = ipsec_sa_hash_find(spi, lookup,
+					      ODP_IPSEC_LOOKUP_SPI);
+		if (ipsec_sa)
+			return ipsec_sa;
+
+		odp_mb_acquire();
+	} while (seq != odp_atomic_load_u32(&hash->seq));
+
+	return NULL;
 }
 
 int _odp_ipsec_sa_stats_precheck(ipsec_sa_t *ipsec_sa,
@@ -10,6 +10,8 @@
 #include <odp/api/plat/packet_inlines.h>
 #include <odp_packet_internal.h>
 #include <odp_debug_internal.h>
+#include <odp_internal.h>
+#include <odp_arch_chksum_internal.h>
 #include <odp/api/hints.h>
 #include <odp/api/byteorder.h>
 #include <odp/api/plat/byteorder_inlines.h>
@@ -22,6 +24,7 @@
 #include <protocols/udp.h>
 
 #include <errno.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include <inttypes.h>
@@ -30,16 +33,16 @@
 
 /* Fill in packet header field offsets for inline functions */
 const _odp_packet_inline_offset_t ODP_ALIGNED_CACHE _odp_packet_inline = {
-	.data           = offsetof(odp_packet_hdr_t, buf_hdr.seg[0].data),
-	.seg_len        = offsetof(odp_packet_hdr_t, buf_hdr.seg[0].len),
+	.data           = offsetof(odp_packet_hdr_t, seg[0].data),
+	.seg_len        = offsetof(odp_packet_hdr_t, seg[0].len),
 	.frame_len      = offsetof(odp_packet_hdr_t, frame_len),
 	.headroom       = offsetof(odp_packet_hdr_t, headroom),
 	.tailroom       = offsetof(odp_packet_hdr_t, tailroom),
 	.pool           = offsetof(odp_packet_hdr_t, buf_hdr.pool_ptr),
 	.input          = offsetof(odp_packet_hdr_t, input),
 	.segcount       = offsetof(odp_packet_hdr_t, buf_hdr.segcount),
-	.user_ptr       = offsetof(odp_packet_hdr_t, buf_hdr.buf_ctx),
-	.user_area      = offsetof(odp_packet_hdr_t, buf_hdr.uarea_addr),
+	.user_ptr       = offsetof(odp_packet_hdr_t, buf_ctx),
+	.user_area      = offsetof(odp_packet_hdr_t, uarea_addr),
 	.l2_offset      = offsetof(odp_packet_hdr_t, p.l2_offset),
 	.l3_offset      = offsetof(odp_packet_hdr_t, p.l3_offset),
 	.l4_offset      = offsetof(odp_packet_hdr_t, p.l4_offset),
@@ -79,7 +82,7 @@ static inline seg_entry_t *seg_entry(odp_packet_hdr_t *hdr,
 
 	idx = seg_idx - idx;
 
-	return &hdr->buf_hdr.seg[idx];
+	return &hdr->seg[idx];
 }
 
 static inline void seg_entry_find_idx(odp_packet_hdr_t **p_hdr,
@@ -118,7 +121,7 @@ static inline seg_entry_t *seg_entry_next(odp_packet_hdr_t **cur_hdr,
 		*cur_idx = idx + 1;
 	}
 
-	return &hdr->buf_hdr.seg[idx];
+	return &hdr->seg[idx];
 }
 
 static inline void seg_entry_find_offset(odp_packet_hdr_t **p_hdr,
@@ -183,12 +186,12 @@ static inline uint16_t packet_last_seg(odp_packet_hdr_t *pkt_hdr)
 
 static inline uint32_t packet_first_seg_len(odp_packet_hdr_t *pkt_hdr)
 {
-	return pkt_hdr->buf_hdr.seg[0].len;
+	return pkt_hdr->seg[0].len;
 }
 
 static inline void *packet_data(odp_packet_hdr_t *pkt_hdr)
 {
-	return pkt_hdr->buf_hdr.seg[0].data;
+	return pkt_hdr->seg[0].data;
 }
 
 static inline void *packet_tail(odp_packet_hdr_t *pkt_hdr)
@@ -212,7 +215,7 @@ static inline uint32_t seg_tailroom(odp_packet_hdr_t *pkt_hdr, int seg_idx)
 {
 	seg_entry_t *seg = seg_entry(pkt_hdr, seg_idx);
 
-	odp_buffer_hdr_t *hdr = seg->hdr;
+	odp_packet_hdr_t *hdr = seg->hdr;
 	uint8_t *tail         = seg->data + seg->len;
 
 	return hdr->buf_end - tail;
@@ -222,16 +225,16 @@ static inline void push_head(odp_packet_hdr_t *pkt_hdr, uint32_t len)
 {
 	pkt_hdr->headroom  -= len;
 	pkt_hdr->frame_len += len;
-	pkt_hdr->buf_hdr.seg[0].data -= len;
-	pkt_hdr->buf_hdr.seg[0].len  += len;
+	pkt_hdr->seg[0].data -= len;
+	pkt_hdr->seg[0].len  += len;
 }
 
 static inline void pull_head(odp_packet_hdr_t *pkt_hdr, uint32_t len)
 {
 	pkt_hdr->headroom  += len;
 	pkt_hdr->frame_len -= len;
-	pkt_hdr->buf_hdr.seg[0].data += len;
-	pkt_hdr->buf_hdr.seg[0].len  -= len;
+	pkt_hdr->seg[0].data += len;
+	pkt_hdr->seg[0].len  -= len;
 }
 
 static inline void push_tail(odp_packet_hdr_t *pkt_hdr, uint32_t len)
@@ -261,12 +264,12 @@ static inline void packet_seg_copy_md(odp_packet_hdr_t *dst,
 	dst->flow_hash = src->flow_hash;
 	dst->timestamp = src->timestamp;
 
-	/* buffer header side packet metadata */
-	dst->buf_hdr.buf_u64    = src->buf_hdr.buf_u64;
-	dst->buf_hdr.uarea_addr = src->buf_hdr.uarea_addr;
+	/* user context and user area */
+	dst->buf_u64    = src->buf_u64;
+	dst->uarea_addr = src->uarea_addr;
 
 	/* segmentation data is not copied:
-	 *   buf_hdr.seg[]
+	 *   seg[]
 	 *   buf_hdr.segcount
 	 *   buf_hdr.num_seg
 	 *   buf_hdr.next_seg
@@ -287,8 +290,8 @@ static inline void *packet_map(void *pkt_ptr, uint32_t offset,
 		return NULL;
 
 	if (odp_likely(CONFIG_PACKET_SEG_DISABLED || seg_count == 1)) {
-		addr = pkt_hdr->buf_hdr.seg[0].data + offset;
-		len  = pkt_hdr->buf_hdr.seg[0].len - offset;
+		addr = pkt_hdr->seg[0].data + offset;
+		len  = pkt_hdr->seg[0].len - offset;
 	} else {
 		int i;
 		seg_entry_t *seg = NULL;
@@ -407,9 +410,9 @@ static inline void link_segments(odp_packet_hdr_t *pkt_hdr[], int num)
 			odp_buffer_hdr_t *buf_hdr;
 
 			buf_hdr = &pkt_hdr[cur]->buf_hdr;
-			hdr->buf_hdr.seg[i].hdr  = buf_hdr;
-			hdr->buf_hdr.seg[i].data = buf_hdr->base_data;
-			hdr->buf_hdr.seg[i].len  = seg_len;
+			hdr->seg[i].hdr  = buf_hdr;
+			hdr->seg[i].data = buf_hdr->base_data;
+			hdr->seg[i].len  = seg_len;
 
 			/* init_segments() handles first seg ref_cnt init */
 			if (ODP_DEBUG == 1 && cur > 0) {
@@ -446,8 +449,8 @@ static inline void init_segments(odp_packet_hdr_t *pkt_hdr[], int num)
 	seg_len = ((pool_t *)(hdr->buf_hdr.pool_ptr))->seg_len;
 
 	/* Defaults for single segment packet */
-	hdr->buf_hdr.seg[0].data = hdr->buf_hdr.base_data;
-	hdr->buf_hdr.seg[0].len  = seg_len;
+	hdr->seg[0].data = hdr->buf_hdr.base_data;
+	hdr->seg[0].len  = seg_len;
 
 	if (ODP_DEBUG == 1) {
 		uint32_t prev_ref =
@@ -555,8 +558,8 @@ static inline odp_packet_hdr_t *add_segments(odp_packet_hdr_t *pkt_hdr,
 		add_all_segs(new_hdr, pkt_hdr);
 
 		/* adjust first segment length */
-		new_hdr->buf_hdr.seg[0].data += offset;
-		new_hdr->buf_hdr.seg[0].len   = seg_len;
+		new_hdr->seg[0].data += offset;
+		new_hdr->seg[0].len   = seg_len;
 
 		packet_seg_copy_md(new_hdr, pkt_hdr);
 		new_hdr->frame_len = pkt_hdr->frame_len + len;
@@ -585,7 +588,7 @@ static inline int seg_is_link(void *hdr)
 {
 	odp_packet_hdr_t *pkt_hdr = hdr;
 
-	return pkt_hdr != pkt_hdr->buf_hdr.seg[0].hdr;
+	return pkt_hdr != pkt_hdr->seg[0].hdr;
 }
 
 static inline void buffer_ref_inc(odp_buffer_hdr_t *buf_hdr)
@@ -630,6 +633,7 @@ static inline void packet_ref_inc(odp_packet_hdr_t *pkt_hdr)
 
 static inline void packet_free_multi(odp_buffer_hdr_t *hdr[], int num)
 {
+	odp_packet_hdr_t *pkt_hdr;
 	int i;
 	uint32_t ref_cnt;
 	int num_ref = 0;
@@ -647,9 +651,17 @@ static inline void packet_free_multi(odp_buffer_hdr_t *hdr[], int num)
 			}
 		}
 
+		pkt_hdr = (odp_packet_hdr_t *)hdr[i];
+
 		/* Reset link header back to normal header */
-		if (odp_unlikely(seg_is_link(hdr[i])))
-			hdr[i]->seg[0].hdr = hdr[i];
+		if (odp_unlikely(seg_is_link(pkt_hdr)))
+			pkt_hdr->seg[0].hdr = pkt_hdr;
+
+		/* Check the cold part of the header only when zero-copy
+		 * packets are possible */
+		if (odp_unlikely(_odp_ipc_zero_copy &&
+				 pkt_hdr->ipc_zc != NULL))
+			_odp_ipc_free_zero_copy(pkt_hdr);
 
 		/* Skip references and pack to be freed headers to array head */
 		if (odp_unlikely(num_ref))
@@ -670,7 +682,7 @@ static inline void free_all_segments(odp_packet_hdr_t *pkt_hdr, int num)
 
 	if (odp_likely(pkt_hdr->buf_hdr.num_seg == num)) {
 		for (i = 0; i < num; i++)
-			buf_hdr[i] = pkt_hdr->buf_hdr.seg[i].hdr;
+			buf_hdr[i] = pkt_hdr->seg[i].hdr;
 
 		if (odp_unlikely(seg_is_link(pkt_hdr))) {
 			buf_hdr[num] = &pkt_hdr->buf_hdr;
@@ -735,7 +747,7 @@ static inline odp_packet_hdr_t *free_segments(odp_packet_hdr_t *pkt_hdr,
 		/* The first remaining header is the new packet descriptor.
 		 * Copy remaining segments from the last to-be-removed header
 		 * to the new header. */
-		new_hdr = hdr->buf_hdr.seg[idx].hdr;
+		new_hdr = hdr->seg[idx].hdr;
 		num_seg = hdr->buf_hdr.num_seg - idx;
 
 		new_hdr->buf_hdr.next_seg = hdr->buf_hdr.next_seg;
@@ -750,7 +762,7 @@ static inline odp_packet_hdr_t *free_segments(odp_packet_hdr_t *pkt_hdr,
 
 		for (i = 0; i < num_seg; i++) {
 			seg        = seg_entry_next(&hdr, &idx);
-			new_hdr->buf_hdr.seg[i] = *seg;
+			new_hdr->seg[i] = *seg;
 		}
 
 		packet_seg_copy_md(new_hdr, pkt_hdr);
@@ -929,7 +941,7 @@ void odp_packet_free(odp_packet_t pkt)
 
 		if (odp_unlikely(seg_is_link(pkt_hdr))) {
 			num        = 2;
-			buf_hdr[1] = pkt_hdr->buf_hdr.seg[0].hdr;
+			buf_hdr[1] = pkt_hdr->seg[0].hdr;
 		}
 
 		packet_free_multi(buf_hdr, num);
@@ -959,7 +971,7 @@ void odp_packet_free_multi(const odp_packet_t pkt[], int num)
 		}
 
 		if (odp_unlikely(seg_is_link(pkt_hdr))) {
-			buf_hdr2[links] = pkt_hdr->buf_hdr.seg[0].hdr;
+			buf_hdr2[links] = pkt_hdr->seg[0].hdr;
 			links++;
 		}
 
@@ -1044,6 +1056,7 @@ void *odp_packet_push_head(odp_packet_t pkt, uint32_t len)
 	if (len > pkt_hdr->headroom)
 		return NULL;
 
+	packet_parse_finish(pkt_hdr);
 	push_head(pkt_hdr, len);
 	return packet_data(pkt_hdr);
 }
@@ -1056,6 +1069,8 @@ int odp_packet_extend_head(odp_packet_t *pkt, uint32_t len,
 	uint32_t headroom  = pkt_hdr->headroom;
 	int ret = 0;
 
+	packet_parse_finish(pkt_hdr);
+
 	if (len > headroom) {
 		pool_t *pool = pkt_hdr->buf_hdr.pool_ptr;
 		int num;
@@ -1096,6 +1111,7 @@ void *odp_packet_pull_head(odp_packet_t pkt, uint32_t len)
 	if (len > pkt_hdr->frame_len)
 		return NULL;
 
+	packet_parse_finish(pkt_hdr);
 	pull_head(pkt_hdr, len);
 	return packet_data(pkt_hdr);
 }
@@ -1109,6 +1125,8 @@ int odp_packet_trunc_head(odp_packet_t *pkt, uint32_t len,
 	if (len > pkt_hdr->frame_len)
 		return -1;
 
+	packet_parse_finish(pkt_hdr);
+
 	if (len < seg_len) {
 		pull_head(pkt_hdr, len);
 	} else if (!CONFIG_PACKET_SEG_DISABLED) {
@@ -1266,7 +1284,7 @@ void *odp_packet_offset(odp_packet_t pkt, uint32_t offset, uint32_t *len,
 
 void odp_packet_user_ptr_set(odp_packet_t pkt, const void *ctx)
 {
-	packet_hdr(pkt)->buf_hdr.buf_cctx = ctx;
+	packet_hdr(pkt)->buf_cctx = ctx;
 }
 
 int odp_packet_l2_offset_set(odp_packet_t pkt, uint32_t offset)
@@ -1276,6 +1294,7 @@ int odp_packet_l2_offset_set(odp_packet_t pkt, uint32_t offset)
 	if (offset >= pkt_hdr->frame_len)
 		return -1;
 
+	packet_parse_finish(pkt_hdr);
 	packet_hdr_has_l2_set(pkt_hdr, 1);
 	pkt_hdr->p.l2_offset = offset;
 	return 0;
@@ -1288,6 +1307,7 @@ int odp_packet_l3_offset_set(odp_packet_t pkt, uint32_t offset)
 	if (offset >= pkt_hdr->frame_len)
 		return -1;
 
+	packet_parse_finish(pkt_hdr);
 	pkt_hdr->p.l3_offset = offset;
 	return 0;
 }
@@ -1299,16 +1319,192 @@ int odp_packet_l4_offset_set(odp_packet_t pkt, uint32_t offset)
 	if (offset >= pkt_hdr->frame_len)
 		return -1;
 
+	packet_parse_finish(pkt_hdr);
 	pkt_hdr->p.l4_offset = offset;
 	return 0;
 }
 
+/* Ones' complement sum over packet data, which may span multiple segments.
+ * Sum of a segment that starts at an odd offset from the start of the range
+ * is byte swapped before adding it to the total. */
+static uint16_t packet_sum(odp_packet_hdr_t *pkt_hdr, uint32_t offset,
+			   uint32_t len, uint64_t sum)
+{
+	uint32_t done = 0;
+	uint32_t seglen = 0; /* GCC */
+	uint32_t sumlen;
+	uint16_t segsum;
+	void *mapaddr;
+
+	while (len > 0) {
+		mapaddr = packet_map(pkt_hdr, offset, &seglen, NULL);
+		sumlen = len > seglen ? seglen : len;
+		segsum = chksum_fold(cpu_chksum_sum(mapaddr, sumlen));
+
+		if (done & 1)
+			segsum = (segsum >> 8) | (segsum << 8);
+
+		sum    += segsum;
+		offset += sumlen;
+		done   += sumlen;
+		len    -= sumlen;
+	}
+
+	return chksum_fold(sum);
+}
+
 uint16_t odp_packet_ones_comp(odp_packet_t pkt, odp_packet_data_range_t *range)
 {
-	(void)pkt;
-	range->length = 0;
-	range->offset = 0;
-	return 0;
+	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
+	uint32_t offset;
+
+	packet_parse_lazy(pkt_hdr, ODP_PROTO_LAYER_L3);
+	offset = pkt_hdr->p.l4_offset;
+
+	/* Sum is calculated over L4 header and payload of received packets */
+	if (pkt_hdr->input == ODP_PKTIO_INVALID ||
+	    offset == ODP_PACKET_OFFSET_INVALID ||
+	    offset >= pkt_hdr->frame_len) {
+		range->length = 0;
+		range->offset = 0;
+		return 0;
+	}
+
+	range->offset = offset;
+	range->length = pkt_hdr->frame_len - offset;
+
+	return packet_sum(pkt_hdr, range->offset, range->length, 0);
+}
+
+#define OUT_CHKSUM(_ena, _dflt, _ovr_set, _ovr) \
+	(_ena && (_ovr_set ? _ovr : _dflt))
+
+void _odp_packet_chksum_insert(odp_packet_hdr_t *pkt_hdr,
+			       const odp_pktout_config_opt_t *cfg)
+{
+	odp_packet_t pkt = packet_handle(pkt_hdr);
+	packet_parser_t *p = &pkt_hdr->p;
+	uint32_t l3_offset, l4_offset;
+	union {
+		/* Maximum IPv4 header length */
+		uint8_t u8[_ODP_IPV4HDR_IHL(0xff) * 4];
+		_odp_ipv4hdr_t ipv4;
+		_odp_ipv6hdr_t ipv6;
+	} l3_hdr;
+	_odp_ipv4hdr_t *ipv4 = &l3_hdr.ipv4;
+	_odp_ipv6hdr_t *ipv6 = &l3_hdr.ipv6;
+	odp_bool_t ipv4_chksum, udp_chksum, tcp_chksum;
+	uint32_t l3_len, l4_len, chksum_offset, tot_len;
+	uint64_t sum = 0;
+	uint16_t chksum, frag_offset;
+	uint8_t proto;
+
+	/* Offsets and L4 flags are read below */
+	packet_parse_finish(pkt_hdr);
+	l3_offset = p->l3_offset;
+	l4_offset = p->l4_offset;
+
+	if (l3_offset == ODP_PACKET_OFFSET_INVALID ||
+	    _odp_packet_copy_to_mem(pkt, l3_offset, 1, &l3_hdr))
+		return;
+
+	if (_ODP_IPV4HDR_VER(l3_hdr.u8[0]) == _ODP_IPV4) {
+		l3_len = _ODP_IPV4HDR_IHL(l3_hdr.u8[0]) * 4;
+
+		if (l3_len < _ODP_IPV4HDR_LEN ||
+		    _odp_packet_copy_to_mem(pkt, l3_offset, l3_len, &l3_hdr))
+			return;
+
+		ipv4_chksum = OUT_CHKSUM(cfg->bit.ipv4_chksum_ena,
+					 cfg->bit.ipv4_chksum,
+					 p->output_flags.l3_chksum_set,
+					 p->output_flags.l3_chksum);
+		if (ipv4_chksum) {
+			ipv4->chksum = 0;
+			chksum = ~odp_chksum_ones_comp16(&l3_hdr, l3_len);
+			_odp_packet_copy_from_mem(pkt, l3_offset +
+						  offsetof(_odp_ipv4hdr_t,
+							   chksum),
+						  2, &chksum);
+		}
+
+		/* Fragments do not contain the whole L4 payload, and other
+		 * than the first fragment do not contain the L4 header */
+		frag_offset = odp_be_to_cpu_16(ipv4->frag_offset);
+		if (_ODP_IPV4HDR_IS_FRAGMENT(frag_offset))
+			return;
+
+		/* Total length includes the header */
+		tot_len = odp_be_to_cpu_16(ipv4->tot_len);
+		if (tot_len < l3_len)
+			return;
+
+		proto  = ipv4->proto;
+		l4_len = tot_len - l3_len;
+		sum    = cpu_chksum_sum(&ipv4->src_addr, 2 * _ODP_IPV4ADDR_LEN);
+	} else if (_ODP_IPV4HDR_VER(l3_hdr.u8[0]) == _ODP_IPV6) {
+		if (_odp_packet_copy_to_mem(pkt, l3_offset, _ODP_IPV6HDR_LEN,
+					    &l3_hdr))
+			return;
+
+		if (l4_offset == ODP_PACKET_OFFSET_INVALID ||
+		    l4_offset < l3_offset + _ODP_IPV6HDR_LEN ||
+		    p->input_flags.ipfrag)
+			return;
+
+		/* Payload length includes extension headers */
+		tot_len = odp_be_to_cpu_16(ipv6->payload_len);
+		l3_len  = l4_offset - l3_offset - _ODP_IPV6HDR_LEN;
+		if (tot_len < l3_len)
+			return;
+
+		proto  = p->input_flags.udp ? _ODP_IPPROTO_UDP :
+			 p->input_flags.tcp ? _ODP_IPPROTO_TCP : ipv6->next_hdr;
+		l4_len = tot_len - l3_len;
+		sum    = cpu_chksum_sum(&ipv6->src_addr, 2 * _ODP_IPV6ADDR_LEN);
+	} else {
+		return;
+	}
+
+	udp_chksum = proto == _ODP_IPPROTO_UDP &&
+		     OUT_CHKSUM(cfg->bit.udp_chksum_ena, cfg->bit.udp_chksum,
+				p->output_flags.l4_chksum_set,
+				p->output_flags.l4_chksum);
+	tcp_chksum = proto == _ODP_IPPROTO_TCP &&
+		     OUT_CHKSUM(cfg->bit.tcp_chksum_ena, cfg->bit.tcp_chksum,
+				p->output_flags.l4_chksum_set,
+				p->output_flags.l4_chksum);
+
+	if (!udp_chksum && !tcp_chksum)
+		return;
+
+	if (l4_offset == ODP_PACKET_OFFSET_INVALID ||
+	    l4_offset + l4_len > pkt_hdr->frame_len)
+		return;
+
+	chksum_offset = l4_offset + (udp_chksum ?
+				     offsetof(_odp_udphdr_t, chksum) :
+				     offsetof(_odp_tcphdr_t, cksm));
+
+	/* Checksum field must be within L4 length */
+	if (chksum_offset + 2 > l4_offset + l4_len)
+		return;
+
+	chksum = 0;
+	if (_odp_packet_copy_from_mem(pkt, chksum_offset, 2, &chksum))
+		return;
+
+	/* Pseudo header */
+	sum += odp_cpu_to_be_16(proto);
+	sum += odp_cpu_to_be_16(l4_len);
+
+	chksum = ~packet_sum(pkt_hdr, l4_offset, l4_len, sum);
+
+	/* Zero UDP checksum means that checksum is not used */
+	if (udp_chksum && chksum == 0)
+		chksum = 0xffff;
+
+	_odp_packet_copy_from_mem(pkt, chksum_offset, 2, &chksum);
 }
 
 void odp_packet_l3_chksum_insert(odp_packet_t pkt, int insert)
@@ -1887,10 +2083,10 @@ int _odp_packet_copy_md_to_packet(odp_packet_t srcpkt, odp_packet_t dstpkt)
 
 	dsthdr->input = srchdr->input;
 	dsthdr->dst_queue = srchdr->dst_queue;
-	dsthdr->buf_hdr.buf_u64 = srchdr->buf_hdr.buf_u64;
-	if (dsthdr->buf_hdr.uarea_addr != NULL &&
-	    srchdr->buf_hdr.uarea_addr != NULL) {
-		memcpy(dsthdr->buf_hdr.uarea_addr, srchdr->buf_hdr.uarea_addr,
+	dsthdr->buf_u64 = srchdr->buf_u64;
+	if (dsthdr->uarea_addr != NULL &&
+	    srchdr->uarea_addr != NULL) {
+		memcpy(dsthdr->uarea_addr, srchdr->uarea_addr,
 		       dst_uarea_size <= src_uarea_size ? dst_uarea_size :
 		       src_uarea_size);
 	}
@@ -2256,6 +2452,365 @@ int packet_parse_common(packet_parser_t *prs, const uint8_t *ptr,
 					 seg_len, layer, ethtype);
 }
 
+/* Maximum number of packets classified and grouped at a time */
+#define PARSE_MULTI_MAX 16
+
+/* Packet types of parse_type(). A type is
+ * PARSE_TYPE_L4_xxx + PARSE_TYPE_IPV6 (when IPv6) + PARSE_TYPE_VLAN (when
+ * a single VLAN tag). Zero is any other packet. */
+#define PARSE_TYPE_OTHER   0
+#define PARSE_TYPE_L4_TCP  1
+#define PARSE_TYPE_L4_UDP  2
+#define PARSE_TYPE_L4_ICMP 3
+#define PARSE_TYPE_IPV6    3
+#define PARSE_TYPE_VLAN    6
+#define PARSE_TYPE_NUM     13
+
+/* Offset and length of the header window parse_type() reads. It starts
+ * from the Ethernet type and covers IPv4 protocol and IPv6 next header
+ * fields behind a VLAN tag. */
+#define PARSE_TYPE_OFFSET  12
+#define PARSE_TYPE_LEN     16
+
+/* Type of L4 protocol numbers: TCP, UDP or ICMP (ICMPv4 and ICMPv6) */
+static const uint8_t parse_l4_type[256] = {
+	[_ODP_IPPROTO_ICMPV4] = PARSE_TYPE_L4_ICMP,
+	[_ODP_IPPROTO_TCP]    = PARSE_TYPE_L4_TCP,
+	[_ODP_IPPROTO_UDP]    = PARSE_TYPE_L4_UDP,
+	[_ODP_IPPROTO_ICMPV6] = PARSE_TYPE_L4_ICMP
+};
+
+/* Classify a packet into a PARSE_TYPE_xxx type. Reads PARSE_TYPE_LEN bytes
+ * from ptr + PARSE_TYPE_OFFSET. IPv4 packets must have no options and must
+ * not be fragments. The caller checks lengths and other header fields. */
+static inline uint8_t parse_type(const uint8_t *ptr)
+{
+	const uint8_t *win = ptr + PARSE_TYPE_OFFSET;
+	uint32_t vlan, ipv4, ipv6, l4;
+	uint8_t proto;
+
+	vlan = win[0] == 0x81 && win[1] == 0x00;
+	win += 4 * vlan;
+
+	ipv4 = win[0] == 0x08 && win[1] == 0x00 && win[2] == 0x45 &&
+	       (win[8] & 0x3f) == 0 && win[9] == 0;
+	ipv6 = win[0] == 0x86 && win[1] == 0xdd && (win[2] & 0xf0) == 0x60;
+
+	proto = ipv6 ? win[8] : win[11];
+	l4 = parse_l4_type[proto];
+
+	if (l4 == 0 || (ipv4 | ipv6) == 0)
+		return PARSE_TYPE_OTHER;
+
+	return l4 + PARSE_TYPE_IPV6 * ipv6 + PARSE_TYPE_VLAN * vlan;
+}
+
+/* Packet indexes of a burst of one packet type */
+static const uint8_t parse_idx[PARSE_MULTI_MAX] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+/* Input flags per parsed layer and header offsets of a packet type */
+typedef struct {
+	_odp_packet_input_flags_t l2;
+	_odp_packet_input_flags_t l3;
+	_odp_packet_input_flags_t l4;
+	uint8_t l3_offset;
+	uint8_t l4_offset;
+	/* Bytes parse_fast() reads from L4 header, must be in the first
+	 * segment */
+	uint8_t l4_len;
+	uint8_t ipv6;
+} parse_type_info_t;
+
+#define PARSE_L3_OFFSET(vlan) (_ODP_ETHHDR_LEN + (vlan) * _ODP_VLANHDR_LEN)
+
+/* ICMP uses UDP header length, see parse_fast() */
+#define PARSE_TYPE_INFO(vlan_, ipv6_, tcp_, udp_, icmp_) { \
+	.l2 = { .l2 = 1, .eth = 1, .vlan = vlan_ }, \
+	.l3 = { .l3 = 1, .ipv4 = !(ipv6_), .ipv6 = ipv6_ }, \
+	.l4 = { .l4 = 1, .tcp = tcp_, .udp = udp_, .icmp = icmp_ }, \
+	.l3_offset = PARSE_L3_OFFSET(vlan_), \
+	.l4_offset = PARSE_L3_OFFSET(vlan_) + \
+		     ((ipv6_) ? _ODP_IPV6HDR_LEN : _ODP_IPV4HDR_LEN), \
+	.l4_len = (tcp_) ? _ODP_TCPHDR_LEN : _ODP_UDPHDR_LEN, \
+	.ipv6 = ipv6_ }
+
+/* Packet types in PARSE_TYPE_L4_xxx order */
+#define PARSE_TYPE_INFO_IP(vlan, ipv6) \
+	PARSE_TYPE_INFO(vlan, ipv6, 1, 0, 0), \
+	PARSE_TYPE_INFO(vlan, ipv6, 0, 1, 0), \
+	PARSE_TYPE_INFO(vlan, ipv6, 0, 0, 1)
+
+static const parse_type_info_t parse_type_info[PARSE_TYPE_NUM] = {
+	[PARSE_TYPE_OTHER] = { .l2 = { .all = 0 } },
+	PARSE_TYPE_INFO_IP(0, 0),
+	PARSE_TYPE_INFO_IP(0, 1),
+	PARSE_TYPE_INFO_IP(1, 0),
+	PARSE_TYPE_INFO_IP(1, 1)
+};
+
+/*
+ * Parse a packet of a type found by parse_type(). Flags come from the
+ * type table, only lengths and address flags are read from the packet.
+ * The type is a constant in each caller, so that type checks are resolved
+ * at compile time. Results are equal to packet_parse_common(). Returns -1
+ * without updating the parser metadata, when the packet must be passed to
+ * the full parser: on a header error, a short first segment or the IPsec
+ * NAT-T port.
+ */
+static inline __attribute__((always_inline))
+int parse_fast(packet_parser_t *prs, const uint8_t *ptr, uint32_t frame_len,
+	       uint32_t seg_len, int layer, int type)
+{
+	const parse_type_info_t *t = &parse_type_info[type];
+	const uint8_t *l3 = ptr + t->l3_offset;
+	const uint8_t *l4 = ptr + t->l4_offset;
+	_odp_packet_input_flags_t flags;
+	uint16_t mac[3], len, udp_len, udp_port;
+	uint32_t dst, l3_len, err;
+
+	if (odp_unlikely(seg_len < (uint32_t)t->l4_offset + t->l4_len))
+		return -1;
+
+	if (t->ipv6) {
+		memcpy(&len, l3 + 4, sizeof(len));
+		l3_len = _odp_be_to_cpu_16(len) + _ODP_IPV6HDR_LEN;
+	} else {
+		memcpy(&len, l3 + 2, sizeof(len));
+		l3_len = _odp_be_to_cpu_16(len);
+	}
+
+	err = l3_len > frame_len - t->l3_offset;
+
+	if (t->l4.tcp)
+		err |= (l4[12] >> 4) < 5;
+
+	if (t->l4.udp) {
+		memcpy(&udp_port, l4 + 2, sizeof(udp_port));
+		memcpy(&udp_len, l4 + 4, sizeof(udp_len));
+		err |= (_odp_be_to_cpu_16(udp_len) < _ODP_UDPHDR_LEN) |
+		       (_odp_be_to_cpu_16(udp_port) == _ODP_UDP_IPSEC_PORT);
+	}
+
+	if (odp_unlikely(err))
+		return -1;
+
+	memcpy(mac, ptr, sizeof(mac));
+
+	flags.all = t->l2.all;
+	flags.jumbo = frame_len > _ODP_ETH_LEN_MAX;
+	flags.eth_mcast = ptr[0] & 1;
+	flags.eth_bcast = (mac[0] & mac[1] & mac[2]) == 0xffff;
+
+	prs->l2_offset = 0;
+	prs->l3_offset = t->l3_offset;
+
+	if (layer >= ODP_PROTO_LAYER_L3) {
+		flags.all |= t->l3.all;
+
+		if (t->ipv6) {
+			flags.ip_mcast = l3[24] == 0xff;
+		} else {
+			memcpy(&dst, l3 + 16, sizeof(dst));
+			dst = _odp_be_to_cpu_32(dst);
+			flags.ip_bcast = dst == 0xffffffff;
+			flags.ip_mcast = (dst >> 28) == 0xe;
+		}
+
+		prs->l4_offset = t->l4_offset;
+	}
+
+	if (layer >= ODP_PROTO_LAYER_L4)
+		flags.all |= t->l4.all;
+
+	prs->input_flags.all |= flags.all;
+
+	return prs->error_flags.all != 0;
+}
+
+/* Parse packets idx[] of the same type */
+static inline __attribute__((always_inline))
+void parse_fast_burst(packet_parser_t *prs[], const uint8_t *ptr[],
+		      const uint32_t frame_len[], const uint32_t seg_len[],
+		      int ret[], const uint8_t idx[], int num, int layer,
+		      int type)
+{
+	int i, k;
+
+	for (i = 0; i < num; i++) {
+		k = idx[i];
+
+		ret[k] = parse_fast(prs[k], ptr[k], frame_len[k], seg_len[k],
+				    layer, type);
+
+		if (odp_unlikely(ret[k] < 0))
+			ret[k] = packet_parse_common(prs[k], ptr[k],
+						     frame_len[k], seg_len[k],
+						     layer);
+	}
+}
+
+#define PARSE_FAST_CASE(type) \
+	case type: \
+		parse_fast_burst(prs, ptr, frame_len, seg_len, ret, idx, num, \
+				 layer, type); \
+		break
+
+#define PARSE_FAST_CASE_IP(vlan, ipv6) \
+	PARSE_FAST_CASE(PARSE_TYPE_L4_TCP + (ipv6) * PARSE_TYPE_IPV6 + \
+			(vlan) * PARSE_TYPE_VLAN); \
+	PARSE_FAST_CASE(PARSE_TYPE_L4_UDP + (ipv6) * PARSE_TYPE_IPV6 + \
+			(vlan) * PARSE_TYPE_VLAN); \
+	PARSE_FAST_CASE(PARSE_TYPE_L4_ICMP + (ipv6) * PARSE_TYPE_IPV6 + \
+			(vlan) * PARSE_TYPE_VLAN)
+
+/* Parse packets idx[] of a type with a parser specialized to the type */
+static void parse_type_burst(packet_parser_t *prs[], const uint8_t *ptr[],
+			     const uint32_t frame_len[],
+			     const uint32_t seg_len[], int ret[],
+			     const uint8_t idx[], int num, int layer, int type)
+{
+	int i, k;
+
+	switch (type) {
+	PARSE_FAST_CASE_IP(0, 0);
+	PARSE_FAST_CASE_IP(0, 1);
+	PARSE_FAST_CASE_IP(1, 0);
+	PARSE_FAST_CASE_IP(1, 1);
+	default:
+		for (i = 0; i < num; i++) {
+			k = idx[i];
+			ret[k] = packet_parse_common(prs[k], ptr[k],
+						     frame_len[k], seg_len[k],
+						     layer);
+		}
+	}
+}
+
+/**
+ * Parse common packet headers of several packets
+ *
+ * Same as packet_parse_common() for each packet, return values are stored
+ * into ret[]. Packets are parsed one by one unless the burst parser is
+ * selected with ODP_PACKET_PARSE_BURST environment variable. The burst parser
+ * classifies packets and groups them by type. Groups of common packet types
+ * are parsed with type specific code without mispredicted branches on
+ * mixed traffic. Other packets are passed to packet_parse_common().
+ */
+void packet_parse_common_multi(packet_parser_t *prs[], const uint8_t *ptr[],
+			       const uint32_t frame_len[],
+			       const uint32_t seg_len[], int ret[], int num,
+			       int layer)
+{
+	uint8_t type[PARSE_MULTI_MAX];
+	uint8_t idx[PARSE_TYPE_NUM][PARSE_MULTI_MAX];
+	uint8_t cnt[PARSE_TYPE_NUM];
+	int i, j, k, n, t;
+
+	if (odp_unlikely(layer == ODP_PROTO_LAYER_NONE)) {
+		for (i = 0; i < num; i++)
+			ret[i] = 0;
+		return;
+	}
+
+	if (!odp_global_data.parse_burst) {
+		for (i = 0; i < num; i++)
+			ret[i] = packet_parse_common(prs[i], ptr[i],
+						     frame_len[i], seg_len[i],
+						     layer);
+		return;
+	}
+
+	for (i = 0; i < num; i += n) {
+		n = num - i;
+		if (n > PARSE_MULTI_MAX)
+			n = PARSE_MULTI_MAX;
+
+		for (j = 0; j < n; j++) {
+			k = i + j;
+			type[j] = PARSE_TYPE_OTHER;
+			if (odp_likely(seg_len[k] >= PARSE_TYPE_OFFSET +
+				       PARSE_TYPE_LEN))
+				type[j] = parse_type(ptr[k]);
+		}
+
+		/* Bursts of a single flow are often of one type */
+		for (j = 1; j < n && type[j] == type[0]; j++)
+			;
+
+		if (j == n) {
+			parse_type_burst(&prs[i], &ptr[i], &frame_len[i],
+					 &seg_len[i], &ret[i], parse_idx, n,
+					 layer, type[0]);
+			continue;
+		}
+
+		memset(cnt, 0, sizeof(cnt));
+
+		for (j = 0; j < n; j++) {
+			t = type[j];
+			idx[t][cnt[t]++] = j;
+		}
+
+		for (t = 0; t < PARSE_TYPE_NUM; t++)
+			if (cnt[t])
+				parse_type_burst(&prs[i], &ptr[i],
+						 &frame_len[i], &seg_len[i],
+						 &ret[i], idx[t], cnt[t],
+						 layer, t);
+	}
+}
+
+ODP_STATIC_ASSERT(_ODP_PARSE_LAYER_L2 == ODP_PROTO_LAYER_L2 &&
+		  _ODP_PARSE_LAYER_L3 == ODP_PROTO_LAYER_L3 &&
+		  _ODP_PARSE_LAYER_L4 == ODP_PROTO_LAYER_L4 &&
+		  _ODP_PARSE_LAYER_ALL == ODP_PROTO_LAYER_ALL,
+		  "PARSE_LAYER_ERROR");
+
+/* Mark layers above 'layer' for parsing on first use. L4 is the last layer
+ * parsed. */
+static inline void parse_defer(packet_parser_t *prs, odp_proto_layer_t layer)
+{
+	if (layer < ODP_PROTO_LAYER_L4) {
+		prs->input_flags.parse_lazy = 1;
+		prs->input_flags.parse_layer = layer;
+	}
+}
+
+/**
+ * Parse layers deferred at packet input
+ *
+ * Called by metadata accessors on first use of a layer that packet input did
+ * not parse. All remaining layers are parsed at once. Headers are parsed
+ * again from L2 into a separate parser state, which is merged into the
+ * packet metadata. This keeps flags set after packet input, like checksum
+ * status and color.
+ */
+void _odp_packet_parse_lazy(odp_packet_t pkt)
+{
+	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
+	packet_parser_t *prs = &pkt_hdr->p;
+	packet_parser_t tmp;
+
+	tmp.input_flags.all = 0;
+	tmp.error_flags.all = 0;
+	tmp.l2_offset = ODP_PACKET_OFFSET_INVALID;
+	tmp.l3_offset = ODP_PACKET_OFFSET_INVALID;
+	tmp.l4_offset = ODP_PACKET_OFFSET_INVALID;
+
+	packet_parse_common(&tmp, packet_data(pkt_hdr), pkt_hdr->frame_len,
+			    packet_first_seg_len(pkt_hdr), ODP_PROTO_LAYER_ALL);
+
+	prs->input_flags.parse_lazy = 0;
+	prs->input_flags.parse_layer = 0;
+	prs->input_flags.all |= tmp.input_flags.all;
+	prs->error_flags.all |= tmp.error_flags.all;
+	prs->l2_offset = tmp.l2_offset;
+	prs->l3_offset = tmp.l3_offset;
+	prs->l4_offset = tmp.l4_offset;
+}
+
 /**
  * Simple packet parser
  */
@@ -2265,10 +2820,42 @@ int packet_parse_layer(odp_packet_hdr_t *pkt_hdr,
 	uint32_t seg_len = packet_first_seg_len(pkt_hdr);
 	void *base = packet_data(pkt_hdr);
 
+	parse_defer(&pkt_hdr->p, layer);
+
 	return packet_parse_common(&pkt_hdr->p, base, pkt_hdr->frame_len,
 				   seg_len, layer);
 }
 
+void packet_parse_layer_multi(odp_packet_hdr_t *pkt_hdr[], int num,
+			      odp_proto_layer_t layer)
+{
+	packet_parser_t *prs[PARSE_MULTI_MAX];
+	const uint8_t *ptr[PARSE_MULTI_MAX];
+	uint32_t frame_len[PARSE_MULTI_MAX];
+	uint32_t seg_len[PARSE_MULTI_MAX];
+	int ret[PARSE_MULTI_MAX];
+	int i, j, n;
+
+	for (i = 0; i < num; i += n) {
+		n = num - i;
+		if (n > PARSE_MULTI_MAX)
+			n = PARSE_MULTI_MAX;
+
+		for (j = 0; j < n; j++) {
+			odp_packet_hdr_t *hdr = pkt_hdr[i + j];
+
+			prs[j] = &hdr->p;
+			ptr[j] = packet_data(hdr);
+			frame_len[j] = hdr->frame_len;
+			seg_len[j] = packet_first_seg_len(hdr);
+			parse_defer(prs[j], layer);
+		}
+
+		packet_parse_common_multi(prs, ptr, frame_len, seg_len, ret,
+					  n, layer);
+	}
+}
+
 int odp_packet_parse(odp_packet_t pkt, uint32_t offset,
 		     const odp_packet_parse_param_t *param)
 {
@@ -2317,11 +2904,50 @@ int odp_packet_parse(odp_packet_t pkt, uint32_t offset,
 int odp_packet_parse_multi(const odp_packet_t pkt[], const uint32_t offset[],
 			   int num, const odp_packet_parse_param_t *param)
 {
-	int i;
+	packet_parser_t *prs[PARSE_MULTI_MAX];
+	const uint8_t *ptr[PARSE_MULTI_MAX];
+	uint32_t frame_len[PARSE_MULTI_MAX];
+	uint32_t seg_len[PARSE_MULTI_MAX];
+	int ret[PARSE_MULTI_MAX];
+	odp_packet_hdr_t *pkt_hdr;
+	int i, j, n, num_map;
+
+	if (param->proto != ODP_PROTO_ETH ||
+	    param->last_layer == ODP_PROTO_LAYER_NONE) {
+		for (i = 0; i < num; i++)
+			if (odp_packet_parse(pkt[i], offset[i], param))
+				return i;
 
-	for (i = 0; i < num; i++)
-		if (odp_packet_parse(pkt[i], offset[i], param))
-			return i;
+		return num;
+	}
+
+	for (i = 0; i < num; i += n) {
+		n = num - i;
+		if (n > PARSE_MULTI_MAX)
+			n = PARSE_MULTI_MAX;
+
+		for (num_map = 0; num_map < n; num_map++) {
+			pkt_hdr = packet_hdr(pkt[i + num_map]);
+			ptr[num_map] = packet_map(pkt_hdr, offset[i + num_map],
+						  &seg_len[num_map], NULL);
+			if (ptr[num_map] == NULL)
+				break;
+
+			packet_parse_reset(pkt_hdr);
+			prs[num_map] = &pkt_hdr->p;
+			frame_len[num_map] = pkt_hdr->frame_len;
+		}
+
+		packet_parse_common_multi(prs, ptr, frame_len, seg_len, ret,
+					  num_map, param->last_layer);
+
+		for (j = 0; j < num_map; j++)
+			if (ret[j])
+				return i + j;
+
+		if (num_map < n)
+			return i + num_map;
+	}
 
 	return num;
 }
@@ -2383,9 +3009,9 @@ odp_packet_t odp_packet_ref(odp_packet_t pkt, uint32_t offset)
 
 	seg = seg_entry_next(&hdr, &idx);
 	link_hdr->buf_hdr.num_seg = 1;
-	link_hdr->buf_hdr.seg[0].hdr  = seg->hdr;
-	link_hdr->buf_hdr.seg[0].data = seg->data + seg_offset;
-	link_hdr->buf_hdr.seg[0].len  = seg->len  - seg_offset;
+	link_hdr->seg[0].hdr  = seg->hdr;
+	link_hdr->seg[0].data = seg->data + seg_offset;
+	link_hdr->seg[0].len  = seg->len  - seg_offset;
 	buffer_ref_inc(seg->hdr);
 
 	/* The 'CONFIG_PACKET_SEGS_PER_HDR > 1' condition is required to fix an
@@ -2399,9 +3025,9 @@ odp_packet_t odp_packet_ref(odp_packet_t pkt, uint32_t offset)
 		seg = seg_entry_next(&hdr, &idx);
 
 		link_hdr->buf_hdr.num_seg++;
-		link_hdr->buf_hdr.seg[i].hdr  = seg->hdr;
-		link_hdr->buf_hdr.seg[i].data = seg->data;
-		link_hdr->buf_hdr.seg[i].len  = seg->len;
+		link_hdr->seg[i].hdr  = seg->hdr;
+		link_hdr->seg[i].data = seg->data;
+		link_hdr->seg[i].len  = seg->len;
 		buffer_ref_inc(seg->hdr);
 	}
 
@@ -10,13 +10,16 @@
 #include <odp/api/packet_flags.h>
 #include <odp_packet_internal.h>
 
-#define retflag(pkt, x) do {                             \
+/* Layers above the pktio parser configuration are parsed on first use */
+#define retflag(pkt, x, layer) do {                      \
 	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt); \
+	packet_parse_lazy(pkt_hdr, layer);               \
 	return pkt_hdr->p.x;                             \
 	} while (0)
 
 #define setflag(pkt, x, v) do {                          \
 	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt); \
+	packet_parse_finish(pkt_hdr);                    \
 	pkt_hdr->p.x = (v) & 1;				 \
 	} while (0)
 
@@ -24,6 +27,8 @@ int odp_packet_has_error(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
 
+	/* Errors of all layers */
+	packet_parse_finish(pkt_hdr);
 	return pkt_hdr->p.error_flags.all != 0;
 }
 
@@ -32,8 +37,8 @@ int odp_packet_has_error(odp_packet_t pkt)
 int odp_packet_has_l2_error(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
-	/* L2 parsing is always done by default and hence
-	no additional check is required */
+	/* L2 is parsed at input unless the parser is disabled */
+	packet_parse_lazy(pkt_hdr, ODP_PROTO_LAYER_L2);
 	return pkt_hdr->p.error_flags.frame_len
 		| pkt_hdr->p.error_flags.snap_len
 		| pkt_hdr->p.error_flags.l2_chksum;
@@ -41,111 +46,113 @@ int odp_packet_has_l2_error(odp_packet_t pkt)
 
 int odp_packet_has_l3(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.l3);
+	retflag(pkt, input_flags.l3, ODP_PROTO_LAYER_L3);
 }
 
 int odp_packet_has_l3_error(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
 
+	packet_parse_lazy(pkt_hdr, ODP_PROTO_LAYER_L3);
 	return pkt_hdr->p.error_flags.ip_err;
 }
 
 int odp_packet_has_l4(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.l4);
+	retflag(pkt, input_flags.l4, ODP_PROTO_LAYER_L4);
 }
 
 int odp_packet_has_l4_error(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
 
+	packet_parse_lazy(pkt_hdr, ODP_PROTO_LAYER_L4);
 	return pkt_hdr->p.error_flags.tcp_err | pkt_hdr->p.error_flags.udp_err;
 }
 
 int odp_packet_has_eth_bcast(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.eth_bcast);
+	retflag(pkt, input_flags.eth_bcast, ODP_PROTO_LAYER_L2);
 }
 
 int odp_packet_has_eth_mcast(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.eth_mcast);
+	retflag(pkt, input_flags.eth_mcast, ODP_PROTO_LAYER_L2);
 }
 
 int odp_packet_has_vlan(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.vlan);
+	retflag(pkt, input_flags.vlan, ODP_PROTO_LAYER_L2);
 }
 
 int odp_packet_has_vlan_qinq(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.vlan_qinq);
+	retflag(pkt, input_flags.vlan_qinq, ODP_PROTO_LAYER_L2);
 }
 
 int odp_packet_has_arp(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.arp);
+	retflag(pkt, input_flags.arp, ODP_PROTO_LAYER_L3);
 }
 
 int odp_packet_has_ipv4(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipv4);
+	retflag(pkt, input_flags.ipv4, ODP_PROTO_LAYER_L3);
 }
 
 int odp_packet_has_ipv6(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipv6);
+	retflag(pkt, input_flags.ipv6, ODP_PROTO_LAYER_L3);
 }
 
 int odp_packet_has_ip_bcast(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ip_bcast);
+	retflag(pkt, input_flags.ip_bcast, ODP_PROTO_LAYER_L3);
 }
 
 int odp_packet_has_ip_mcast(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ip_mcast);
+	retflag(pkt, input_flags.ip_mcast, ODP_PROTO_LAYER_L3);
 }
 
 int odp_packet_has_ipfrag(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipfrag);
+	retflag(pkt, input_flags.ipfrag, ODP_PROTO_LAYER_L3);
 }
 
 int odp_packet_has_ipopt(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipopt);
+	retflag(pkt, input_flags.ipopt, ODP_PROTO_LAYER_L3);
 }
 
 int odp_packet_has_ipsec(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipsec);
+	retflag(pkt, input_flags.ipsec, ODP_PROTO_LAYER_L4);
 }
 
 int odp_packet_has_udp(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.udp);
+	retflag(pkt, input_flags.udp, ODP_PROTO_LAYER_L4);
 }
 
 int odp_packet_has_tcp(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.tcp);
+	retflag(pkt, input_flags.tcp, ODP_PROTO_LAYER_L4);
 }
 
 int odp_packet_has_sctp(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.sctp);
+	retflag(pkt, input_flags.sctp, ODP_PROTO_LAYER_L4);
 }
 
 int odp_packet_has_icmp(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.icmp);
+	retflag(pkt, input_flags.icmp, ODP_PROTO_LAYER_L4);
 }
 
 odp_packet_color_t odp_packet_color(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.color);
+	retflag(pkt, input_flags.color, ODP_PROTO_LAYER_NONE);
 }
 
 void odp_packet_color_set(odp_packet_t pkt, odp_packet_color_t color)
@@ -164,12 +171,14 @@ odp_bool_t odp_packet_drop_eligible(odp_packet_t pkt)
 
 void odp_packet_drop_eligible_set(odp_packet_t pkt, odp_bool_t drop)
 {
-	setflag(pkt, input_flags.nodrop, !drop);
+	odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
+
+	pkt_hdr->p.input_flags.nodrop = !drop;
 }
 
 int8_t odp_packet_shaper_len_adjust(odp_packet_t pkt)
 {
-	retflag(pkt, output_flags.shaper_len_adj);
+	retflag(pkt, output_flags.shaper_len_adj, ODP_PROTO_LAYER_NONE);
 }
 
 void odp_packet_shaper_len_adjust_set(odp_packet_t pkt, int8_t adj)
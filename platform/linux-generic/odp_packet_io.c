@@ -27,6 +27,7 @@
 #include <odp/api/time.h>
 
 #include <string.h>
+#include <stdlib.h>
 #include <inttypes.h>
 #include <sys/ioctl.h>
 #include <ifaddrs.h>
@@ -57,6 +58,12 @@ int odp_pktio_init_global(void)
 	int i;
 	odp_shm_t shm;
 	int pktio_if;
+	const char *env;
+
+	/* Packets are parsed one by one by default. The burst parser helps
+	 * on mixed traffic, but is slower on uniform traffic. */
+	env = getenv("ODP_PACKET_PARSE_BURST");
+	odp_global_data.parse_burst = env && atoi(env) > 0;
 
 	shm = odp_shm_reserve("odp_pktio_entries",
 			      sizeof(pktio_table_t),
@@ -391,6 +398,16 @@ int odp_pktio_close(odp_pktio_t hdl)
 	return 0;
 }
 
+void _odp_pktio_chksum_insert(pktio_entry_t *pktio_entry,
+			      const odp_packet_t pkt_table[], int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		_odp_packet_chksum_insert(packet_hdr(pkt_table[i]),
+					  &pktio_entry->s.config.pktout);
+}
+
 int odp_pktio_config(odp_pktio_t hdl, const odp_pktio_config_t *config)
 {
 	pktio_entry_t *entry;
@@ -434,6 +451,10 @@ int odp_pktio_config(odp_pktio_t hdl, const odp_pktio_config_t *config)
 
 	entry->s.config = *config;
 
+	entry->s.chksum_insert_ena = config->pktout.bit.ipv4_chksum_ena ||
+				     config->pktout.bit.udp_chksum_ena ||
+				     config->pktout.bit.tcp_chksum_ena;
+
 	if (entry->s.ops->config)
 		res = entry->s.ops->config(entry, config);
 
@@ -717,10 +738,12 @@ int sched_cb_pktin_poll_one(int pktio_index,
 	return num_rx;
 }
 
+/* Returns number of packets received, or <0 when the pktio has been stopped */
 int sched_cb_pktin_poll(int pktio_index, int num_queue, int index[])
 {
 	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
 	int num, idx;
+	int num_pkt = 0;
 	pktio_entry_t *entry;
 	entry = pktio_entry_by_index(pktio_index);
 	int state = entry->s.state;
@@ -750,9 +773,10 @@ int sched_cb_pktin_poll(int pktio_index, int num_queue, int index[])
 
 		q_int = entry->s.in_queue[index[idx]].queue_int;
 		queue_fn->enq_multi(q_int, hdr_tbl, num);
+		num_pkt += num;
 	}
 
-	return 0;
+	return num_pkt;
 }
 
 void sched_cb_pktio_stop_finalize(int pktio_index)
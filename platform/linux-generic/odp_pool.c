@@ -11,14 +11,17 @@
 #include <odp/api/align.h>
 #include <odp/api/ticketlock.h>
 #include <odp/api/system_info.h>
+#include <odp/api/thread.h>
 
 #include <odp_pool_internal.h>
 #include <odp_internal.h>
 #include <odp_buffer_inlines.h>
 #include <odp_packet_internal.h>
+#include <odp_timer_internal.h>
 #include <odp_config_internal.h>
 #include <odp_debug_internal.h>
 #include <odp_ring_internal.h>
+#include <_ishmphy_internal.h>
 
 #include <string.h>
 #include <stdio.h>
@@ -40,8 +43,8 @@
 /* Define a practical limit for contiguous memory allocations */
 #define MAX_SIZE   (10 * 1024 * 1024)
 
-ODP_STATIC_ASSERT(CONFIG_POOL_CACHE_SIZE > (2 * CACHE_BURST),
-		  "cache_burst_size_too_large_compared_to_cache_size");
+ODP_STATIC_ASSERT(CONFIG_POOL_CACHE_SIZE <= CONFIG_POOL_CACHE_MAX_SIZE,
+		  "default_cache_size_too_large");
 
 ODP_STATIC_ASSERT(CONFIG_PACKET_SEG_LEN_MIN >= 256,
 		  "ODP Segment size must be a minimum of 256 bytes");
@@ -51,8 +54,8 @@ ODP_STATIC_ASSERT(CONFIG_PACKET_SEG_SIZE < 0xffff,
 
 /* Thread local variables */
 typedef struct pool_local_t {
-	pool_cache_t *cache[ODP_CONFIG_POOLS];
 	int thr_id;
+	uint32_t numa_node;
 } pool_local_t;
 
 pool_table_t *pool_tbl;
@@ -80,20 +83,6 @@ static inline pool_t *pool_from_buf(odp_buffer_t buf)
 	return buf_hdr->pool_ptr;
 }
 
-static inline odp_buffer_hdr_t *buf_hdr_from_index(pool_t *pool,
-						   uint32_t buffer_idx)
-{
-	uint32_t block_offset;
-	odp_buffer_hdr_t *buf_hdr;
-
-	block_offset = buffer_idx * pool->block_size;
-
-	/* clang requires cast to uintptr_t */
-	buf_hdr = (odp_buffer_hdr_t *)(uintptr_t)&pool->base_addr[block_offset];
-
-	return buf_hdr;
-}
-
 int odp_pool_init_global(void)
 {
 	uint32_t i;
@@ -155,35 +144,73 @@ int odp_pool_term_global(void)
 
 int odp_pool_init_local(void)
 {
-	pool_t *pool;
-	int i;
-	int thr_id = odp_thread_id();
-
 	memset(&local, 0, sizeof(pool_local_t));
 
-	for (i = 0; i < ODP_CONFIG_POOLS; i++) {
-		pool           = pool_entry(i);
-		local.cache[i] = &pool->local_cache[thr_id];
-		local.cache[i]->num = 0;
+	/* Pool caches are allocated at pool create. A cache is left empty
+	 * when its previous owner thread exits (odp_pool_term_local). */
+	local.thr_id = odp_thread_id();
+	local.numa_node = _odp_numa_node_self();
+	return 0;
+}
+
+/* Dequeue up to 'num' buffer indexes from the pool. With per NUMA node rings,
+ * the ring of the local node is tried first and other rings only when less
+ * than 'min_num' indexes were found. */
+static inline uint32_t pool_ring_deq_multi(pool_t *pool, uint32_t data[],
+					   uint32_t num, uint32_t min_num)
+{
+	uint32_t mask, node, i, num_deq;
+
+	mask = pool->ring_mask;
+
+	if (odp_likely(pool->num_rings == 1))
+		return ring_deq_multi(&pool->ring->hdr, mask, data, num);
+
+	node    = local.numa_node % pool->num_rings;
+	num_deq = ring_deq_multi(&pool_ring(pool, node)->hdr, mask, data,
+				 num);
+
+	for (i = 1; num_deq < min_num && i < pool->num_rings; i++) {
+		node = (node + 1) % pool->num_rings;
+		num_deq += ring_deq_multi(&pool_ring(pool, node)->hdr, mask,
+					  &data[num_deq], min_num - num_deq);
 	}
 
-	local.thr_id = thr_id;
-	return 0;
+	return num_deq;
 }
 
-static void flush_cache(pool_cache_t *cache, pool_t *pool)
+/* Enqueue buffer indexes to the pool. With per NUMA node rings, each index
+ * returns to the ring of its home node. */
+static inline void pool_ring_enq_multi(pool_t *pool, uint32_t data[],
+				       uint32_t num)
 {
-	ring_t *ring;
-	uint32_t mask;
-	uint32_t cache_num, i;
+	uint32_t mask, node, i, first;
 
-	ring = &pool->ring->hdr;
 	mask = pool->ring_mask;
-	cache_num = cache->num;
 
-	for (i = 0; i < cache_num; i++)
-		ring_enq(ring, mask, cache->buf_index[i]);
+	if (odp_likely(pool->num_rings == 1)) {
+		ring_enq_multi(&pool->ring->hdr, mask, data, num);
+		return;
+	}
+
+	/* Enqueue runs of indexes with the same home node */
+	first = 0;
+	while (first < num) {
+		node = data[first] / pool->node_blocks;
+
+		for (i = first + 1; i < num; i++)
+			if (data[i] / pool->node_blocks != node)
+				break;
+
+		ring_enq_multi(&pool_ring(pool, node)->hdr, mask, &data[first],
+			       i - first);
+		first = i;
+	}
+}
 
+static void flush_cache(pool_cache_t *cache, pool_t *pool)
+{
+	pool_ring_enq_multi(pool, cache->buf_index, cache->num);
 	cache->num = 0;
 }
 
@@ -194,18 +221,38 @@ int odp_pool_term_local(void)
 	for (i = 0; i < ODP_CONFIG_POOLS; i++) {
 		pool_t *pool = pool_entry(i);
 
-		flush_cache(local.cache[i], pool);
+		LOCK(&pool->lock);
+		if (pool->reserved && pool->local_cache)
+			flush_cache(pool_local_cache(pool, local.thr_id), pool);
+		UNLOCK(&pool->lock);
 	}
 
 	return 0;
 }
 
-static pool_t *reserve_pool(void)
+/* Reserve a pool and its rings. The rings and the per thread caches share one
+ * shm block, which is sized by the number of buffers, the cache size and the
+ * maximum number of threads. */
+static pool_t *reserve_pool(uint32_t ring_size, uint32_t num_rings,
+			    uint32_t cache_size)
 {
 	int i;
+	uint32_t t, num_cache, cache_stride, cache_burst;
+	uint64_t ring_len;
 	pool_t *pool;
 	char ring_name[ODP_POOL_NAME_LEN];
 
+	num_cache    = odp_thread_count_max();
+	cache_stride = ROUNDUP_CACHE_LINE(sizeof(pool_cache_t) +
+					  cache_size * sizeof(uint32_t));
+	ring_len     = ROUNDUP_CACHE_LINE(sizeof(pool_ring_t) +
+					  ring_size * sizeof(uint32_t));
+	/* Burst transfers between cache and ring must not exceed half of
+	 * the cache size */
+	cache_burst  = CACHE_BURST;
+	if (cache_size / 2 < cache_burst)
+		cache_burst = cache_size / 2;
+
 	for (i = 0; i < ODP_CONFIG_POOLS; i++) {
 		pool = pool_entry(i);
 
@@ -216,7 +263,9 @@ static pool_t *reserve_pool(void)
 			sprintf(ring_name, "pool_ring_%d", i);
 			pool->ring_shm =
 				odp_shm_reserve(ring_name,
-						sizeof(pool_ring_t),
+						num_rings * ring_len +
+						(uint64_t)num_cache *
+						cache_stride,
 						ODP_CACHE_LINE_SIZE, 0);
 			if (odp_unlikely(pool->ring_shm == ODP_SHM_INVALID)) {
 				ODP_ERR("Unable to alloc pool ring %d\n", i);
@@ -226,6 +275,18 @@ static pool_t *reserve_pool(void)
 				break;
 			}
 			pool->ring = odp_shm_addr(pool->ring_shm);
+			pool->ring_stride  = ring_len;
+			pool->num_rings    = num_rings;
+			pool->local_cache  = (uint8_t *)pool->ring +
+					     num_rings * ring_len;
+			pool->cache_size   = cache_size;
+			pool->cache_stride = cache_stride;
+			pool->cache_burst  = cache_burst;
+			pool->num_cache    = num_cache;
+
+			for (t = 0; t < num_cache; t++)
+				pool_local_cache(pool, t)->num = 0;
+
 			return pool;
 		}
 		UNLOCK(&pool->lock);
@@ -234,18 +295,38 @@ static pool_t *reserve_pool(void)
 	return NULL;
 }
 
+/* Buffer and timeout pools do not use the packet header layout. Their header
+ * is followed by the burst table, and the table by the data. */
+static inline uint32_t buf_burst_offset(int type)
+{
+	if (type == ODP_POOL_TIMEOUT)
+		return sizeof(odp_timeout_hdr_t);
+
+	return sizeof(odp_buffer_hdr_t);
+}
+
+static inline uint32_t pool_hdr_size(int type)
+{
+	if (type == ODP_POOL_PACKET)
+		return sizeof(odp_packet_hdr_t);
+
+	return buf_burst_offset(type) +
+	       BUFFER_BURST_SIZE * sizeof(odp_buffer_hdr_t *);
+}
+
 static void init_buffers(pool_t *pool)
 {
 	uint32_t i;
 	odp_buffer_hdr_t *buf_hdr;
 	odp_packet_hdr_t *pkt_hdr;
+	odp_buffer_hdr_t **burst;
 	odp_shm_info_t shm_info;
 	void *addr;
 	void *uarea = NULL;
 	uint8_t *data;
 	uint32_t offset;
 	ring_t *ring;
-	uint32_t mask;
+	uint32_t mask, n;
 	int type;
 	uint64_t page_size;
 	int skipped_blocks = 0;
@@ -254,10 +335,12 @@ static void init_buffers(pool_t *pool)
 		ODP_ABORT("Shm info failed\n");
 
 	page_size = shm_info.page_size;
-	ring = &pool->ring->hdr;
 	mask = pool->ring_mask;
 	type = pool->params.type;
 
+	for (n = 0; n < pool->num_rings; n++)
+		ring_init(&pool_ring(pool, n)->hdr);
+
 	for (i = 0; i < pool->num + skipped_blocks ; i++) {
 		addr    = &pool->base_addr[i * pool->block_size];
 		buf_hdr = addr;
@@ -282,10 +365,14 @@ static void init_buffers(pool_t *pool)
 		if (pool->uarea_size)
 			uarea = &pool->uarea_base_addr[(i - skipped_blocks) *
 						       pool->uarea_size];
-		data = buf_hdr->data;
-
-		if (type == ODP_POOL_PACKET)
-			data = pkt_hdr->data;
+		if (type == ODP_POOL_PACKET) {
+			burst = pkt_hdr->burst;
+			data  = pkt_hdr->data;
+		} else {
+			burst = (odp_buffer_hdr_t **)(uintptr_t)
+				((uint8_t *)addr + buf_burst_offset(type));
+			data  = (uint8_t *)&burst[BUFFER_BURST_SIZE];
+		}
 
 		offset = pool->headroom;
 
@@ -300,25 +387,30 @@ static void init_buffers(pool_t *pool)
 		buf_hdr->type = type;
 		buf_hdr->event_type = type;
 		buf_hdr->pool_ptr = pool;
-		buf_hdr->uarea_addr = uarea;
+		buf_hdr->burst    = burst;
 		buf_hdr->segcount = 1;
 		buf_hdr->num_seg  = 1;
 		buf_hdr->next_seg = NULL;
 		buf_hdr->last_seg = buf_hdr;
-
-		/* Pointer to data start (of the first segment) */
-		buf_hdr->seg[0].hdr       = buf_hdr;
-		buf_hdr->seg[0].data      = &data[offset];
-		buf_hdr->seg[0].len       = pool->seg_len;
+		buf_hdr->base_data = &data[offset];
 
 		odp_atomic_init_u32(&buf_hdr->ref_cnt, 0);
 
-		/* Store base values for fast init */
-		buf_hdr->base_data = buf_hdr->seg[0].data;
-		buf_hdr->buf_end   = &data[offset + pool->seg_len +
-				     pool->tailroom];
+		if (type == ODP_POOL_PACKET) {
+			pkt_hdr->uarea_addr = uarea;
+
+			/* Pointer to data start (of the first segment) */
+			pkt_hdr->seg[0].hdr  = buf_hdr;
+			pkt_hdr->seg[0].data = &data[offset];
+			pkt_hdr->seg[0].len  = pool->seg_len;
+
+			/* Store base values for fast init */
+			pkt_hdr->buf_end = &data[offset + pool->seg_len +
+						 pool->tailroom];
+		}
 
 		/* Store buffer index into the global pool */
+		ring = &pool_ring(pool, i / pool->node_blocks)->hdr;
 		ring_enq(ring, mask, i);
 	}
 }
@@ -339,6 +431,49 @@ static bool shm_is_from_huge_pages(odp_shm_t shm)
 	return (info.page_size >= huge_page_size);
 }
 
+/* Set preferred NUMA nodes of pool memory before it is first touched */
+static void pool_numa_bind(pool_t *pool)
+{
+	odp_shm_info_t info;
+	uint64_t offset, len;
+	uint32_t n;
+	int node = pool->params.numa.node;
+
+	if (pool->num_rings > 1) {
+		if (odp_shm_info(pool->shm, &info))
+			return;
+
+		for (n = 0; n < pool->num_rings; n++) {
+			offset = (uint64_t)n * pool->node_blocks *
+				 pool->block_size;
+			len    = (uint64_t)pool->node_blocks * pool->block_size;
+			if (offset >= pool->shm_size)
+				break;
+			if (offset + len > pool->shm_size)
+				len = pool->shm_size - offset;
+
+			_odp_ishmphy_numa_bind(&pool->base_addr[offset], len,
+					       info.page_size, n);
+		}
+
+		return;
+	}
+
+	if (node == ODP_POOL_NUMA_ANY || node < 0 ||
+	    node >= _odp_numa_node_count())
+		return;
+
+	if (odp_shm_info(pool->shm, &info) == 0)
+		_odp_ishmphy_numa_bind(pool->base_addr, pool->shm_size,
+				       info.page_size, node);
+
+	if (pool->uarea_shm != ODP_SHM_INVALID &&
+	    odp_shm_info(pool->uarea_shm, &info) == 0)
+		_odp_ishmphy_numa_bind(pool->uarea_base_addr,
+				       pool->uarea_shm_size, info.page_size,
+				       node);
+}
+
 static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 			      uint32_t shmflags)
 {
@@ -346,8 +481,8 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 	uint32_t uarea_size, headroom, tailroom;
 	odp_shm_t shm;
 	uint32_t seg_len, align, num, hdr_size, block_size;
-	uint32_t max_len;
-	uint32_t ring_size;
+	uint32_t max_len, cache_size;
+	uint32_t ring_size, num_rings, node_blocks;
 	uint32_t num_extra = 0;
 	int name_len;
 	const char *postfix = "_uarea";
@@ -378,6 +513,7 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 	case ODP_POOL_BUFFER:
 		num  = params->buf.num;
 		seg_len = params->buf.size;
+		cache_size = params->buf.cache_size;
 		break;
 
 	case ODP_POOL_PACKET:
@@ -413,10 +549,12 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 		tailroom    = CONFIG_PACKET_TAILROOM;
 		num         = params->pkt.num;
 		uarea_size  = params->pkt.uarea_size;
+		cache_size  = params->pkt.cache_size;
 		break;
 
 	case ODP_POOL_TIMEOUT:
 		num = params->tmo.num;
+		cache_size = params->tmo.cache_size;
 		break;
 
 	default:
@@ -427,7 +565,40 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 	if (uarea_size)
 		uarea_size = ROUNDUP_CACHE_LINE(uarea_size);
 
-	pool = reserve_pool();
+	hdr_size = pool_hdr_size(params->type);
+	hdr_size = ROUNDUP_CACHE_LINE(hdr_size);
+
+	block_size = ROUNDUP_CACHE_LINE(hdr_size + align + headroom + seg_len +
+					tailroom);
+
+	/* Allocate extra memory for skipping packet buffers which cross huge
+	 * page boundaries. */
+	if (params->type == ODP_POOL_PACKET) {
+		num_extra = (((uint64_t)(num * block_size) +
+				FIRST_HP_SIZE - 1) / FIRST_HP_SIZE);
+		num_extra += (((uint64_t)(num_extra * block_size) +
+				FIRST_HP_SIZE - 1) / FIRST_HP_SIZE);
+	}
+
+	/* With per NUMA node partitions, buffer blocks are split evenly
+	 * between the nodes, each partition having its own ring. */
+	num_rings = 1;
+	if (params->numa.per_node) {
+		num_rings = _odp_numa_node_count();
+		if (num_rings > CONFIG_NUMA_NODES_MAX)
+			num_rings = CONFIG_NUMA_NODES_MAX;
+	}
+
+	node_blocks = num + num_extra;
+	if (num_rings > 1)
+		node_blocks = (num + num_extra + num_rings - 1) / num_rings;
+
+	if (node_blocks <= RING_SIZE_MIN)
+		ring_size = RING_SIZE_MIN;
+	else
+		ring_size = ROUNDUP_POWER2_U32(node_blocks);
+
+	pool = reserve_pool(ring_size, num_rings, cache_size);
 
 	if (pool == NULL) {
 		ODP_ERR("No more free pools");
@@ -448,27 +619,8 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 
 	pool->params = *params;
 
-	hdr_size = sizeof(odp_packet_hdr_t);
-	hdr_size = ROUNDUP_CACHE_LINE(hdr_size);
-
-	block_size = ROUNDUP_CACHE_LINE(hdr_size + align + headroom + seg_len +
-					tailroom);
-
-	/* Allocate extra memory for skipping packet buffers which cross huge
-	 * page boundaries. */
-	if (params->type == ODP_POOL_PACKET) {
-		num_extra = (((uint64_t)(num * block_size) +
-				FIRST_HP_SIZE - 1) / FIRST_HP_SIZE);
-		num_extra += (((uint64_t)(num_extra * block_size) +
-				FIRST_HP_SIZE - 1) / FIRST_HP_SIZE);
-	}
-
-	if (num <= RING_SIZE_MIN)
-		ring_size = RING_SIZE_MIN;
-	else
-		ring_size = ROUNDUP_POWER2_U32(num);
-
 	pool->ring_mask      = ring_size - 1;
+	pool->node_blocks    = node_blocks;
 	pool->num            = num;
 	pool->align          = align;
 	pool->headroom       = headroom;
@@ -512,7 +664,7 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 		pool->uarea_base_addr = odp_shm_addr(pool->uarea_shm);
 	}
 
-	ring_init(&pool->ring->hdr);
+	pool_numa_bind(pool);
 	init_buffers(pool);
 
 	return pool->pool_hdl;
@@ -524,6 +676,10 @@ error:
 	if (pool->uarea_shm != ODP_SHM_INVALID)
 		odp_shm_free(pool->uarea_shm);
 
+	odp_shm_free(pool->ring_shm);
+	pool->ring = NULL;
+	pool->local_cache = NULL;
+
 	LOCK(&pool->lock);
 	pool->reserved = 0;
 	UNLOCK(&pool->lock);
@@ -554,6 +710,12 @@ static int check_params(odp_pool_param_t *params)
 			return -1;
 		}
 
+		if (params->buf.cache_size > capa.buf.max_cache_size) {
+			ODP_DBG("buf.cache_size too large %u\n",
+				params->buf.cache_size);
+			return -1;
+		}
+
 		break;
 
 	case ODP_POOL_PACKET:
@@ -580,6 +742,12 @@ static int check_params(odp_pool_param_t *params)
 			return -1;
 		}
 
+		if (params->pkt.cache_size > capa.pkt.max_cache_size) {
+			ODP_DBG("pkt.cache_size too large %u\n",
+				params->pkt.cache_size);
+			return -1;
+		}
+
 		break;
 
 	case ODP_POOL_TIMEOUT:
@@ -587,6 +755,12 @@ static int check_params(odp_pool_param_t *params)
 			ODP_DBG("tmo.num too large %u\n", params->tmo.num);
 			return -1;
 		}
+
+		if (params->tmo.cache_size > capa.tmo.max_cache_size) {
+			ODP_DBG("tmo.cache_size too large %u\n",
+				params->tmo.cache_size);
+			return -1;
+		}
 		break;
 
 	default:
@@ -613,7 +787,7 @@ odp_pool_t odp_pool_create(const char *name, odp_pool_param_t *params)
 int odp_pool_destroy(odp_pool_t pool_hdl)
 {
 	pool_t *pool = pool_entry_from_hdl(pool_hdl);
-	int i;
+	uint32_t i;
 
 	if (pool == NULL)
 		return -1;
@@ -634,8 +808,8 @@ int odp_pool_destroy(odp_pool_t pool_hdl)
 	}
 
 	/* Make sure local caches are empty */
-	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
-		flush_cache(&pool->local_cache[i], pool);
+	for (i = 0; i < pool->num_cache; i++)
+		flush_cache(pool_local_cache(pool, i), pool);
 
 	odp_shm_free(pool->shm);
 
@@ -645,6 +819,7 @@ int odp_pool_destroy(odp_pool_t pool_hdl)
 	pool->reserved = 0;
 	odp_shm_free(pool->ring_shm);
 	pool->ring = NULL;
+	pool->local_cache = NULL;
 	UNLOCK(&pool->lock);
 
 	return 0;
@@ -701,25 +876,24 @@ int odp_pool_info(odp_pool_t pool_hdl, odp_pool_info_t *info)
 
 int buffer_alloc_multi(pool_t *pool, odp_buffer_hdr_t *buf_hdr[], int max_num)
 {
-	ring_t *ring;
-	uint32_t mask, i;
+	uint32_t i;
 	pool_cache_t *cache;
 	uint32_t cache_num, num_ch, num_deq, burst;
 	odp_buffer_hdr_t *hdr;
 
-	cache = local.cache[pool->pool_idx];
+	cache = pool_local_cache(pool, local.thr_id);
 
 	cache_num = cache->num;
 	num_ch    = max_num;
 	num_deq   = 0;
-	burst     = CACHE_BURST;
+	burst     = pool->cache_burst;
 
 	if (odp_unlikely(cache_num < (uint32_t)max_num)) {
 		/* Cache does not have enough buffers */
 		num_ch  = cache_num;
 		num_deq = max_num - cache_num;
 
-		if (odp_unlikely(num_deq > CACHE_BURST))
+		if (odp_unlikely(num_deq > burst))
 			burst = num_deq;
 	}
 
@@ -736,9 +910,7 @@ int buffer_alloc_multi(pool_t *pool, odp_buffer_hdr_t *buf_hdr[], int max_num)
 		 * and not uint32_t. */
 		uint32_t data[burst];
 
-		ring      = &pool->ring->hdr;
-		mask      = pool->ring_mask;
-		burst     = ring_deq_multi(ring, mask, data, burst);
+		burst     = pool_ring_deq_multi(pool, data, burst, num_deq);
 		cache_num = burst - num_deq;
 
 		if (odp_unlikely(burst < num_deq)) {
@@ -770,24 +942,20 @@ static inline void buffer_free_to_pool(pool_t *pool,
 				       odp_buffer_hdr_t *buf_hdr[], int num)
 {
 	int i;
-	ring_t *ring;
-	uint32_t mask;
 	pool_cache_t *cache;
 	uint32_t cache_num;
 
-	cache = local.cache[pool->pool_idx];
+	cache = pool_local_cache(pool, local.thr_id);
 
 	/* Special case of a very large free. Move directly to
 	 * the global pool. */
-	if (odp_unlikely(num > CONFIG_POOL_CACHE_SIZE)) {
+	if (odp_unlikely((uint32_t)num > pool->cache_size)) {
 		uint32_t buf_index[num];
 
-		ring  = &pool->ring->hdr;
-		mask  = pool->ring_mask;
 		for (i = 0; i < num; i++)
 			buf_index[i] = buf_hdr[i]->index;
 
-		ring_enq_multi(ring, mask, buf_index, num);
+		pool_ring_enq_multi(pool, buf_index, num);
 
 		return;
 	}
@@ -796,16 +964,13 @@ static inline void buffer_free_to_pool(pool_t *pool,
 	 * transfer. */
 	cache_num = cache->num;
 
-	if (odp_unlikely((int)(CONFIG_POOL_CACHE_SIZE - cache_num) < num)) {
+	if (odp_unlikely((int)(pool->cache_size - cache_num) < num)) {
 		uint32_t index;
-		int burst = CACHE_BURST;
+		int burst = pool->cache_burst;
 
-		ring  = &pool->ring->hdr;
-		mask  = pool->ring_mask;
-
-		if (odp_unlikely(num > CACHE_BURST))
+		if (odp_unlikely(num > burst))
 			burst = num;
-		if (odp_unlikely((uint32_t)num > cache_num))
+		if (odp_unlikely(burst > (int)cache_num))
 			burst = cache_num;
 
 		{
@@ -818,7 +983,7 @@ static inline void buffer_free_to_pool(pool_t *pool,
 			for (i = 0; i < burst; i++)
 				data[i] = cache->buf_index[index + i];
 
-			ring_enq_multi(ring, mask, data, burst);
+			pool_ring_enq_multi(pool, data, burst);
 		}
 
 		cache_num -= burst;
@@ -911,6 +1076,8 @@ int odp_pool_capability(odp_pool_capability_t *capa)
 	capa->buf.max_align = ODP_CONFIG_BUFFER_ALIGN_MAX;
 	capa->buf.max_size  = MAX_SIZE;
 	capa->buf.max_num   = CONFIG_POOL_MAX_NUM;
+	capa->buf.min_cache_size = 0;
+	capa->buf.max_cache_size = CONFIG_POOL_CACHE_MAX_SIZE;
 
 	/* Packet pools */
 	capa->pkt.max_pools        = ODP_CONFIG_POOLS;
@@ -923,10 +1090,14 @@ int odp_pool_capability(odp_pool_capability_t *capa)
 	capa->pkt.min_seg_len      = CONFIG_PACKET_SEG_LEN_MIN;
 	capa->pkt.max_seg_len      = max_seg_len;
 	capa->pkt.max_uarea_size   = MAX_SIZE;
+	capa->pkt.min_cache_size   = 0;
+	capa->pkt.max_cache_size   = CONFIG_POOL_CACHE_MAX_SIZE;
 
 	/* Timeout pools */
 	capa->tmo.max_pools = ODP_CONFIG_POOLS;
 	capa->tmo.max_num   = CONFIG_POOL_MAX_NUM;
+	capa->tmo.min_cache_size = 0;
+	capa->tmo.max_cache_size = CONFIG_POOL_CACHE_MAX_SIZE;
 
 	return 0;
 }
@@ -934,6 +1105,8 @@ int odp_pool_capability(odp_pool_capability_t *capa)
 void odp_pool_print(odp_pool_t pool_hdl)
 {
 	pool_t *pool;
+	ring_t *ring;
+	uint32_t i;
 
 	pool = pool_entry_from_hdl(pool_hdl);
 
@@ -963,6 +1136,14 @@ void odp_pool_print(odp_pool_t pool_hdl)
 	ODP_PRINT("  base addr       %p\n", pool->base_addr);
 	ODP_PRINT("  uarea shm size  %u\n", pool->uarea_shm_size);
 	ODP_PRINT("  uarea base addr %p\n", pool->uarea_base_addr);
+	ODP_PRINT("  ring size       %u\n", pool->ring_mask + 1);
+	for (i = 0; i < pool->num_rings; i++) {
+		ring = &pool_ring(pool, i)->hdr;
+		ODP_PRINT("  node %u ring     %u buffers\n", i,
+			  odp_atomic_load_u32(&ring->w_tail) -
+			  odp_atomic_load_u32(&ring->r_tail));
+	}
+	ODP_PRINT("  cache size      %u\n", pool->cache_size);
 	ODP_PRINT("\n");
 }
 
@@ -977,6 +1158,10 @@ void odp_pool_param_init(odp_pool_param_t *params)
 {
 	memset(params, 0, sizeof(odp_pool_param_t));
 	params->pkt.headroom = CONFIG_PACKET_HEADROOM;
+	params->buf.cache_size = CONFIG_POOL_CACHE_SIZE;
+	params->pkt.cache_size = CONFIG_POOL_CACHE_SIZE;
+	params->tmo.cache_size = CONFIG_POOL_CACHE_SIZE;
+	params->numa.node = ODP_POOL_NUMA_ANY;
 }
 
 uint64_t odp_pool_to_u64(odp_pool_t hdl)
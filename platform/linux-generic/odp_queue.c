@@ -28,19 +28,46 @@
 
 #define NUM_INTERNAL_QUEUES 64
 
+/* Event handle on a queue ring: pool index and buffer index in the pool */
+#define RING_POOL_SHIFT 24
+#define RING_BUF_MASK   ((1U << RING_POOL_SHIFT) - 1)
+
+ODP_STATIC_ASSERT(CONFIG_POOL_MAX_NUM <= (1U << RING_POOL_SHIFT),
+		  "CONFIG_POOL_MAX_NUM too large for queue ring");
+ODP_STATIC_ASSERT(ODP_CONFIG_POOLS <= (1U << (32 - RING_POOL_SHIFT)),
+		  "ODP_CONFIG_POOLS too large for queue ring");
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(CONFIG_QUEUE_RING_SIZE),
+		  "CONFIG_QUEUE_RING_SIZE is not a power of two");
+
 #include <odp/api/plat/ticketlock_inlines.h>
 #define LOCK(a)      _odp_ticketlock_lock(a)
 #define UNLOCK(a)    _odp_ticketlock_unlock(a)
 #define LOCK_INIT(a) odp_ticketlock_init(a)
 
 #include <string.h>
+#include <stdlib.h>
 #include <inttypes.h>
 
+/* Statistics are counted per thread, compiled out when disabled */
+#if CONFIG_SCHED_STATS
+#define QUEUE_STAT_ADD(queue, name, val) \
+	((queue)->s.stat[odp_thread_id()].name += (val))
+#else
+#define QUEUE_STAT_ADD(queue, name, val) ((void)0)
+#endif
+
 static int queue_init(queue_entry_t *queue, const char *name,
 		      const odp_queue_param_t *param);
 
 typedef struct queue_table_t {
 	queue_entry_t  queue[ODP_CONFIG_QUEUES];
+
+	/* Ring storage of all queues. Each queue has a ring header followed
+	 * by ring_size event handles. */
+	odp_shm_t      ring_shm;
+	uint8_t       *ring_mem;
+	uint32_t       ring_size;
+	uint32_t       ring_len;
 } queue_table_t;
 
 static queue_table_t *queue_tbl;
@@ -67,9 +94,57 @@ queue_entry_t *get_qentry(uint32_t queue_id)
 	return &queue_tbl->queue[queue_id];
 }
 
+static inline uint32_t buf_hdr_to_ring(odp_buffer_hdr_t *buf_hdr)
+{
+	pool_t *pool = buf_hdr->pool_ptr;
+
+	return (pool->pool_idx << RING_POOL_SHIFT) | buf_hdr->index;
+}
+
+static inline odp_buffer_hdr_t *buf_hdr_from_ring(uint32_t data)
+{
+	pool_t *pool = pool_entry(data >> RING_POOL_SHIFT);
+
+	return buf_hdr_from_index(pool, data & RING_BUF_MASK);
+}
+
+static inline ring_t *queue_ring(uint32_t queue_id)
+{
+	return (ring_t *)(uintptr_t)(queue_tbl->ring_mem +
+				     (uint64_t)queue_id * queue_tbl->ring_len);
+}
+
+static inline int queue_is_empty(queue_entry_t *queue)
+{
+	if (queue->s.ring)
+		return ring_is_empty(queue->s.ring);
+
+	return queue->s.head == NULL;
+}
+
+/* Ring size from ODP_QUEUE_RING_SIZE, or the default */
+static uint32_t queue_ring_size(void)
+{
+	const char *env = getenv("ODP_QUEUE_RING_SIZE");
+	int val;
+
+	if (env == NULL)
+		return CONFIG_QUEUE_RING_SIZE;
+
+	val = atoi(env);
+
+	if (val < 1 || val > CONFIG_QUEUE_MAX_RING_SIZE ||
+	    !CHECK_IS_POWER2(val)) {
+		ODP_ERR("Bad ODP_QUEUE_RING_SIZE value: %s\n", env);
+		return CONFIG_QUEUE_RING_SIZE;
+	}
+
+	return val;
+}
+
 static int queue_init_global(void)
 {
-	uint32_t i;
+	uint32_t i, ring_size, ring_len;
 	odp_shm_t shm;
 
 	ODP_DBG("Queue init ... ");
@@ -85,6 +160,24 @@ static int queue_init_global(void)
 
 	memset(queue_tbl, 0, sizeof(queue_table_t));
 
+	ring_size = queue_ring_size();
+	ring_len  = ROUNDUP_CACHE_LINE(sizeof(ring_t) +
+				       ring_size * sizeof(uint32_t));
+
+	shm = odp_shm_reserve("odp_queue_rings",
+			      (uint64_t)ODP_CONFIG_QUEUES * ring_len,
+			      ODP_CACHE_LINE_SIZE, 0);
+
+	if (shm == ODP_SHM_INVALID) {
+		odp_shm_free(odp_shm_lookup("odp_queues"));
+		return -1;
+	}
+
+	queue_tbl->ring_shm  = shm;
+	queue_tbl->ring_mem  = odp_shm_addr(shm);
+	queue_tbl->ring_size = ring_size;
+	queue_tbl->ring_len  = ring_len;
+
 	for (i = 0; i < ODP_CONFIG_QUEUES; i++) {
 		/* init locks */
 		queue_entry_t *queue = get_qentry(i);
@@ -99,6 +192,7 @@ static int queue_init_global(void)
 		sizeof(struct queue_entry_s));
 	ODP_DBG("  queue_entry_t size        %zu\n",
 		sizeof(queue_entry_t));
+	ODP_DBG("  queue ring size           %" PRIu32 "\n", ring_size);
 	ODP_DBG("\n");
 
 	return 0;
@@ -131,6 +225,12 @@ static int queue_term_global(void)
 		UNLOCK(&queue->s.lock);
 	}
 
+	ret = odp_shm_free(queue_tbl->ring_shm);
+	if (ret < 0) {
+		ODP_ERR("shm free failed for odp_queue_rings");
+		rc = -1;
+	}
+
 	ret = odp_shm_free(odp_shm_lookup("odp_queues"));
 	if (ret < 0) {
 		ODP_ERR("shm free failed for odp_queues");
@@ -150,8 +250,10 @@ static int queue_capability(odp_queue_capability_t *capa)
 	capa->max_sched_groups  = sched_fn->num_grps();
 	capa->sched_prios       = odp_schedule_num_prio();
 	capa->plain.max_num     = capa->max_queues;
+	capa->plain.max_size    = queue_tbl->ring_size;
 	capa->plain.nonblocking = ODP_BLOCKING;
 	capa->sched.max_num     = capa->max_queues;
+	capa->sched.max_size    = queue_tbl->ring_size;
 	capa->sched.nonblocking = ODP_BLOCKING;
 
 	return 0;
@@ -270,7 +372,7 @@ static int queue_destroy(odp_queue_t handle)
 		ODP_ERR("queue \"%s\" already destroyed\n", queue->s.name);
 		return -1;
 	}
-	if (queue->s.head != NULL) {
+	if (!queue_is_empty(queue)) {
 		UNLOCK(&queue->s.lock);
 		ODP_ERR("queue \"%s\" not empty\n", queue->s.name);
 		return -1;
@@ -333,6 +435,150 @@ static odp_queue_t queue_lookup(const char *name)
 	return ODP_QUEUE_INVALID;
 }
 
+static inline int enq_multi_ring(queue_t q_int, odp_buffer_hdr_t *buf_hdr[],
+				 int num)
+{
+	uint32_t data[QUEUE_MULTI_MAX];
+	queue_entry_t *queue;
+	int sched = 0;
+	int num_enq = 0;
+	int i, ret;
+
+	queue = qentry_from_int(q_int);
+	if (sched_fn->ord_enq_multi(q_int, (void **)buf_hdr, num, &ret))
+		return ret;
+
+	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
+		ODP_ERR("Bad queue status\n");
+		return -1;
+	}
+
+	while (num_enq < num) {
+		int burst = num - num_enq;
+		int n;
+
+		if (burst > QUEUE_MULTI_MAX)
+			burst = QUEUE_MULTI_MAX;
+
+		for (i = 0; i < burst; i++)
+			data[i] = buf_hdr_to_ring(buf_hdr[num_enq + i]);
+
+		n = ring_enq_multi_bounded(queue->s.ring, queue->s.ring_mask,
+					   data, burst);
+		num_enq += n;
+
+		/* Queue full */
+		if (n < burst)
+			break;
+	}
+
+	QUEUE_STAT_ADD(queue, enq, num_enq);
+	QUEUE_STAT_ADD(queue, enq_fail, num - num_enq);
+
+	if (odp_unlikely(num_enq == 0))
+		return 0;
+
+	if (queue->s.type != ODP_QUEUE_TYPE_SCHED)
+		return num_enq;
+
+	/* Order the ring write before the status read. Pairs with the barrier
+	 * in deq_multi_ring(). */
+	odp_mb_full();
+
+	/* Lock only when the queue needs to be added to scheduling */
+	if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
+		LOCK(&queue->s.lock);
+		if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
+			queue->s.status = QUEUE_STATUS_SCHED;
+			sched = 1; /* retval: schedule queue */
+		}
+		UNLOCK(&queue->s.lock);
+	}
+
+	/* Add queue to scheduling */
+	if (sched && sched_fn->sched_queue(queue->s.index))
+		ODP_ABORT("schedule_queue failed\n");
+
+	return num_enq;
+}
+
+static inline int deq_multi_ring(queue_entry_t *queue,
+				 odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	uint32_t data[QUEUE_MULTI_MAX];
+	int status_sync = sched_fn->status_sync;
+	int sched = queue->s.type == ODP_QUEUE_TYPE_SCHED;
+	int locked = status_sync && sched;
+	int i, ret;
+
+	if (num > QUEUE_MULTI_MAX)
+		num = QUEUE_MULTI_MAX;
+
+	/* Scheduler context must be saved atomically with the dequeue */
+	if (locked)
+		LOCK(&queue->s.lock);
+
+	while (1) {
+		if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
+			/* Bad queue, or queue has been destroyed.
+			 * Scheduler finalizes queue destroy after this. */
+			ret = -1;
+			break;
+		}
+
+		ret = ring_deq_multi(queue->s.ring, queue->s.ring_mask, data,
+				     num);
+
+		if (ret) {
+			for (i = 0; i < ret; i++) {
+				buf_hdr[i] = buf_hdr_from_ring(data[i]);
+				odp_prefetch(buf_hdr[i]);
+			}
+
+			if (locked)
+				sched_fn->save_context(queue->s.index);
+			break;
+		}
+
+		if (!sched || queue->s.status != QUEUE_STATUS_SCHED)
+			break;
+
+		/* Empty scheduled queue, remove it from scheduling unless an
+		 * enqueue raced with us */
+		if (!locked)
+			LOCK(&queue->s.lock);
+
+		queue->s.status = QUEUE_STATUS_NOTSCHED;
+
+		/* Pairs with the barrier in enq_multi_ring() */
+		odp_mb_full();
+
+		if (ring_is_empty(queue->s.ring)) {
+			if (status_sync)
+				sched_fn->unsched_queue(queue->s.index);
+			if (!locked)
+				UNLOCK(&queue->s.lock);
+			break;
+		}
+
+		/* Events arrived meanwhile. Enqueuer may have seen the queue
+		 * in scheduling, so keep it there and try again. */
+		queue->s.status = QUEUE_STATUS_SCHED;
+		if (!locked)
+			UNLOCK(&queue->s.lock);
+	}
+
+	if (locked)
+		UNLOCK(&queue->s.lock);
+
+	if (ret > 0)
+		QUEUE_STAT_ADD(queue, deq, ret);
+	else if (ret == 0)
+		QUEUE_STAT_ADD(queue, deq_empty, 1);
+
+	return ret;
+}
+
 static inline int enq_multi(queue_t q_int, odp_buffer_hdr_t *buf_hdr[],
 			    int num)
 {
@@ -342,6 +588,9 @@ static inline int enq_multi(queue_t q_int, odp_buffer_hdr_t *buf_hdr[],
 	odp_buffer_hdr_t *hdr, *tail, *next_hdr;
 
 	queue = qentry_from_int(q_int);
+	if (queue->s.ring)
+		return enq_multi_ring(q_int, buf_hdr, num);
+
 	if (sched_fn->ord_enq_multi(q_int, (void **)buf_hdr, num, &ret))
 		return ret;
 
@@ -403,6 +652,8 @@ static inline int enq_multi(queue_t q_int, odp_buffer_hdr_t *buf_hdr[],
 	}
 	UNLOCK(&queue->s.lock);
 
+	QUEUE_STAT_ADD(queue, enq, num);
+
 	/* Add queue to scheduling */
 	if (sched && sched_fn->sched_queue(queue->s.index))
 		ODP_ABORT("schedule_queue failed\n");
@@ -458,6 +709,9 @@ static inline int deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
 	int updated = 0;
 	int status_sync = sched_fn->status_sync;
 
+	if (queue->s.ring)
+		return deq_multi_ring(queue, buf_hdr, num);
+
 	LOCK(&queue->s.lock);
 	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
 		/* Bad queue, or queue has been destroyed.
@@ -478,6 +732,7 @@ static inline int deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
 		}
 
 		UNLOCK(&queue->s.lock);
+		QUEUE_STAT_ADD(queue, deq_empty, 1);
 		return 0;
 	}
 
@@ -522,6 +777,8 @@ static inline int deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
 
 	UNLOCK(&queue->s.lock);
 
+	QUEUE_STAT_ADD(queue, deq, i);
+
 	return i;
 }
 
@@ -583,11 +840,26 @@ static int queue_init(queue_entry_t *queue, const char *name,
 
 	queue->s.type = queue->s.param.type;
 
+#if CONFIG_SCHED_STATS
+	memset(queue->s.stat, 0, sizeof(queue->s.stat));
+#endif
+
 	queue->s.enqueue = queue_int_enq;
 	queue->s.dequeue = queue_int_deq;
 	queue->s.enqueue_multi = queue_int_enq_multi;
 	queue->s.dequeue_multi = queue_int_deq_multi;
 
+	/* Queues of limited size store events on a ring, others (including
+	 * those too large for a ring) on a list */
+	if (param->size && param->size <= queue_tbl->ring_size) {
+		queue->s.ring = queue_ring(queue->s.index);
+		queue->s.ring_mask = ROUNDUP_POWER2_U32(param->size) - 1;
+		ring_init(queue->s.ring);
+	} else {
+		queue->s.ring = NULL;
+		queue->s.ring_mask = 0;
+	}
+
 	queue->s.pktin = PKTIN_INVALID;
 	queue->s.pktout = PKTOUT_INVALID;
 
@@ -648,6 +920,40 @@ static int queue_info(odp_queue_t handle, odp_queue_info_t *info)
 	return 0;
 }
 
+static int queue_stats(odp_queue_t handle, odp_queue_stats_t *stats)
+{
+#if CONFIG_SCHED_STATS
+	uint32_t queue_id = queue_to_id(handle);
+	queue_entry_t *queue;
+	int i;
+
+	if (odp_unlikely(queue_id >= ODP_CONFIG_QUEUES)) {
+		ODP_ERR("Invalid queue handle:%" PRIu64 "\n",
+			odp_queue_to_u64(handle));
+		return -1;
+	}
+
+	queue = get_qentry(queue_id);
+	memset(stats, 0, sizeof(odp_queue_stats_t));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		queue_stat_t *stat = &queue->s.stat[i];
+
+		stats->enq       += stat->enq;
+		stats->enq_fail  += stat->enq_fail;
+		stats->deq       += stat->deq;
+		stats->deq_empty += stat->deq_empty;
+	}
+
+	return 0;
+#else
+	(void)handle;
+	(void)stats;
+
+	return -1;
+#endif
+}
+
 odp_queue_t sched_cb_queue_handle(uint32_t queue_index)
 {
 	return queue_from_id(queue_index);
@@ -673,7 +979,7 @@ int sched_cb_queue_empty(uint32_t queue_index)
 		return -1;
 	}
 
-	if (queue->s.head == NULL) {
+	if (queue_is_empty(queue)) {
 		/* Already empty queue. Update status. */
 		if (queue->s.status == QUEUE_STATUS_SCHED)
 			queue->s.status = QUEUE_STATUS_NOTSCHED;
@@ -767,7 +1073,8 @@ queue_api_t queue_default_api = {
 	.queue_lock_count = queue_lock_count,
 	.queue_to_u64 = queue_to_u64,
 	.queue_param_init = queue_param_init,
-	.queue_info = queue_info
+	.queue_info = queue_info,
+	.queue_stats = queue_stats
 };
 
 /* Functions towards internal components */
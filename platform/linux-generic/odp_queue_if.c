@@ -111,3 +111,11 @@ int odp_queue_info(odp_queue_t queue, odp_queue_info_t *info)
 {
 	return queue_api->queue_info(queue, info);
 }
+
+int odp_queue_stats(odp_queue_t queue, odp_queue_stats_t *stats)
+{
+	if (queue_api->queue_stats == NULL)
+		return -1;
+
+	return queue_api->queue_stats(queue, stats);
+}
@@ -7,6 +7,9 @@
 #include "config.h"
 
 #include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <stdio.h>
 #include <odp/api/schedule.h>
 #include <odp_schedule_if.h>
 #include <odp/api/align.h>
@@ -25,6 +28,9 @@
 #include <odp/api/packet_io.h>
 #include <odp_ring_internal.h>
 #include <odp_timer_internal.h>
+#include <odp_schedule_idle_internal.h>
+#include <odp_buffer_inlines.h>
+#include <odp/api/plat/packet_inlines.h>
 
 /* Should remove this dependency */
 #include <odp_queue_internal.h>
@@ -40,24 +46,28 @@ ODP_STATIC_ASSERT((ODP_SCHED_PRIO_NORMAL > 0) &&
 		  (ODP_SCHED_PRIO_NORMAL < (NUM_PRIO - 1)),
 		  "normal_prio_is_not_between_highest_and_lowest");
 
-/* Number of scheduling groups */
-#define NUM_SCHED_GRPS 32
+/* Maximum number of scheduling groups */
+#define MAX_SCHED_GRPS 256
 
-/* Priority queues per priority */
-#define QUEUES_PER_PRIO  4
+/* Maximum number of priority queues per priority */
+#define MAX_QUEUES_PER_PRIO 8
 
-/* A thread polls a non preferred sched queue every this many polls
- * of the prefer queue. */
-#define PREFER_RATIO 64
+/* Maximum preferred queue poll ratio */
+#define MAX_PREFER_RATIO 4096
 
-/* Size of poll weight table */
-#define WEIGHT_TBL_SIZE ((QUEUES_PER_PRIO - 1) * PREFER_RATIO)
+/* Maximum ordered stash size */
+#define MAX_ORDERED_STASH (16 * 1024)
 
-/* Packet input poll cmd queues */
-#define PKTIO_CMD_QUEUES  4
+/* Maximum number of reorder contexts per thread */
+#define MAX_REORDER_CTX 32
 
-/* Mask for wrapping command queues */
-#define PKTIO_CMD_QUEUE_MASK (PKTIO_CMD_QUEUES - 1)
+/* Reorder window size of an ordered queue. A context released further than
+ * this from the window head waits for room. Must be a power of two. */
+#define REORDER_WIN_SIZE 64
+#define REORDER_WIN_MASK (REORDER_WIN_SIZE - 1)
+
+/* Maximum number of packet input poll cmd queues */
+#define MAX_PKTIO_CMD_QUEUES 64
 
 /* Maximum number of packet input queues per command */
 #define MAX_PKTIN 16
@@ -77,59 +87,54 @@ ODP_STATIC_ASSERT((ODP_SCHED_PRIO_NORMAL > 0) &&
 /* Pktio command is free */
 #define PKTIO_CMD_FREE    PKTIO_CMD_INVALID
 
-/* Packet IO poll queue ring size. In worst case, all pktios have all pktins
- * enabled and one poll command is created per pktin queue. The ring size must
- * be larger than or equal to NUM_PKTIO_CMD / PKTIO_CMD_QUEUES, so that it can
- * hold all poll commands in the worst case. */
-#define PKTIO_RING_SIZE (NUM_PKTIO_CMD / PKTIO_CMD_QUEUES)
-
-/* Mask for wrapping around pktio poll command index */
-#define PKTIO_RING_MASK (PKTIO_RING_SIZE - 1)
-
-/* Priority queue ring size. In worst case, all event queues are scheduled
- * queues and have the same priority. The ring size must be larger than or
- * equal to ODP_CONFIG_QUEUES / QUEUES_PER_PRIO, so that it can hold all
- * queues in the worst case. */
-#define PRIO_QUEUE_RING_SIZE  (ODP_CONFIG_QUEUES / QUEUES_PER_PRIO)
-
-/* Mask for wrapping around priority queue index */
-#define PRIO_QUEUE_MASK  (PRIO_QUEUE_RING_SIZE - 1)
-
 /* Priority queue empty, not a valid queue index. */
 #define PRIO_QUEUE_EMPTY NULL_INDEX
 
-/* For best performance, the number of queues should be a power of two. */
+/* Priority queue rings hold ODP_CONFIG_QUEUES / queues_per_prio and packet
+ * IO command rings NUM_PKTIO_CMD / pktio_cmd_queues entries, so that those
+ * can hold all queues or poll commands in the worst case. Ring sizes must be
+ * powers of two. Both divisors are powers of two. */
 ODP_STATIC_ASSERT(CHECK_IS_POWER2(ODP_CONFIG_QUEUES),
 		  "Number_of_queues_is_not_power_of_two");
 
-/* Ring size must be power of two, so that MAX_QUEUE_IDX_MASK can be used. */
-ODP_STATIC_ASSERT(CHECK_IS_POWER2(PRIO_QUEUE_RING_SIZE),
-		  "Ring_size_is_not_power_of_two");
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(NUM_PKTIO_CMD) &&
+		  NUM_PKTIO_CMD >= MAX_PKTIO_CMD_QUEUES,
+		  "Number_of_pktio_cmds_is_not_power_of_two");
 
-/* Ring size must be power of two, so that PKTIO_RING_MASK can be used. */
-ODP_STATIC_ASSERT(CHECK_IS_POWER2(PKTIO_RING_SIZE),
-		  "pktio_ring_size_is_not_power_of_two");
-
-/* Number of commands queues must be power of two, so that PKTIO_CMD_QUEUE_MASK
- * can be used. */
-ODP_STATIC_ASSERT(CHECK_IS_POWER2(PKTIO_CMD_QUEUES),
-		  "pktio_cmd_queues_is_not_power_of_two");
+ODP_STATIC_ASSERT(ODP_CONFIG_QUEUES >= MAX_QUEUES_PER_PRIO,
+		  "Too_few_queues");
 
 /* Mask of queues per priority */
 typedef uint8_t pri_mask_t;
 
-ODP_STATIC_ASSERT((8 * sizeof(pri_mask_t)) >= QUEUES_PER_PRIO,
+ODP_STATIC_ASSERT((8 * sizeof(pri_mask_t)) >= MAX_QUEUES_PER_PRIO,
 		  "pri_mask_t_is_too_small");
 
+/* Group and weight tables of a thread store group indexes in uint8_t */
+ODP_STATIC_ASSERT(MAX_SCHED_GRPS <= 256, "Too_many_sched_groups");
+
+/* Weight table size fits into sched_local.round */
+ODP_STATIC_ASSERT((MAX_QUEUES_PER_PRIO - 1) * MAX_PREFER_RATIO <= UINT16_MAX,
+		  "Too_large_weight_table");
+
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(REORDER_WIN_SIZE),
+		  "Reorder_window_size_is_not_power_of_two");
+
+/* Reorder window slots store thread ids in 16 and reorder context indexes
+ * in 8 bits */
+ODP_STATIC_ASSERT(ODP_THREAD_COUNT_MAX <= UINT16_MAX &&
+		  MAX_REORDER_CTX < UINT8_MAX, "Too_many_reorder_contexts");
+
+ODP_STATIC_ASSERT(CONFIG_SCHED_GROUPS > ODP_SCHED_GROUP_CONTROL &&
+		  CONFIG_SCHED_GROUPS <= MAX_SCHED_GRPS,
+		  "Bad_CONFIG_SCHED_GROUPS");
+
 /* Start of named groups in group mask arrays */
 #define SCHED_GROUP_NAMED (ODP_SCHED_GROUP_CONTROL + 1)
 
 /* Maximum number of dequeues */
 #define MAX_DEQ CONFIG_BURST_SIZE
 
-/* Ordered stash size */
-#define MAX_ORDERED_STASH 512
-
 /* Storage for stashed enqueue operation arguments */
 typedef struct {
 	odp_buffer_hdr_t *buf_hdr[QUEUE_MULTI_MAX];
@@ -146,6 +151,59 @@ typedef union {
 ODP_STATIC_ASSERT(sizeof(lock_called_t) == sizeof(uint32_t),
 		  "Lock_called_values_do_not_fit_in_uint32");
 
+/* Reorder context. Enqueue operations stashed in an ordered context. The
+ * context is owned by a thread and freed by the thread that retires the
+ * ordered context. Stash size is set at global init. */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Non-zero while in use */
+	odp_atomic_u32_t busy;
+
+	/* Number of stashed enqueue operations */
+	uint32_t num;
+
+	/* Stashed enqueue operations */
+	ordered_stash_t stash[];
+
+} reorder_ctx_t;
+
+/* Reorder window slot of a context released out of order: valid flag,
+ * ordered lock states, reorder context index and thread id. Zero marks an
+ * empty slot. */
+#define SLOT_VALID     (1ull << 63)
+#define SLOT_RCTX_NONE 0xff
+
+/* Order context head. The oldest context id that has not been retired is
+ * stored in the low and a change indicator in the high 32 bits. */
+#define HC_HEAD(hc)    ((uint32_t)(hc))
+#define HC_CHGI_ONE    (1ull << 32)
+
+/* Reorder statistics of a thread */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Number of ordered contexts released */
+	uint64_t release;
+
+	/* Number of contexts released out of order into a reorder window */
+	uint64_t out_of_order;
+
+	/* Sum and maximum of reorder depths. Depth is the distance to the
+	 * window head on an out of order release. */
+	uint64_t depth;
+	uint64_t depth_max;
+
+	/* Number of contexts of other threads retired */
+	uint64_t retire;
+
+	/* Number of waits for order: packet output, full stash, no free
+	 * reorder context or full reorder window */
+	uint64_t stall;
+
+} reorder_stat_t;
+
+/* Scheduler statistics of a thread */
+typedef struct ODP_ALIGNED_CACHE {
+	odp_schedule_stats_t s;
+} sched_stat_t;
+
 /* Scheduler local data */
 typedef struct {
 	int thr;
@@ -161,38 +219,61 @@ typedef struct {
 		/* Source queue index */
 		uint32_t src_queue;
 		uint64_t ctx; /**< Ordered context id */
-		int stash_num; /**< Number of stashed enqueue operations */
 		uint8_t in_order; /**< Order status */
 		lock_called_t lock_called; /**< States of ordered locks */
-		/** Storage for stashed enqueue operations */
-		ordered_stash_t stash[MAX_ORDERED_STASH];
+		/** Reorder context of stashed enqueue operations, or NULL */
+		reorder_ctx_t *rctx;
+		int rctx_idx; /**< Index of the reorder context */
 	} ordered;
 
+	/* Events pulled ahead by schedule_prefetch(). Events are stored in
+	 * ev_stash. Scheduling context of the source queue is taken into use
+	 * on the next schedule call. */
+	struct {
+		int num;
+		odp_queue_t queue;
+		/* Atomic queue to hold */
+		uint32_t queue_index;
+		/* Ordered queue and context */
+		uint32_t src_queue;
+		uint64_t ctx;
+	} prefetch;
+
 	uint32_t grp_epoch;
 	int num_grp;
-	uint8_t grp[NUM_SCHED_GRPS];
-	uint8_t weight_tbl[WEIGHT_TBL_SIZE];
-	uint8_t grp_weight[WEIGHT_TBL_SIZE];
+	uint8_t grp[MAX_SCHED_GRPS];
+
+	/* Poll weight tables of the thread */
+	uint8_t *weight_tbl;
+	uint8_t *grp_weight;
+
+	/* Statistics of the thread, and start time of the current atomic
+	 * context */
+	odp_schedule_stats_t *stat;
+	uint64_t atomic_ns;
+
+	/* Reorder statistics of the thread */
+	reorder_stat_t *reorder_stat;
 
 } sched_local_t;
 
-/* Priority queue */
+/* Priority queue. Ring size is set at global init. */
 typedef struct ODP_ALIGNED_CACHE {
 	/* Ring header */
 	ring_t ring;
 
 	/* Ring data: queue indexes */
-	uint32_t queue_index[PRIO_QUEUE_RING_SIZE];
+	uint32_t queue_index[];
 
 } prio_queue_t;
 
-/* Packet IO queue */
+/* Packet IO queue. Ring size is set at global init. */
 typedef struct ODP_ALIGNED_CACHE {
 	/* Ring header */
 	ring_t ring;
 
 	/* Ring data: pktio poll command indexes */
-	uint32_t cmd_index[PKTIO_RING_SIZE];
+	uint32_t cmd_index[];
 
 } pktio_queue_t;
 
@@ -206,8 +287,8 @@ typedef struct {
 
 /* Order context of a queue */
 typedef struct ODP_ALIGNED_CACHE {
-	/* Current ordered context id */
-	odp_atomic_u64_t ODP_ALIGNED_CACHE ctx;
+	/* Head and change indicator of the reorder window */
+	odp_atomic_u64_t ODP_ALIGNED_CACHE hc;
 
 	/* Next unallocated context id */
 	odp_atomic_u64_t next_ctx;
@@ -215,26 +296,53 @@ typedef struct ODP_ALIGNED_CACHE {
 	/* Array of ordered locks */
 	odp_atomic_u64_t lock[CONFIG_QUEUE_MAX_ORD_LOCKS];
 
+	/* Reorder window. Contexts released out of order, indexed by context
+	 * id. */
+	odp_atomic_u64_t win[REORDER_WIN_SIZE];
+
 } order_context_t;
 
 typedef struct {
 	pri_mask_t     pri_mask[NUM_PRIO];
 	odp_spinlock_t mask_lock;
 
-	prio_queue_t   prio_q[NUM_SCHED_GRPS][NUM_PRIO][QUEUES_PER_PRIO];
+	/* Scheduler sizing, set at global init */
+	int            num_grps;
+	int            queues_per_prio;
+	int            prefer_ratio;
+	int            ordered_stash;
+	int            num_rctx;
+	int            pktio_cmd_queues;
+	uint16_t       weight_tbl_size;
+
+	/* Priority queues, NUM_PRIO * queues_per_prio per group */
+	uint8_t       *prio_q;
+	uint32_t       prio_q_len;
+	uint32_t       prio_q_mask;
 
 	odp_spinlock_t poll_cmd_lock;
 	/* Number of commands in a command queue */
-	uint16_t       num_pktio_cmd[PKTIO_CMD_QUEUES];
+	uint16_t       num_pktio_cmd[MAX_PKTIO_CMD_QUEUES];
 
 	/* Packet IO command queues */
-	pktio_queue_t  pktio_q[PKTIO_CMD_QUEUES];
+	uint8_t       *pktio_q;
+	uint32_t       pktio_q_len;
+	uint32_t       pktio_q_mask;
 
 	/* Packet IO poll commands */
 	pktio_cmd_t    pktio_cmd[NUM_PKTIO_CMD];
 
+	/* Per thread weight tables and reorder contexts */
+	uint8_t       *thr_data;
+	uint64_t       thr_data_len;
+	uint64_t       rctx_offset;
+	uint64_t       rctx_len;
+
 	odp_shm_t      shm;
-	uint32_t       pri_count[NUM_PRIO][QUEUES_PER_PRIO];
+	uint32_t       pri_count[NUM_PRIO][MAX_QUEUES_PER_PRIO];
+
+	/* Maximum number of events pulled ahead by schedule_prefetch() */
+	int            prefetch_depth;
 
 	odp_thrmask_t    mask_all;
 	odp_spinlock_t   grp_lock;
@@ -244,7 +352,7 @@ typedef struct {
 		char           name[ODP_SCHED_GROUP_NAME_LEN];
 		odp_thrmask_t  mask;
 		int	       allocated;
-	} sched_grp[NUM_SCHED_GRPS];
+	} sched_grp[MAX_SCHED_GRPS];
 
 	struct {
 		int         grp;
@@ -261,6 +369,15 @@ typedef struct {
 
 	order_context_t order[ODP_CONFIG_QUEUES];
 
+#if CONFIG_SCHED_STATS
+	/* Per thread statistics */
+	sched_stat_t stat[ODP_THREAD_COUNT_MAX];
+	reorder_stat_t reorder_stat[ODP_THREAD_COUNT_MAX];
+#endif
+
+	/* Threads waiting for events */
+	sched_idle_t idle;
+
 } sched_global_t;
 
 /* Global scheduler context */
@@ -272,11 +389,59 @@ static __thread sched_local_t sched_local;
 /* Function prototypes */
 static inline void schedule_release_context(void);
 
+/* Statistics are counted per thread, compiled out when disabled */
+#define SCHED_STAT_ADD(name, val) \
+	do { \
+		if (CONFIG_SCHED_STATS) \
+			sched_local.stat->name += (val); \
+	} while (0)
+
+#define REORDER_STAT_ADD(name, val) \
+	do { \
+		if (CONFIG_SCHED_STATS) \
+			sched_local.reorder_stat->name += (val); \
+	} while (0)
+
+static inline uint64_t stat_time_ns(void)
+{
+	return odp_time_to_ns(odp_time_local());
+}
+
+static inline void stat_atomic_begin(void)
+{
+	if (CONFIG_SCHED_STATS)
+		sched_local.atomic_ns = stat_time_ns();
+}
+
+static inline prio_queue_t *prio_queue(int grp, int prio, int id)
+{
+	uint32_t i = (grp * NUM_PRIO + prio) * sched->queues_per_prio + id;
+
+	return (prio_queue_t *)(uintptr_t)(sched->prio_q +
+					   i * sched->prio_q_len);
+}
+
+static inline pktio_queue_t *pktio_queue(int id)
+{
+	return (pktio_queue_t *)(uintptr_t)(sched->pktio_q +
+					    id * sched->pktio_q_len);
+}
+
+static inline reorder_ctx_t *reorder_ctx(int thr, int idx)
+{
+	return (reorder_ctx_t *)(uintptr_t)(sched->thr_data +
+					    thr * sched->thr_data_len +
+					    sched->rctx_offset +
+					    idx * sched->rctx_len);
+}
+
 static void sched_local_init(void)
 {
 	int i;
 	uint8_t id;
 	uint8_t offset = 0;
+	uint8_t *thr_data;
+	int queues_per_prio = sched->queues_per_prio;
 
 	memset(&sched_local, 0, sizeof(sched_local_t));
 
@@ -284,55 +449,165 @@ static void sched_local_init(void)
 	sched_local.queue     = ODP_QUEUE_INVALID;
 	sched_local.queue_index = PRIO_QUEUE_EMPTY;
 	sched_local.ordered.src_queue = NULL_INDEX;
+	sched_local.prefetch.queue_index = PRIO_QUEUE_EMPTY;
+	sched_local.prefetch.src_queue = NULL_INDEX;
 
-	id = sched_local.thr & (QUEUES_PER_PRIO - 1);
+	thr_data = sched->thr_data + sched_local.thr * sched->thr_data_len;
+	sched_local.weight_tbl = thr_data;
+	sched_local.grp_weight = thr_data + sched->weight_tbl_size;
 
-	for (i = 0; i < WEIGHT_TBL_SIZE; i++) {
+#if CONFIG_SCHED_STATS
+	sched_local.stat = &sched->stat[sched_local.thr].s;
+	sched_local.reorder_stat = &sched->reorder_stat[sched_local.thr];
+#endif
+
+	id = sched_local.thr & (queues_per_prio - 1);
+
+	for (i = 0; i < sched->weight_tbl_size; i++) {
 		sched_local.weight_tbl[i] = id;
 
-		if (i % PREFER_RATIO == 0) {
+		if (i % sched->prefer_ratio == 0) {
 			offset++;
 			sched_local.weight_tbl[i] = (id + offset) &
-						    (QUEUES_PER_PRIO - 1);
-			if (offset == QUEUES_PER_PRIO - 1)
+						    (queues_per_prio - 1);
+			if (offset == queues_per_prio - 1)
 				offset = 0;
 		}
 	}
 }
 
+/* Read a scheduler setting from an environment variable. The default is
+ * used when the variable is not set or the value is not valid. */
+static int sched_config(const char *name, int def, int min, int max,
+			int pow2)
+{
+	const char *env = getenv(name);
+	int val;
+
+	if (env == NULL)
+		return def;
+
+	val = atoi(env);
+
+	if (val < min || val > max || (pow2 && !CHECK_IS_POWER2(val))) {
+		ODP_ERR("Bad %s value: %s\n", name, env);
+		return def;
+	}
+
+	return val;
+}
+
 static int schedule_init_global(void)
 {
 	odp_shm_t shm;
 	int i, j, grp;
+	int num_grps, queues_per_prio, prefer_ratio, pktio_cmd_queues;
+	int ordered_stash, num_rctx;
+	uint32_t prio_q_size, pktio_q_size, num_prio_q;
+	uint64_t global_len, prio_q_len, pktio_q_len, thr_data_len, mem_size;
+	uint64_t rctx_offset, rctx_len;
+	uint16_t weight_tbl_size;
+	uint8_t *addr;
 
 	ODP_DBG("Schedule init ... ");
 
-	shm = odp_shm_reserve("odp_scheduler",
-			      sizeof(sched_global_t),
+	num_grps = sched_config("ODP_SCHED_GROUPS", CONFIG_SCHED_GROUPS,
+				SCHED_GROUP_NAMED, MAX_SCHED_GRPS, 0);
+	queues_per_prio = sched_config("ODP_SCHED_SPREAD", CONFIG_SCHED_SPREAD,
+				       1, MAX_QUEUES_PER_PRIO, 1);
+	prefer_ratio = sched_config("ODP_SCHED_PREFER_RATIO",
+				    CONFIG_SCHED_PREFER_RATIO, 1,
+				    MAX_PREFER_RATIO, 0);
+	ordered_stash = sched_config("ODP_SCHED_ORDERED_STASH",
+				     CONFIG_SCHED_ORDERED_STASH, 1,
+				     MAX_ORDERED_STASH, 0);
+	num_rctx = sched_config("ODP_SCHED_REORDER_CTX",
+				CONFIG_SCHED_REORDER_CTX, 1, MAX_REORDER_CTX,
+				0);
+	pktio_cmd_queues = sched_config("ODP_SCHED_PKTIO_CMD_QUEUES",
+					CONFIG_SCHED_PKTIO_CMD_QUEUES, 1,
+					MAX_PKTIO_CMD_QUEUES, 1);
+
+	/* Weight table is used also for round robin over groups. Preferred
+	 * queue is the only queue when there is one queue per priority. */
+	weight_tbl_size = prefer_ratio;
+	if (queues_per_prio > 1)
+		weight_tbl_size = (queues_per_prio - 1) * prefer_ratio;
+
+	num_prio_q   = num_grps * NUM_PRIO * queues_per_prio;
+	prio_q_size  = ODP_CONFIG_QUEUES / queues_per_prio;
+	pktio_q_size = NUM_PKTIO_CMD / pktio_cmd_queues;
+	prio_q_len   = ROUNDUP_CACHE_LINE(sizeof(prio_queue_t) +
+					  prio_q_size * sizeof(uint32_t));
+	pktio_q_len  = ROUNDUP_CACHE_LINE(sizeof(pktio_queue_t) +
+					  pktio_q_size * sizeof(uint32_t));
+	rctx_offset  = ROUNDUP_CACHE_LINE(2 * weight_tbl_size);
+	rctx_len     = ROUNDUP_CACHE_LINE(sizeof(reorder_ctx_t) +
+					  ordered_stash *
+					  sizeof(ordered_stash_t));
+	thr_data_len = rctx_offset + num_rctx * rctx_len;
+	global_len   = ROUNDUP_CACHE_LINE(sizeof(sched_global_t));
+
+	mem_size = global_len +
+		   num_prio_q * prio_q_len +
+		   pktio_cmd_queues * pktio_q_len +
+		   (uint64_t)odp_thread_count_max() * thr_data_len;
+
+	shm = odp_shm_reserve("odp_scheduler", mem_size,
 			      ODP_CACHE_LINE_SIZE, 0);
 
-	sched = odp_shm_addr(shm);
+	addr = odp_shm_addr(shm);
 
-	if (sched == NULL) {
+	if (addr == NULL) {
 		ODP_ERR("Schedule init: Shm reserve failed.\n");
 		return -1;
 	}
 
+	sched = (sched_global_t *)(uintptr_t)addr;
 	memset(sched, 0, sizeof(sched_global_t));
 
 	sched->shm  = shm;
 	odp_spinlock_init(&sched->mask_lock);
 
-	for (grp = 0; grp < NUM_SCHED_GRPS; grp++) {
+	sched->num_grps         = num_grps;
+	sched->queues_per_prio  = queues_per_prio;
+	sched->prefer_ratio     = prefer_ratio;
+	sched->ordered_stash    = ordered_stash;
+	sched->num_rctx         = num_rctx;
+	sched->pktio_cmd_queues = pktio_cmd_queues;
+	sched->weight_tbl_size  = weight_tbl_size;
+
+	/* Stashes are not initialized, the memory is touched on use */
+	sched->prio_q       = addr + global_len;
+	sched->prio_q_len   = prio_q_len;
+	sched->prio_q_mask  = prio_q_size - 1;
+	sched->pktio_q      = sched->prio_q + num_prio_q * prio_q_len;
+	sched->pktio_q_len  = pktio_q_len;
+	sched->pktio_q_mask = pktio_q_size - 1;
+	sched->thr_data     = sched->pktio_q + pktio_cmd_queues * pktio_q_len;
+	sched->thr_data_len = thr_data_len;
+	sched->rctx_offset  = rctx_offset;
+	sched->rctx_len     = rctx_len;
+
+	for (i = 0; i < odp_thread_count_max(); i++) {
+		for (j = 0; j < num_rctx; j++)
+			odp_atomic_init_u32(&reorder_ctx(i, j)->busy, 0);
+	}
+
+	sched->prefetch_depth = sched_config("ODP_SCHED_PREFETCH",
+					     CONFIG_SCHED_PREFETCH, 0, MAX_DEQ,
+					     0);
+
+	for (grp = 0; grp < num_grps; grp++) {
 		for (i = 0; i < NUM_PRIO; i++) {
-			for (j = 0; j < QUEUES_PER_PRIO; j++) {
+			for (j = 0; j < queues_per_prio; j++) {
 				prio_queue_t *prio_q;
-				int k;
+				uint32_t k;
 
-				prio_q = &sched->prio_q[grp][i][j];
+				prio_q = prio_queue(grp, i, j);
 				ring_init(&prio_q->ring);
 
-				for (k = 0; k < PRIO_QUEUE_RING_SIZE; k++) {
+				for (k = 0; k < prio_q_size; k++) {
 					prio_q->queue_index[k] =
 					PRIO_QUEUE_EMPTY;
 				}
@@ -341,11 +616,13 @@ static int schedule_init_global(void)
 	}
 
 	odp_spinlock_init(&sched->poll_cmd_lock);
-	for (i = 0; i < PKTIO_CMD_QUEUES; i++) {
-		ring_init(&sched->pktio_q[i].ring);
+	for (i = 0; i < pktio_cmd_queues; i++) {
+		pktio_queue_t *pktio_q = pktio_queue(i);
 
-		for (j = 0; j < PKTIO_RING_SIZE; j++)
-			sched->pktio_q[i].cmd_index[j] = PKTIO_CMD_INVALID;
+		ring_init(&pktio_q->ring);
+
+		for (j = 0; j < (int)pktio_q_size; j++)
+			pktio_q->cmd_index[j] = PKTIO_CMD_INVALID;
 	}
 
 	for (i = 0; i < NUM_PKTIO_CMD; i++)
@@ -354,7 +631,7 @@ static int schedule_init_global(void)
 	odp_spinlock_init(&sched->grp_lock);
 	odp_atomic_init_u32(&sched->grp_epoch, 0);
 
-	for (i = 0; i < NUM_SCHED_GRPS; i++) {
+	for (i = 0; i < num_grps; i++) {
 		memset(sched->sched_grp[i].name, 0, ODP_SCHED_GROUP_NAME_LEN);
 		odp_thrmask_zero(&sched->sched_grp[i].mask);
 	}
@@ -365,6 +642,8 @@ static int schedule_init_global(void)
 
 	odp_thrmask_setall(&sched->mask_all);
 
+	sched_idle_init(&sched->idle);
+
 	ODP_DBG("done\n");
 
 	return 0;
@@ -381,14 +660,14 @@ static int schedule_term_global(void)
 	int rc = 0;
 	int i, j, grp;
 
-	for (grp = 0; grp < NUM_SCHED_GRPS; grp++) {
+	for (grp = 0; grp < sched->num_grps; grp++) {
 		for (i = 0; i < NUM_PRIO; i++) {
-			for (j = 0; j < QUEUES_PER_PRIO; j++) {
-				ring_t *ring = &sched->prio_q[grp][i][j].ring;
+			for (j = 0; j < sched->queues_per_prio; j++) {
+				ring_t *ring = &prio_queue(grp, i, j)->ring;
 				uint32_t qi;
 
-				while ((qi = ring_deq(ring, PRIO_QUEUE_MASK)) !=
-				       RING_EMPTY) {
+				while ((qi = ring_deq(ring, sched->prio_q_mask))
+				       != RING_EMPTY) {
 					odp_event_t events[1];
 					int num;
 
@@ -423,7 +702,7 @@ static int schedule_init_local(void)
 
 static int schedule_term_local(void)
 {
-	if (sched_local.num) {
+	if (sched_local.num || sched_local.prefetch.num) {
 		ODP_ERR("Locally pre-scheduled events exist.\n");
 		return -1;
 	}
@@ -436,6 +715,9 @@ static inline void grp_update_mask(int grp, const odp_thrmask_t *new_mask)
 {
 	odp_thrmask_copy(&sched->sched_grp[grp].mask, new_mask);
 	odp_atomic_add_rel_u32(&sched->grp_epoch, 1);
+
+	/* Sleeping threads need to update their groups */
+	sched_idle_wake(&sched->idle);
 }
 
 static inline int grp_update_tbl(void)
@@ -446,7 +728,7 @@ static inline int grp_update_tbl(void)
 
 	odp_spinlock_lock(&sched->grp_lock);
 
-	for (i = 0; i < NUM_SCHED_GRPS; i++) {
+	for (i = 0; i < sched->num_grps; i++) {
 		if (sched->sched_grp[i].allocated == 0)
 			continue;
 
@@ -459,7 +741,7 @@ static inline int grp_update_tbl(void)
 	odp_spinlock_unlock(&sched->grp_lock);
 
 	/* Update group weights. Round robin over all thread's groups. */
-	for (i = 0; i < WEIGHT_TBL_SIZE; i++)
+	for (i = 0; i < sched->weight_tbl_size; i++)
 		sched_local.grp_weight[i] = i % num;
 
 	sched_local.num_grp = num;
@@ -473,7 +755,7 @@ static uint32_t schedule_max_ordered_locks(void)
 
 static inline int queue_per_prio(uint32_t queue_index)
 {
-	return ((QUEUES_PER_PRIO - 1) & queue_index);
+	return ((sched->queues_per_prio - 1) & queue_index);
 }
 
 static void pri_set(int id, int prio)
@@ -523,12 +805,15 @@ static int schedule_init_queue(uint32_t queue_index,
 	sched->queue[queue_index].sync = sched_param->sync;
 	sched->queue[queue_index].order_lock_count = sched_param->lock_count;
 
-	odp_atomic_init_u64(&sched->order[queue_index].ctx, 0);
+	odp_atomic_init_u64(&sched->order[queue_index].hc, 0);
 	odp_atomic_init_u64(&sched->order[queue_index].next_ctx, 0);
 
 	for (i = 0; i < CONFIG_QUEUE_MAX_ORD_LOCKS; i++)
 		odp_atomic_init_u64(&sched->order[queue_index].lock[i], 0);
 
+	for (i = 0; i < REORDER_WIN_SIZE; i++)
+		odp_atomic_init_u64(&sched->order[queue_index].win[i], 0);
+
 	return 0;
 }
 
@@ -552,14 +837,14 @@ static void schedule_destroy_queue(uint32_t queue_index)
 	sched->queue[queue_index].queue_per_prio = 0;
 
 	if (queue_is_ordered(queue_index) &&
-	    odp_atomic_load_u64(&sched->order[queue_index].ctx) !=
-	    odp_atomic_load_u64(&sched->order[queue_index].next_ctx))
+	    HC_HEAD(odp_atomic_load_u64(&sched->order[queue_index].hc)) !=
+	    (uint32_t)odp_atomic_load_u64(&sched->order[queue_index].next_ctx))
 		ODP_ERR("queue reorder incomplete\n");
 }
 
 static int poll_cmd_queue_idx(int pktio_index, int pktin_idx)
 {
-	return PKTIO_CMD_QUEUE_MASK & (pktio_index ^ pktin_idx);
+	return (sched->pktio_cmd_queues - 1) & (pktio_index ^ pktin_idx);
 }
 
 static inline pktio_cmd_t *alloc_pktio_cmd(void)
@@ -620,9 +905,12 @@ static void schedule_pktio_start(int pktio_index, int num_pktin,
 		cmd->pktio_index = pktio_index;
 		cmd->num_pktin   = 1;
 		cmd->pktin[0]    = pktin_idx[i];
-		ring_enq(&sched->pktio_q[idx].ring, PKTIO_RING_MASK,
+		ring_enq(&pktio_queue(idx)->ring, sched->pktio_q_mask,
 			 cmd->cmd_index);
 	}
+
+	/* Sleeping threads need to start polling */
+	sched_idle_wake(&sched->idle);
 }
 
 static int schedule_pktio_stop(int pktio_index, int first_pktin)
@@ -647,80 +935,236 @@ static void schedule_release_atomic(void)
 		int grp = sched->queue[qi].grp;
 		int prio = sched->queue[qi].prio;
 		int queue_per_prio = sched->queue[qi].queue_per_prio;
-		ring_t *ring = &sched->prio_q[grp][prio][queue_per_prio].ring;
+		ring_t *ring = &prio_queue(grp, prio, queue_per_prio)->ring;
 
 		/* Release current atomic queue */
-		ring_enq(ring, PRIO_QUEUE_MASK, qi);
+		ring_enq(ring, sched->prio_q_mask, qi);
 		sched_local.queue_index = PRIO_QUEUE_EMPTY;
+		sched_idle_wake(&sched->idle);
+
+		SCHED_STAT_ADD(atomic_ctx, 1);
+		SCHED_STAT_ADD(atomic_hold_ns,
+			       stat_time_ns() - sched_local.atomic_ns);
 	}
 }
 
 static inline int ordered_own_turn(uint32_t queue_index)
 {
-	uint64_t ctx;
+	uint64_t hc;
 
-	ctx = odp_atomic_load_acq_u64(&sched->order[queue_index].ctx);
+	hc = odp_atomic_load_acq_u64(&sched->order[queue_index].hc);
 
-	return ctx == sched_local.ordered.ctx;
+	return HC_HEAD(hc) == (uint32_t)sched_local.ordered.ctx;
 }
 
 static inline void wait_for_order(uint32_t queue_index)
 {
+	if (ordered_own_turn(queue_index))
+		return;
+
+	REORDER_STAT_ADD(stall, 1);
+
 	/* Busy loop to synchronize ordered processing */
 	while (1) {
+		odp_cpu_pause();
 		if (ordered_own_turn(queue_index))
 			break;
-		odp_cpu_pause();
 	}
 }
 
+static inline reorder_ctx_t *rctx_alloc(void)
+{
+	int i;
+
+	for (i = 0; i < sched->num_rctx; i++) {
+		reorder_ctx_t *rctx = reorder_ctx(sched_local.thr, i);
+
+		if (odp_atomic_load_acq_u32(&rctx->busy) == 0) {
+			odp_atomic_store_u32(&rctx->busy, 1);
+			rctx->num = 0;
+			sched_local.ordered.rctx = rctx;
+			sched_local.ordered.rctx_idx = i;
+			return rctx;
+		}
+	}
+
+	return NULL;
+}
+
 /**
- * Perform stashed enqueue operations
+ * Perform stashed enqueue operations and free the reorder context
  *
  * Should be called only when already in order.
  */
-static inline void ordered_stash_release(void)
+static inline void rctx_release(reorder_ctx_t *rctx)
 {
-	int i;
+	uint32_t i;
 
-	for (i = 0; i < sched_local.ordered.stash_num; i++) {
+	for (i = 0; i < rctx->num; i++) {
 		queue_entry_t *queue_entry;
 		odp_buffer_hdr_t **buf_hdr;
-		int num;
+		int num, num_enq;
+
+		queue_entry = rctx->stash[i].queue_entry;
+		buf_hdr = rctx->stash[i].buf_hdr;
+		num = rctx->stash[i].num;
+
+		num_enq = queue_fn->enq_multi(qentry_to_int(queue_entry),
+					      buf_hdr, num);
+
+		/* Drop events that did not fit into a bounded destination
+		 * queue */
+		if (odp_unlikely(num_enq < num)) {
+			int j;
 
-		queue_entry = sched_local.ordered.stash[i].queue_entry;
-		buf_hdr = sched_local.ordered.stash[i].buf_hdr;
-		num = sched_local.ordered.stash[i].num;
+			if (odp_unlikely(num_enq < 0))
+				num_enq = 0;
 
-		queue_fn->enq_multi(qentry_to_int(queue_entry), buf_hdr, num);
+			ODP_DBG("Dropped %i events\n", num - num_enq);
+
+			for (j = num_enq; j < num; j++)
+				odp_event_free(odp_buffer_to_event(
+					       buf_from_buf_hdr(buf_hdr[j])));
+		}
 	}
-	sched_local.ordered.stash_num = 0;
+
+	rctx->num = 0;
+	odp_atomic_store_rel_u32(&rctx->busy, 0);
 }
 
-static inline void release_ordered(void)
+/* Context is in order: perform stashed enqueue operations, following enqueues
+ * are done directly */
+static inline void ordered_set_in_order(void)
 {
-	uint32_t qi;
-	uint32_t i;
+	sched_local.ordered.in_order = 1;
+
+	if (sched_local.ordered.rctx) {
+		rctx_release(sched_local.ordered.rctx);
+		sched_local.ordered.rctx = NULL;
+	}
+}
 
-	qi = sched_local.ordered.src_queue;
+/* Retire an ordered context in order. Releases the ordered locks the context
+ * did not call and performs its stashed enqueue operations. */
+static inline void retire_ordered(uint32_t qi, uint64_t ctx,
+				  reorder_ctx_t *rctx, uint32_t lock_called)
+{
+	lock_called_t called;
+	uint32_t i;
 
-	wait_for_order(qi);
+	called.all = lock_called;
 
-	/* Release all ordered locks */
 	for (i = 0; i < sched->queue[qi].order_lock_count; i++) {
-		if (!sched_local.ordered.lock_called.u8[i])
+		if (!called.u8[i])
 			odp_atomic_store_rel_u64(&sched->order[qi].lock[i],
-						 sched_local.ordered.ctx + 1);
+						 ctx + 1);
 	}
 
+	if (rctx)
+		rctx_release(rctx);
+}
+
+/* Release the current ordered context. A context released out of order is
+ * left into the reorder window of the queue. The thread releasing the window
+ * head retires its own context and all following contexts found from the
+ * window. Head and change indicator are updated together, so that a context
+ * is either seen by the retiring thread or its releaser sees the new head. */
+static inline void release_ordered(void)
+{
+	uint32_t qi = sched_local.ordered.src_queue;
+	uint64_t ctx = sched_local.ordered.ctx;
+	reorder_ctx_t *rctx = sched_local.ordered.rctx;
+	uint32_t lock_called = sched_local.ordered.lock_called.all;
+	order_context_t *order = &sched->order[qi];
+	uint64_t hc, slot;
+	uint32_t depth;
+
 	sched_local.ordered.lock_called.all = 0;
 	sched_local.ordered.src_queue = NULL_INDEX;
 	sched_local.ordered.in_order = 0;
+	sched_local.ordered.rctx = NULL;
+	REORDER_STAT_ADD(release, 1);
+
+	hc = odp_atomic_load_acq_u64(&order->hc);
+	depth = (uint32_t)ctx - HC_HEAD(hc);
+
+	if (odp_unlikely(depth >= REORDER_WIN_SIZE)) {
+		/* Wait until the context fits into the window */
+		REORDER_STAT_ADD(stall, 1);
+
+		do {
+			odp_cpu_pause();
+			hc = odp_atomic_load_acq_u64(&order->hc);
+			depth = (uint32_t)ctx - HC_HEAD(hc);
+		} while (depth >= REORDER_WIN_SIZE);
+	}
+
+	if (depth) {
+		REORDER_STAT_ADD(out_of_order, 1);
+		REORDER_STAT_ADD(depth, depth);
+		if (CONFIG_SCHED_STATS &&
+		    depth > sched_local.reorder_stat->depth_max)
+			sched_local.reorder_stat->depth_max = depth;
+
+		slot = SLOT_VALID | ((uint64_t)lock_called << 24) |
+		       sched_local.thr;
+		if (rctx)
+			slot |= (uint64_t)sched_local.ordered.rctx_idx << 16;
+		else
+			slot |= SLOT_RCTX_NONE << 16;
+
+		odp_atomic_store_rel_u64(&order->win[ctx & REORDER_WIN_MASK],
+					 slot);
+
+		/* Change indicator update fails when the head has moved. The
+		 * context may have become in order, or been retired. */
+		do {
+			if (odp_atomic_cas_rel_u64(&order->hc, &hc,
+						   hc + HC_CHGI_ONE))
+				return;
+
+			hc = odp_atomic_load_acq_u64(&order->hc);
+		} while (HC_HEAD(hc) != (uint32_t)ctx);
+
+		/* In order, own context is retired from the window */
+	} else {
+		retire_ordered(qi, ctx, rctx, lock_called);
+		ctx++;
+	}
+
+	while (1) {
+		odp_atomic_u64_t *win = &order->win[ctx & REORDER_WIN_MASK];
+
+		slot = odp_atomic_load_acq_u64(win);
+
+		if (slot) {
+			int thr = slot & 0xffff;
+			uint32_t rctx_idx = (slot >> 16) & 0xff;
 
-	ordered_stash_release();
+			odp_atomic_store_u64(win, 0);
 
-	/* Next thread can continue processing */
-	odp_atomic_add_rel_u64(&sched->order[qi].ctx, 1);
+			rctx = NULL;
+			if (rctx_idx != SLOT_RCTX_NONE)
+				rctx = reorder_ctx(thr, rctx_idx);
+
+			retire_ordered(qi, ctx, rctx, (uint32_t)(slot >> 24));
+
+			if (thr != sched_local.thr)
+				REORDER_STAT_ADD(retire, 1);
+
+			ctx++;
+			continue;
+		}
+
+		/* Next thread can continue processing. Fails when a context
+		 * was released into the window meanwhile. */
+		if (odp_atomic_cas_rel_u64(&order->hc, &hc,
+					   ((hc >> 32) + 1) << 32 |
+					   (uint32_t)ctx))
+			break;
+
+		hc = odp_atomic_load_acq_u64(&order->hc);
+	}
 }
 
 static void schedule_release_ordered(void)
@@ -762,52 +1206,106 @@ static int schedule_ord_enq_multi(queue_t q_int, void *buf_hdr[],
 				  int num, int *ret)
 {
 	int i;
-	uint32_t stash_num = sched_local.ordered.stash_num;
+	ordered_stash_t *stash;
 	queue_entry_t *dst_queue = qentry_from_int(q_int);
 	uint32_t src_queue = sched_local.ordered.src_queue;
+	reorder_ctx_t *rctx = sched_local.ordered.rctx;
 
 	if ((src_queue == NULL_INDEX) || sched_local.ordered.in_order)
 		return 0;
 
 	if (ordered_own_turn(src_queue)) {
 		/* Own turn, so can do enqueue directly. */
-		sched_local.ordered.in_order = 1;
-		ordered_stash_release();
+		ordered_set_in_order();
 		return 0;
 	}
 
+	if (rctx == NULL && dst_queue->s.pktout.pktio == ODP_PKTIO_INVALID)
+		rctx = rctx_alloc();
+
 	/* Pktout may drop packets, so the operation cannot be stashed. */
 	if (dst_queue->s.pktout.pktio != ODP_PKTIO_INVALID ||
-	    odp_unlikely(stash_num >=  MAX_ORDERED_STASH)) {
-		/* If the local stash is full, wait until it is our turn and
-		 * then release the stash and do enqueue directly. */
+	    odp_unlikely(rctx == NULL ||
+			 rctx->num >= (uint32_t)sched->ordered_stash)) {
+		/* If the local stash is full or there is no free reorder
+		 * context, wait until it is our turn and then release the
+		 * stash and do enqueue directly. */
 		wait_for_order(src_queue);
 
-		sched_local.ordered.in_order = 1;
-
-		ordered_stash_release();
+		ordered_set_in_order();
 		return 0;
 	}
 
-	sched_local.ordered.stash[stash_num].queue_entry = dst_queue;
-	sched_local.ordered.stash[stash_num].num = num;
+	stash = &rctx->stash[rctx->num];
+	stash->queue_entry = dst_queue;
+	stash->num = num;
 	for (i = 0; i < num; i++)
-		sched_local.ordered.stash[stash_num].buf_hdr[i] = buf_hdr[i];
+		stash->buf_hdr[i] = buf_hdr[i];
 
-	sched_local.ordered.stash_num++;
+	rctx->num++;
 
 	*ret = num;
 	return 1;
 }
 
+/* Prefetch the first data cache line of packets. Event headers have been
+ * prefetched on dequeue. */
+static inline void prefetch_events(odp_event_t ev[], int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		odp_buffer_hdr_t *buf_hdr = (odp_buffer_hdr_t *)(uintptr_t)ev[i];
+
+		if (buf_hdr->event_type == ODP_EVENT_PACKET)
+			odp_prefetch(_odp_packet_data((odp_packet_t)buf_hdr));
+	}
+}
+
+/* Take events pulled ahead by schedule_prefetch() into use */
+static inline int prefetch_use(odp_queue_t *out_queue, odp_event_t out_ev[],
+			       unsigned int max_num)
+{
+	int ret;
+
+	sched_local.num   = sched_local.prefetch.num;
+	sched_local.index = 0;
+	sched_local.queue = sched_local.prefetch.queue;
+	sched_local.queue_index = sched_local.prefetch.queue_index;
+
+	if (sched_local.queue_index != PRIO_QUEUE_EMPTY)
+		stat_atomic_begin();
+
+	if (sched_local.prefetch.src_queue != NULL_INDEX) {
+		sched_local.ordered.ctx = sched_local.prefetch.ctx;
+		sched_local.ordered.src_queue = sched_local.prefetch.src_queue;
+	}
+
+	sched_local.prefetch.num = 0;
+	sched_local.prefetch.queue_index = PRIO_QUEUE_EMPTY;
+	sched_local.prefetch.src_queue = NULL_INDEX;
+
+	ret = copy_events(out_ev, max_num);
+
+	if (out_queue)
+		*out_queue = sched_local.queue;
+
+	return ret;
+}
+
+/* Schedule events from a group. When 'prefetch' is set, events are left in
+ * the local stash and the scheduling context is stored for later use. */
 static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
-				  unsigned int max_num, int grp, int first)
+				  unsigned int max_num, int grp, int first,
+				  int prefetch)
 {
 	int prio, i;
 	int ret;
 	int id;
 	unsigned int max_deq = MAX_DEQ;
 	uint32_t qi;
+	int queues_per_prio = sched->queues_per_prio;
+	uint32_t ring_mask = sched->prio_q_mask;
 
 	/* Schedule events */
 	for (prio = 0; prio < NUM_PRIO; prio++) {
@@ -818,13 +1316,13 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 		/* Select the first ring based on weights */
 		id = first;
 
-		for (i = 0; i < QUEUES_PER_PRIO;) {
+		for (i = 0; i < queues_per_prio;) {
 			int num;
-			int ordered;
+			int ordered, atomic;
 			odp_queue_t handle;
 			ring_t *ring;
 
-			if (id >= QUEUES_PER_PRIO)
+			if (id >= queues_per_prio)
 				id = 0;
 
 			/* No queues created for this priority queue */
@@ -836,8 +1334,8 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 			}
 
 			/* Get queue index from the priority queue */
-			ring = &sched->prio_q[grp][prio][id].ring;
-			qi   = ring_deq(ring, PRIO_QUEUE_MASK);
+			ring = &prio_queue(grp, prio, id)->ring;
+			qi   = ring_deq(ring, ring_mask);
 
 			/* Priority queue empty */
 			if (qi == RING_EMPTY) {
@@ -853,11 +1351,13 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 				max_deq = MAX_DEQ / 2;
 
 			ordered = queue_is_ordered(qi);
+			atomic  = queue_is_atomic(qi);
 
 			/* Do not cache ordered events locally to improve
 			 * parallelism. Ordered context can only be released
-			 * when the local cache is empty. */
-			if (ordered && max_num < MAX_DEQ)
+			 * when the local cache is empty. Events pulled ahead
+			 * are limited to the prefetch depth. */
+			if ((ordered || prefetch) && max_num < MAX_DEQ)
 				max_deq = max_num;
 
 			num = sched_cb_queue_deq_multi(qi, sched_local.ev_stash,
@@ -876,11 +1376,18 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 				continue;
 			}
 
-			handle            = sched_cb_queue_handle(qi);
-			sched_local.num   = num;
-			sched_local.index = 0;
-			sched_local.queue = handle;
-			ret = copy_events(out_ev, max_num);
+			handle = sched_cb_queue_handle(qi);
+
+			if (prefetch) {
+				sched_local.prefetch.num   = num;
+				sched_local.prefetch.queue = handle;
+				ret = num;
+			} else {
+				sched_local.num   = num;
+				sched_local.index = 0;
+				sched_local.queue = handle;
+				ret = copy_events(out_ev, max_num);
+			}
 
 			if (ordered) {
 				uint64_t ctx;
@@ -889,20 +1396,35 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 				next_ctx = &sched->order[qi].next_ctx;
 				ctx = odp_atomic_fetch_inc_u64(next_ctx);
 
-				sched_local.ordered.ctx = ctx;
-				sched_local.ordered.src_queue = qi;
+				if (prefetch) {
+					sched_local.prefetch.ctx = ctx;
+					sched_local.prefetch.src_queue = qi;
+				} else {
+					sched_local.ordered.ctx = ctx;
+					sched_local.ordered.src_queue = qi;
+				}
 
 				/* Continue scheduling ordered queues */
-				ring_enq(ring, PRIO_QUEUE_MASK, qi);
+				ring_enq(ring, ring_mask, qi);
 
-			} else if (queue_is_atomic(qi)) {
+			} else if (atomic) {
 				/* Hold queue during atomic access */
-				sched_local.queue_index = qi;
+				if (prefetch) {
+					sched_local.prefetch.queue_index = qi;
+				} else {
+					sched_local.queue_index = qi;
+					stat_atomic_begin();
+				}
 			} else {
 				/* Continue scheduling the queue */
-				ring_enq(ring, PRIO_QUEUE_MASK, qi);
+				ring_enq(ring, ring_mask, qi);
 			}
 
+			/* A full burst from a queue that is still scheduled
+			 * hints that there is work for sleeping threads */
+			if (num == (int)max_deq && !atomic)
+				sched_idle_wake(&sched->idle);
+
 			/* Output the source queue handle */
 			if (out_queue)
 				*out_queue = handle;
@@ -914,37 +1436,21 @@ static inline int do_schedule_grp(odp_queue_t *out_queue, odp_event_t out_ev[],
 	return 0;
 }
 
-/*
- * Schedule queues
- */
-static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
-			      unsigned int max_num)
+/* Schedule queues of all groups of the thread */
+static inline int schedule_grps(odp_queue_t *out_queue, odp_event_t out_ev[],
+				unsigned int max_num, int prefetch)
 {
 	int i, num_grp;
 	int ret;
-	int id, first, grp_id;
+	int first, grp_id;
 	uint16_t round;
 	uint32_t epoch;
 
-	if (sched_local.num) {
-		ret = copy_events(out_ev, max_num);
-
-		if (out_queue)
-			*out_queue = sched_local.queue;
-
-		return ret;
-	}
-
-	schedule_release_context();
-
-	if (odp_unlikely(sched_local.pause))
-		return 0;
-
 	/* Each thread prefers a priority queue. Poll weight table avoids
 	 * starvation of other priority queues on low thread counts. */
 	round = sched_local.round + 1;
 
-	if (odp_unlikely(round == WEIGHT_TBL_SIZE))
+	if (odp_unlikely(round == sched->weight_tbl_size))
 		round = 0;
 
 	sched_local.round = round;
@@ -965,7 +1471,8 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 		int grp;
 
 		grp = sched_local.grp[grp_id];
-		ret = do_schedule_grp(out_queue, out_ev, max_num, grp, first);
+		ret = do_schedule_grp(out_queue, out_ev, max_num, grp, first,
+				      prefetch);
 
 		if (odp_likely(ret))
 			return ret;
@@ -975,6 +1482,43 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 			grp_id = 0;
 	}
 
+	return 0;
+}
+
+/*
+ * Schedule queues
+ */
+static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
+			      unsigned int max_num)
+{
+	int i;
+	int ret;
+	int id;
+	int num_pkt;
+	int cmd_queue_mask;
+
+	if (sched_local.num) {
+		ret = copy_events(out_ev, max_num);
+
+		if (out_queue)
+			*out_queue = sched_local.queue;
+
+		return ret;
+	}
+
+	schedule_release_context();
+
+	if (odp_unlikely(sched_local.prefetch.num))
+		return prefetch_use(out_queue, out_ev, max_num);
+
+	if (odp_unlikely(sched_local.pause))
+		return 0;
+
+	ret = schedule_grps(out_queue, out_ev, max_num, 0);
+
+	if (odp_likely(ret))
+		return ret;
+
 	/*
 	 * Poll packet input when there are no events
 	 *   * Each thread starts the search for a poll command from its
@@ -985,10 +1529,11 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 	 *     have to do full iteration to avoid packet input starvation when
 	 *     there are less threads than command queues.
 	 */
-	id = sched_local.thr & PKTIO_CMD_QUEUE_MASK;
+	cmd_queue_mask = sched->pktio_cmd_queues - 1;
+	id = sched_local.thr & cmd_queue_mask;
 
-	for (i = 0; i < PKTIO_CMD_QUEUES; i++, id = ((id + 1) &
-	     PKTIO_CMD_QUEUE_MASK)) {
+	for (i = 0; i < sched->pktio_cmd_queues; i++,
+	     id = ((id + 1) & cmd_queue_mask)) {
 		ring_t *ring;
 		uint32_t cmd_index;
 		pktio_cmd_t *cmd;
@@ -996,8 +1541,8 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 		if (odp_unlikely(sched->num_pktio_cmd[id] == 0))
 			continue;
 
-		ring      = &sched->pktio_q[id].ring;
-		cmd_index = ring_deq(ring, PKTIO_RING_MASK);
+		ring      = &pktio_queue(id)->ring;
+		cmd_index = ring_deq(ring, sched->pktio_q_mask);
 
 		if (odp_unlikely(cmd_index == RING_EMPTY))
 			continue;
@@ -1005,9 +1550,10 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 		cmd = &sched->pktio_cmd[cmd_index];
 
 		/* Poll packet input */
-		if (odp_unlikely(sched_cb_pktin_poll(cmd->pktio_index,
-						     cmd->num_pktin,
-						     cmd->pktin))){
+		num_pkt = sched_cb_pktin_poll(cmd->pktio_index,
+					      cmd->num_pktin, cmd->pktin);
+
+		if (odp_unlikely(num_pkt < 0)) {
 			/* Pktio stopped or closed. Remove poll command and call
 			 * stop_finalize when all commands of the pktio has
 			 * been removed. */
@@ -1017,8 +1563,11 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 
 			free_pktio_cmd(cmd);
 		} else {
+			SCHED_STAT_ADD(pktin_polls, 1);
+			SCHED_STAT_ADD(pktin_hits, num_pkt > 0);
+
 			/* Continue scheduling the pktio */
-			ring_enq(ring, PKTIO_RING_MASK, cmd_index);
+			ring_enq(ring, sched->pktio_q_mask, cmd_index);
 
 			/* Do not iterate through all pktin poll command queues
 			 * every time. */
@@ -1032,39 +1581,71 @@ static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 }
 
 
+/* Packet input and inline timers are polled only by scheduling threads */
+static inline int idle_poll(void)
+{
+	int i;
+
+	if (inline_timers)
+		return 1;
+
+	for (i = 0; i < sched->pktio_cmd_queues; i++)
+		if (sched->num_pktio_cmd[i])
+			return 1;
+
+	return 0;
+}
+
 static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 			 odp_event_t out_ev[],
 			 unsigned int max_num)
 {
-	odp_time_t next, wtime;
+	odp_time_t next, now;
+	sched_idle_wait_t idle;
+	uint64_t tmo_ns = UINT64_MAX;
 	int first = 1;
 	int ret;
 
+	sched_idle_wait_init(&idle);
+
 	while (1) {
+		sched_idle_prepare(&sched->idle, &idle);
+
 		timer_run();
 
 		ret = do_schedule(out_queue, out_ev, max_num);
 
-		if (ret)
+		SCHED_STAT_ADD(polls, 1);
+
+		if (ret) {
+			SCHED_STAT_ADD(events, ret);
 			break;
+		}
 
-		if (wait == ODP_SCHED_WAIT)
-			continue;
+		SCHED_STAT_ADD(empty_polls, 1);
 
 		if (wait == ODP_SCHED_NO_WAIT)
 			break;
 
-		if (first) {
-			wtime = odp_time_local_from_ns(wait);
-			next = odp_time_sum(odp_time_local(), wtime);
-			first = 0;
-			continue;
+		if (wait != ODP_SCHED_WAIT) {
+			now = odp_time_local();
+
+			if (first) {
+				next = odp_time_local_from_ns(wait);
+				next = odp_time_sum(now, next);
+				first = 0;
+			} else if (odp_time_cmp(next, now) < 0) {
+				break;
+			}
+
+			tmo_ns = odp_time_to_ns(odp_time_diff(next, now));
 		}
 
-		if (odp_time_cmp(next, odp_time_local()) < 0)
-			break;
+		sched_idle_wait(&sched->idle, &idle, tmo_ns, idle_poll());
 	}
 
+	sched_idle_done(&sched->idle, &idle, ret);
+
 	return ret;
 }
 
@@ -1105,6 +1686,7 @@ static void schedule_order_lock(uint32_t lock_index)
 {
 	odp_atomic_u64_t *ord_lock;
 	uint32_t queue_index;
+	uint64_t start_ns = 0;
 
 	queue_index = sched_local.ordered.src_queue;
 
@@ -1114,6 +1696,9 @@ static void schedule_order_lock(uint32_t lock_index)
 
 	ord_lock = &sched->order[queue_index].lock[lock_index];
 
+	if (CONFIG_SCHED_STATS)
+		start_ns = stat_time_ns();
+
 	/* Busy loop to synchronize ordered processing */
 	while (1) {
 		uint64_t lock_seq;
@@ -1122,6 +1707,9 @@ static void schedule_order_lock(uint32_t lock_index)
 
 		if (lock_seq == sched_local.ordered.ctx) {
 			sched_local.ordered.lock_called.u8[lock_index] = 1;
+			SCHED_STAT_ADD(ord_lock, 1);
+			SCHED_STAT_ADD(ord_lock_wait_ns,
+				       stat_time_ns() - start_ns);
 			return;
 		}
 		odp_cpu_pause();
@@ -1172,6 +1760,134 @@ static int schedule_num_prio(void)
 	return NUM_PRIO;
 }
 
+static void reorder_print(void)
+{
+#if CONFIG_SCHED_STATS
+	reorder_stat_t sum;
+	int i;
+
+	memset(&sum, 0, sizeof(sum));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		reorder_stat_t *stat = &sched->reorder_stat[i];
+
+		sum.release      += stat->release;
+		sum.out_of_order += stat->out_of_order;
+		sum.depth        += stat->depth;
+		sum.retire       += stat->retire;
+		sum.stall        += stat->stall;
+		if (stat->depth_max > sum.depth_max)
+			sum.depth_max = stat->depth_max;
+	}
+#endif
+
+	ODP_PRINT("  Reorder\n");
+	ODP_PRINT("    window size     %i\n", REORDER_WIN_SIZE);
+	ODP_PRINT("    contexts        %i per thread\n", sched->num_rctx);
+#if CONFIG_SCHED_STATS
+	ODP_PRINT("    releases        %" PRIu64 "\n", sum.release);
+	ODP_PRINT("    out of order    %" PRIu64 "\n", sum.out_of_order);
+	ODP_PRINT("    depth           %" PRIu64 " avg, %" PRIu64 " max\n",
+		  sum.out_of_order ? sum.depth / sum.out_of_order : 0,
+		  sum.depth_max);
+	ODP_PRINT("    retired by peer %" PRIu64 "\n", sum.retire);
+	ODP_PRINT("    stalls          %" PRIu64 "\n", sum.stall);
+#endif
+}
+
+static void schedule_print(void)
+{
+	ODP_PRINT("\nScheduler info\n--------------\n");
+	ODP_PRINT("  Priorities       %i\n", NUM_PRIO);
+	ODP_PRINT("  Groups           %i\n", sched->num_grps);
+	ODP_PRINT("  Queues per prio  %i\n", sched->queues_per_prio);
+	ODP_PRINT("  Prefer ratio     %i\n", sched->prefer_ratio);
+	ODP_PRINT("  Ordered stash    %i\n", sched->ordered_stash);
+	ODP_PRINT("  Pktin cmd queues %i\n", sched->pktio_cmd_queues);
+	ODP_PRINT("  Prefetch depth   %i\n", sched->prefetch_depth);
+	reorder_print();
+	sched_idle_print(&sched->idle);
+	ODP_PRINT("\n");
+}
+
+#if CONFIG_SCHED_STATS
+static void stats_add(odp_schedule_stats_t *sum,
+		      const odp_schedule_stats_t *stat)
+{
+	sum->polls            += stat->polls;
+	sum->empty_polls      += stat->empty_polls;
+	sum->events           += stat->events;
+	sum->atomic_ctx       += stat->atomic_ctx;
+	sum->atomic_hold_ns   += stat->atomic_hold_ns;
+	sum->ord_lock         += stat->ord_lock;
+	sum->ord_lock_wait_ns += stat->ord_lock_wait_ns;
+	sum->pktin_polls      += stat->pktin_polls;
+	sum->pktin_hits       += stat->pktin_hits;
+}
+
+static inline uint64_t stats_avg(uint64_t sum, uint64_t num)
+{
+	return num ? sum / num : 0;
+}
+
+static void stats_print_row(const char *thr,
+			    const odp_schedule_stats_t *stat)
+{
+	ODP_PRINT("  %-5s %12" PRIu64 " %5" PRIu64 " %12" PRIu64 " %10"
+		  PRIu64 " %8" PRIu64 " %10" PRIu64 " %8" PRIu64 " %10"
+		  PRIu64 " %5" PRIu64 "\n", thr, stat->polls,
+		  stats_avg(100 * stat->empty_polls, stat->polls),
+		  stat->events, stat->atomic_ctx,
+		  stats_avg(stat->atomic_hold_ns, stat->atomic_ctx),
+		  stat->ord_lock,
+		  stats_avg(stat->ord_lock_wait_ns, stat->ord_lock),
+		  stat->pktin_polls,
+		  stats_avg(100 * stat->pktin_hits, stat->pktin_polls));
+}
+
+static int schedule_stats(odp_schedule_stats_t *stats)
+{
+	int i;
+
+	memset(stats, 0, sizeof(odp_schedule_stats_t));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		stats_add(stats, &sched->stat[i].s);
+
+	return 0;
+}
+
+static void schedule_stats_print(void)
+{
+	odp_schedule_stats_t sum;
+	char thr[8];
+	int i;
+
+	memset(&sum, 0, sizeof(sum));
+
+	ODP_PRINT("\nScheduler statistics\n--------------------\n");
+	ODP_PRINT("  %-5s %12s %5s %12s %10s %8s %10s %8s %10s %5s\n",
+		  "thr", "polls", "empty", "events", "atomic", "hold ns",
+		  "ord lock", "wait ns", "pktin", "hit");
+	ODP_PRINT("  %-5s %12s %5s %12s %10s %8s %10s %8s %10s %5s\n",
+		  "", "", "%", "", "contexts", "avg", "", "avg", "polls", "%");
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		odp_schedule_stats_t *stat = &sched->stat[i].s;
+
+		if (stat->polls == 0)
+			continue;
+
+		snprintf(thr, sizeof(thr), "%i", i);
+		stats_print_row(thr, stat);
+		stats_add(&sum, stat);
+	}
+
+	stats_print_row("sum", &sum);
+	ODP_PRINT("\n");
+}
+#endif
+
 static odp_schedule_group_t schedule_group_create(const char *name,
 						  const odp_thrmask_t *mask)
 {
@@ -1180,7 +1896,7 @@ static odp_schedule_group_t schedule_group_create(const char *name,
 
 	odp_spinlock_lock(&sched->grp_lock);
 
-	for (i = SCHED_GROUP_NAMED; i < NUM_SCHED_GRPS; i++) {
+	for (i = SCHED_GROUP_NAMED; i < sched->num_grps; i++) {
 		if (!sched->sched_grp[i].allocated) {
 			char *grp_name = sched->sched_grp[i].name;
 
@@ -1212,7 +1928,7 @@ static int schedule_group_destroy(odp_schedule_group_t group)
 
 	odp_spinlock_lock(&sched->grp_lock);
 
-	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	if (group < sched->num_grps && group >= SCHED_GROUP_NAMED &&
 	    sched->sched_grp[group].allocated) {
 		grp_update_mask(group, &zero);
 		memset(sched->sched_grp[group].name, 0,
@@ -1234,7 +1950,7 @@ static odp_schedule_group_t schedule_group_lookup(const char *name)
 
 	odp_spinlock_lock(&sched->grp_lock);
 
-	for (i = SCHED_GROUP_NAMED; i < NUM_SCHED_GRPS; i++) {
+	for (i = SCHED_GROUP_NAMED; i < sched->num_grps; i++) {
 		if (strcmp(name, sched->sched_grp[i].name) == 0) {
 			group = (odp_schedule_group_t)i;
 			break;
@@ -1252,7 +1968,7 @@ static int schedule_group_join(odp_schedule_group_t group,
 
 	odp_spinlock_lock(&sched->grp_lock);
 
-	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	if (group < sched->num_grps && group >= SCHED_GROUP_NAMED &&
 	    sched->sched_grp[group].allocated) {
 		odp_thrmask_t new_mask;
 
@@ -1278,7 +1994,7 @@ static int schedule_group_leave(odp_schedule_group_t group,
 
 	odp_spinlock_lock(&sched->grp_lock);
 
-	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	if (group < sched->num_grps && group >= SCHED_GROUP_NAMED &&
 	    sched->sched_grp[group].allocated) {
 		odp_thrmask_and(&new_mask, &sched->sched_grp[group].mask,
 				&new_mask);
@@ -1300,7 +2016,7 @@ static int schedule_group_thrmask(odp_schedule_group_t group,
 
 	odp_spinlock_lock(&sched->grp_lock);
 
-	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	if (group < sched->num_grps && group >= SCHED_GROUP_NAMED &&
 	    sched->sched_grp[group].allocated) {
 		*thrmask = sched->sched_grp[group].mask;
 		ret = 0;
@@ -1319,7 +2035,7 @@ static int schedule_group_info(odp_schedule_group_t group,
 
 	odp_spinlock_lock(&sched->grp_lock);
 
-	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	if (group < sched->num_grps && group >= SCHED_GROUP_NAMED &&
 	    sched->sched_grp[group].allocated) {
 		info->name    = sched->sched_grp[group].name;
 		info->thrmask = sched->sched_grp[group].mask;
@@ -1375,9 +2091,34 @@ static int schedule_thr_rem(odp_schedule_group_t group, int thr)
 	return 0;
 }
 
-/* This function is a no-op */
-static void schedule_prefetch(int num ODP_UNUSED)
+/* Pull events of the next queue while the application is still processing
+ * the current events. The current scheduling context is not affected: the
+ * context of the new queue is taken into use on the next schedule call. When
+ * events remain in the local stash, only their data is prefetched. */
+static void schedule_prefetch(int num)
 {
+	if (num > sched->prefetch_depth)
+		num = sched->prefetch_depth;
+
+	if (odp_unlikely(num <= 0))
+		return;
+
+	if (sched_local.num) {
+		if (num > sched_local.num)
+			num = sched_local.num;
+
+		prefetch_events(&sched_local.ev_stash[sched_local.index], num);
+		return;
+	}
+
+	if (sched_local.prefetch.num || odp_unlikely(sched_local.pause))
+		return;
+
+	schedule_grps(NULL, NULL, num, 1);
+
+	/* Data of the new events is loaded while the application processes
+	 * the current events */
+	prefetch_events(sched_local.ev_stash, sched_local.prefetch.num);
 }
 
 static int schedule_sched_queue(uint32_t queue_index)
@@ -1385,15 +2126,16 @@ static int schedule_sched_queue(uint32_t queue_index)
 	int grp            = sched->queue[queue_index].grp;
 	int prio           = sched->queue[queue_index].prio;
 	int queue_per_prio = sched->queue[queue_index].queue_per_prio;
-	ring_t *ring       = &sched->prio_q[grp][prio][queue_per_prio].ring;
+	ring_t *ring       = &prio_queue(grp, prio, queue_per_prio)->ring;
 
-	ring_enq(ring, PRIO_QUEUE_MASK, queue_index);
+	ring_enq(ring, sched->prio_q_mask, queue_index);
+	sched_idle_wake(&sched->idle);
 	return 0;
 }
 
 static int schedule_num_grps(void)
 {
-	return NUM_SCHED_GRPS;
+	return sched->num_grps;
 }
 
 /* Fill in scheduler interface */
@@ -1429,6 +2171,7 @@ const schedule_api_t schedule_default_api = {
 	.schedule_release_ordered = schedule_release_ordered,
 	.schedule_prefetch        = schedule_prefetch,
 	.schedule_num_prio        = schedule_num_prio,
+	.schedule_print           = schedule_print,
 	.schedule_group_create    = schedule_group_create,
 	.schedule_group_destroy   = schedule_group_destroy,
 	.schedule_group_lookup    = schedule_group_lookup,
@@ -1438,5 +2181,9 @@ const schedule_api_t schedule_default_api = {
 	.schedule_group_info      = schedule_group_info,
 	.schedule_order_lock      = schedule_order_lock,
 	.schedule_order_unlock    = schedule_order_unlock,
-	.schedule_order_unlock_lock    = schedule_order_unlock_lock
+	.schedule_order_unlock_lock    = schedule_order_unlock_lock,
+#if CONFIG_SCHED_STATS
+	.schedule_stats           = schedule_stats,
+	.schedule_stats_print     = schedule_stats_print
+#endif
 };
@@ -0,0 +1,140 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include <odp_schedule_idle_internal.h>
+#include <odp_debug_internal.h>
+
+/* Scheduler global data is shared between processes, so futexes must not be
+ * process private. */
+static inline int futex_wait(odp_atomic_u32_t *addr, uint32_t val,
+			     uint64_t ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec  = ns / ODP_TIME_SEC_IN_NS;
+	ts.tv_nsec = ns % ODP_TIME_SEC_IN_NS;
+
+	return syscall(SYS_futex, &addr->v, FUTEX_WAIT, val, &ts, NULL, 0);
+}
+
+static inline int futex_wake(odp_atomic_u32_t *addr, int num)
+{
+	return syscall(SYS_futex, &addr->v, FUTEX_WAKE, num, NULL, NULL, 0);
+}
+
+static inline uint64_t time_global_ns(void)
+{
+	return odp_time_to_ns(odp_time_global());
+}
+
+void sched_idle_init(sched_idle_t *idle)
+{
+	memset(idle->stat, 0, sizeof(idle->stat));
+	odp_atomic_init_u32(&idle->seq, 0);
+	odp_atomic_init_u32(&idle->sleepers, 0);
+	odp_atomic_init_u32(&idle->hops, 0);
+	odp_atomic_init_u64(&idle->wakeup_time, 0);
+}
+
+void _sched_idle_wake(sched_idle_t *idle)
+{
+	uint32_t sleepers = odp_atomic_load_u32(&idle->sleepers);
+
+	/* The wake up may be passed on until every sleeper has seen it */
+	odp_atomic_store_u32(&idle->hops, sleepers ? sleepers - 1 : 0);
+	odp_atomic_store_u64(&idle->wakeup_time, time_global_ns());
+	odp_atomic_inc_u32(&idle->seq);
+	futex_wake(&idle->seq, 1);
+}
+
+void _sched_idle_wake_next(sched_idle_t *idle)
+{
+	uint32_t hops = odp_atomic_load_u32(&idle->hops);
+
+	do {
+		if (hops == 0)
+			return;
+	} while (!odp_atomic_cas_u32(&idle->hops, &hops, hops - 1));
+
+	odp_atomic_inc_u32(&idle->seq);
+	futex_wake(&idle->seq, 1);
+}
+
+void _sched_idle_sleep(sched_idle_t *idle, sched_idle_wait_t *w,
+		       uint64_t tmo_ns, int poll)
+{
+	sched_idle_stat_t *stat = &idle->stat[odp_thread_id()];
+	uint64_t ns = poll ? CONFIG_SCHED_IDLE_POLL_NS :
+			     CONFIG_SCHED_IDLE_SLEEP_NS;
+
+	/* A wake up may have been missed during registration */
+	if (!w->slept && ns > CONFIG_SCHED_IDLE_POLL_NS)
+		ns = CONFIG_SCHED_IDLE_POLL_NS;
+
+	if (tmo_ns < ns)
+		ns = tmo_ns;
+
+	if (ns && futex_wait(&idle->seq, w->seq, ns) && errno != EAGAIN &&
+	    errno != ETIMEDOUT && errno != EINTR)
+		ODP_ERR("futex wait failed: %s\n", strerror(errno));
+
+	stat->sleep++;
+	w->slept = 1;
+
+	if (odp_atomic_load_acq_u32(&idle->seq) != w->seq) {
+		uint64_t wakeup = odp_atomic_load_u64(&idle->wakeup_time);
+		uint64_t now = time_global_ns();
+		uint64_t lat = now > wakeup ? now - wakeup : 0;
+
+		w->woken = 1;
+		stat->wakeup++;
+		stat->wakeup_ns += lat;
+		if (lat > stat->wakeup_max_ns)
+			stat->wakeup_max_ns = lat;
+	}
+}
+
+void sched_idle_print(sched_idle_t *idle)
+{
+	sched_idle_stat_t sum;
+	int i;
+
+	memset(&sum, 0, sizeof(sum));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		sched_idle_stat_t *stat = &idle->stat[i];
+
+		sum.idle     += stat->idle;
+		sum.spin_hit += stat->spin_hit;
+		sum.sleep    += stat->sleep;
+		sum.wakeup   += stat->wakeup;
+		sum.wakeup_ns += stat->wakeup_ns;
+		if (stat->wakeup_max_ns > sum.wakeup_max_ns)
+			sum.wakeup_max_ns = stat->wakeup_max_ns;
+	}
+
+	ODP_PRINT("  Idle\n");
+	ODP_PRINT("    spin time       %i nsec\n", CONFIG_SCHED_IDLE_SPIN_NS);
+	ODP_PRINT("    max sleep       %i nsec\n", CONFIG_SCHED_IDLE_SLEEP_NS);
+	ODP_PRINT("    waits           %" PRIu64 "\n", sum.idle);
+	ODP_PRINT("    spin hits       %" PRIu64 "\n", sum.spin_hit);
+	ODP_PRINT("    sleeps          %" PRIu64 "\n", sum.sleep);
+	ODP_PRINT("    wake ups        %" PRIu64 "\n", sum.wakeup);
+	ODP_PRINT("    wake up latency %" PRIu64 " nsec avg, %" PRIu64
+		  " nsec max\n",
+		  sum.wakeup ? sum.wakeup_ns / sum.wakeup : 0,
+		  sum.wakeup_max_ns);
+}
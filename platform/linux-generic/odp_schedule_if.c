@@ -20,6 +20,9 @@ extern const schedule_api_t schedule_iquery_api;
 extern const schedule_fn_t  schedule_scalable_fn;
 extern const schedule_api_t schedule_scalable_api;
 
+extern const schedule_fn_t  schedule_ws_fn;
+extern const schedule_api_t schedule_ws_api;
+
 #ifdef ODP_SCHEDULE_SP
 const schedule_fn_t *sched_fn   = &schedule_sp_fn;
 const schedule_api_t *sched_api = &schedule_sp_api;
@@ -29,6 +32,9 @@ const schedule_api_t *sched_api = &schedule_iquery_api;
 #elif defined(ODP_SCHEDULE_SCALABLE)
 const schedule_fn_t  *sched_fn  = &schedule_scalable_fn;
 const schedule_api_t *sched_api = &schedule_scalable_api;
+#elif defined(ODP_SCHEDULE_WS)
+const schedule_fn_t  *sched_fn  = &schedule_ws_fn;
+const schedule_api_t *sched_api = &schedule_ws_api;
 #else
 const schedule_fn_t  *sched_fn  = &schedule_default_fn;
 const schedule_api_t *sched_api = &schedule_default_api;
@@ -80,6 +86,25 @@ int odp_schedule_num_prio(void)
 	return sched_api->schedule_num_prio();
 }
 
+void odp_schedule_print(void)
+{
+	sched_api->schedule_print();
+}
+
+int odp_schedule_stats(odp_schedule_stats_t *stats)
+{
+	if (sched_api->schedule_stats == NULL)
+		return -1;
+
+	return sched_api->schedule_stats(stats);
+}
+
+void odp_schedule_stats_print(void)
+{
+	if (sched_api->schedule_stats_print)
+		sched_api->schedule_stats_print();
+}
+
 odp_schedule_group_t odp_schedule_group_create(const char *name,
 					       const odp_thrmask_t *mask)
 {
@@ -25,6 +25,7 @@
 #include <odp/api/packet_io.h>
 #include <odp_config_internal.h>
 #include <odp_timer_internal.h>
+#include <odp_schedule_idle_internal.h>
 
 /* Should remove this dependency */
 #include <odp_queue_internal.h>
@@ -158,6 +159,12 @@ typedef struct {
 	sched_thread_local_t *threads[ODP_THREAD_COUNT_MAX];
 
 	order_context_t order[ODP_CONFIG_QUEUES];
+
+	/* Number of started pktio interfaces */
+	odp_atomic_u32_t num_pktio;
+
+	/* Threads waiting for events */
+	sched_idle_t idle;
 } sched_global_t;
 
 /* Per thread events cache */
@@ -277,6 +284,9 @@ static int schedule_init_global(void)
 	for (i = 0; i < NUM_PKTIO_CMD; i++)
 		sched->pktio_poll.commands[i].index = PKTIO_CMD_FREE;
 
+	odp_atomic_init_u32(&sched->num_pktio, 0);
+	sched_idle_init(&sched->idle);
+
 	ODP_DBG("done\n");
 	return 0;
 }
@@ -600,6 +610,11 @@ static void schedule_pktio_start(int pktio,
 		ring_enq(&sched->pktio_poll.queues[index].ring,
 			 PKTIO_RING_MASK, cmd->index);
 	}
+
+	odp_atomic_inc_u32(&sched->num_pktio);
+
+	/* Sleeping threads need to start polling */
+	sched_idle_wake(&sched->idle);
 }
 
 static int schedule_pktio_stop(int pktio, int pktin ODP_UNUSED)
@@ -676,14 +691,16 @@ static inline void pktio_poll_input(void)
 		/* Poll packet input */
 		if (odp_unlikely(sched_cb_pktin_poll(cmd->pktio,
 						     cmd->count,
-						     cmd->pktin))) {
+						     cmd->pktin) < 0)) {
 			/* Pktio stopped or closed. Remove poll
 			 * command and call stop_finalize when all
 			 * commands of the pktio has been removed.
 			 */
 			if (schedule_pktio_stop(cmd->pktio,
-						cmd->pktin[0]) == 0)
+						cmd->pktin[0]) == 0) {
+				odp_atomic_dec_u32(&sched->num_pktio);
 				sched_cb_pktio_stop_finalize(cmd->pktio);
+			}
 
 			free_pktio_cmd(cmd);
 		} else {
@@ -744,13 +761,25 @@ static int do_schedule(odp_queue_t *out_queue,
 	return 0;
 }
 
+/* Packet input and inline timers are polled only by scheduling threads */
+static inline int idle_poll(void)
+{
+	return inline_timers || odp_atomic_load_u32(&sched->num_pktio) != 0;
+}
+
 static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 			 odp_event_t out_ev[], unsigned int max_num)
 {
 	int count, first = 1;
-	odp_time_t next, wtime;
+	odp_time_t next, now;
+	sched_idle_wait_t idle;
+	uint64_t tmo_ns = UINT64_MAX;
+
+	sched_idle_wait_init(&idle);
 
 	while (1) {
+		sched_idle_prepare(&sched->idle, &idle);
+
 		timer_run();
 
 		count = do_schedule(out_queue, out_ev, max_num);
@@ -758,23 +787,28 @@ static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 		if (count)
 			break;
 
-		if (wait == ODP_SCHED_WAIT)
-			continue;
-
 		if (wait == ODP_SCHED_NO_WAIT)
 			break;
 
-		if (first) {
-			wtime = odp_time_local_from_ns(wait);
-			next = odp_time_sum(odp_time_local(), wtime);
-			first = 0;
-			continue;
+		if (wait != ODP_SCHED_WAIT) {
+			now = odp_time_local();
+
+			if (first) {
+				next = odp_time_local_from_ns(wait);
+				next = odp_time_sum(now, next);
+				first = 0;
+			} else if (odp_time_cmp(next, now) < 0) {
+				break;
+			}
+
+			tmo_ns = odp_time_to_ns(odp_time_diff(next, now));
 		}
 
-		if (odp_time_cmp(next, odp_time_local()) < 0)
-			break;
+		sched_idle_wait(&sched->idle, &idle, tmo_ns, idle_poll());
 	}
 
+	sched_idle_done(&sched->idle, &idle, count);
+
 	return count;
 }
 
@@ -815,6 +849,15 @@ static int number_of_priorites(void)
 	return NUM_SCHED_PRIO;
 }
 
+static void schedule_print(void)
+{
+	ODP_PRINT("\nScheduler info (iquery)\n-----------------------\n");
+	ODP_PRINT("  Priorities       %i\n", NUM_SCHED_PRIO);
+	ODP_PRINT("  Groups           %i\n", NUM_SCHED_GRPS);
+	sched_idle_print(&sched->idle);
+	ODP_PRINT("\n");
+}
+
 /*
  * Create a named schedule group with pre-defined
  * set of subscription threads.
@@ -951,6 +994,11 @@ static int schedule_group_join(odp_schedule_group_t group,
 	}
 
 	odp_rwlock_write_unlock(&G->lock);
+
+	/* Sleeping threads may have new queues to check */
+	if (done == 0)
+		sched_idle_wake(&sched->idle);
+
 	return done;
 }
 
@@ -1083,6 +1131,7 @@ static int schedule_sched_queue(uint32_t queue_index)
 {
 	/* Set available indications globally */
 	sched->availables[queue_index] = true;
+	sched_idle_wake(&sched->idle);
 	return 0;
 }
 
@@ -1102,6 +1151,7 @@ static void schedule_release_atomic(void)
 		queue_index = thread_local.atomic - sched->availables;
 		thread_local.atomic = NULL;
 		sched->availables[queue_index] = true;
+		sched_idle_wake(&sched->idle);
 	}
 }
 
@@ -1367,6 +1417,7 @@ const schedule_api_t schedule_iquery_api = {
 	.schedule_release_ordered = schedule_release_ordered,
 	.schedule_prefetch        = schedule_prefetch,
 	.schedule_num_prio        = number_of_priorites,
+	.schedule_print           = schedule_print,
 	.schedule_group_create    = schedule_group_create,
 	.schedule_group_destroy   = schedule_group_destroy,
 	.schedule_group_lookup    = schedule_group_lookup,
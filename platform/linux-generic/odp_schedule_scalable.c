@@ -1355,6 +1355,14 @@ static int schedule_num_prio(void)
 	return ODP_SCHED_PRIO_NUM - 1; /* Discount the pktin priority level */
 }
 
+static void schedule_print(void)
+{
+	ODP_PRINT("\nScheduler info (scalable)\n-------------------------\n");
+	ODP_PRINT("  Priorities       %i\n", schedule_num_prio());
+	ODP_PRINT("  Groups           %i\n", (int)MAX_SCHED_GROUP);
+	ODP_PRINT("\n");
+}
+
 static int schedule_group_update(sched_group_t *sg,
 				 uint32_t sgi,
 				 const odp_thrmask_t *mask,
@@ -2086,6 +2094,7 @@ const schedule_api_t schedule_scalable_api = {
 	.schedule_release_ordered	= schedule_release_ordered,
 	.schedule_prefetch		= schedule_prefetch,
 	.schedule_num_prio		= schedule_num_prio,
+	.schedule_print			= schedule_print,
 	.schedule_group_create		= schedule_group_create,
 	.schedule_group_destroy		= schedule_group_destroy,
 	.schedule_group_lookup		= schedule_group_lookup,
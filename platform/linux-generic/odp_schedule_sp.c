@@ -18,6 +18,7 @@
 #include <odp_config_internal.h>
 #include <odp_ring_internal.h>
 #include <odp_timer_internal.h>
+#include <odp_schedule_idle_internal.h>
 
 #define NUM_THREAD        ODP_THREAD_COUNT_MAX
 #define NUM_QUEUE         ODP_CONFIG_QUEUES
@@ -112,6 +113,12 @@ typedef struct {
 	prio_queue_t  prio_queue[NUM_GROUP][NUM_PRIO];
 	sched_group_t sched_group;
 	odp_shm_t     shm;
+
+	/* Number of started pktio interfaces */
+	odp_atomic_u32_t num_pktio;
+
+	/* Threads waiting for events */
+	sched_idle_t  idle;
 } sched_global_t;
 
 typedef struct {
@@ -207,6 +214,9 @@ static int init_global(void)
 	odp_thrmask_zero(&sched_group->s.group[GROUP_CONTROL].mask);
 	sched_group->s.group[GROUP_CONTROL].allocated = 1;
 
+	odp_atomic_init_u32(&sched_global->num_pktio, 0);
+	sched_idle_init(&sched_global->idle);
+
 	return 0;
 }
 
@@ -259,6 +269,9 @@ static void add_group(sched_group_t *sched_group, int thr, int group)
 	thr_group->num_group  = num + 1;
 	gen_cnt = odp_atomic_load_u32(&thr_group->gen_cnt);
 	odp_atomic_store_u32(&thr_group->gen_cnt, gen_cnt + 1);
+
+	/* Sleeping threads need to update their groups */
+	sched_idle_wake(&sched_global->idle);
 }
 
 static void remove_group(sched_group_t *sched_group, int thr, int group)
@@ -408,6 +421,7 @@ static int sched_queue(uint32_t qi)
 
 	cmd = &sched_global->queue_cmd[qi];
 	add_tail(cmd);
+	sched_idle_wake(&sched_global->idle);
 
 	return 0;
 }
@@ -446,7 +460,11 @@ static void pktio_start(int pktio_index,
 
 	cmd->s.num_pktin = num;
 
+	odp_atomic_inc_u32(&sched_global->num_pktio);
 	add_tail(cmd);
+
+	/* Sleeping threads need to start polling */
+	sched_idle_wake(&sched_global->idle);
 }
 
 static inline sched_cmd_t *sched_cmd(void)
@@ -496,16 +514,27 @@ static uint64_t schedule_wait_time(uint64_t ns)
 	return ns;
 }
 
+/* Packet input and inline timers are polled only by scheduling threads */
+static inline int idle_poll(void)
+{
+	return inline_timers ||
+	       odp_atomic_load_u32(&sched_global->num_pktio) != 0;
+}
+
 static int schedule_multi(odp_queue_t *from, uint64_t wait,
 			  odp_event_t events[], int max_events ODP_UNUSED)
 {
-	odp_time_t t1;
+	odp_time_t t1, now;
+	sched_idle_wait_t idle;
+	uint64_t tmo_ns = UINT64_MAX;
 	int update_t1 = 1;
 
 	if (sched_local.cmd) {
 		/* Continue scheduling if queue is not empty */
-		if (sched_cb_queue_empty(sched_local.cmd->s.index) == 0)
+		if (sched_cb_queue_empty(sched_local.cmd->s.index) == 0) {
 			add_tail(sched_local.cmd);
+			sched_idle_wake(&sched_global->idle);
+		}
 
 		sched_local.cmd = NULL;
 	}
@@ -513,19 +542,24 @@ static int schedule_multi(odp_queue_t *from, uint64_t wait,
 	if (odp_unlikely(sched_local.pause))
 		return 0;
 
+	sched_idle_wait_init(&idle);
+
 	while (1) {
 		sched_cmd_t *cmd;
 		uint32_t qi;
 		int num;
 
+		sched_idle_prepare(&sched_global->idle, &idle);
+
 		timer_run();
 
 		cmd = sched_cmd();
 
 		if (cmd && cmd->s.type == CMD_PKTIO) {
 			if (sched_cb_pktin_poll(cmd->s.index, cmd->s.num_pktin,
-						cmd->s.pktin_idx)) {
+						cmd->s.pktin_idx) < 0) {
 				/* Pktio stopped or closed. */
+				odp_atomic_dec_u32(&sched_global->num_pktio);
 				sched_cb_pktio_stop_finalize(cmd->s.index);
 			} else {
 				/* Continue polling pktio. */
@@ -539,28 +573,32 @@ static int schedule_multi(odp_queue_t *from, uint64_t wait,
 		if (cmd == NULL) {
 			/* All priority queues are empty */
 			if (wait == ODP_SCHED_NO_WAIT)
-				return 0;
+				break;
 
-			if (wait == ODP_SCHED_WAIT)
-				continue;
+			if (wait != ODP_SCHED_WAIT) {
+				now = odp_time_local();
 
-			if (update_t1) {
-				t1 = odp_time_sum(odp_time_local(),
-						  odp_time_local_from_ns(wait));
-				update_t1 = 0;
-				continue;
-			}
+				if (update_t1) {
+					t1 = odp_time_local_from_ns(wait);
+					t1 = odp_time_sum(now, t1);
+					update_t1 = 0;
+				} else if (odp_time_cmp(now, t1) >= 0) {
+					break;
+				}
 
-			if (odp_time_cmp(odp_time_local(), t1) < 0)
-				continue;
+				tmo_ns = odp_time_to_ns(odp_time_diff(t1, now));
+			}
 
-			return 0;
+			sched_idle_wait(&sched_global->idle, &idle, tmo_ns,
+					idle_poll());
+			continue;
 		}
 
 		qi  = cmd->s.index;
 		num = sched_cb_queue_deq_multi(qi, events, 1);
 
 		if (num > 0) {
+			sched_idle_done(&sched_global->idle, &idle, 1);
 			sched_local.cmd = cmd;
 
 			if (from)
@@ -583,6 +621,10 @@ static int schedule_multi(odp_queue_t *from, uint64_t wait,
 			continue;
 		}
 	}
+
+	sched_idle_done(&sched_global->idle, &idle, 0);
+
+	return 0;
 }
 
 static odp_event_t schedule(odp_queue_t *from, uint64_t wait)
@@ -625,6 +667,15 @@ static int schedule_num_prio(void)
 	return NUM_PRIO - 1;
 }
 
+static void schedule_print(void)
+{
+	ODP_PRINT("\nScheduler info (SP)\n-------------------\n");
+	ODP_PRINT("  Priorities       %i\n", NUM_PRIO - 1);
+	ODP_PRINT("  Groups           %i\n", NUM_GROUP);
+	sched_idle_print(&sched_global->idle);
+	ODP_PRINT("\n");
+}
+
 static odp_schedule_group_t schedule_group_create(const char *name,
 						  const odp_thrmask_t *thrmask)
 {
@@ -870,6 +921,7 @@ const schedule_api_t schedule_sp_api = {
 	.schedule_release_ordered = schedule_release_ordered,
 	.schedule_prefetch        = schedule_prefetch,
 	.schedule_num_prio        = schedule_num_prio,
+	.schedule_print           = schedule_print,
 	.schedule_group_create    = schedule_group_create,
 	.schedule_group_destroy   = schedule_group_destroy,
 	.schedule_group_lookup    = schedule_group_lookup,
@@ -0,0 +1,1801 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * Work-stealing scheduler
+ *
+ * Each scheduling thread owns ready rings (one per priority) of queues that
+ * have events. A thread serves queues from its own rings and steals from
+ * rings of randomly selected threads only when it runs out of local work.
+ * A queue returns to the ring of the thread that served it last, so queue
+ * state and events tend to stay in the cache of the same core. The common
+ * case touches only cache lines of the local thread, instead of the shared
+ * per priority rings of the default scheduler.
+ *
+ * Queues of a schedule group that has no scheduling threads are parked on
+ * shared per group rings, until a thread of the group starts scheduling.
+ * Atomic and ordered synchronization is the same as in the default
+ * scheduler: an atomic queue is held by one thread at a time, and ordered
+ * queues use per queue order contexts.
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <odp/api/schedule.h>
+#include <odp_schedule_if.h>
+#include <odp/api/align.h>
+#include <odp/api/shared_memory.h>
+#include <odp_internal.h>
+#include <odp_debug_internal.h>
+#include <odp/api/thread.h>
+#include <odp/api/time.h>
+#include <odp/api/spinlock.h>
+#include <odp/api/hints.h>
+#include <odp/api/cpu.h>
+#include <odp/api/thrmask.h>
+#include <odp_config_internal.h>
+#include <odp_align_internal.h>
+#include <odp/api/sync.h>
+#include <odp/api/packet_io.h>
+#include <odp_ring_internal.h>
+#include <odp_timer_internal.h>
+#include <odp_schedule_idle_internal.h>
+#include <odp_buffer_inlines.h>
+#include <odp_queue_internal.h>
+#include <odp/api/plat/packet_inlines.h>
+
+/* Number of priority levels  */
+#define NUM_PRIO 8
+
+ODP_STATIC_ASSERT(ODP_SCHED_PRIO_LOWEST == (NUM_PRIO - 1),
+		  "lowest_prio_does_not_match_with_num_prios");
+
+ODP_STATIC_ASSERT((ODP_SCHED_PRIO_NORMAL > 0) &&
+		  (ODP_SCHED_PRIO_NORMAL < (NUM_PRIO - 1)),
+		  "normal_prio_is_not_between_highest_and_lowest");
+
+/* Number of scheduling groups */
+#define NUM_SCHED_GRPS 32
+
+/* Group masks are stored as 32 bit words */
+ODP_STATIC_ASSERT(NUM_SCHED_GRPS <= 32, "Group_mask_too_small");
+
+/* Maximum number of threads */
+#define NUM_THR ODP_THREAD_COUNT_MAX
+
+/* A thread tries to steal work every this many scheduling rounds also when
+ * it has local work. This bounds the latency of queues left on rings of
+ * threads that do not call schedule for a while. */
+#define STEAL_INTERVAL 64
+
+/* Packet input poll cmd queues */
+#define PKTIO_CMD_QUEUES  4
+
+/* Mask for wrapping command queues */
+#define PKTIO_CMD_QUEUE_MASK (PKTIO_CMD_QUEUES - 1)
+
+/* Maximum number of packet input queues per command */
+#define MAX_PKTIN 16
+
+/* Maximum number of packet IO interfaces */
+#define NUM_PKTIO ODP_CONFIG_PKTIO_ENTRIES
+
+/* Maximum number of pktio poll commands */
+#define NUM_PKTIO_CMD (MAX_PKTIN * NUM_PKTIO)
+
+/* Not a valid index */
+#define NULL_INDEX ((uint32_t)-1)
+
+/* Not a valid poll command */
+#define PKTIO_CMD_INVALID NULL_INDEX
+
+/* Pktio command is free */
+#define PKTIO_CMD_FREE    PKTIO_CMD_INVALID
+
+/* Packet IO poll queue ring size. In worst case, all pktios have all pktins
+ * enabled and one poll command is created per pktin queue. The ring size must
+ * be larger than or equal to NUM_PKTIO_CMD / PKTIO_CMD_QUEUES, so that it can
+ * hold all poll commands in the worst case. */
+#define PKTIO_RING_SIZE (NUM_PKTIO_CMD / PKTIO_CMD_QUEUES)
+
+/* Mask for wrapping around pktio poll command index */
+#define PKTIO_RING_MASK (PKTIO_RING_SIZE - 1)
+
+/* Ready queue ring size. In worst case, all event queues are on the same
+ * ring. */
+#define READY_RING_SIZE ODP_CONFIG_QUEUES
+
+/* Mask for wrapping around ready queue index */
+#define READY_RING_MASK (READY_RING_SIZE - 1)
+
+/* Ring size must be power of two, so that READY_RING_MASK can be used. */
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(READY_RING_SIZE),
+		  "Ready_ring_size_is_not_power_of_two");
+
+/* Ring size must be power of two, so that PKTIO_RING_MASK can be used. */
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(PKTIO_RING_SIZE),
+		  "pktio_ring_size_is_not_power_of_two");
+
+/* Number of commands queues must be power of two, so that PKTIO_CMD_QUEUE_MASK
+ * can be used. */
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(PKTIO_CMD_QUEUES),
+		  "pktio_cmd_queues_is_not_power_of_two");
+
+/* Start of named groups in group mask arrays */
+#define SCHED_GROUP_NAMED (ODP_SCHED_GROUP_CONTROL + 1)
+
+/* Maximum number of dequeues */
+#define MAX_DEQ CONFIG_BURST_SIZE
+
+/* Ordered stash size */
+#define MAX_ORDERED_STASH 512
+
+/* Storage for stashed enqueue operation arguments */
+typedef struct {
+	odp_buffer_hdr_t *buf_hdr[QUEUE_MULTI_MAX];
+	queue_entry_t *queue_entry;
+	int num;
+} ordered_stash_t;
+
+/* Ordered lock states */
+typedef union {
+	uint8_t u8[CONFIG_QUEUE_MAX_ORD_LOCKS];
+	uint32_t all;
+} lock_called_t;
+
+ODP_STATIC_ASSERT(sizeof(lock_called_t) == sizeof(uint32_t),
+		  "Lock_called_values_do_not_fit_in_uint32");
+
+/* Scheduler local data */
+typedef struct {
+	int thr;
+	int num;
+	int index;
+	int pause;
+	int active;
+	uint32_t round;
+	uint32_t seed;
+	uint16_t pktin_polls;
+	uint32_t queue_index;
+	odp_queue_t queue;
+	odp_event_t ev_stash[MAX_DEQ];
+	struct {
+		/* Source queue index */
+		uint32_t src_queue;
+		uint64_t ctx; /**< Ordered context id */
+		int stash_num; /**< Number of stashed enqueue operations */
+		uint8_t in_order; /**< Order status */
+		lock_called_t lock_called; /**< States of ordered locks */
+		/** Storage for stashed enqueue operations */
+		ordered_stash_t stash[MAX_ORDERED_STASH];
+	} ordered;
+
+	/* Events pulled ahead by schedule_prefetch(). Events are stored in
+	 * ev_stash. Scheduling context of the source queue is taken into use
+	 * on the next schedule call. */
+	struct {
+		int num;
+		odp_queue_t queue;
+		/* Atomic queue to hold */
+		uint32_t queue_index;
+		/* Ordered queue and context */
+		uint32_t src_queue;
+		uint64_t ctx;
+	} prefetch;
+
+	uint32_t grp_epoch;
+	uint32_t grp_mask;
+
+	/* Number of queues stolen from other threads */
+	uint64_t steal;
+
+} sched_local_t;
+
+/* Ready queue ring */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Ring header */
+	ring_t ring;
+
+	/* Ring data: queue indexes */
+	uint32_t queue_index[READY_RING_SIZE];
+
+} ready_ring_t;
+
+/* Per thread scheduler state. Other threads add queues to the ready rings
+ * and steal queues from those. */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Number of queues on the ready rings. This is a hint, which may be
+	 * momentarily out of sync with the rings. */
+	odp_atomic_u32_t num;
+
+	/* Groups of the thread. Zero when the thread does not schedule. */
+	odp_atomic_u32_t grp_mask;
+
+	/* Ready queues per priority */
+	ready_ring_t ready[NUM_PRIO];
+
+} sched_thr_t;
+
+/* Packet IO queue */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Ring header */
+	ring_t ring;
+
+	/* Ring data: pktio poll command indexes */
+	uint32_t cmd_index[PKTIO_RING_SIZE];
+
+} pktio_queue_t;
+
+/* Packet IO poll command */
+typedef struct {
+	int pktio_index;
+	int num_pktin;
+	int pktin[MAX_PKTIN];
+	uint32_t cmd_index;
+} pktio_cmd_t;
+
+/* Order context of a queue */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Current ordered context id */
+	odp_atomic_u64_t ODP_ALIGNED_CACHE ctx;
+
+	/* Next unallocated context id */
+	odp_atomic_u64_t next_ctx;
+
+	/* Array of ordered locks */
+	odp_atomic_u64_t lock[CONFIG_QUEUE_MAX_ORD_LOCKS];
+
+} order_context_t;
+
+typedef struct {
+	sched_thr_t    thr[NUM_THR];
+
+	/* Queues of groups without scheduling threads */
+	ready_ring_t   parked[NUM_SCHED_GRPS][NUM_PRIO];
+	odp_atomic_u32_t num_parked;
+
+	/* Thread ids of scheduling threads are less than this */
+	odp_atomic_u32_t num_thr;
+
+	odp_spinlock_t poll_cmd_lock;
+	/* Number of commands in a command queue */
+	uint16_t       num_pktio_cmd[PKTIO_CMD_QUEUES];
+
+	/* Packet IO command queues */
+	pktio_queue_t  pktio_q[PKTIO_CMD_QUEUES];
+
+	/* Packet IO poll commands */
+	pktio_cmd_t    pktio_cmd[NUM_PKTIO_CMD];
+
+	odp_shm_t      shm;
+
+	/* Maximum number of events pulled ahead by schedule_prefetch() */
+	int            prefetch_depth;
+
+	odp_thrmask_t    mask_all;
+	odp_spinlock_t   grp_lock;
+	odp_atomic_u32_t grp_epoch;
+
+	struct {
+		char           name[ODP_SCHED_GROUP_NAME_LEN];
+		odp_thrmask_t  mask;
+		int	       allocated;
+	} sched_grp[NUM_SCHED_GRPS];
+
+	struct {
+		int         grp;
+		int         prio;
+		int         sync;
+		uint32_t    order_lock_count;
+		/* Thread that served the queue last */
+		uint32_t    thr;
+	} queue[ODP_CONFIG_QUEUES];
+
+	struct {
+		/* Number of active commands for a pktio interface */
+		int num_cmd;
+	} pktio[NUM_PKTIO];
+
+	order_context_t order[ODP_CONFIG_QUEUES];
+
+	/* Threads waiting for events */
+	sched_idle_t idle;
+
+} sched_global_t;
+
+/* Global scheduler context */
+static sched_global_t *sched;
+
+/* Thread local scheduler context */
+static __thread sched_local_t sched_local;
+
+/* Function prototypes */
+static inline void schedule_release_context(void);
+
+static void sched_local_init(void)
+{
+	memset(&sched_local, 0, sizeof(sched_local_t));
+
+	sched_local.thr       = odp_thread_id();
+	sched_local.queue     = ODP_QUEUE_INVALID;
+	sched_local.queue_index = NULL_INDEX;
+	sched_local.ordered.src_queue = NULL_INDEX;
+	sched_local.prefetch.queue_index = NULL_INDEX;
+	sched_local.prefetch.src_queue = NULL_INDEX;
+	sched_local.seed      = sched_local.thr + 1;
+}
+
+static int schedule_init_global(void)
+{
+	odp_shm_t shm;
+	int i, j, grp;
+	const char *env;
+
+	ODP_DBG("Schedule init ... ");
+
+	shm = odp_shm_reserve("odp_scheduler",
+			      sizeof(sched_global_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+
+	sched = odp_shm_addr(shm);
+
+	if (sched == NULL) {
+		ODP_ERR("Schedule init: Shm reserve failed.\n");
+		return -1;
+	}
+
+	memset(sched, 0, sizeof(sched_global_t));
+
+	sched->shm  = shm;
+
+	sched->prefetch_depth = CONFIG_SCHED_PREFETCH;
+
+	env = getenv("ODP_SCHED_PREFETCH");
+	if (env) {
+		i = atoi(env);
+		if (i >= 0 && i <= MAX_DEQ)
+			sched->prefetch_depth = i;
+	}
+
+	for (i = 0; i < NUM_THR; i++) {
+		odp_atomic_init_u32(&sched->thr[i].num, 0);
+		odp_atomic_init_u32(&sched->thr[i].grp_mask, 0);
+
+		for (j = 0; j < NUM_PRIO; j++)
+			ring_init(&sched->thr[i].ready[j].ring);
+	}
+
+	for (grp = 0; grp < NUM_SCHED_GRPS; grp++)
+		for (i = 0; i < NUM_PRIO; i++)
+			ring_init(&sched->parked[grp][i].ring);
+
+	odp_atomic_init_u32(&sched->num_parked, 0);
+	odp_atomic_init_u32(&sched->num_thr, 0);
+
+	odp_spinlock_init(&sched->poll_cmd_lock);
+	for (i = 0; i < PKTIO_CMD_QUEUES; i++) {
+		ring_init(&sched->pktio_q[i].ring);
+
+		for (j = 0; j < PKTIO_RING_SIZE; j++)
+			sched->pktio_q[i].cmd_index[j] = PKTIO_CMD_INVALID;
+	}
+
+	for (i = 0; i < NUM_PKTIO_CMD; i++)
+		sched->pktio_cmd[i].cmd_index = PKTIO_CMD_FREE;
+
+	odp_spinlock_init(&sched->grp_lock);
+	odp_atomic_init_u32(&sched->grp_epoch, 0);
+
+	for (i = 0; i < NUM_SCHED_GRPS; i++) {
+		memset(sched->sched_grp[i].name, 0, ODP_SCHED_GROUP_NAME_LEN);
+		odp_thrmask_zero(&sched->sched_grp[i].mask);
+	}
+
+	sched->sched_grp[ODP_SCHED_GROUP_ALL].allocated = 1;
+	sched->sched_grp[ODP_SCHED_GROUP_WORKER].allocated = 1;
+	sched->sched_grp[ODP_SCHED_GROUP_CONTROL].allocated = 1;
+
+	odp_thrmask_setall(&sched->mask_all);
+
+	sched_idle_init(&sched->idle);
+
+	ODP_DBG("done\n");
+
+	return 0;
+}
+
+static void ready_ring_drain(ring_t *ring)
+{
+	uint32_t qi;
+
+	while ((qi = ring_deq(ring, READY_RING_MASK)) != RING_EMPTY) {
+		odp_event_t events[1];
+		int num;
+
+		num = sched_cb_queue_deq_multi(qi, events, 1);
+
+		if (num < 0)
+			sched_cb_queue_destroy_finalize(qi);
+
+		if (num > 0)
+			ODP_ERR("Queue not empty\n");
+	}
+}
+
+static int schedule_term_global(void)
+{
+	int ret = 0;
+	int rc = 0;
+	int i, j, grp;
+
+	for (i = 0; i < NUM_THR; i++)
+		for (j = 0; j < NUM_PRIO; j++)
+			ready_ring_drain(&sched->thr[i].ready[j].ring);
+
+	for (grp = 0; grp < NUM_SCHED_GRPS; grp++)
+		for (i = 0; i < NUM_PRIO; i++)
+			ready_ring_drain(&sched->parked[grp][i].ring);
+
+	ret = odp_shm_free(sched->shm);
+	if (ret < 0) {
+		ODP_ERR("Shm free failed for odp_scheduler");
+		rc = -1;
+	}
+
+	return rc;
+}
+
+/* Add a queue to the ready ring of a thread */
+static inline void thr_ready(uint32_t thr, uint32_t queue_index, int prio)
+{
+	sched_thr_t *sched_thr = &sched->thr[thr];
+
+	ring_enq(&sched_thr->ready[prio].ring, READY_RING_MASK, queue_index);
+	odp_atomic_inc_u32(&sched_thr->num);
+}
+
+/* Select a thread for a queue. The thread that served the queue last is
+ * preferred. Queues without a preferred thread are spread over threads of
+ * the group. Returns NULL_INDEX when no thread of the group schedules. */
+static inline uint32_t select_thr(uint32_t queue_index, int grp)
+{
+	uint32_t grp_bit = 1u << grp;
+	uint32_t thr = sched->queue[queue_index].thr;
+	uint32_t num_thr, i;
+
+	if (odp_likely(thr != NULL_INDEX &&
+		       (odp_atomic_load_u32(&sched->thr[thr].grp_mask) &
+			grp_bit)))
+		return thr;
+
+	num_thr = odp_atomic_load_acq_u32(&sched->num_thr);
+
+	for (i = 0; i < num_thr; i++) {
+		thr = (queue_index + i) % num_thr;
+
+		if (odp_atomic_load_u32(&sched->thr[thr].grp_mask) & grp_bit)
+			return thr;
+	}
+
+	return NULL_INDEX;
+}
+
+/* Make a queue ready for scheduling */
+static inline void queue_ready(uint32_t queue_index)
+{
+	int grp  = sched->queue[queue_index].grp;
+	int prio = sched->queue[queue_index].prio;
+	uint32_t thr = select_thr(queue_index, grp);
+
+	if (odp_likely(thr != NULL_INDEX)) {
+		thr_ready(thr, queue_index, prio);
+	} else {
+		ring_enq(&sched->parked[grp][prio].ring, READY_RING_MASK,
+			 queue_index);
+		odp_atomic_inc_u32(&sched->num_parked);
+	}
+
+	sched_idle_wake(&sched->idle);
+}
+
+static inline void grp_update_mask(int grp, const odp_thrmask_t *new_mask)
+{
+	odp_thrmask_copy(&sched->sched_grp[grp].mask, new_mask);
+	odp_atomic_add_rel_u32(&sched->grp_epoch, 1);
+
+	/* Sleeping threads need to update their groups */
+	sched_idle_wake(&sched->idle);
+}
+
+static inline void grp_update_tbl(void)
+{
+	int i;
+	uint32_t mask = 0;
+	int thr = sched_local.thr;
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	for (i = 0; i < NUM_SCHED_GRPS; i++) {
+		if (sched->sched_grp[i].allocated == 0)
+			continue;
+
+		if (odp_thrmask_isset(&sched->sched_grp[i].mask, thr))
+			mask |= 1u << i;
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+
+	sched_local.grp_mask = mask;
+
+	if (sched_local.active)
+		odp_atomic_store_rel_u32(&sched->thr[thr].grp_mask, mask);
+}
+
+/* Thread starts to schedule. Other threads may add queues to its rings and
+ * steal from those after this. */
+static void thr_activate(void)
+{
+	uint32_t thr = sched_local.thr;
+
+	sched_local.active = 1;
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	if (odp_atomic_load_u32(&sched->num_thr) <= thr)
+		odp_atomic_store_rel_u32(&sched->num_thr, thr + 1);
+
+	odp_spinlock_unlock(&sched->grp_lock);
+
+	sched_local.grp_epoch = odp_atomic_load_acq_u32(&sched->grp_epoch);
+	grp_update_tbl();
+}
+
+/* Thread stops scheduling. Queues left on its rings move to other threads. */
+static void thr_deactivate(void)
+{
+	sched_thr_t *sched_thr = &sched->thr[sched_local.thr];
+	uint32_t qi;
+	int prio;
+
+	odp_atomic_store_rel_u32(&sched_thr->grp_mask, 0);
+	sched_local.active = 0;
+
+	/* Pairs with ready ring enqueue. Queues added after this are
+	 * stolen by other threads. */
+	odp_mb_full();
+
+	for (prio = 0; prio < NUM_PRIO; prio++) {
+		ring_t *ring = &sched_thr->ready[prio].ring;
+
+		while ((qi = ring_deq(ring, READY_RING_MASK)) != RING_EMPTY) {
+			odp_atomic_dec_u32(&sched_thr->num);
+			queue_ready(qi);
+		}
+	}
+}
+
+static int schedule_init_local(void)
+{
+	sched_local_init();
+	return 0;
+}
+
+static int schedule_term_local(void)
+{
+	if (sched_local.num || sched_local.prefetch.num) {
+		ODP_ERR("Locally pre-scheduled events exist.\n");
+		return -1;
+	}
+
+	schedule_release_context();
+
+	if (sched_local.active)
+		thr_deactivate();
+
+	return 0;
+}
+
+static uint32_t schedule_max_ordered_locks(void)
+{
+	return CONFIG_QUEUE_MAX_ORD_LOCKS;
+}
+
+static int schedule_init_queue(uint32_t queue_index,
+			       const odp_schedule_param_t *sched_param)
+{
+	int i;
+
+	sched->queue[queue_index].grp  = sched_param->group;
+	sched->queue[queue_index].prio = sched_param->prio;
+	sched->queue[queue_index].sync = sched_param->sync;
+	sched->queue[queue_index].order_lock_count = sched_param->lock_count;
+	sched->queue[queue_index].thr  = NULL_INDEX;
+
+	odp_atomic_init_u64(&sched->order[queue_index].ctx, 0);
+	odp_atomic_init_u64(&sched->order[queue_index].next_ctx, 0);
+
+	for (i = 0; i < CONFIG_QUEUE_MAX_ORD_LOCKS; i++)
+		odp_atomic_init_u64(&sched->order[queue_index].lock[i], 0);
+
+	return 0;
+}
+
+static inline int queue_is_atomic(uint32_t queue_index)
+{
+	return sched->queue[queue_index].sync == ODP_SCHED_SYNC_ATOMIC;
+}
+
+static inline int queue_is_ordered(uint32_t queue_index)
+{
+	return sched->queue[queue_index].sync == ODP_SCHED_SYNC_ORDERED;
+}
+
+static void schedule_destroy_queue(uint32_t queue_index)
+{
+	sched->queue[queue_index].grp = 0;
+	sched->queue[queue_index].prio = 0;
+	sched->queue[queue_index].thr = NULL_INDEX;
+
+	if (queue_is_ordered(queue_index) &&
+	    odp_atomic_load_u64(&sched->order[queue_index].ctx) !=
+	    odp_atomic_load_u64(&sched->order[queue_index].next_ctx))
+		ODP_ERR("queue reorder incomplete\n");
+}
+
+static int poll_cmd_queue_idx(int pktio_index, int pktin_idx)
+{
+	return PKTIO_CMD_QUEUE_MASK & (pktio_index ^ pktin_idx);
+}
+
+static inline pktio_cmd_t *alloc_pktio_cmd(void)
+{
+	int i;
+	pktio_cmd_t *cmd = NULL;
+
+	odp_spinlock_lock(&sched->poll_cmd_lock);
+
+	/* Find next free command */
+	for (i = 0; i < NUM_PKTIO_CMD; i++) {
+		if (sched->pktio_cmd[i].cmd_index == PKTIO_CMD_FREE) {
+			cmd = &sched->pktio_cmd[i];
+			cmd->cmd_index = i;
+			break;
+		}
+	}
+
+	odp_spinlock_unlock(&sched->poll_cmd_lock);
+
+	return cmd;
+}
+
+static inline void free_pktio_cmd(pktio_cmd_t *cmd)
+{
+	odp_spinlock_lock(&sched->poll_cmd_lock);
+
+	cmd->cmd_index = PKTIO_CMD_FREE;
+
+	odp_spinlock_unlock(&sched->poll_cmd_lock);
+}
+
+static void schedule_pktio_start(int pktio_index, int num_pktin,
+				 int pktin_idx[], odp_queue_t odpq[] ODP_UNUSED)
+{
+	int i, idx;
+	pktio_cmd_t *cmd;
+
+	if (num_pktin > MAX_PKTIN)
+		ODP_ABORT("Too many input queues for scheduler\n");
+
+	sched->pktio[pktio_index].num_cmd = num_pktin;
+
+	/* Create a pktio poll command per queue */
+	for (i = 0; i < num_pktin; i++) {
+
+		cmd = alloc_pktio_cmd();
+
+		if (cmd == NULL)
+			ODP_ABORT("Scheduler out of pktio commands\n");
+
+		idx = poll_cmd_queue_idx(pktio_index, pktin_idx[i]);
+
+		odp_spinlock_lock(&sched->poll_cmd_lock);
+		sched->num_pktio_cmd[idx]++;
+		odp_spinlock_unlock(&sched->poll_cmd_lock);
+
+		cmd->pktio_index = pktio_index;
+		cmd->num_pktin   = 1;
+		cmd->pktin[0]    = pktin_idx[i];
+		ring_enq(&sched->pktio_q[idx].ring, PKTIO_RING_MASK,
+			 cmd->cmd_index);
+	}
+
+	/* Sleeping threads need to start polling */
+	sched_idle_wake(&sched->idle);
+}
+
+static int schedule_pktio_stop(int pktio_index, int first_pktin)
+{
+	int num;
+	int idx = poll_cmd_queue_idx(pktio_index, first_pktin);
+
+	odp_spinlock_lock(&sched->poll_cmd_lock);
+	sched->num_pktio_cmd[idx]--;
+	sched->pktio[pktio_index].num_cmd--;
+	num = sched->pktio[pktio_index].num_cmd;
+	odp_spinlock_unlock(&sched->poll_cmd_lock);
+
+	return num;
+}
+
+static void schedule_release_atomic(void)
+{
+	uint32_t qi = sched_local.queue_index;
+
+	if (qi != NULL_INDEX && sched_local.num  == 0) {
+		/* Release current atomic queue back to the local ring */
+		thr_ready(sched_local.thr, qi, sched->queue[qi].prio);
+		sched_local.queue_index = NULL_INDEX;
+		sched_idle_wake(&sched->idle);
+	}
+}
+
+static inline int ordered_own_turn(uint32_t queue_index)
+{
+	uint64_t ctx;
+
+	ctx = odp_atomic_load_acq_u64(&sched->order[queue_index].ctx);
+
+	return ctx == sched_local.ordered.ctx;
+}
+
+static inline void wait_for_order(uint32_t queue_index)
+{
+	/* Busy loop to synchronize ordered processing */
+	while (1) {
+		if (ordered_own_turn(queue_index))
+			break;
+		odp_cpu_pause();
+	}
+}
+
+/**
+ * Perform stashed enqueue operations
+ *
+ * Should be called only when already in order.
+ */
+static inline void ordered_stash_release(void)
+{
+	int i;
+
+	for (i = 0; i < sched_local.ordered.stash_num; i++) {
+		queue_entry_t *queue_entry;
+		odp_buffer_hdr_t **buf_hdr;
+		int num, num_enq;
+
+		queue_entry = sched_local.ordered.stash[i].queue_entry;
+		buf_hdr = sched_local.ordered.stash[i].buf_hdr;
+		num = sched_local.ordered.stash[i].num;
+
+		num_enq = queue_fn->enq_multi(qentry_to_int(queue_entry),
+					      buf_hdr, num);
+
+		/* Drop events that did not fit into a bounded destination
+		 * queue */
+		if (odp_unlikely(num_enq < num)) {
+			int j;
+
+			if (odp_unlikely(num_enq < 0))
+				num_enq = 0;
+
+			ODP_DBG("Dropped %i events\n", num - num_enq);
+
+			for (j = num_enq; j < num; j++)
+				odp_event_free(odp_buffer_to_event(
+					       buf_from_buf_hdr(buf_hdr[j])));
+		}
+	}
+	sched_local.ordered.stash_num = 0;
+}
+
+static inline void release_ordered(void)
+{
+	uint32_t qi;
+	uint32_t i;
+
+	qi = sched_local.ordered.src_queue;
+
+	wait_for_order(qi);
+
+	/* Release all ordered locks */
+	for (i = 0; i < sched->queue[qi].order_lock_count; i++) {
+		if (!sched_local.ordered.lock_called.u8[i])
+			odp_atomic_store_rel_u64(&sched->order[qi].lock[i],
+						 sched_local.ordered.ctx + 1);
+	}
+
+	sched_local.ordered.lock_called.all = 0;
+	sched_local.ordered.src_queue = NULL_INDEX;
+	sched_local.ordered.in_order = 0;
+
+	ordered_stash_release();
+
+	/* Next thread can continue processing */
+	odp_atomic_add_rel_u64(&sched->order[qi].ctx, 1);
+}
+
+static void schedule_release_ordered(void)
+{
+	uint32_t queue_index;
+
+	queue_index = sched_local.ordered.src_queue;
+
+	if (odp_unlikely((queue_index == NULL_INDEX) || sched_local.num))
+		return;
+
+	release_ordered();
+}
+
+static inline void schedule_release_context(void)
+{
+	if (sched_local.ordered.src_queue != NULL_INDEX)
+		release_ordered();
+	else
+		schedule_release_atomic();
+}
+
+static inline int copy_events(odp_event_t out_ev[], unsigned int max)
+{
+	int i = 0;
+
+	while (sched_local.num && max) {
+		out_ev[i] = sched_local.ev_stash[sched_local.index];
+		sched_local.index++;
+		sched_local.num--;
+		max--;
+		i++;
+	}
+
+	return i;
+}
+
+static int schedule_ord_enq_multi(queue_t q_int, void *buf_hdr[],
+				  int num, int *ret)
+{
+	int i;
+	uint32_t stash_num = sched_local.ordered.stash_num;
+	queue_entry_t *dst_queue = qentry_from_int(q_int);
+	uint32_t src_queue = sched_local.ordered.src_queue;
+
+	if ((src_queue == NULL_INDEX) || sched_local.ordered.in_order)
+		return 0;
+
+	if (ordered_own_turn(src_queue)) {
+		/* Own turn, so can do enqueue directly. */
+		sched_local.ordered.in_order = 1;
+		ordered_stash_release();
+		return 0;
+	}
+
+	/* Pktout may drop packets, so the operation cannot be stashed. */
+	if (dst_queue->s.pktout.pktio != ODP_PKTIO_INVALID ||
+	    odp_unlikely(stash_num >=  MAX_ORDERED_STASH)) {
+		/* If the local stash is full, wait until it is our turn and
+		 * then release the stash and do enqueue directly. */
+		wait_for_order(src_queue);
+
+		sched_local.ordered.in_order = 1;
+
+		ordered_stash_release();
+		return 0;
+	}
+
+	sched_local.ordered.stash[stash_num].queue_entry = dst_queue;
+	sched_local.ordered.stash[stash_num].num = num;
+	for (i = 0; i < num; i++)
+		sched_local.ordered.stash[stash_num].buf_hdr[i] = buf_hdr[i];
+
+	sched_local.ordered.stash_num++;
+
+	*ret = num;
+	return 1;
+}
+
+/* Prefetch the first data cache line of packets. Event headers have been
+ * prefetched on dequeue. */
+static inline void prefetch_events(odp_event_t ev[], int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		odp_buffer_hdr_t *buf_hdr = (odp_buffer_hdr_t *)(uintptr_t)ev[i];
+
+		if (buf_hdr->event_type == ODP_EVENT_PACKET)
+			odp_prefetch(_odp_packet_data((odp_packet_t)buf_hdr));
+	}
+}
+
+/* Take events pulled ahead by schedule_prefetch() into use */
+static inline int prefetch_use(odp_queue_t *out_queue, odp_event_t out_ev[],
+			       unsigned int max_num)
+{
+	int ret;
+
+	sched_local.num   = sched_local.prefetch.num;
+	sched_local.index = 0;
+	sched_local.queue = sched_local.prefetch.queue;
+	sched_local.queue_index = sched_local.prefetch.queue_index;
+
+	if (sched_local.prefetch.src_queue != NULL_INDEX) {
+		sched_local.ordered.ctx = sched_local.prefetch.ctx;
+		sched_local.ordered.src_queue = sched_local.prefetch.src_queue;
+	}
+
+	sched_local.prefetch.num = 0;
+	sched_local.prefetch.queue_index = NULL_INDEX;
+	sched_local.prefetch.src_queue = NULL_INDEX;
+
+	ret = copy_events(out_ev, max_num);
+
+	if (out_queue)
+		*out_queue = sched_local.queue;
+
+	return ret;
+}
+
+/* Schedule events from a queue taken from a ready ring. Returns zero when
+ * the queue had no events or belongs to a group of other threads. When
+ * 'prefetch' is set, events are left in the local stash and the scheduling
+ * context is stored for later use. */
+static inline int schedule_queue(uint32_t qi, odp_queue_t *out_queue,
+				 odp_event_t out_ev[], unsigned int max_num,
+				 int prefetch)
+{
+	int num, ret, ordered, atomic;
+	odp_queue_t handle;
+	unsigned int max_deq = MAX_DEQ;
+	uint32_t thr = sched_local.thr;
+	int prio = sched->queue[qi].prio;
+
+	/* Queue of a group this thread is not part of (anymore) */
+	if (odp_unlikely(!(sched_local.grp_mask &
+			   (1u << sched->queue[qi].grp)))) {
+		queue_ready(qi);
+		return 0;
+	}
+
+	/* Low priorities have smaller batch size to limit head of line
+	 * blocking latency. */
+	if (odp_unlikely(MAX_DEQ > 1 && prio > ODP_SCHED_PRIO_DEFAULT))
+		max_deq = MAX_DEQ / 2;
+
+	ordered = queue_is_ordered(qi);
+	atomic  = queue_is_atomic(qi);
+
+	/* Do not cache ordered events locally to improve parallelism.
+	 * Ordered context can only be released when the local cache is
+	 * empty. Events pulled ahead are limited to the prefetch depth. */
+	if ((ordered || prefetch) && max_num < MAX_DEQ)
+		max_deq = max_num;
+
+	num = sched_cb_queue_deq_multi(qi, sched_local.ev_stash, max_deq);
+
+	if (num < 0) {
+		/* Destroyed queue */
+		sched_cb_queue_destroy_finalize(qi);
+		return 0;
+	}
+
+	/* Empty queue is removed from scheduling */
+	if (num == 0)
+		return 0;
+
+	/* Queue returns to this thread */
+	if (sched->queue[qi].thr != thr)
+		sched->queue[qi].thr = thr;
+
+	handle = sched_cb_queue_handle(qi);
+
+	if (prefetch) {
+		sched_local.prefetch.num   = num;
+		sched_local.prefetch.queue = handle;
+		ret = num;
+	} else {
+		sched_local.num   = num;
+		sched_local.index = 0;
+		sched_local.queue = handle;
+		ret = copy_events(out_ev, max_num);
+	}
+
+	if (ordered) {
+		uint64_t ctx;
+		odp_atomic_u64_t *next_ctx;
+
+		next_ctx = &sched->order[qi].next_ctx;
+		ctx = odp_atomic_fetch_inc_u64(next_ctx);
+
+		if (prefetch) {
+			sched_local.prefetch.ctx = ctx;
+			sched_local.prefetch.src_queue = qi;
+		} else {
+			sched_local.ordered.ctx = ctx;
+			sched_local.ordered.src_queue = qi;
+		}
+
+		/* Continue scheduling ordered queues */
+		thr_ready(thr, qi, prio);
+
+	} else if (atomic) {
+		/* Hold queue during atomic access */
+		if (prefetch)
+			sched_local.prefetch.queue_index = qi;
+		else
+			sched_local.queue_index = qi;
+	} else {
+		/* Continue scheduling the queue */
+		thr_ready(thr, qi, prio);
+	}
+
+	/* A full burst from a queue that is still scheduled hints that there
+	 * is work for sleeping threads to steal */
+	if (num == (int)max_deq && !atomic)
+		sched_idle_wake(&sched->idle);
+
+	/* Output the source queue handle */
+	if (out_queue)
+		*out_queue = handle;
+
+	return ret;
+}
+
+/* Schedule from local ready rings in priority order */
+static inline int schedule_local(odp_queue_t *out_queue, odp_event_t out_ev[],
+				 unsigned int max_num, int prefetch)
+{
+	sched_thr_t *sched_thr = &sched->thr[sched_local.thr];
+	int prio, ret;
+	uint32_t qi;
+
+	if (odp_atomic_load_u32(&sched_thr->num) == 0)
+		return 0;
+
+	for (prio = 0; prio < NUM_PRIO; prio++) {
+		ring_t *ring = &sched_thr->ready[prio].ring;
+
+		while ((qi = ring_deq(ring, READY_RING_MASK)) != RING_EMPTY) {
+			odp_atomic_dec_u32(&sched_thr->num);
+
+			ret = schedule_queue(qi, out_queue, out_ev, max_num,
+					     prefetch);
+
+			if (ret)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Schedule queues parked on groups of this thread */
+static inline int schedule_parked(odp_queue_t *out_queue, odp_event_t out_ev[],
+				  unsigned int max_num, int prefetch)
+{
+	int prio, grp, ret;
+	uint32_t qi, grp_mask;
+
+	if (odp_likely(odp_atomic_load_u32(&sched->num_parked) == 0))
+		return 0;
+
+	for (prio = 0; prio < NUM_PRIO; prio++) {
+		grp_mask = sched_local.grp_mask;
+
+		while (grp_mask) {
+			ring_t *ring;
+
+			grp = __builtin_ctz(grp_mask);
+			grp_mask &= ~(1u << grp);
+			ring = &sched->parked[grp][prio].ring;
+
+			qi = ring_deq(ring, READY_RING_MASK);
+
+			if (qi == RING_EMPTY)
+				continue;
+
+			odp_atomic_dec_u32(&sched->num_parked);
+
+			ret = schedule_queue(qi, out_queue, out_ev, max_num,
+					     prefetch);
+
+			if (ret)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
+static inline uint32_t random_u32(void)
+{
+	/* xorshift32 */
+	uint32_t x = sched_local.seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	sched_local.seed = x;
+
+	return x;
+}
+
+/* Steal a queue from another thread. Victims are visited in random order.
+ * The highest priority queue of a victim is stolen. */
+static inline int schedule_steal(odp_queue_t *out_queue, odp_event_t out_ev[],
+				 unsigned int max_num, int prefetch)
+{
+	uint32_t num_thr, first, i, qi, grp_mask;
+	uint32_t thr = sched_local.thr;
+	int prio, ret;
+
+	num_thr = odp_atomic_load_acq_u32(&sched->num_thr);
+
+	if (odp_unlikely(num_thr < 2))
+		return 0;
+
+	first = random_u32() % num_thr;
+
+	for (i = 0; i < num_thr; i++) {
+		uint32_t victim = first + i;
+		sched_thr_t *sched_thr;
+
+		if (victim >= num_thr)
+			victim -= num_thr;
+
+		sched_thr = &sched->thr[victim];
+
+		if (victim == thr ||
+		    odp_atomic_load_u32(&sched_thr->num) == 0)
+			continue;
+
+		/* Skip threads of other groups. Queues left on rings of
+		 * threads that do not schedule anymore are always stolen. */
+		grp_mask = odp_atomic_load_u32(&sched_thr->grp_mask);
+
+		if (grp_mask && !(grp_mask & sched_local.grp_mask))
+			continue;
+
+		for (prio = 0; prio < NUM_PRIO; prio++) {
+			qi = ring_deq(&sched_thr->ready[prio].ring,
+				      READY_RING_MASK);
+
+			if (qi == RING_EMPTY)
+				continue;
+
+			odp_atomic_dec_u32(&sched_thr->num);
+			sched_local.steal++;
+
+			ret = schedule_queue(qi, out_queue, out_ev, max_num,
+					     prefetch);
+
+			if (ret)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Schedule queues of the thread: occasionally steal, then local and parked
+ * queues */
+static inline int schedule_queues(odp_queue_t *out_queue, odp_event_t out_ev[],
+				  unsigned int max_num, int prefetch)
+{
+	int ret;
+	uint32_t epoch;
+
+	epoch = odp_atomic_load_acq_u32(&sched->grp_epoch);
+
+	if (odp_unlikely(sched_local.grp_epoch != epoch)) {
+		grp_update_tbl();
+		sched_local.grp_epoch = epoch;
+	}
+
+	sched_local.round++;
+
+	if (odp_unlikely((sched_local.round % STEAL_INTERVAL) == 0)) {
+		ret = schedule_steal(out_queue, out_ev, max_num, prefetch);
+
+		if (ret)
+			return ret;
+	}
+
+	ret = schedule_local(out_queue, out_ev, max_num, prefetch);
+
+	if (odp_likely(ret))
+		return ret;
+
+	return schedule_parked(out_queue, out_ev, max_num, prefetch);
+}
+
+/*
+ * Schedule queues
+ */
+static inline int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
+			      unsigned int max_num)
+{
+	int i;
+	int ret;
+	int id;
+
+	if (sched_local.num) {
+		ret = copy_events(out_ev, max_num);
+
+		if (out_queue)
+			*out_queue = sched_local.queue;
+
+		return ret;
+	}
+
+	schedule_release_context();
+
+	if (odp_unlikely(sched_local.prefetch.num))
+		return prefetch_use(out_queue, out_ev, max_num);
+
+	if (odp_unlikely(sched_local.pause))
+		return 0;
+
+	ret = schedule_queues(out_queue, out_ev, max_num, 0);
+
+	if (odp_likely(ret))
+		return ret;
+
+	/*
+	 * Poll packet input when there are no events
+	 *   * Each thread starts the search for a poll command from its
+	 *     preferred command queue. If the queue is empty, it moves to other
+	 *     queues.
+	 *   * Most of the times, the search stops on the first command found to
+	 *     optimize multi-threaded performance. A small portion of polls
+	 *     have to do full iteration to avoid packet input starvation when
+	 *     there are less threads than command queues.
+	 */
+	id = sched_local.thr & PKTIO_CMD_QUEUE_MASK;
+
+	for (i = 0; i < PKTIO_CMD_QUEUES; i++, id = ((id + 1) &
+	     PKTIO_CMD_QUEUE_MASK)) {
+		ring_t *ring;
+		uint32_t cmd_index;
+		pktio_cmd_t *cmd;
+
+		if (odp_unlikely(sched->num_pktio_cmd[id] == 0))
+			continue;
+
+		ring      = &sched->pktio_q[id].ring;
+		cmd_index = ring_deq(ring, PKTIO_RING_MASK);
+
+		if (odp_unlikely(cmd_index == RING_EMPTY))
+			continue;
+
+		cmd = &sched->pktio_cmd[cmd_index];
+
+		/* Poll packet input */
+		if (odp_unlikely(sched_cb_pktin_poll(cmd->pktio_index,
+						     cmd->num_pktin,
+						     cmd->pktin) < 0)) {
+			/* Pktio stopped or closed. Remove poll command and call
+			 * stop_finalize when all commands of the pktio has
+			 * been removed. */
+			if (schedule_pktio_stop(cmd->pktio_index,
+						cmd->pktin[0]) == 0)
+				sched_cb_pktio_stop_finalize(cmd->pktio_index);
+
+			free_pktio_cmd(cmd);
+		} else {
+			/* Continue scheduling the pktio */
+			ring_enq(ring, PKTIO_RING_MASK, cmd_index);
+
+			/* Do not iterate through all pktin poll command queues
+			 * every time. */
+			if (odp_likely(sched_local.pktin_polls & 0xf))
+				break;
+		}
+	}
+
+	sched_local.pktin_polls++;
+
+	/* Out of local work */
+	return schedule_steal(out_queue, out_ev, max_num, 0);
+}
+
+/* Packet input and inline timers are polled only by scheduling threads */
+static inline int idle_poll(void)
+{
+	int i;
+
+	if (inline_timers)
+		return 1;
+
+	for (i = 0; i < PKTIO_CMD_QUEUES; i++)
+		if (sched->num_pktio_cmd[i])
+			return 1;
+
+	return 0;
+}
+
+static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
+			 odp_event_t out_ev[],
+			 unsigned int max_num)
+{
+	odp_time_t next, now;
+	sched_idle_wait_t idle;
+	uint64_t tmo_ns = UINT64_MAX;
+	int first = 1;
+	int ret;
+
+	if (odp_unlikely(!sched_local.active))
+		thr_activate();
+
+	sched_idle_wait_init(&idle);
+
+	while (1) {
+		sched_idle_prepare(&sched->idle, &idle);
+
+		timer_run();
+
+		ret = do_schedule(out_queue, out_ev, max_num);
+
+		if (ret)
+			break;
+
+		if (wait == ODP_SCHED_NO_WAIT)
+			break;
+
+		if (wait != ODP_SCHED_WAIT) {
+			now = odp_time_local();
+
+			if (first) {
+				next = odp_time_local_from_ns(wait);
+				next = odp_time_sum(now, next);
+				first = 0;
+			} else if (odp_time_cmp(next, now) < 0) {
+				break;
+			}
+
+			tmo_ns = odp_time_to_ns(odp_time_diff(next, now));
+		}
+
+		sched_idle_wait(&sched->idle, &idle, tmo_ns, idle_poll());
+	}
+
+	sched_idle_done(&sched->idle, &idle, ret);
+
+	return ret;
+}
+
+static odp_event_t schedule(odp_queue_t *out_queue, uint64_t wait)
+{
+	odp_event_t ev;
+
+	ev = ODP_EVENT_INVALID;
+
+	schedule_loop(out_queue, wait, &ev, 1);
+
+	return ev;
+}
+
+static int schedule_multi(odp_queue_t *out_queue, uint64_t wait,
+			  odp_event_t events[], int num)
+{
+	return schedule_loop(out_queue, wait, events, num);
+}
+
+static inline void order_lock(void)
+{
+	uint32_t queue_index;
+
+	queue_index = sched_local.ordered.src_queue;
+
+	if (queue_index == NULL_INDEX)
+		return;
+
+	wait_for_order(queue_index);
+}
+
+static void order_unlock(void)
+{
+}
+
+static void schedule_order_lock(uint32_t lock_index)
+{
+	odp_atomic_u64_t *ord_lock;
+	uint32_t queue_index;
+
+	queue_index = sched_local.ordered.src_queue;
+
+	ODP_ASSERT(queue_index != NULL_INDEX &&
+		   lock_index <= sched->queue[queue_index].order_lock_count &&
+		   !sched_local.ordered.lock_called.u8[lock_index]);
+
+	ord_lock = &sched->order[queue_index].lock[lock_index];
+
+	/* Busy loop to synchronize ordered processing */
+	while (1) {
+		uint64_t lock_seq;
+
+		lock_seq = odp_atomic_load_acq_u64(ord_lock);
+
+		if (lock_seq == sched_local.ordered.ctx) {
+			sched_local.ordered.lock_called.u8[lock_index] = 1;
+			return;
+		}
+		odp_cpu_pause();
+	}
+}
+
+static void schedule_order_unlock(uint32_t lock_index)
+{
+	odp_atomic_u64_t *ord_lock;
+	uint32_t queue_index;
+
+	queue_index = sched_local.ordered.src_queue;
+
+	ODP_ASSERT(queue_index != NULL_INDEX &&
+		   lock_index <= sched->queue[queue_index].order_lock_count);
+
+	ord_lock = &sched->order[queue_index].lock[lock_index];
+
+	ODP_ASSERT(sched_local.ordered.ctx == odp_atomic_load_u64(ord_lock));
+
+	odp_atomic_store_rel_u64(ord_lock, sched_local.ordered.ctx + 1);
+}
+
+static void schedule_order_unlock_lock(uint32_t unlock_index,
+				       uint32_t lock_index)
+{
+	schedule_order_unlock(unlock_index);
+	schedule_order_lock(lock_index);
+}
+
+static void schedule_pause(void)
+{
+	sched_local.pause = 1;
+}
+
+static void schedule_resume(void)
+{
+	sched_local.pause = 0;
+}
+
+static uint64_t schedule_wait_time(uint64_t ns)
+{
+	return ns;
+}
+
+static int schedule_num_prio(void)
+{
+	return NUM_PRIO;
+}
+
+static void schedule_print(void)
+{
+	uint32_t i, num_thr;
+
+	num_thr = odp_atomic_load_u32(&sched->num_thr);
+
+	ODP_PRINT("\nScheduler info\n--------------\n");
+	ODP_PRINT("  Type             work-stealing\n");
+	ODP_PRINT("  Priorities       %i\n", NUM_PRIO);
+	ODP_PRINT("  Groups           %i\n", NUM_SCHED_GRPS);
+	ODP_PRINT("  Prefetch depth   %i\n", sched->prefetch_depth);
+	ODP_PRINT("  Parked queues    %u\n",
+		  odp_atomic_load_u32(&sched->num_parked));
+	ODP_PRINT("  Ready queues per thread:\n");
+
+	for (i = 0; i < num_thr; i++) {
+		sched_thr_t *sched_thr = &sched->thr[i];
+
+		if (odp_atomic_load_u32(&sched_thr->grp_mask) == 0)
+			continue;
+
+		ODP_PRINT("    thread %3u     %u\n", i,
+			  odp_atomic_load_u32(&sched_thr->num));
+	}
+
+	ODP_PRINT("  Steals by thread %" PRIu64 "\n", sched_local.steal);
+	sched_idle_print(&sched->idle);
+	ODP_PRINT("\n");
+}
+
+static odp_schedule_group_t schedule_group_create(const char *name,
+						  const odp_thrmask_t *mask)
+{
+	odp_schedule_group_t group = ODP_SCHED_GROUP_INVALID;
+	int i;
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	for (i = SCHED_GROUP_NAMED; i < NUM_SCHED_GRPS; i++) {
+		if (!sched->sched_grp[i].allocated) {
+			char *grp_name = sched->sched_grp[i].name;
+
+			if (name == NULL) {
+				grp_name[0] = 0;
+			} else {
+				strncpy(grp_name, name,
+					ODP_SCHED_GROUP_NAME_LEN - 1);
+				grp_name[ODP_SCHED_GROUP_NAME_LEN - 1] = 0;
+			}
+
+			grp_update_mask(i, mask);
+			group = (odp_schedule_group_t)i;
+			sched->sched_grp[i].allocated = 1;
+			break;
+		}
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+	return group;
+}
+
+static int schedule_group_destroy(odp_schedule_group_t group)
+{
+	odp_thrmask_t zero;
+	int ret;
+
+	odp_thrmask_zero(&zero);
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	    sched->sched_grp[group].allocated) {
+		grp_update_mask(group, &zero);
+		memset(sched->sched_grp[group].name, 0,
+		       ODP_SCHED_GROUP_NAME_LEN);
+		sched->sched_grp[group].allocated = 0;
+		ret = 0;
+	} else {
+		ret = -1;
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+	return ret;
+}
+
+static odp_schedule_group_t schedule_group_lookup(const char *name)
+{
+	odp_schedule_group_t group = ODP_SCHED_GROUP_INVALID;
+	int i;
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	for (i = SCHED_GROUP_NAMED; i < NUM_SCHED_GRPS; i++) {
+		if (strcmp(name, sched->sched_grp[i].name) == 0) {
+			group = (odp_schedule_group_t)i;
+			break;
+		}
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+	return group;
+}
+
+static int schedule_group_join(odp_schedule_group_t group,
+			       const odp_thrmask_t *mask)
+{
+	int ret;
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	    sched->sched_grp[group].allocated) {
+		odp_thrmask_t new_mask;
+
+		odp_thrmask_or(&new_mask, &sched->sched_grp[group].mask, mask);
+		grp_update_mask(group, &new_mask);
+
+		ret = 0;
+	} else {
+		ret = -1;
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+	return ret;
+}
+
+static int schedule_group_leave(odp_schedule_group_t group,
+				const odp_thrmask_t *mask)
+{
+	odp_thrmask_t new_mask;
+	int ret;
+
+	odp_thrmask_xor(&new_mask, mask, &sched->mask_all);
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	    sched->sched_grp[group].allocated) {
+		odp_thrmask_and(&new_mask, &sched->sched_grp[group].mask,
+				&new_mask);
+		grp_update_mask(group, &new_mask);
+
+		ret = 0;
+	} else {
+		ret = -1;
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+	return ret;
+}
+
+static int schedule_group_thrmask(odp_schedule_group_t group,
+				  odp_thrmask_t *thrmask)
+{
+	int ret;
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	    sched->sched_grp[group].allocated) {
+		*thrmask = sched->sched_grp[group].mask;
+		ret = 0;
+	} else {
+		ret = -1;
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+	return ret;
+}
+
+static int schedule_group_info(odp_schedule_group_t group,
+			       odp_schedule_group_info_t *info)
+{
+	int ret;
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	if (group < NUM_SCHED_GRPS && group >= SCHED_GROUP_NAMED &&
+	    sched->sched_grp[group].allocated) {
+		info->name    = sched->sched_grp[group].name;
+		info->thrmask = sched->sched_grp[group].mask;
+		ret = 0;
+	} else {
+		ret = -1;
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+	return ret;
+}
+
+static int schedule_thr_add(odp_schedule_group_t group, int thr)
+{
+	odp_thrmask_t mask;
+	odp_thrmask_t new_mask;
+
+	if (group < 0 || group >= SCHED_GROUP_NAMED)
+		return -1;
+
+	odp_thrmask_zero(&mask);
+	odp_thrmask_set(&mask, thr);
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	odp_thrmask_or(&new_mask, &sched->sched_grp[group].mask, &mask);
+	grp_update_mask(group, &new_mask);
+
+	odp_spinlock_unlock(&sched->grp_lock);
+
+	return 0;
+}
+
+static int schedule_thr_rem(odp_schedule_group_t group, int thr)
+{
+	odp_thrmask_t mask;
+	odp_thrmask_t new_mask;
+
+	if (group < 0 || group >= SCHED_GROUP_NAMED)
+		return -1;
+
+	odp_thrmask_zero(&mask);
+	odp_thrmask_set(&mask, thr);
+	odp_thrmask_xor(&new_mask, &mask, &sched->mask_all);
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	odp_thrmask_and(&new_mask, &sched->sched_grp[group].mask, &new_mask);
+	grp_update_mask(group, &new_mask);
+
+	odp_spinlock_unlock(&sched->grp_lock);
+
+	return 0;
+}
+
+/* Pull events of the next queue while the application is still processing
+ * the current events. The current scheduling context is not affected: the
+ * context of the new queue is taken into use on the next schedule call. When
+ * events remain in the local stash, only their data is prefetched. */
+static void schedule_prefetch(int num)
+{
+	if (num > sched->prefetch_depth)
+		num = sched->prefetch_depth;
+
+	if (odp_unlikely(num <= 0))
+		return;
+
+	if (sched_local.num) {
+		if (num > sched_local.num)
+			num = sched_local.num;
+
+		prefetch_events(&sched_local.ev_stash[sched_local.index], num);
+		return;
+	}
+
+	if (sched_local.prefetch.num || odp_unlikely(sched_local.pause))
+		return;
+
+	schedule_queues(NULL, NULL, num, 1);
+
+	/* Data of the new events is loaded while the application processes
+	 * the current events */
+	prefetch_events(sched_local.ev_stash, sched_local.prefetch.num);
+}
+
+static int schedule_sched_queue(uint32_t queue_index)
+{
+	queue_ready(queue_index);
+	return 0;
+}
+
+static int schedule_num_grps(void)
+{
+	return NUM_SCHED_GRPS;
+}
+
+/* Fill in scheduler interface */
+const schedule_fn_t schedule_ws_fn = {
+	.status_sync = 0,
+	.pktio_start = schedule_pktio_start,
+	.thr_add = schedule_thr_add,
+	.thr_rem = schedule_thr_rem,
+	.num_grps = schedule_num_grps,
+	.init_queue = schedule_init_queue,
+	.destroy_queue = schedule_destroy_queue,
+	.sched_queue = schedule_sched_queue,
+	.ord_enq_multi = schedule_ord_enq_multi,
+	.init_global = schedule_init_global,
+	.term_global = schedule_term_global,
+	.init_local  = schedule_init_local,
+	.term_local  = schedule_term_local,
+	.order_lock = order_lock,
+	.order_unlock = order_unlock,
+	.max_ordered_locks = schedule_max_ordered_locks,
+	.unsched_queue = NULL,
+	.save_context = NULL
+};
+
+/* Fill in scheduler API calls */
+const schedule_api_t schedule_ws_api = {
+	.schedule_wait_time       = schedule_wait_time,
+	.schedule                 = schedule,
+	.schedule_multi           = schedule_multi,
+	.schedule_pause           = schedule_pause,
+	.schedule_resume          = schedule_resume,
+	.schedule_release_atomic  = schedule_release_atomic,
+	.schedule_release_ordered = schedule_release_ordered,
+	.schedule_prefetch        = schedule_prefetch,
+	.schedule_num_prio        = schedule_num_prio,
+	.schedule_print           = schedule_print,
+	.schedule_group_create    = schedule_group_create,
+	.schedule_group_destroy   = schedule_group_destroy,
+	.schedule_group_lookup    = schedule_group_lookup,
+	.schedule_group_join      = schedule_group_join,
+	.schedule_group_leave     = schedule_group_leave,
+	.schedule_group_thrmask   = schedule_group_thrmask,
+	.schedule_group_info      = schedule_group_info,
+	.schedule_order_lock      = schedule_order_lock,
+	.schedule_order_unlock    = schedule_order_unlock,
+	.schedule_order_unlock_lock    = schedule_order_unlock_lock
+};
@@ -13,19 +13,46 @@
 #include <malloc.h>
 #include <stdio.h>
 #include <inttypes.h>
+#include <odp/api/hints.h>
 #include <odp_debug_internal.h>
 #include <odp_sorted_list_internal.h>
 
+/* Each sorted list is kept as a pairing heap, which gives O(1) inserts and
+ * O(log n) amortized removes and deletes.  The heap items are carved out of
+ * chunks owned by the sorted_pool and recycled through a free list, so that
+ * the insert/remove path never calls malloc/free once the pool has warmed up.
+ * A per pool hash table indexed by <list_idx, user_data> makes find and
+ * delete independent of the list length.
+ */
+
+#define ITEMS_PER_CHUNK  256
+#define MIN_HASH_SIZE    64
+#define HASH_MULT        0x9E3779B97F4A7C15ULL
+
 typedef struct sorted_list_item_s sorted_list_item_t;
 
+/* Must be exactly 64 bytes long. */
 struct sorted_list_item_s {
-	sorted_list_item_t *next_item;
+	sorted_list_item_t *child;     /* Leftmost child */
+	sorted_list_item_t *next_item; /* Right sibling or free list link */
+	sorted_list_item_t *prev_item; /* Left sibling or parent */
+	sorted_list_item_t *hash_next;
 	uint64_t            sort_key;
 	uint64_t            user_data;
+	uint64_t            insert_seq; /* Ties go to the oldest entry */
+	uint32_t            list_idx;
+	uint32_t            pad;
+};
+
+typedef struct items_chunk_s items_chunk_t;
+
+struct items_chunk_s {
+	items_chunk_t      *next_chunk;
+	sorted_list_item_t  items[ITEMS_PER_CHUNK];
 };
 
 typedef struct {
-	sorted_list_item_t *first_item;
+	sorted_list_item_t *root_item;
 	uint32_t            sorted_list_len;
 	uint32_t            pad;
 } sorted_list_desc_t;
@@ -38,26 +65,259 @@ typedef struct {
 	uint64_t             total_inserts;
 	uint64_t             total_deletes;
 	uint64_t             total_removes;
+	uint64_t             next_insert_seq;
 	uint32_t             max_sorted_lists;
 	uint32_t             next_list_idx;
+	uint32_t             num_items;
+	uint32_t             num_alloc_items;
+	uint32_t             hash_mask;
+	uint32_t             pad;
+	sorted_list_item_t  *free_items;
+	items_chunk_t       *chunks;
+	sorted_list_item_t **hash_tbl;
 	sorted_list_descs_t *list_descs;
 } sorted_pool_t;
 
+static inline uint32_t item_hash(sorted_pool_t *pool, uint32_t list_idx,
+				 uint64_t user_data)
+{
+	uint64_t hash;
+
+	hash  = (user_data + list_idx) * HASH_MULT;
+	hash ^= hash >> 32;
+	return (uint32_t)hash & pool->hash_mask;
+}
+
+static int hash_tbl_resize(sorted_pool_t *pool, uint32_t hash_size)
+{
+	sorted_list_item_t **new_tbl, **old_tbl, *item, *next_item;
+	uint32_t             old_size, idx, hash;
+
+	new_tbl = malloc(hash_size * sizeof(sorted_list_item_t *));
+	if (!new_tbl)
+		return -1;
+
+	memset(new_tbl, 0, hash_size * sizeof(sorted_list_item_t *));
+	old_tbl         = pool->hash_tbl;
+	old_size        = old_tbl ? pool->hash_mask + 1 : 0;
+	pool->hash_tbl  = new_tbl;
+	pool->hash_mask = hash_size - 1;
+
+	for (idx = 0; idx < old_size; idx++) {
+		item = old_tbl[idx];
+		while (item) {
+			next_item       = item->hash_next;
+			hash = item_hash(pool, item->list_idx,
+					 item->user_data);
+			item->hash_next = new_tbl[hash];
+			new_tbl[hash]   = item;
+			item            = next_item;
+		}
+	}
+
+	free(old_tbl);
+	return 0;
+}
+
+static sorted_list_item_t *item_alloc(sorted_pool_t *pool)
+{
+	sorted_list_item_t *item;
+	items_chunk_t      *chunk;
+	uint32_t            idx;
+
+	if (odp_unlikely(!pool->free_items)) {
+		chunk = malloc(sizeof(items_chunk_t));
+		if (!chunk)
+			return NULL;
+
+		chunk->next_chunk = pool->chunks;
+		pool->chunks      = chunk;
+		for (idx = 0; idx < ITEMS_PER_CHUNK; idx++) {
+			item            = &chunk->items[idx];
+			item->next_item = pool->free_items;
+			pool->free_items = item;
+		}
+
+		pool->num_alloc_items += ITEMS_PER_CHUNK;
+	}
+
+	item             = pool->free_items;
+	pool->free_items = item->next_item;
+	return item;
+}
+
+static inline void item_free(sorted_pool_t *pool, sorted_list_item_t *item)
+{
+	item->next_item  = pool->free_items;
+	pool->free_items = item;
+}
+
+static inline int item_before(sorted_list_item_t *item1,
+			      sorted_list_item_t *item2)
+{
+	if (item1->sort_key != item2->sort_key)
+		return item1->sort_key < item2->sort_key;
+
+	return item1->insert_seq < item2->insert_seq;
+}
+
+/* Links two heap roots together and returns the new root. */
+static sorted_list_item_t *heap_meld(sorted_list_item_t *root1,
+				     sorted_list_item_t *root2)
+{
+	sorted_list_item_t *temp;
+
+	if (item_before(root2, root1)) {
+		temp  = root1;
+		root1 = root2;
+		root2 = temp;
+	}
+
+	root2->prev_item = root1;
+	root2->next_item = root1->child;
+	if (root1->child)
+		root1->child->prev_item = root2;
+
+	root1->child = root2;
+	return root1;
+}
+
+/* Standard two pass pairing of a sibling list: meld the siblings pairwise
+ * from left to right, then meld the resulting heaps from right to left.
+ */
+static sorted_list_item_t *heap_merge_pairs(sorted_list_item_t *first)
+{
+	sorted_list_item_t *item1, *item2, *rest, *pairs, *root;
+
+	pairs = NULL;
+	while (first) {
+		item1 = first;
+		item2 = item1->next_item;
+		rest  = item2 ? item2->next_item : NULL;
+
+		item1->prev_item = NULL;
+		item1->next_item = NULL;
+		if (item2) {
+			item2->prev_item = NULL;
+			item2->next_item = NULL;
+			item1 = heap_meld(item1, item2);
+		}
+
+		item1->next_item = pairs;
+		pairs            = item1;
+		first            = rest;
+	}
+
+	if (!pairs)
+		return NULL;
+
+	root  = pairs;
+	pairs = root->next_item;
+	root->next_item = NULL;
+	while (pairs) {
+		item1 = pairs;
+		pairs = item1->next_item;
+		item1->next_item = NULL;
+		root  = heap_meld(root, item1);
+	}
+
+	root->prev_item = NULL;
+	return root;
+}
+
+/* Removes an arbitrary item from the heap described by list_desc. */
+static void heap_unlink(sorted_list_desc_t *list_desc,
+			sorted_list_item_t *item)
+{
+	sorted_list_item_t *sub_heap;
+
+	sub_heap = heap_merge_pairs(item->child);
+	if (item == list_desc->root_item) {
+		list_desc->root_item = sub_heap;
+		return;
+	}
+
+	if (item->prev_item->child == item)
+		item->prev_item->child = item->next_item;
+	else
+		item->prev_item->next_item = item->next_item;
+
+	if (item->next_item)
+		item->next_item->prev_item = item->prev_item;
+
+	if (sub_heap)
+		list_desc->root_item = heap_meld(list_desc->root_item,
+						 sub_heap);
+}
+
+/* Removes the item from the hash table, after the item has been unlinked
+ * from its heap.
+ */
+static void hash_unlink(sorted_pool_t *pool, sorted_list_item_t *item)
+{
+	sorted_list_item_t **link_ptr;
+
+	link_ptr = &pool->hash_tbl[item_hash(pool, item->list_idx,
+					     item->user_data)];
+	while (*link_ptr != item)
+		link_ptr = &(*link_ptr)->hash_next;
+
+	*link_ptr = item->hash_next;
+}
+
+static sorted_list_item_t *hash_find(sorted_pool_t *pool, uint32_t list_idx,
+				     uint64_t user_data)
+{
+	sorted_list_item_t *item;
+
+	item = pool->hash_tbl[item_hash(pool, list_idx, user_data)];
+	while (item) {
+		if ((item->user_data == user_data) &&
+		    (item->list_idx  == list_idx))
+			return item;
+
+		item = item->hash_next;
+	}
+
+	return NULL;
+}
+
 _odp_int_sorted_pool_t _odp_sorted_pool_create(uint32_t max_sorted_lists)
 {
 	sorted_list_descs_t *list_descs;
 	sorted_pool_t       *pool;
-	uint32_t             malloc_len;
+	uint32_t             malloc_len, hash_size;
 
 	pool = malloc(sizeof(sorted_pool_t));
+	if (!pool)
+		return _ODP_INT_SORTED_POOL_INVALID;
+
 	memset(pool, 0, sizeof(sorted_pool_t));
 	pool->max_sorted_lists = max_sorted_lists;
 	pool->next_list_idx    = 1;
 
 	malloc_len = max_sorted_lists * sizeof(sorted_list_desc_t);
 	list_descs = malloc(malloc_len);
+	if (!list_descs) {
+		free(pool);
+		return _ODP_INT_SORTED_POOL_INVALID;
+	}
+
 	memset(list_descs, 0, malloc_len);
 	pool->list_descs = list_descs;
+
+	/* Start with roughly one hash bucket per list.  The table is doubled
+	 * whenever the number of items exceeds the number of buckets. */
+	hash_size = MIN_HASH_SIZE;
+	while (hash_size < max_sorted_lists && hash_size < (1U << 31))
+		hash_size <<= 1;
+
+	if (hash_tbl_resize(pool, hash_size) != 0) {
+		free(list_descs);
+		free(pool);
+		return _ODP_INT_SORTED_POOL_INVALID;
+	}
+
 	return (_odp_int_sorted_pool_t)(uintptr_t)pool;
 }
 
@@ -79,9 +339,9 @@ int _odp_sorted_list_insert(_odp_int_sorted_pool_t sorted_pool,
 			    uint64_t              user_data)
 {
 	sorted_list_desc_t *list_desc;
-	sorted_list_item_t *new_list_item, *list_item, *prev_list_item;
+	sorted_list_item_t *new_list_item;
 	sorted_pool_t      *pool;
-	uint32_t            list_idx;
+	uint32_t            list_idx, hash;
 
 	pool     = (sorted_pool_t *)(uintptr_t)sorted_pool;
 	list_idx = (uint32_t)sorted_list;
@@ -89,30 +349,35 @@ int _odp_sorted_list_insert(_odp_int_sorted_pool_t sorted_pool,
 	    (pool->max_sorted_lists <= list_idx))
 		return -1;
 
-	list_desc     = &pool->list_descs->descs[list_idx];
-	new_list_item = malloc(sizeof(sorted_list_item_t));
-	memset(new_list_item, 0, sizeof(sorted_list_item_t));
-	new_list_item->next_item = NULL;
-	new_list_item->sort_key  = sort_key;
-	new_list_item->user_data = user_data;
-
-       /* Now insert the new_list_item according to the sort_key (lowest
-	* value first).
-	*/
-	list_item      = list_desc->first_item;
-	prev_list_item = NULL;
-	while ((list_item) && (list_item->sort_key <= sort_key)) {
-		prev_list_item = list_item;
-		list_item      = list_item->next_item;
-	}
+	if (odp_unlikely(pool->hash_mask < pool->num_items) &&
+	    (pool->hash_mask < (1U << 31)))
+		(void)hash_tbl_resize(pool, 2 * (pool->hash_mask + 1));
 
-	new_list_item->next_item = list_item;
-	if (!prev_list_item)
-		list_desc->first_item = new_list_item;
+	new_list_item = item_alloc(pool);
+	if (!new_list_item)
+		return -1;
+
+	new_list_item->child      = NULL;
+	new_list_item->next_item  = NULL;
+	new_list_item->prev_item  = NULL;
+	new_list_item->sort_key   = sort_key;
+	new_list_item->user_data  = user_data;
+	new_list_item->insert_seq = pool->next_insert_seq++;
+	new_list_item->list_idx   = list_idx;
+
+	hash = item_hash(pool, list_idx, user_data);
+	new_list_item->hash_next = pool->hash_tbl[hash];
+	pool->hash_tbl[hash]     = new_list_item;
+
+	list_desc = &pool->list_descs->descs[list_idx];
+	if (!list_desc->root_item)
+		list_desc->root_item = new_list_item;
 	else
-		prev_list_item->next_item = new_list_item;
+		list_desc->root_item = heap_meld(list_desc->root_item,
+						 new_list_item);
 
 	list_desc->sorted_list_len++;
+	pool->num_items++;
 	pool->total_inserts++;
 	return 0;
 }
@@ -122,7 +387,6 @@ int _odp_sorted_list_find(_odp_int_sorted_pool_t sorted_pool,
 			  uint64_t              user_data,
 			  uint64_t             *sort_key_ptr)
 {
-	sorted_list_desc_t *list_desc;
 	sorted_list_item_t *list_item;
 	sorted_pool_t      *pool;
 	uint32_t            list_idx;
@@ -133,25 +397,14 @@ int _odp_sorted_list_find(_odp_int_sorted_pool_t sorted_pool,
 	    (pool->max_sorted_lists <= list_idx))
 		return -1;
 
-	list_desc = &pool->list_descs->descs[list_idx];
-
-       /* Now search the sorted linked list - as described by list_desc -
-	* until an entry is found whose user_data field matches the supplied
-	* user_data or the end of the list is reached.
-	*/
-	list_item = list_desc->first_item;
-	while (list_item) {
-		if (list_item->user_data == user_data) {
-			if (sort_key_ptr)
-				*sort_key_ptr = list_item->sort_key;
-
-			return 1;
-		}
+	list_item = hash_find(pool, list_idx, user_data);
+	if (!list_item)
+		return 0;
 
-		list_item = list_item->next_item;
-	}
+	if (sort_key_ptr)
+		*sort_key_ptr = list_item->sort_key;
 
-	return 0;
+	return 1;
 }
 
 int _odp_sorted_list_delete(_odp_int_sorted_pool_t sorted_pool,
@@ -159,7 +412,7 @@ int _odp_sorted_list_delete(_odp_int_sorted_pool_t sorted_pool,
 			    uint64_t              user_data)
 {
 	sorted_list_desc_t *list_desc;
-	sorted_list_item_t *next_list_item, *list_item, *prev_list_item;
+	sorted_list_item_t *list_item;
 	sorted_pool_t      *pool;
 	uint32_t            list_idx;
 
@@ -169,34 +422,19 @@ int _odp_sorted_list_delete(_odp_int_sorted_pool_t sorted_pool,
 	    (pool->max_sorted_lists <= list_idx))
 		return -1;
 
-	list_desc = &pool->list_descs->descs[list_idx];
-
-       /* Now search the sorted linked list - as described by list_desc -
-	* until an entry is found whose user_data field matches the supplied
-	* user_data or the end of the list is reached.
-	*/
-	list_item      = list_desc->first_item;
-	prev_list_item = NULL;
-	while (list_item) {
-		next_list_item = list_item->next_item;
-
-		if (list_item->user_data == user_data) {
-			if (!prev_list_item)
-				list_desc->first_item = next_list_item;
-			else
-				prev_list_item->next_item = next_list_item;
-
-			list_desc->sorted_list_len--;
-			free(list_item);
-			pool->total_deletes++;
-			return 0;
-		}
+	list_item = hash_find(pool, list_idx, user_data);
+	if (!list_item)
+		return -1;
 
-		prev_list_item = list_item;
-		list_item      = next_list_item;
-	}
+	list_desc = &pool->list_descs->descs[list_idx];
+	heap_unlink(list_desc, list_item);
+	hash_unlink(pool, list_item);
+	item_free(pool, list_item);
 
-	return -1;
+	list_desc->sorted_list_len--;
+	pool->num_items--;
+	pool->total_deletes++;
+	return 0;
 }
 
 int _odp_sorted_list_remove(_odp_int_sorted_pool_t sorted_pool,
@@ -217,11 +455,11 @@ int _odp_sorted_list_remove(_odp_int_sorted_pool_t sorted_pool,
 
 	list_desc = &pool->list_descs->descs[list_idx];
 	if ((list_desc->sorted_list_len == 0) ||
-	    (!list_desc->first_item))
+	    (!list_desc->root_item))
 		return -1;
 
-	list_item             = list_desc->first_item;
-	list_desc->first_item = list_item->next_item;
+	list_item            = list_desc->root_item;
+	list_desc->root_item = heap_merge_pairs(list_item->child);
 	list_desc->sorted_list_len--;
 
 	if (sort_key_ptr)
@@ -230,7 +468,9 @@ int _odp_sorted_list_remove(_odp_int_sorted_pool_t sorted_pool,
 	if (user_data_ptr)
 		*user_data_ptr = list_item->user_data;
 
-	free(list_item);
+	hash_unlink(pool, list_item);
+	item_free(pool, list_item);
+	pool->num_items--;
 	pool->total_removes++;
 	return 1;
 }
@@ -264,6 +504,8 @@ void _odp_sorted_list_stats_print(_odp_int_sorted_pool_t sorted_pool)
 	ODP_PRINT("sorted_pool=0x%" PRIX64 "\n", sorted_pool);
 	ODP_PRINT("  max_sorted_lists=%u next_list_idx=%u\n",
 		  pool->max_sorted_lists, pool->next_list_idx);
+	ODP_PRINT("  num_items=%u num_alloc_items=%u hash_size=%u\n",
+		  pool->num_items, pool->num_alloc_items, pool->hash_mask + 1);
 	ODP_PRINT("  total_inserts=%" PRIu64 " total_deletes=%" PRIu64
 		  " total_removes=%" PRIu64 "\n", pool->total_inserts,
 		  pool->total_deletes, pool->total_removes);
@@ -271,25 +513,18 @@ void _odp_sorted_list_stats_print(_odp_int_sorted_pool_t sorted_pool)
 
 void _odp_sorted_pool_destroy(_odp_int_sorted_pool_t sorted_pool)
 {
-	sorted_list_descs_t *list_descs;
-	sorted_list_desc_t  *list_desc;
-	sorted_list_item_t  *list_item, *next_list_item;
-	sorted_pool_t       *pool;
-	uint32_t             list_idx;
-
-	pool       = (sorted_pool_t *)(uintptr_t)sorted_pool;
-	list_descs = pool->list_descs;
-
-	for (list_idx = 0; list_idx < pool->next_list_idx; list_idx++) {
-		list_desc = &list_descs->descs[list_idx];
-		list_item = list_desc->first_item;
-		while (list_item) {
-			next_list_item = list_item->next_item;
-			free(list_item);
-			list_item = next_list_item;
-		}
+	items_chunk_t *chunk, *next_chunk;
+	sorted_pool_t *pool;
+
+	pool  = (sorted_pool_t *)(uintptr_t)sorted_pool;
+	chunk = pool->chunks;
+	while (chunk) {
+		next_chunk = chunk->next_chunk;
+		free(chunk);
+		chunk = next_chunk;
 	}
 
-	free(list_descs);
+	free(pool->hash_tbl);
+	free(pool->list_descs);
 	free(pool);
 }
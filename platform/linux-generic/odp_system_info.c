@@ -21,11 +21,13 @@
 #include <odp_debug_internal.h>
 #include <odp/api/align.h>
 #include <odp/api/cpu.h>
+#include <odp_config_internal.h>
 #include <errno.h>
 #include <pthread.h>
 #include <sched.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <inttypes.h>
 #include <ctype.h>
 
@@ -316,6 +318,59 @@ static int systemcpu(system_info_t *sysinfo)
 	return 0;
 }
 
+/*
+ * NUMA node of each CPU, from /sys/devices/system/cpu/cpuN/nodeM links.
+ * CPUs without node information are reported to be on node 0.
+ *
+ * ODP_NUMA_NODES environment variable overrides the node count for testing
+ * per node code paths on hosts with fewer nodes. Threads are then spread
+ * over the nodes by thread id.
+ */
+static void systemcpu_numa(system_info_t *sysinfo)
+{
+	char path[64];
+	DIR *dir;
+	struct dirent *entry;
+	int cpu, node;
+	const char *env;
+
+	sysinfo->numa_node_count = 1;
+	sysinfo->numa_node_fake = 0;
+
+	env = getenv("ODP_NUMA_NODES");
+	if (env && atoi(env) > 0) {
+		node = atoi(env);
+		if (node > CONFIG_NUMA_NODES_MAX)
+			node = CONFIG_NUMA_NODES_MAX;
+
+		sysinfo->numa_node_count = node;
+		sysinfo->numa_node_fake = 1;
+		ODP_PRINT("NUMA: %i nodes from ODP_NUMA_NODES\n", node);
+		return;
+	}
+
+	for (cpu = 0; cpu < MAX_CPU_NUMBER; cpu++) {
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d",
+			 cpu);
+		dir = opendir(path);
+		if (dir == NULL)
+			continue;
+
+		while ((entry = readdir(dir)) != NULL) {
+			if (sscanf(entry->d_name, "node%d", &node) != 1 ||
+			    node < 0 || node >= MAX_CPU_NUMBER)
+				continue;
+
+			sysinfo->cpu_numa_node[cpu] = node;
+			if (node >= sysinfo->numa_node_count)
+				sysinfo->numa_node_count = node + 1;
+			break;
+		}
+
+		closedir(dir);
+	}
+}
+
 /*
  * Huge page information
  */
@@ -363,6 +418,8 @@ int odp_system_info_init(void)
 		return -1;
 	}
 
+	systemcpu_numa(&odp_global_data.system_info);
+
 	system_hp(&odp_global_data.hugepage_info);
 
 	return 0;
@@ -418,6 +475,28 @@ uint64_t odp_cpu_hz_max_id(int id)
 		return 0;
 }
 
+int _odp_numa_node_count(void)
+{
+	return odp_global_data.system_info.numa_node_count;
+}
+
+/* NUMA node of the CPU the calling thread is running on */
+int _odp_numa_node_self(void)
+{
+	system_info_t *sysinfo = &odp_global_data.system_info;
+	int cpu;
+
+	if (sysinfo->numa_node_fake)
+		return odp_thread_id() % sysinfo->numa_node_count;
+
+	cpu = sched_getcpu();
+
+	if (cpu < 0 || cpu >= MAX_CPU_NUMBER)
+		return 0;
+
+	return sysinfo->cpu_numa_node[cpu];
+}
+
 uint64_t odp_sys_huge_page_size(void)
 {
 	return odp_global_data.hugepage_info.default_huge_page_size;
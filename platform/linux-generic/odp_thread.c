@@ -37,6 +37,8 @@ typedef struct {
 	uint32_t       num;
 	uint32_t       num_worker;
 	uint32_t       num_control;
+	/* Thread ids are less than this */
+	uint32_t       num_max;
 	odp_spinlock_t lock;
 } thread_globals_t;
 
@@ -50,9 +52,10 @@ __thread _odp_thread_state_t *_odp_this_thread;
 
 #include <odp/visibility_end.h>
 
-int odp_thread_init_global(void)
+int odp_thread_init_global(const odp_init_t *params)
 {
 	odp_shm_t shm;
+	uint32_t num_max = ODP_THREAD_COUNT_MAX;
 
 	shm = odp_shm_reserve("odp_thread_globals",
 			      sizeof(thread_globals_t),
@@ -66,6 +69,27 @@ int odp_thread_init_global(void)
 	memset(thread_globals, 0, sizeof(thread_globals_t));
 	odp_spinlock_init(&thread_globals->lock);
 
+	/* Application may limit the number of threads. Tables with per thread
+	 * entries are sized by odp_thread_count_max(). Internal threads
+	 * (e.g. traffic manager service threads) use ids on top of
+	 * the application threads. */
+	if (params && (params->num_worker > 0 || params->num_control > 0)) {
+		num_max = params->num_worker + params->num_control;
+
+		if (params->num_worker < 0 || params->num_control < 0 ||
+		    num_max > ODP_THREAD_COUNT_MAX) {
+			ODP_ERR("Bad thread count: %i workers, %i control\n",
+				params->num_worker, params->num_control);
+			return -1;
+		}
+
+		num_max += CONFIG_INTERNAL_THREADS;
+		if (num_max > ODP_THREAD_COUNT_MAX)
+			num_max = ODP_THREAD_COUNT_MAX;
+	}
+
+	thread_globals->num_max = num_max;
+
 	return 0;
 }
 
@@ -85,10 +109,10 @@ static int alloc_id(odp_thread_type_t type)
 	int thr;
 	odp_thrmask_t *all = &thread_globals->all;
 
-	if (thread_globals->num >= ODP_THREAD_COUNT_MAX)
+	if (thread_globals->num >= thread_globals->num_max)
 		return -1;
 
-	for (thr = 0; thr < ODP_THREAD_COUNT_MAX; thr++) {
+	for (thr = 0; thr < (int)thread_globals->num_max; thr++) {
 		if (odp_thrmask_isset(all, thr) == 0) {
 			odp_thrmask_set(all, thr);
 
@@ -201,7 +225,7 @@ int odp_thread_count(void)
 
 int odp_thread_count_max(void)
 {
-	return ODP_THREAD_COUNT_MAX;
+	return thread_globals->num_max;
 }
 
 int odp_thrmask_worker(odp_thrmask_t *mask)
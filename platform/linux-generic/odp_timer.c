@@ -168,6 +168,46 @@ static inline void set_next_free(_odp_timer_t *tim, uint32_t nf)
 	tim->queue = _odp_cast_scalar(odp_queue_t, nf);
 }
 
+/******************************************************************************
+ * Hierarchical timing wheel
+ * Optional per timer pool index of active timers sorted by expiration tick
+ *****************************************************************************/
+
+/* The wheel follows the classic cascading design: the root level has one
+ * slot per tick, each upper level slot covers all the slots of the level
+ * below. Timers far in the future are cascaded down level by level as the
+ * wheel turns. */
+#define TW_ROOT_BITS 8
+#define TW_ROOT_SIZE (1U << TW_ROOT_BITS)
+#define TW_LVL_BITS 6
+#define TW_LVL_SIZE (1U << TW_LVL_BITS)
+#define TW_NUM_LVLS 4 /* Upper levels, total range is 2^32 ticks */
+#define TW_NUM_SLOTS (TW_ROOT_SIZE + TW_NUM_LVLS * TW_LVL_SIZE)
+#define TW_MAX_DELTA ((1ULL << (TW_ROOT_BITS + TW_NUM_LVLS * TW_LVL_BITS)) - 1)
+#define TW_LVL_SHIFT(lvl) (TW_ROOT_BITS + (lvl) * TW_LVL_BITS)
+/* End of slot list */
+#define TW_NULL ((uint32_t)0xFFFFFFFF)
+/* Visit tick of a timer which is not linked into the wheel */
+#define TW_UNLINKED ((uint64_t)0xFFFFFFFFFFFFFFFF)
+
+typedef struct {
+	/* Tick when the slot holding the timer is processed, TW_UNLINKED when
+	 * timer is not in the wheel. Always less than or equal to the current
+	 * expiration tick of an active timer. */
+	odp_atomic_u64_t visit_tck;
+	uint32_t next;
+	uint32_t prev;
+	uint32_t slot;
+} tw_node_t;
+
+typedef struct {
+	odp_spinlock_t lock;
+	uint32_t num; /* Number of timers linked into the wheel */
+	uint64_t base; /* Next tick to be processed */
+	tw_node_t *node; /* Wheel linkage, one per timer */
+	uint32_t slot[TW_NUM_SLOTS]; /* Slot list heads */
+} timer_wheel_t;
+
 /******************************************************************************
  * timer_pool_t abstract datatype
  * Inludes alloc and free timer
@@ -182,6 +222,7 @@ typedef struct timer_pool_s {
 	uint64_t max_rel_tck;
 	tick_buf_t *tick_buf; /* Expiration tick and timeout buffer */
 	_odp_timer_t *timers; /* User pointer and queue handle (and lock) */
+	timer_wheel_t *wheel; /* Timing wheel or NULL when scanning timers */
 	odp_atomic_u32_t high_wm;/* High watermark of allocated timers */
 	odp_spinlock_t lock;
 	uint32_t num_alloc;/* Current number of allocated timers */
@@ -236,6 +277,25 @@ static inline odp_timer_t tp_idx_to_handle(timer_pool_t *tp,
 static void itimer_init(timer_pool_t *tp);
 static void itimer_fini(timer_pool_t *tp);
 
+static void timer_wheel_init(timer_wheel_t *tw, tw_node_t *node,
+			     uint32_t num_timers)
+{
+	uint32_t i;
+
+	odp_spinlock_init(&tw->lock);
+	tw->num = 0;
+	tw->base = 0;
+	tw->node = node;
+	for (i = 0; i < TW_NUM_SLOTS; i++)
+		tw->slot[i] = TW_NULL;
+	for (i = 0; i < num_timers; i++) {
+		odp_atomic_init_u64(&node[i].visit_tck, TW_UNLINKED);
+		node[i].next = TW_NULL;
+		node[i].prev = TW_NULL;
+		node[i].slot = TW_NULL;
+	}
+}
+
 static odp_timer_pool_t timer_pool_new(const char *name,
 				       const odp_timer_pool_param_t *param)
 {
@@ -250,11 +310,18 @@ static odp_timer_pool_t timer_pool_new(const char *name,
 	size_t sz1 = ROUNDUP_CACHE_LINE(sizeof(tick_buf_t) * param->num_timers);
 	size_t sz2 = ROUNDUP_CACHE_LINE(sizeof(_odp_timer_t) *
 					param->num_timers);
-	odp_shm_t shm = odp_shm_reserve(name, sz0 + sz1 + sz2,
+	size_t sz3 = 0;
+	size_t sz4 = 0;
+
+	if (param->expire == ODP_TIMER_EXPIRE_WHEEL) {
+		sz3 = ROUNDUP_CACHE_LINE(sizeof(timer_wheel_t));
+		sz4 = ROUNDUP_CACHE_LINE(sizeof(tw_node_t) * param->num_timers);
+	}
+	odp_shm_t shm = odp_shm_reserve(name, sz0 + sz1 + sz2 + sz3 + sz4,
 			ODP_CACHE_LINE_SIZE, ODP_SHM_SW_ONLY);
 	if (odp_unlikely(shm == ODP_SHM_INVALID))
 		ODP_ABORT("%s: timer pool shm-alloc(%zuKB) failed\n",
-			  name, (sz0 + sz1 + sz2) / 1024);
+			  name, (sz0 + sz1 + sz2 + sz3 + sz4) / 1024);
 	timer_pool_t *tp = (timer_pool_t *)odp_shm_addr(shm);
 	tp->prev_scan = odp_time_global();
 	tp->time_per_tick = odp_time_global_from_ns(param->res_ns);
@@ -276,6 +343,14 @@ static odp_timer_pool_t timer_pool_new(const char *name,
 	tp->notify_overrun = 1;
 	tp->tick_buf = (void *)((char *)odp_shm_addr(shm) + sz0);
 	tp->timers = (void *)((char *)odp_shm_addr(shm) + sz0 + sz1);
+	tp->wheel = NULL;
+	if (sz3) {
+		char *base = (char *)odp_shm_addr(shm) + sz0 + sz1 + sz2;
+
+		tp->wheel = (void *)base;
+		timer_wheel_init(tp->wheel, (void *)(base + sz3),
+				 param->num_timers);
+	}
 	/* Initialize all odp_timer entries */
 	uint32_t i;
 	for (i = 0; i < tp->param.num_timers; i++) {
@@ -665,6 +740,200 @@ static unsigned timer_expire(timer_pool_t *tp, uint32_t idx, uint64_t tick)
 	}
 }
 
+/******************************************************************************
+ * Timing wheel operations
+ * Timer state lives in tick_buf as with scanning, the wheel only tracks when
+ * each timer needs to be looked at next. Timers are unlinked lazily: a
+ * cancelled, freed or postponed timer stays in its slot until the slot is
+ * processed and the timer state is checked again.
+ *****************************************************************************/
+
+static inline uint64_t tw_exp_tck(tick_buf_t *tb)
+{
+#if __GCC_ATOMIC_LLONG_LOCK_FREE < 2
+	return tb->exp_tck.v;
+#else
+	return odp_atomic_load_u64(&tb->exp_tck);
+#endif
+}
+
+/* Link timer into the slot matching the expiration tick. Wheel lock must be
+ * held and timer must not be linked. */
+static void tw_insert(timer_wheel_t *tw, uint32_t idx, uint64_t exp_tck)
+{
+	tw_node_t *node = &tw->node[idx];
+	uint64_t delta;
+	uint64_t visit;
+	uint32_t slot;
+	int lvl;
+
+	if (exp_tck < tw->base)
+		exp_tck = tw->base;
+	delta = exp_tck - tw->base;
+
+	if (delta < TW_ROOT_SIZE) {
+		slot = exp_tck & (TW_ROOT_SIZE - 1);
+		visit = exp_tck;
+	} else {
+		if (delta > TW_MAX_DELTA) {
+			/* Beyond the wheel, revisit at the end of it */
+			exp_tck = tw->base + TW_MAX_DELTA;
+			delta = TW_MAX_DELTA;
+		}
+		for (lvl = 0; lvl < TW_NUM_LVLS - 1; lvl++)
+			if (delta < (1ULL << TW_LVL_SHIFT(lvl + 1)))
+				break;
+		slot = TW_ROOT_SIZE + lvl * TW_LVL_SIZE +
+		       ((exp_tck >> TW_LVL_SHIFT(lvl)) & (TW_LVL_SIZE - 1));
+		/* Slot is cascaded when the lower levels wrap around */
+		visit = exp_tck & ~((1ULL << TW_LVL_SHIFT(lvl)) - 1);
+	}
+
+	node->slot = slot;
+	node->prev = TW_NULL;
+	node->next = tw->slot[slot];
+	if (node->next != TW_NULL)
+		tw->node[node->next].prev = idx;
+	tw->slot[slot] = idx;
+	tw->num++;
+	odp_atomic_store_u64(&node->visit_tck, visit);
+}
+
+/* Unlink timer from its slot. Wheel lock must be held. */
+static void tw_remove(timer_wheel_t *tw, uint32_t idx)
+{
+	tw_node_t *node = &tw->node[idx];
+
+	if (node->prev != TW_NULL)
+		tw->node[node->prev].next = node->next;
+	else
+		tw->slot[node->slot] = node->next;
+	if (node->next != TW_NULL)
+		tw->node[node->next].prev = node->prev;
+	tw->num--;
+	odp_atomic_store_u64(&node->visit_tck, TW_UNLINKED);
+}
+
+/* Make sure that an active timer is visited no later than its expiration
+ * tick. Called after the expiration tick has been updated. */
+static void tw_timer_set(timer_pool_t *tp, uint32_t idx, uint64_t abs_tck)
+{
+	timer_wheel_t *tw = tp->wheel;
+	tw_node_t *node = &tw->node[idx];
+
+	/* Order the expiration tick update before the visit tick check. Pairs
+	 * with the barrier in tw_visit(). */
+	odp_mb_full();
+
+	/* Common case with postponed timers: timer will be visited earlier
+	 * and relinked then */
+	if (odp_atomic_load_u64(&node->visit_tck) <= abs_tck)
+		return;
+
+	odp_spinlock_lock(&tw->lock);
+	if (odp_atomic_load_u64(&node->visit_tck) > abs_tck) {
+		if (odp_atomic_load_u64(&node->visit_tck) != TW_UNLINKED)
+			tw_remove(tw, idx);
+		tw_insert(tw, idx, abs_tck);
+	}
+	odp_spinlock_unlock(&tw->lock);
+}
+
+/* Process a timer unlinked from a slot being visited at 'tick'. Expired
+ * timers are delivered, still active ones are linked back into the wheel.
+ * Wheel lock must be held. */
+static unsigned tw_visit(timer_pool_t *tp, uint32_t idx, uint64_t tick)
+{
+	timer_wheel_t *tw = tp->wheel;
+	uint64_t exp_tck;
+
+	odp_atomic_store_u64(&tw->node[idx].visit_tck, TW_UNLINKED);
+	/* Pairs with the barrier in tw_timer_set() */
+	odp_mb_full();
+	exp_tck = tw_exp_tck(&tp->tick_buf[idx]);
+
+	/* Cancelled, expired or freed timer */
+	if (exp_tck & TMO_INACTIVE)
+		return 0;
+
+	if (exp_tck > tick) {
+		tw_insert(tw, idx, exp_tck);
+		return 0;
+	}
+
+	if (odp_likely(timer_expire(tp, idx, tick)))
+		return 1;
+
+	/* Timer changed concurrently, check it again on the next tick */
+	tw_insert(tw, idx, tick + 1);
+	return 0;
+}
+
+/* Detach all timers from a slot, returns the list head */
+static inline uint32_t tw_detach(timer_wheel_t *tw, uint32_t slot)
+{
+	uint32_t head = tw->slot[slot];
+
+	tw->slot[slot] = TW_NULL;
+	return head;
+}
+
+static unsigned tw_process_slot(timer_pool_t *tp, uint32_t slot,
+				uint64_t tick)
+{
+	timer_wheel_t *tw = tp->wheel;
+	uint32_t idx = tw_detach(tw, slot);
+	unsigned nexp = 0;
+
+	while (idx != TW_NULL) {
+		uint32_t next = tw->node[idx].next;
+
+		tw->num--;
+		nexp += tw_visit(tp, idx, tick);
+		idx = next;
+	}
+	return nexp;
+}
+
+static unsigned timer_wheel_expire(timer_pool_t *tp, uint64_t tick)
+{
+	timer_wheel_t *tw = tp->wheel;
+	unsigned nexp = 0;
+	uint64_t t;
+	int lvl;
+
+	odp_spinlock_lock(&tw->lock);
+
+	while (tw->base <= tick) {
+		if (tw->num == 0) {
+			/* Nothing to visit, turn the wheel at once */
+			tw->base = tick + 1;
+			break;
+		}
+		t = tw->base;
+
+		/* Cascade upper level slots whose time has come. Timers are
+		 * relinked relative to the current base and end up into lower
+		 * level slots or into the current root slot. */
+		for (lvl = 0; lvl < TW_NUM_LVLS; lvl++) {
+			uint32_t shift = TW_LVL_SHIFT(lvl);
+
+			if (t & ((1ULL << shift) - 1))
+				break;
+			nexp += tw_process_slot(tp, TW_ROOT_SIZE +
+						lvl * TW_LVL_SIZE +
+						((t >> shift) &
+						 (TW_LVL_SIZE - 1)), t);
+		}
+
+		nexp += tw_process_slot(tp, t & (TW_ROOT_SIZE - 1), t);
+		tw->base = t + 1;
+	}
+
+	odp_spinlock_unlock(&tw->lock);
+	return nexp;
+}
+
 static unsigned odp_timer_pool_expire(odp_timer_pool_t tpid, uint64_t tick)
 {
 	tick_buf_t *array = &tpid->tick_buf[0];
@@ -673,6 +942,9 @@ static unsigned odp_timer_pool_expire(odp_timer_pool_t tpid, uint64_t tick)
 	unsigned nexp = 0;
 	uint32_t i;
 
+	if (tpid->wheel)
+		return timer_wheel_expire(tpid, tick);
+
 	ODP_ASSERT(high_wm <= tpid->param.num_timers);
 	for (i = 0; i < high_wm;) {
 		/* As a rare occurrence, we can outsmart the HW prefetcher
@@ -982,6 +1254,13 @@ int odp_timer_capability(odp_timer_clk_src_t clk_src,
 	return ret;
 }
 
+void odp_timer_pool_param_init(odp_timer_pool_param_t *param)
+{
+	memset(param, 0, sizeof(odp_timer_pool_param_t));
+	param->clk_src = ODP_CLOCK_CPU;
+	param->expire = ODP_TIMER_EXPIRE_DEFAULT;
+}
+
 odp_timer_pool_t
 odp_timer_pool_create(const char *name,
 		      const odp_timer_pool_param_t *param)
@@ -1081,10 +1360,11 @@ int odp_timer_set_abs(odp_timer_t hdl,
 		return ODP_TIMER_TOOEARLY;
 	if (odp_unlikely(abs_tck > cur_tick + tp->max_rel_tck))
 		return ODP_TIMER_TOOLATE;
-	if (timer_reset(idx, abs_tck, (odp_buffer_t *)tmo_ev, tp))
-		return ODP_TIMER_SUCCESS;
-	else
+	if (!timer_reset(idx, abs_tck, (odp_buffer_t *)tmo_ev, tp))
 		return ODP_TIMER_NOEVENT;
+	if (tp->wheel)
+		tw_timer_set(tp, idx, abs_tck);
+	return ODP_TIMER_SUCCESS;
 }
 
 int odp_timer_set_rel(odp_timer_t hdl,
@@ -1098,10 +1378,11 @@ int odp_timer_set_rel(odp_timer_t hdl,
 		return ODP_TIMER_TOOEARLY;
 	if (odp_unlikely(rel_tck > tp->max_rel_tck))
 		return ODP_TIMER_TOOLATE;
-	if (timer_reset(idx, abs_tck, (odp_buffer_t *)tmo_ev, tp))
-		return ODP_TIMER_SUCCESS;
-	else
+	if (!timer_reset(idx, abs_tck, (odp_buffer_t *)tmo_ev, tp))
 		return ODP_TIMER_NOEVENT;
+	if (tp->wheel)
+		tw_timer_set(tp, idx, abs_tck);
+	return ODP_TIMER_SUCCESS;
 }
 
 int odp_timer_cancel(odp_timer_t hdl, odp_event_t *tmo_ev)
@@ -12,6 +12,7 @@
 #define _GNU_SOURCE
 #endif
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <malloc.h>
 #include <stdio.h>
@@ -91,6 +92,9 @@ static odp_ticketlock_t tm_create_lock;
 static odp_ticketlock_t tm_profile_lock;
 static odp_barrier_t tm_first_enq;
 
+/* Maximum number of TM service threads, 0 selects the default policy */
+static uint32_t tm_max_service_threads;
+
 static int g_main_thread_cpu = -1;
 static int g_tm_cpu_num;
 
@@ -279,78 +283,96 @@ static input_work_queue_t *input_work_queue_create(void)
 {
 	input_work_queue_t *input_work_queue;
 
-	input_work_queue = malloc(sizeof(input_work_queue_t));
+	if (posix_memalign((void **)&input_work_queue, ODP_CACHE_LINE_SIZE,
+			   sizeof(input_work_queue_t)) != 0)
+		return NULL;
+
 	memset(input_work_queue, 0, sizeof(input_work_queue_t));
-	odp_atomic_init_u64(&input_work_queue->queue_cnt, 0);
-	odp_ticketlock_init(&input_work_queue->lock);
+	odp_atomic_init_u32(&input_work_queue->w_head, 0);
+	odp_atomic_init_u32(&input_work_queue->w_tail, 0);
+	odp_atomic_init_u32(&input_work_queue->r_tail, 0);
+	odp_atomic_init_u64(&input_work_queue->enqueue_fail_cnt, 0);
 	return input_work_queue;
 }
 
 static void input_work_queue_destroy(input_work_queue_t *input_work_queue)
 {
-       /* We first need to "flush/drain" this input_work_queue before
-	* freeing it.  Of course, elsewhere it is essential to have first
-	* stopped new tm_enq() (et al) calls from succeeding.
+       /* It is essential to have first stopped new tm_enq() (et al) calls
+	* from succeeding, and the service thread from consuming, before
+	* freeing the input_work_queue.
 	*/
-	odp_ticketlock_lock(&input_work_queue->lock);
 	free(input_work_queue);
 }
 
-static int input_work_queue_append(tm_system_t *tm_system,
-				   input_work_item_t *work_item)
+static inline uint32_t input_work_queue_cnt(input_work_queue_t *queue)
+{
+	return odp_atomic_load_u32(&queue->w_tail) -
+		odp_atomic_load_u32(&queue->r_tail);
+}
+
+/* Appends up to num work items, as many as there is free space for, and
+ * returns the number of items appended. Safe to call from any number of
+ * producer threads concurrently. */
+static uint32_t input_work_queue_append(tm_system_t *tm_system,
+					input_work_item_t work_items[],
+					uint32_t num)
 {
 	input_work_queue_t *input_work_queue;
-	input_work_item_t *entry_ptr;
-	uint32_t queue_cnt, tail_idx;
+	uint32_t old_head, new_head, r_tail, num_free, idx;
 
 	input_work_queue = tm_system->input_work_queue;
-	queue_cnt = odp_atomic_load_u64(&input_work_queue->queue_cnt);
-	if (INPUT_WORK_RING_SIZE <= queue_cnt) {
-		input_work_queue->enqueue_fail_cnt++;
-		return -1;
-	}
+	old_head = odp_atomic_load_u32(&input_work_queue->w_head);
+
+	/* Move the writer head. This thread owns the slots after old_head. */
+	do {
+		r_tail   = odp_atomic_load_acq_u32(&input_work_queue->r_tail);
+		num_free = INPUT_WORK_RING_SIZE - (old_head - r_tail);
+		if (odp_unlikely(num_free == 0)) {
+			odp_atomic_inc_u64(&input_work_queue->enqueue_fail_cnt);
+			return 0;
+		}
 
-	odp_ticketlock_lock(&input_work_queue->lock);
-	tail_idx = input_work_queue->tail_idx;
-	entry_ptr = &input_work_queue->work_ring[tail_idx];
-
-	*entry_ptr = *work_item;
-	tail_idx++;
-	if (INPUT_WORK_RING_SIZE <= tail_idx)
-		tail_idx = 0;
-
-	input_work_queue->total_enqueues++;
-	input_work_queue->tail_idx = tail_idx;
-	odp_ticketlock_unlock(&input_work_queue->lock);
-	odp_atomic_inc_u64(&input_work_queue->queue_cnt);
-	if (input_work_queue->peak_cnt <= queue_cnt)
-		input_work_queue->peak_cnt = queue_cnt + 1;
-	return 0;
+		if (num > num_free)
+			num = num_free;
+
+		new_head = old_head + num;
+	} while (!odp_atomic_cas_acq_u32(&input_work_queue->w_head,
+					 &old_head, new_head));
+
+	for (idx = 0; idx < num; idx++)
+		input_work_queue->work_ring[(old_head + idx) &
+					    (INPUT_WORK_RING_SIZE - 1)] =
+			work_items[idx];
+
+	/* Wait until earlier writers have published their items, so that
+	 * items are consumed in reservation order. */
+	while (odp_unlikely(odp_atomic_load_acq_u32(&input_work_queue->w_tail)
+			    != old_head))
+		odp_cpu_pause();
+
+	odp_atomic_store_rel_u32(&input_work_queue->w_tail, new_head);
+	return num;
 }
 
+/* Only called by the TM service thread - the single consumer. */
 static int input_work_queue_remove(input_work_queue_t *input_work_queue,
 				   input_work_item_t *work_item)
 {
-	input_work_item_t *entry_ptr;
-	uint32_t queue_cnt, head_idx;
+	uint32_t r_tail, w_tail, queue_cnt;
 
-	queue_cnt = odp_atomic_load_u64(&input_work_queue->queue_cnt);
+	r_tail = odp_atomic_load_u32(&input_work_queue->r_tail);
+	w_tail = odp_atomic_load_acq_u32(&input_work_queue->w_tail);
+	queue_cnt = w_tail - r_tail;
 	if (queue_cnt == 0)
 		return -1;
 
-	odp_ticketlock_lock(&input_work_queue->lock);
-	head_idx = input_work_queue->head_idx;
-	entry_ptr = &input_work_queue->work_ring[head_idx];
-
-	*work_item = *entry_ptr;
-	head_idx++;
-	if (INPUT_WORK_RING_SIZE <= head_idx)
-		head_idx = 0;
+	if (input_work_queue->peak_cnt < queue_cnt)
+		input_work_queue->peak_cnt = queue_cnt;
 
+	*work_item = input_work_queue->work_ring[r_tail &
+						 (INPUT_WORK_RING_SIZE - 1)];
 	input_work_queue->total_dequeues++;
-	input_work_queue->head_idx = head_idx;
-	odp_ticketlock_unlock(&input_work_queue->lock);
-	odp_atomic_dec_u64(&input_work_queue->queue_cnt);
+	odp_atomic_store_rel_u32(&input_work_queue->r_tail, r_tail + 1);
 	return 0;
 }
 
@@ -1876,23 +1898,39 @@ static void tm_queue_cnts_decrement(tm_system_t *tm_system,
 	odp_atomic_sub_u64(&queue_cnts->byte_cnt, frame_len);
 }
 
+/* The service thread of a tm_group waits for the first enqueue. With several
+ * producer threads exactly one of them joins that barrier, the others spin
+ * until it has been passed. */
+static inline void tm_first_enq_wait(tm_system_t *tm_system)
+{
+	tm_system_group_t *tm_group;
+	uint32_t first_enq = 0;
+
+	tm_group = GET_TM_GROUP(tm_system->odp_tm_group);
+	if (odp_likely(odp_atomic_load_acq_u32(&tm_group->first_enq) == 2))
+		return;
+
+	if (odp_atomic_cas_u32(&tm_group->first_enq, &first_enq, 1)) {
+		odp_barrier_wait(&tm_group->tm_group_barrier);
+		odp_atomic_store_rel_u32(&tm_group->first_enq, 2);
+		return;
+	}
+
+	while (odp_atomic_load_acq_u32(&tm_group->first_enq) != 2)
+		odp_cpu_pause();
+}
+
 static int tm_enqueue(tm_system_t *tm_system,
 		      tm_queue_obj_t *tm_queue_obj,
 		      odp_packet_t pkt)
 {
-	tm_system_group_t *tm_group;
 	input_work_item_t work_item;
 	odp_packet_color_t pkt_color;
 	tm_wred_node_t *initial_tm_wred_node;
 	odp_bool_t drop_eligible, drop;
-	uint32_t frame_len, pkt_depth;
-	int rc;
+	uint32_t frame_len, pkt_depth, num;
 
-	tm_group = GET_TM_GROUP(tm_system->odp_tm_group);
-	if (tm_group->first_enq == 0) {
-		odp_barrier_wait(&tm_group->tm_group_barrier);
-		tm_group->first_enq = 1;
-	}
+	tm_first_enq_wait(tm_system);
 
 	pkt_color = odp_packet_color(pkt);
 	drop_eligible = odp_packet_drop_eligible(pkt);
@@ -1908,12 +1946,12 @@ static int tm_enqueue(tm_system_t *tm_system,
 	work_item.queue_num = tm_queue_obj->queue_num;
 	work_item.pkt = pkt;
 	sched_fn->order_lock();
-	rc = input_work_queue_append(tm_system, &work_item);
+	num = input_work_queue_append(tm_system, &work_item, 1);
 	sched_fn->order_unlock();
 
-	if (rc < 0) {
+	if (num == 0) {
 		ODP_DBG("%s work queue full\n", __func__);
-		return rc;
+		return -1;
 	}
 
 	frame_len = odp_packet_len(pkt);
@@ -1922,6 +1960,58 @@ static int tm_enqueue(tm_system_t *tm_system,
 	return pkt_depth;
 }
 
+static int tm_enqueue_multi(tm_system_t *tm_system,
+			    tm_queue_obj_t *tm_queue_obj,
+			    const odp_packet_t pkts[],
+			    uint32_t num_pkts)
+{
+	input_work_item_t work_items[TM_ENQ_MULTI_BURST];
+	tm_wred_node_t *initial_tm_wred_node;
+	odp_packet_t pkt;
+	uint32_t idx, num, num_enq, frame_len;
+
+	tm_first_enq_wait(tm_system);
+
+	if (num_pkts > TM_ENQ_MULTI_BURST)
+		num_pkts = TM_ENQ_MULTI_BURST;
+
+	/* Run the WRED checks first, stopping at the first drop, so that the
+	 * pkts accepted are always a prefix of the pkts[] array. */
+	initial_tm_wred_node = tm_queue_obj->tm_wred_node;
+	for (num = 0; num < num_pkts; num++) {
+		pkt = pkts[num];
+		if (odp_packet_drop_eligible(pkt) &&
+		    random_early_discard(tm_system, tm_queue_obj,
+					 initial_tm_wred_node,
+					 odp_packet_color(pkt)))
+			break;
+
+		work_items[num].queue_num = tm_queue_obj->queue_num;
+		work_items[num].pkt = pkt;
+	}
+
+	if (num == 0)
+		return 0;
+
+	sched_fn->order_lock();
+	num_enq = input_work_queue_append(tm_system, work_items, num);
+	sched_fn->order_unlock();
+
+	if (num_enq == 0) {
+		ODP_DBG("%s work queue full\n", __func__);
+		return 0;
+	}
+
+	for (idx = 0; idx < num_enq; idx++) {
+		frame_len = odp_packet_len(pkts[idx]);
+		(void)tm_queue_cnts_increment(tm_system, initial_tm_wred_node,
+					      tm_queue_obj->priority,
+					      frame_len);
+	}
+
+	return num_enq;
+}
+
 static void egress_vlan_marking(tm_vlan_marking_t *vlan_marking,
 				odp_packet_t       odp_pkt)
 {
@@ -2087,6 +2177,8 @@ static void tm_egress_marking(tm_system_t *tm_system, odp_packet_t odp_pkt)
 	tm_vlan_marking_t *vlan_marking;
 	tm_tos_marking_t  *ip_marking;
 
+	/* Headers are modified below, complete any lazy parse first */
+	packet_parse_finish(packet_hdr(odp_pkt));
 	color = odp_packet_color(odp_pkt);
 
 	if (odp_packet_has_vlan(odp_pkt)) {
@@ -2331,14 +2423,35 @@ static int thread_affinity_get(odp_cpumask_t *odp_cpu_mask)
 	return 0;
 }
 
+static void tm_group_unlink(tm_system_group_t *tm_group,
+			    tm_system_t *tm_system)
+{
+	tm_system_t *prev_tm_system, *next_tm_system;
+
+	prev_tm_system = tm_system->prev;
+	next_tm_system = tm_system->next;
+	if (next_tm_system == tm_system) {
+		tm_group->first_tm_system = NULL;
+	} else {
+		prev_tm_system->next = next_tm_system;
+		next_tm_system->prev = prev_tm_system;
+		if (tm_group->first_tm_system == tm_system)
+			tm_group->first_tm_system = next_tm_system;
+	}
+
+	tm_system->next = NULL;
+	tm_system->prev = NULL;
+}
+
 static void *tm_system_thread(void *arg)
 {
 	_odp_timer_wheel_t _odp_int_timer_wheel;
 	input_work_queue_t *input_work_queue;
 	tm_system_group_t  *tm_group;
-	tm_system_t *tm_system;
+	tm_system_t *tm_system, *next_tm_system;
 	uint64_t current_ns;
-	uint32_t destroying, work_queue_cnt, timer_cnt;
+	uint32_t work_queue_cnt, timer_cnt;
+	odp_bool_t last_tm_system;
 	int rc;
 
 	rc = odp_init_local((odp_instance_t)odp_global_data.main_pid,
@@ -2346,20 +2459,47 @@ static void *tm_system_thread(void *arg)
 	ODP_ASSERT(rc == 0);
 	tm_group = arg;
 
-	tm_system = tm_group->first_tm_system;
-	_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
-	input_work_queue = tm_system->input_work_queue;
-
 	/* Wait here until we have seen the first enqueue operation. */
 	odp_barrier_wait(&tm_group->tm_group_barrier);
 	main_loop_running = true;
 
-	destroying = odp_atomic_load_u64(&tm_system->destroying);
+	tm_system = tm_group->first_tm_system;
+	while (1) {
+		if (odp_atomic_load_u64(&tm_system->destroying)) {
+			/* This thread is the only one walking the tm_system
+			 * list, so it unlinks the tm_system before letting
+			 * the destroying thread free it. The service thread
+			 * exits with the last tm_system of its tm_group.
+			 * odp_tm_create() may add tm_systems concurrently, so
+			 * the last one is decided while holding the lock. */
+			odp_ticketlock_lock(&tm_create_lock);
+			next_tm_system = tm_system->next;
+			tm_group_unlink(tm_group, tm_system);
+			last_tm_system = tm_group->first_tm_system == NULL;
+			if (last_tm_system)
+				tm_group->exiting = true;
+			odp_ticketlock_unlock(&tm_create_lock);
+			odp_barrier_wait(&tm_system->tm_system_destroy_barrier);
+			if (last_tm_system)
+				break;
+
+			tm_system = next_tm_system;
+			continue;
+		}
 
-	current_ns = odp_time_to_ns(odp_time_local());
-	_odp_timer_wheel_start(_odp_int_timer_wheel, current_ns);
+		_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
+		input_work_queue = tm_system->input_work_queue;
+
+		/* tm_systems may join the tm_group while this thread is
+		 * already running, so each one's timer wheel is started on
+		 * the first visit. */
+		if (odp_unlikely(!tm_system->timer_wheel_started)) {
+			current_ns = odp_time_to_ns(odp_time_local());
+			_odp_timer_wheel_start(_odp_int_timer_wheel,
+					       current_ns);
+			tm_system->timer_wheel_started = 1;
+		}
 
-	while (destroying == 0) {
 		/* See if another thread wants to make a configuration
 		 * change. */
 		check_for_request();
@@ -2382,8 +2522,7 @@ static void *tm_system_thread(void *arg)
 
 		current_ns = odp_time_to_ns(odp_time_local());
 		tm_system->current_time = current_ns;
-		work_queue_cnt =
-			odp_atomic_load_u64(&input_work_queue->queue_cnt);
+		work_queue_cnt = input_work_queue_cnt(input_work_queue);
 
 		if (work_queue_cnt != 0) {
 			tm_process_input_work_queue(tm_system,
@@ -2397,15 +2536,11 @@ static void *tm_system_thread(void *arg)
 		tm_system->current_time = current_ns;
 		tm_system->is_idle = (timer_cnt == 0) &&
 			(work_queue_cnt == 0);
-		destroying = odp_atomic_load_u64(&tm_system->destroying);
 
 		/* Advance to the next tm_system in the tm_system_group. */
 		tm_system = tm_system->next;
-		_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
-		input_work_queue = tm_system->input_work_queue;
 	}
 
-	odp_barrier_wait(&tm_system->tm_system_destroy_barrier);
 	odp_term_local();
 	return NULL;
 }
@@ -2651,6 +2786,7 @@ static _odp_tm_group_t _odp_tm_group_create(const char *name ODP_UNUSED)
 	tm_group = malloc(sizeof(tm_system_group_t));
 	memset(tm_group, 0, sizeof(tm_system_group_t));
 	odp_barrier_init(&tm_group->tm_group_barrier, 2);
+	odp_atomic_init_u32(&tm_group->first_enq, 0);
 
 	/* Add this group to the tm_group_list linked list. */
 	if (tm_group_list == NULL) {
@@ -2714,18 +2850,21 @@ static int _odp_tm_group_add(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 	tm_system->odp_tm_group = odp_tm_group;
 
 	/* Link this tm_system into the circular linked list of all tm_systems
-	 * belonging to the same tm_group. */
+	 * belonging to the same tm_group. The service thread may be walking
+	 * the list, so the new tm_system is fully linked before it becomes
+	 * reachable. */
 	if (tm_group->num_tm_systems == 1) {
-		tm_group->first_tm_system = tm_system;
 		tm_system->next           = tm_system;
 		tm_system->prev           = tm_system;
+		tm_group->first_tm_system = tm_system;
 	} else {
 		first_tm_system        = tm_group->first_tm_system;
 		second_tm_system       = first_tm_system->next;
-		first_tm_system->next  = tm_system;
-		second_tm_system->prev = tm_system;
 		tm_system->prev        = first_tm_system;
 		tm_system->next        = second_tm_system;
+		odp_mb_release();
+		first_tm_system->next  = tm_system;
+		second_tm_system->prev = tm_system;
 		tm_group->first_tm_system = tm_system;
 	}
 
@@ -2741,27 +2880,18 @@ static int _odp_tm_group_add(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 static int _odp_tm_group_remove(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 {
 	tm_system_group_t *tm_group;
-	tm_system_t       *tm_system, *prev_tm_system, *next_tm_system;
+	tm_system_t       *tm_system;
 
 	tm_group  = GET_TM_GROUP(odp_tm_group);
 	tm_system = GET_TM_SYSTEM(odp_tm);
 	if (tm_system->odp_tm_group != odp_tm_group)
 		return -1;
 
-	if ((tm_group->num_tm_systems  == 0) ||
-	    (tm_group->first_tm_system == NULL))
+	if (tm_group->num_tm_systems == 0)
 		return -1;
 
-	/* Remove this tm_system from the tm_group linked list. */
-	if (tm_group->first_tm_system == tm_system)
-		tm_group->first_tm_system = tm_system->next;
-
-	prev_tm_system       = tm_system->prev;
-	next_tm_system       = tm_system->next;
-	prev_tm_system->next = next_tm_system;
-	next_tm_system->prev = prev_tm_system;
-	tm_system->next      = NULL;
-	tm_system->prev      = NULL;
+	/* The service thread has already unlinked this tm_system from the
+	 * tm_group linked list (see tm_system_thread). */
 	tm_group->num_tm_systems--;
 
 	/* If this is the last tm_system associated with this group then
@@ -2777,54 +2907,86 @@ static int tm_group_attach(odp_tm_t odp_tm)
 	tm_system_group_t *tm_group, *min_tm_group;
 	_odp_tm_group_t    odp_tm_group;
 	odp_cpumask_t      all_cpus, worker_cpus;
-	uint32_t           total_cpus, avail_cpus;
-
-	/* If this platform has a small number of cpu's then allocate one
-	 * tm_group and assign all tm_system's to this tm_group.  Otherwise in
-	 * the case of a manycore platform try to allocate one tm_group per
-	 * tm_system, as long as there are still extra cpu's left.  If not
-	 * enough cpu's left than allocate this tm_system to the next tm_group
-	 * in a round robin fashion. */
+	uint32_t           total_cpus, avail_cpus, num_groups, max_groups;
+
+	/* Each tm_group is served by one thread. By default a platform with a
+	 * small number of cpu's allocates one tm_group and assigns all
+	 * tm_system's to it, while a manycore platform tries to allocate one
+	 * tm_group per tm_system as long as there are still extra cpu's left.
+	 * ODP_TM_SERVICE_THREADS overrides the number of tm_groups, so that
+	 * e.g. tm_systems feeding different pktout queues are serviced in
+	 * parallel. When no new tm_group may be created, this tm_system is
+	 * added to the tm_group with the smallest number of tm_systems. */
 	odp_cpumask_all_available(&all_cpus);
 	odp_cpumask_default_worker(&worker_cpus, 0);
 	total_cpus = odp_cpumask_count(&all_cpus);
 	avail_cpus = odp_cpumask_count(&worker_cpus);
 
-	if (total_cpus < 24) {
-		tm_group     = tm_group_list;
-		odp_tm_group = MAKE_ODP_TM_SYSTEM_GROUP(tm_group);
-		if (tm_group == NULL)
-			odp_tm_group = _odp_tm_group_create("");
+	if (tm_max_service_threads)
+		max_groups = tm_max_service_threads;
+	else if (total_cpus < 24)
+		max_groups = 1;
+	else
+		max_groups = avail_cpus > 1 ? ODP_TM_MAX_NUM_SYSTEMS : 1;
 
-		_odp_tm_group_add(odp_tm_group, odp_tm);
-		return 0;
+	num_groups = 0;
+	min_tm_group = NULL;
+	tm_group = tm_group_list;
+	if (tm_group != NULL) {
+		do {
+			/* Service thread of this group is exiting */
+			if (tm_group->exiting) {
+				tm_group = tm_group->next;
+				continue;
+			}
+
+			num_groups++;
+			if (min_tm_group == NULL ||
+			    tm_group->num_tm_systems <
+			    min_tm_group->num_tm_systems)
+				min_tm_group = tm_group;
+
+			tm_group = tm_group->next;
+		} while (tm_group != tm_group_list);
 	}
 
-	/* Manycore case. */
-	if ((tm_group_list == NULL) || (avail_cpus > 1)) {
+	if (num_groups < max_groups)
 		odp_tm_group = _odp_tm_group_create("");
-		_odp_tm_group_add(odp_tm_group, odp_tm);
-		return 0;
-	}
+	else
+		odp_tm_group = MAKE_ODP_TM_SYSTEM_GROUP(min_tm_group);
 
-	/* Pick a tm_group according to the smallest number of tm_systems. */
-	tm_group     = tm_group_list;
-	min_tm_group = NULL;
-	while (tm_group != NULL) {
-		if (min_tm_group == NULL)
-			min_tm_group = tm_group;
-		else if (tm_group->num_tm_systems <
-			 min_tm_group->num_tm_systems)
-			min_tm_group = tm_group;
-
-		tm_group = tm_group->next;
-	}
+	_odp_tm_group_add(odp_tm_group, odp_tm);
+	return 0;
+}
 
-	if (min_tm_group == NULL)
+/* Select the pktout queue of a new tm_system. Successive tm_systems created
+ * on the same pktio use successive pktout queues, so that the egress of a
+ * multi-queue interface can be split between several tm_systems. */
+static int tm_pktout_queue_select(odp_pktio_t pktio,
+				  odp_pktout_queue_t *pktout)
+{
+	odp_pktout_queue_t queues[ODP_TM_MAX_NUM_SYSTEMS];
+	tm_system_t *tm_system;
+	uint32_t tm_idx, num_users;
+	int num;
+
+	num = odp_pktout_queue(pktio, queues, ODP_TM_MAX_NUM_SYSTEMS);
+	if (num < 1)
 		return -1;
 
-	odp_tm_group = MAKE_ODP_TM_SYSTEM_GROUP(tm_group);
-	_odp_tm_group_add(odp_tm_group, odp_tm);
+	if (num > ODP_TM_MAX_NUM_SYSTEMS)
+		num = ODP_TM_MAX_NUM_SYSTEMS;
+
+	num_users = 0;
+	for (tm_idx = 0; tm_idx < ODP_TM_MAX_NUM_SYSTEMS; tm_idx++) {
+		tm_system = odp_tm_systems[tm_idx];
+		if (tm_system &&
+		    tm_system->egress.egress_kind == ODP_TM_EGRESS_PKT_IO &&
+		    tm_system->egress.pktio == pktio)
+			num_users++;
+	}
+
+	*pktout = queues[num_users % num];
 	return 0;
 }
 
@@ -2841,15 +3003,17 @@ odp_tm_t odp_tm_create(const char            *name,
 	uint32_t max_tm_queues, max_sorted_lists;
 	int rc;
 
-	/* If we are using pktio output (usual case) get the first associated
-	 * pktout_queue for this pktio and fail if there isn't one.
+	/* Allocate tm_system_t record. If we are using pktio output (usual
+	 * case) select an associated pktout_queue for this pktio and fail if
+	 * there isn't one.
 	 */
+	odp_ticketlock_lock(&tm_create_lock);
 	if (egress->egress_kind == ODP_TM_EGRESS_PKT_IO &&
-	    odp_pktout_queue(egress->pktio, &pktout, 1) != 1)
+	    tm_pktout_queue_select(egress->pktio, &pktout)) {
+		odp_ticketlock_unlock(&tm_create_lock);
 		return ODP_TM_INVALID;
+	}
 
-	/* Allocate tm_system_t record. */
-	odp_ticketlock_lock(&tm_create_lock);
 	tm_system = tm_system_alloc();
 	if (!tm_system) {
 		odp_ticketlock_unlock(&tm_create_lock);
@@ -3001,13 +3165,16 @@ int odp_tm_destroy(odp_tm_t odp_tm)
 	/* Remove ourselves from the group.  If we are the last tm_system in
 	 * this group, odp_tm_group_remove will destroy any service threads
 	 * allocated by this group. */
+	odp_ticketlock_lock(&tm_create_lock);
 	_odp_tm_group_remove(tm_system->odp_tm_group, odp_tm);
+	odp_ticketlock_unlock(&tm_create_lock);
 
 	input_work_queue_destroy(tm_system->input_work_queue);
 	_odp_sorted_pool_destroy(tm_system->_odp_int_sorted_pool);
 	_odp_queue_pool_destroy(tm_system->_odp_int_queue_pool);
 	_odp_timer_wheel_destroy(tm_system->_odp_int_timer_wheel);
 
+	_odp_int_name_tbl_delete(tm_system->name_tbl_id);
 	tm_system_free(tm_system);
 	return 0;
 }
@@ -4359,6 +4526,38 @@ int odp_tm_enq_with_cnt(odp_tm_queue_t tm_queue, odp_packet_t pkt)
 	return pkt_cnt;
 }
 
+int odp_tm_enq_multi(odp_tm_queue_t tm_queue, const odp_packet_t packets[],
+		     int num)
+{
+	tm_queue_obj_t *tm_queue_obj;
+	tm_system_t *tm_system;
+	int num_enq, rc;
+
+	tm_queue_obj = GET_TM_QUEUE_OBJ(tm_queue);
+	if (!tm_queue_obj)
+		return -1;
+
+	tm_system = odp_tm_systems[tm_queue_obj->tm_idx];
+	if (!tm_system)
+		return -1;
+
+	if (odp_atomic_load_u64(&tm_system->destroying))
+		return -1;
+
+	/* Dropped pkts and a full input queue end the burst. Those are not
+	 * failures, the call returns the number of pkts enqueued before. */
+	num_enq = 0;
+	while (num_enq < num) {
+		rc = tm_enqueue_multi(tm_system, tm_queue_obj,
+				      &packets[num_enq], num - num_enq);
+		num_enq += rc;
+		if (rc < TM_ENQ_MULTI_BURST)
+			break;
+	}
+
+	return num_enq;
+}
+
 int odp_tm_node_info(odp_tm_node_t tm_node, odp_tm_node_info_t *info)
 {
 	tm_queue_thresholds_t *threshold_params;
@@ -4643,20 +4842,21 @@ void odp_tm_stats_print(odp_tm_t odp_tm)
 	input_work_queue_t *input_work_queue;
 	tm_queue_obj_t *tm_queue_obj;
 	tm_system_t *tm_system;
-	uint32_t queue_num, max_queue_num;
+	uint32_t queue_num, max_queue_num, queue_cnt;
 
 	tm_system = GET_TM_SYSTEM(odp_tm);
 	input_work_queue = tm_system->input_work_queue;
 
 	ODP_PRINT("odp_tm_stats_print - tm_system=0x%" PRIX64 " tm_idx=%u\n",
 		  odp_tm, tm_system->tm_idx);
+	queue_cnt = input_work_queue_cnt(input_work_queue);
 	ODP_PRINT("  input_work_queue size=%u current cnt=%u peak cnt=%u\n",
-		  INPUT_WORK_RING_SIZE, input_work_queue->queue_cnt,
-		  input_work_queue->peak_cnt);
+		  INPUT_WORK_RING_SIZE, queue_cnt, input_work_queue->peak_cnt);
 	ODP_PRINT("  input_work_queue enqueues=%" PRIu64 " dequeues=% " PRIu64
-		  " fail_cnt=%" PRIu64 "\n", input_work_queue->total_enqueues,
+		  " fail_cnt=%" PRIu64 "\n",
+		  input_work_queue->total_dequeues + queue_cnt,
 		  input_work_queue->total_dequeues,
-		  input_work_queue->enqueue_fail_cnt);
+		  odp_atomic_load_u64(&input_work_queue->enqueue_fail_cnt));
 	ODP_PRINT("  green_cnt=%" PRIu64 " yellow_cnt=%" PRIu64 " red_cnt=%"
 		  PRIu64 "\n", tm_system->shaper_green_cnt,
 		  tm_system->shaper_yellow_cnt,
@@ -4683,10 +4883,19 @@ void odp_tm_stats_print(odp_tm_t odp_tm)
 
 int odp_tm_init_global(void)
 {
+	const char *env;
+
 	odp_ticketlock_init(&tm_create_lock);
 	odp_ticketlock_init(&tm_profile_lock);
 	odp_barrier_init(&tm_first_enq, 2);
 
+	env = getenv("ODP_TM_SERVICE_THREADS");
+	if (env) {
+		tm_max_service_threads = atoi(env);
+		ODP_DBG("TM service threads: %" PRIu32 "\n",
+			tm_max_service_threads);
+	}
+
 	odp_atomic_init_u64(&atomic_request_cnt, 0);
 	odp_atomic_init_u64(&currently_serving_cnt, 0);
 	odp_atomic_init_u64(&atomic_done_cnt, 0);
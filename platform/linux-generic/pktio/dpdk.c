@@ -123,7 +123,7 @@ static unsigned cache_size(uint32_t num)
 static inline uint16_t mbuf_data_off(struct rte_mbuf *mbuf,
 				     odp_packet_hdr_t *pkt_hdr)
 {
-	return (uintptr_t)pkt_hdr->buf_hdr.seg[0].data -
+	return (uintptr_t)pkt_hdr->seg[0].data -
 			(uintptr_t)mbuf->buf_addr;
 }
 
@@ -141,7 +141,7 @@ static inline void mbuf_update(struct rte_mbuf *mbuf, odp_packet_hdr_t *pkt_hdr,
 	mbuf->ol_flags = 0;
 
 	if (odp_unlikely(pkt_hdr->buf_hdr.base_data !=
-			 pkt_hdr->buf_hdr.seg[0].data))
+			 pkt_hdr->seg[0].data))
 		mbuf->data_off = mbuf_data_off(mbuf, pkt_hdr);
 }
 
@@ -448,8 +448,6 @@ static inline int mbuf_to_pkt(pktio_entry_t *pktio_entry,
 	}
 
 	for (i = 0; i < num; i++) {
-		odp_packet_hdr_t parsed_hdr;
-
 		mbuf = mbuf_table[i];
 		if (odp_unlikely(mbuf->nb_segs != 1)) {
 			ODP_ERR("Segmented buffers not supported\n");
@@ -461,14 +459,6 @@ static inline int mbuf_to_pkt(pktio_entry_t *pktio_entry,
 
 		pkt_len = rte_pktmbuf_pkt_len(mbuf);
 
-		if (pktio_cls_enabled(pktio_entry)) {
-			if (cls_classify_packet(pktio_entry,
-						(const uint8_t *)data,
-						pkt_len, pkt_len, &pool,
-						&parsed_hdr))
-				goto fail;
-		}
-
 		pkt     = pkt_table[i];
 		pkt_hdr = packet_hdr(pkt);
 		pull_tail(pkt_hdr, alloc_len - pkt_len);
@@ -478,9 +468,7 @@ static inline int mbuf_to_pkt(pktio_entry_t *pktio_entry,
 
 		pkt_hdr->input = input;
 
-		if (pktio_cls_enabled(pktio_entry))
-			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
-		else if (parse_layer != ODP_PROTO_LAYER_NONE)
+		if (parse_layer != ODP_PROTO_LAYER_NONE)
 			packet_parse_layer(pkt_hdr, parse_layer);
 
 		if (mbuf->ol_flags & PKT_RX_RSS_HASH)
@@ -512,6 +500,119 @@ fail:
 	return (i > 0 ? i : -1);
 }
 
+/* Classify a burst of mbufs into temporary packet headers */
+static inline int mbuf_classify(pktio_entry_t *pktio_entry,
+				struct rte_mbuf *mbuf_table[], int num,
+				odp_packet_hdr_t parsed_hdr[],
+				odp_pool_t pool[], uint16_t order[])
+{
+	odp_packet_hdr_t *parsed[CLS_BURST_MAX];
+	const uint8_t *data[CLS_BURST_MAX];
+	uint32_t pkt_len[CLS_BURST_MAX];
+	uint32_t seg_len[CLS_BURST_MAX];
+	int i;
+
+	for (i = 0; i < num; i++) {
+		data[i] = rte_pktmbuf_mtod(mbuf_table[i], const uint8_t *);
+		pkt_len[i] = rte_pktmbuf_pkt_len(mbuf_table[i]);
+		seg_len[i] = rte_pktmbuf_data_len(mbuf_table[i]);
+		parsed[i] = &parsed_hdr[i];
+	}
+
+	return cls_classify_packet_multi(pktio_entry, data, pkt_len, seg_len,
+					 pool, parsed, order, num);
+}
+
+/* Copy mbufs into packets allocated from the pools of their destination
+ * CoSes. Packets of the same pool are allocated together. */
+static inline int mbuf_to_pkt_cls(pktio_entry_t *pktio_entry,
+				  odp_packet_t pkt_table[],
+				  struct rte_mbuf *mbuf_table[],
+				  uint16_t mbuf_num, odp_time_t *ts)
+{
+	odp_packet_hdr_t parsed_hdr[CLS_BURST_MAX];
+	odp_pool_t pool[CLS_BURST_MAX];
+	uint16_t order[CLS_BURST_MAX];
+	odp_packet_t pkt[CLS_BURST_MAX];
+	odp_packet_hdr_t *pkt_hdr;
+	struct rte_mbuf *mbuf;
+	uint16_t pkt_len;
+	void *data;
+	int first, num, num_cls, run, num_alloc, i, j, idx;
+	int nb_pkts = 0;
+	int alloc_len = pktio_entry->s.pkt_dpdk.data_room;
+	odp_pktin_config_opt_t *pktin_cfg = &pktio_entry->s.config.pktin;
+	odp_pktio_t input = pktio_entry->s.handle;
+
+	for (first = 0; first < mbuf_num; first += num) {
+		num = mbuf_num - first;
+		if (num > CLS_BURST_MAX)
+			num = CLS_BURST_MAX;
+
+		num_cls = mbuf_classify(pktio_entry, &mbuf_table[first], num,
+					parsed_hdr, pool, order);
+
+		for (i = 0; i < num_cls; i += run) {
+			for (run = 1; i + run < num_cls; run++)
+				if (pool[order[i + run]] != pool[order[i]])
+					break;
+
+			num_alloc = packet_alloc_multi(pool[order[i]],
+						       alloc_len, pkt, run);
+			if (num_alloc != run)
+				ODP_DBG("packet_alloc_multi() unable to "
+					"allocate all packets: %d/%d "
+					"allocated\n", num_alloc, run);
+
+			for (j = 0; j < num_alloc; j++) {
+				idx = order[i + j];
+				mbuf = mbuf_table[first + idx];
+
+				if (odp_unlikely(mbuf->nb_segs != 1)) {
+					ODP_ERR("Segmented buffers not "
+						"supported\n");
+					odp_packet_free(pkt[j]);
+					continue;
+				}
+
+				pkt_len = rte_pktmbuf_pkt_len(mbuf);
+				pkt_hdr = packet_hdr(pkt[j]);
+				pull_tail(pkt_hdr, alloc_len - pkt_len);
+
+				data = rte_pktmbuf_mtod(mbuf, char *);
+				if (_odp_packet_copy_from_mem(pkt[j], 0,
+							      pkt_len, data)) {
+					odp_packet_free(pkt[j]);
+					continue;
+				}
+
+				pkt_hdr->input = input;
+				copy_packet_cls_metadata(&parsed_hdr[idx],
+							 pkt_hdr);
+
+				if (mbuf->ol_flags & PKT_RX_RSS_HASH)
+					packet_set_flow_hash(pkt_hdr,
+							     mbuf->hash.rss);
+
+				packet_set_ts(pkt_hdr, ts);
+
+				if (pktin_cfg->all_bits & PKTIN_CSUM_BITS &&
+				    pkt_set_ol_rx(pktin_cfg, pkt_hdr, mbuf)) {
+					odp_packet_free(pkt[j]);
+					continue;
+				}
+
+				pkt_table[nb_pkts++] = pkt[j];
+			}
+		}
+
+		for (i = 0; i < num; i++)
+			rte_pktmbuf_free(mbuf_table[first + i]);
+	}
+
+	return nb_pkts;
+}
+
 static inline int check_proto(void *l3_hdr, odp_bool_t *l3_proto_v4,
 			      uint8_t *l4_proto)
 {
@@ -674,71 +775,78 @@ static inline int mbuf_to_pkt_zero(pktio_entry_t *pktio_entry,
 				   struct rte_mbuf *mbuf_table[],
 				   uint16_t mbuf_num, odp_time_t *ts)
 {
+	odp_packet_hdr_t parsed_hdr[CLS_BURST_MAX];
+	odp_pool_t pool[CLS_BURST_MAX];
 	odp_packet_t pkt;
 	odp_packet_hdr_t *pkt_hdr;
 	uint16_t pkt_len;
 	struct rte_mbuf *mbuf;
 	void *data;
-	int i;
+	int first, num, i;
 	int nb_pkts = 0;
-	odp_pool_t pool = pktio_entry->s.pkt_dpdk.pool;
+	int cls_enabled = pktio_cls_enabled(pktio_entry);
 	odp_pktin_config_opt_t *pktin_cfg = &pktio_entry->s.config.pktin;
 	odp_proto_layer_t parse_layer = pktio_entry->s.config.parser.layer;
 	odp_pktio_t input = pktio_entry->s.handle;
 
-	for (i = 0; i < mbuf_num; i++) {
-		odp_packet_hdr_t parsed_hdr;
-
-		mbuf = mbuf_table[i];
-		if (odp_unlikely(mbuf->nb_segs != 1)) {
-			ODP_ERR("Segmented buffers not supported\n");
-			rte_pktmbuf_free(mbuf);
-			continue;
-		}
-
-		data = rte_pktmbuf_mtod(mbuf, char *);
-		odp_prefetch(data);
+	for (first = 0; first < mbuf_num; first += num) {
+		num = mbuf_num - first;
+		if (num > CLS_BURST_MAX)
+			num = CLS_BURST_MAX;
 
-		pkt_len = rte_pktmbuf_pkt_len(mbuf);
+		if (cls_enabled)
+			mbuf_classify(pktio_entry, &mbuf_table[first], num,
+				      parsed_hdr, pool, NULL);
 
-		pkt = (odp_packet_t)mbuf->userdata;
-		pkt_hdr = packet_hdr(pkt);
+		for (i = 0; i < num; i++) {
+			mbuf = mbuf_table[first + i];
+			if (odp_unlikely(mbuf->nb_segs != 1)) {
+				ODP_ERR("Segmented buffers not supported\n");
+				rte_pktmbuf_free(mbuf);
+				continue;
+			}
 
-		if (pktio_cls_enabled(pktio_entry)) {
-			if (cls_classify_packet(pktio_entry,
-						(const uint8_t *)data,
-						pkt_len, pkt_len, &pool,
-						&parsed_hdr))
+			if (cls_enabled && pool[i] == ODP_POOL_INVALID) {
 				ODP_ERR("Unable to classify packet\n");
 				rte_pktmbuf_free(mbuf);
 				continue;
-		}
+			}
 
-		/* Init buffer segments. Currently, only single segment packets
-		 * are supported. */
-		pkt_hdr->buf_hdr.seg[0].data = data;
+			data = rte_pktmbuf_mtod(mbuf, char *);
+			odp_prefetch(data);
 
-		packet_init(pkt_hdr, pkt_len);
-		pkt_hdr->input = input;
+			pkt_len = rte_pktmbuf_pkt_len(mbuf);
 
-		if (pktio_cls_enabled(pktio_entry))
-			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
-		else if (parse_layer != ODP_PROTO_LAYER_NONE)
-			packet_parse_layer(pkt_hdr, parse_layer);
+			pkt = (odp_packet_t)mbuf->userdata;
+			pkt_hdr = packet_hdr(pkt);
 
-		if (mbuf->ol_flags & PKT_RX_RSS_HASH)
-			packet_set_flow_hash(pkt_hdr, mbuf->hash.rss);
+			/* Init buffer segments. Currently, only single segment
+			 * packets are supported. */
+			pkt_hdr->seg[0].data = data;
 
-		packet_set_ts(pkt_hdr, ts);
+			packet_init(pkt_hdr, pkt_len);
+			pkt_hdr->input = input;
 
-		if (pktin_cfg->all_bits & PKTIN_CSUM_BITS) {
-			if (pkt_set_ol_rx(pktin_cfg, pkt_hdr, mbuf)) {
-				rte_pktmbuf_free(mbuf);
-				continue;
+			if (cls_enabled)
+				copy_packet_cls_metadata(&parsed_hdr[i],
+							 pkt_hdr);
+			else if (parse_layer != ODP_PROTO_LAYER_NONE)
+				packet_parse_layer(pkt_hdr, parse_layer);
+
+			if (mbuf->ol_flags & PKT_RX_RSS_HASH)
+				packet_set_flow_hash(pkt_hdr, mbuf->hash.rss);
+
+			packet_set_ts(pkt_hdr, ts);
+
+			if (pktin_cfg->all_bits & PKTIN_CSUM_BITS) {
+				if (pkt_set_ol_rx(pktin_cfg, pkt_hdr, mbuf)) {
+					rte_pktmbuf_free(mbuf);
+					continue;
+				}
 			}
-		}
 
-		pkt_table[nb_pkts++] = pkt;
+			pkt_table[nb_pkts++] = pkt;
+		}
 	}
 
 	return nb_pkts;
@@ -1571,6 +1679,9 @@ static int dpdk_recv(pktio_entry_t *pktio_entry, int index,
 		if (ODP_DPDK_ZERO_COPY)
 			nb_rx = mbuf_to_pkt_zero(pktio_entry, pkt_table,
 						 rx_mbufs, nb_rx, ts);
+		else if (pktio_cls_enabled(pktio_entry))
+			nb_rx = mbuf_to_pkt_cls(pktio_entry, pkt_table,
+						rx_mbufs, nb_rx, ts);
 		else
 			nb_rx = mbuf_to_pkt(pktio_entry, pkt_table, rx_mbufs,
 					    nb_rx, ts);
@@ -28,6 +28,32 @@
 /* MAC address for the "ipc" interface */
 static const char pktio_ipc_mac[] = {0x12, 0x12, 0x12, 0x12, 0x12, 0x12};
 
+/* Receive packets without copying data out of the remote pool */
+int _odp_ipc_zero_copy;
+
+/* Zero-copy receive state of an interface. Packets refer to this instead of
+ * the pktio entry, since the entry may be reused after close. */
+typedef struct ODP_ALIGNED_CACHE {
+	/* Zero-copy packets not yet freed, plus one while the interface is
+	 * open. The last reference releases the remote pool and the ring. */
+	odp_atomic_u32_t refs;
+	_ring_t *free_ring;
+	odp_shm_t free_ring_shm;
+	odp_shm_t pool_shm;
+} ipc_zc_t;
+
+typedef struct {
+	ipc_zc_t zc[ODP_CONFIG_PKTIO_ENTRIES];
+	odp_shm_t shm;
+} ipc_global_t;
+
+static ipc_global_t *ipc_global;
+
+static inline ipc_zc_t *ipc_zc(pktio_entry_t *pktio_entry)
+{
+	return &ipc_global->zc[_odp_pktio_index(pktio_entry->s.handle)];
+}
+
 static odp_shm_t _ipc_map_remote_pool(const char *name, int pid);
 
 static const char *_ipc_odp_buffer_pool_shm_name(odp_pool_t pool_hdl)
@@ -335,6 +361,7 @@ static int ipc_pktio_open(odp_pktio_t id ODP_UNUSED,
 	char name[ODP_POOL_NAME_LEN + sizeof("_info")];
 	char tail[ODP_POOL_NAME_LEN];
 	odp_shm_t shm;
+	ipc_zc_t *zc;
 
 	ODP_STATIC_ASSERT(ODP_POOL_NAME_LEN == _RING_NAMESIZE,
 			  "mismatch pool and ring name arrays");
@@ -342,6 +369,15 @@ static int ipc_pktio_open(odp_pktio_t id ODP_UNUSED,
 	if (strncmp(dev, "ipc", 3))
 		return -1;
 
+	/* Packets received through a closed interface of this entry still
+	 * refer to its remote pool */
+	zc = ipc_zc(pktio_entry);
+	if (odp_atomic_load_u32(&zc->refs)) {
+		ODP_ERR("%s: zero-copy packets of a closed interface in use\n",
+			dev);
+		return -1;
+	}
+
 	odp_atomic_init_u32(&pktio_entry->s.ipc.ready, 0);
 
 	pktio_entry->s.ipc.rx.cache = _ring_create("ipc_rx_cache",
@@ -387,6 +423,13 @@ static int ipc_pktio_open(odp_pktio_t id ODP_UNUSED,
 		ret = _ipc_init_master(pktio_entry, dev, pool);
 	}
 
+	if (ret == 0) {
+		zc->free_ring     = NULL;
+		zc->free_ring_shm = ODP_SHM_INVALID;
+		zc->pool_shm      = ODP_SHM_INVALID;
+		odp_atomic_store_u32(&zc->refs, 1);
+	}
+
 	return ret;
 }
 
@@ -424,6 +467,106 @@ static void _ipc_free_ring_packets(pktio_entry_t *pktio_entry, _ring_t *r)
 	}
 }
 
+/* Release remote pool and free ring mappings, which zero-copy packets
+ * refer to */
+static void _ipc_zc_release(ipc_zc_t *zc)
+{
+	odp_mb_acquire();
+
+	if (zc->free_ring_shm != ODP_SHM_INVALID)
+		odp_shm_free(zc->free_ring_shm);
+
+	if (zc->pool_shm != ODP_SHM_INVALID)
+		odp_shm_free(zc->pool_shm);
+
+	zc->free_ring     = NULL;
+	zc->free_ring_shm = ODP_SHM_INVALID;
+	zc->pool_shm      = ODP_SHM_INVALID;
+}
+
+void _odp_ipc_free_zero_copy(odp_packet_hdr_t *pkt_hdr)
+{
+	odp_buffer_hdr_t *buf_hdr = &pkt_hdr->buf_hdr;
+	pool_t *pool = buf_hdr->pool_ptr;
+	ipc_zc_t *zc = pkt_hdr->ipc_zc;
+	uintptr_t offset = pkt_hdr->ipc_hdr_offset;
+	void **rbuf_p = (void *)&offset;
+
+	/* Tell the owner that the buffer is not used anymore */
+	while (_ring_mp_enqueue_burst(zc->free_ring, rbuf_p, 1) != 1)
+		odp_cpu_pause();
+
+	/* Restore local data pointers */
+	buf_hdr->base_data = pkt_hdr->ipc_base_data;
+	pkt_hdr->buf_end   = buf_hdr->base_data + pool->seg_len +
+			     pool->tailroom;
+	pkt_hdr->ipc_zc = NULL;
+
+	/* Interface was closed while this packet was in use */
+	odp_mb_release();
+	if (odp_atomic_fetch_dec_u32(&zc->refs) == 1)
+		_ipc_zc_release(zc);
+}
+
+/* Receive packets referencing data in the remote pool. Locally allocated
+ * packet headers point to the remote data. The remote buffer is returned
+ * to its owner when the packet is freed. */
+static int ipc_pktio_recv_zero_copy(pktio_entry_t *pktio_entry,
+				    odp_packet_t pkt_table[],
+				    uintptr_t offsets[], int pkts)
+{
+	int num, i;
+	int pkts_ring;
+	void **ipcbufs_p;
+	uint8_t *base = pktio_entry->s.ipc.pool_mdata_base;
+	ipc_zc_t *zc = ipc_zc(pktio_entry);
+
+	num = packet_alloc_multi(pktio_entry->s.ipc.pool, 0, pkt_table, pkts);
+	if (odp_unlikely(num < 0))
+		num = 0;
+
+	if (odp_likely(num))
+		odp_atomic_add_u32(&zc->refs, num);
+
+	for (i = 0; i < num; i++) {
+		odp_packet_hdr_t *phdr = (void *)(base + offsets[i]);
+		odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt_table[i]);
+		odp_buffer_hdr_t *buf_hdr = &pkt_hdr->buf_hdr;
+		uint8_t *data = base + phdr->ipc_data_offset;
+
+		copy_packet_cls_metadata(phdr, pkt_hdr);
+		pkt_hdr->p         = phdr->p;
+		pkt_hdr->frame_len = phdr->frame_len;
+		pkt_hdr->headroom  = phdr->headroom;
+		pkt_hdr->tailroom  = phdr->tailroom;
+
+		/* Headroom and tailroom calculations use base data and
+		 * buffer end pointers */
+		pkt_hdr->ipc_base_data = buf_hdr->base_data;
+		buf_hdr->base_data = data + CONFIG_PACKET_HEADROOM -
+				     phdr->headroom;
+		pkt_hdr->buf_end   = data + phdr->frame_len + phdr->tailroom;
+		pkt_hdr->seg[0].data = data;
+		pkt_hdr->seg[0].len  = phdr->frame_len;
+
+		pkt_hdr->ipc_hdr_offset = offsets[i];
+		pkt_hdr->ipc_zc         = zc;
+	}
+
+	/* Keep packet order when out of packet headers */
+	if (odp_unlikely(num != pkts)) {
+		IPC_ODP_DBG("unable to allocate packet %d/%d\n", num, pkts);
+
+		ipcbufs_p = (void *)&offsets[num];
+		pkts_ring = _ring_mp_enqueue_burst(pktio_entry->s.ipc.rx.cache,
+						   ipcbufs_p, pkts - num);
+		if (pkts_ring != (pkts - num))
+			ODP_ABORT("bug to enqueue packets\n");
+	}
+
+	return num;
+}
+
 static int ipc_pktio_recv_lockless(pktio_entry_t *pktio_entry,
 				   odp_packet_t pkt_table[], int len)
 {
@@ -463,6 +606,10 @@ static int ipc_pktio_recv_lockless(pktio_entry_t *pktio_entry,
 	if (odp_likely(0 == pkts))
 		return 0;
 
+	if (_odp_ipc_zero_copy)
+		return ipc_pktio_recv_zero_copy(pktio_entry, pkt_table,
+						offsets, pkts);
+
 	for (i = 0; i < pkts; i++) {
 		odp_pool_t pool;
 		odp_packet_t pkt;
@@ -478,7 +625,7 @@ static int ipc_pktio_recv_lockless(pktio_entry_t *pktio_entry,
 		if (odp_unlikely(pool == ODP_POOL_INVALID))
 			ODP_ABORT("invalid pool");
 
-		data_pool_off = phdr->buf_hdr.ipc_data_offset;
+		data_pool_off = phdr->ipc_data_offset;
 
 		pkt = odp_packet_alloc(pool, phdr->frame_len);
 		if (odp_unlikely(pkt == ODP_PACKET_INVALID)) {
@@ -596,7 +743,8 @@ static int ipc_pktio_send_lockless(pktio_entry_t *pktio_entry,
 	_ipc_free_ring_packets(pktio_entry, pktio_entry->s.ipc.tx.free);
 
 	/* Copy packets to shm shared pool if they are in different
-	 * pool, or if they are references (we can't share across IPC).
+	 * pool, or if they are references or zero-copy packets (we can't
+	 * share across IPC).
 	 */
 	for (i = 0; i < num; i++) {
 		odp_packet_t pkt =  pkt_table[i];
@@ -608,12 +756,17 @@ static int ipc_pktio_send_lockless(pktio_entry_t *pktio_entry,
 		pool = pkt_hdr->buf_hdr.pool_ptr;
 
 		if (pool->pool_idx != ipc_pool->pool_idx ||
-		    odp_packet_has_ref(pkt)) {
+		    odp_packet_has_ref(pkt) ||
+		    pkt_hdr->ipc_zc) {
 			odp_packet_t newpkt;
 
 			newpkt = odp_packet_copy(pkt, pktio_entry->s.ipc.pool);
-			if (newpkt == ODP_PACKET_INVALID)
-				ODP_ABORT("Unable to copy packet\n");
+			if (odp_unlikely(newpkt == ODP_PACKET_INVALID)) {
+				/* Pool is empty until the remote process
+				 * frees packets. Send the rest later. */
+				num = i;
+				break;
+			}
 
 			odp_packet_free(pkt);
 			pkt_table_mapped[i] = newpkt;
@@ -622,6 +775,9 @@ static int ipc_pktio_send_lockless(pktio_entry_t *pktio_entry,
 		}
 	}
 
+	if (odp_unlikely(num == 0))
+		return 0;
+
 	/* Set offset to phdr for outgoing packets */
 	for (i = 0; i < num; i++) {
 		uint64_t data_pool_off;
@@ -632,16 +788,16 @@ static int ipc_pktio_send_lockless(pktio_entry_t *pktio_entry,
 
 		offsets[i] = (uint8_t *)pkt_hdr -
 			     (uint8_t *)odp_shm_addr(pool->shm);
-		data_pool_off = (uint8_t *)pkt_hdr->buf_hdr.seg[0].data -
+		data_pool_off = (uint8_t *)pkt_hdr->seg[0].data -
 				(uint8_t *)odp_shm_addr(pool->shm);
 
 		/* compile all function code even if ipc disabled with config */
-		pkt_hdr->buf_hdr.ipc_data_offset = data_pool_off;
+		pkt_hdr->ipc_data_offset = data_pool_off;
 		IPC_ODP_DBG("%d/%d send packet %llx, pool %llx,"
 			    "phdr = %p, offset %x sendoff %x, addr %llx iaddr %llx\n",
 			    i, num,
 			    odp_packet_to_u64(pkt), odp_pool_to_u64(pool_hdl),
-			    pkt_hdr, pkt_hdr->buf_hdr.ipc_data_offset,
+			    pkt_hdr, pkt_hdr->ipc_data_offset,
 			    offsets[i], odp_shm_addr(pool->shm),
 			    odp_shm_addr(pool_entry_from_hdl(
 					 pktio_entry->s.ipc.pool)->shm));
@@ -695,6 +851,7 @@ static int ipc_mac_addr_get(pktio_entry_t *pktio_entry ODP_UNUSED,
 static int ipc_start(pktio_entry_t *pktio_entry)
 {
 	uint32_t ready = odp_atomic_load_u32(&pktio_entry->s.ipc.ready);
+	int ret;
 
 	if (ready) {
 		ODP_ABORT("%s Already started\n", pktio_entry->s.name);
@@ -702,9 +859,14 @@ static int ipc_start(pktio_entry_t *pktio_entry)
 	}
 
 	if (pktio_entry->s.ipc.type == PKTIO_TYPE_IPC_MASTER)
-		return _ipc_master_start(pktio_entry);
+		ret = _ipc_master_start(pktio_entry);
 	else
-		return _ipc_slave_start(pktio_entry);
+		ret = _ipc_slave_start(pktio_entry);
+
+	if (ret == 0)
+		ipc_zc(pktio_entry)->free_ring = pktio_entry->s.ipc.rx.free;
+
+	return ret;
 }
 
 static int ipc_stop(pktio_entry_t *pktio_entry)
@@ -740,11 +902,10 @@ static int ipc_close(pktio_entry_t *pktio_entry)
 	char name[ODP_POOL_NAME_LEN];
 	char tail[ODP_POOL_NAME_LEN];
 	int pid = 0;
+	ipc_zc_t *zc = ipc_zc(pktio_entry);
 
 	ipc_stop(pktio_entry);
 
-	odp_shm_free(pktio_entry->s.ipc.remote_pool_shm);
-
 	if (sscanf(dev, "ipc:%d:%s", &pid, tail) == 2)
 		snprintf(name, sizeof(name), "ipc:%s", tail);
 	else
@@ -753,24 +914,84 @@ static int ipc_close(pktio_entry_t *pktio_entry)
 	/* unlink this pktio info for both master and slave */
 	odp_shm_free(pktio_entry->s.ipc.pinfo_shm);
 
+	/* Zero-copy packets refer to the remote pool and return buffers
+	 * through the rx free ring. Those are released when the last packet
+	 * is freed. */
+	if (pktio_entry->s.ipc.type == PKTIO_TYPE_IPC_MASTER)
+		snprintf(ipc_shm_name, sizeof(ipc_shm_name), "%s_s_cons",
+			 name);
+	else
+		snprintf(ipc_shm_name, sizeof(ipc_shm_name), "%s_m_cons",
+			 name);
+
+	zc->free_ring_shm = odp_shm_lookup(ipc_shm_name);
+	zc->pool_shm      = pktio_entry->s.ipc.remote_pool_shm;
+
 	/* destroy rings */
-	snprintf(ipc_shm_name, sizeof(ipc_shm_name), "%s_s_cons", name);
-	_ring_destroy(ipc_shm_name);
 	snprintf(ipc_shm_name, sizeof(ipc_shm_name), "%s_s_prod", name);
 	_ring_destroy(ipc_shm_name);
-	snprintf(ipc_shm_name, sizeof(ipc_shm_name), "%s_m_cons", name);
-	_ring_destroy(ipc_shm_name);
 	snprintf(ipc_shm_name, sizeof(ipc_shm_name), "%s_m_prod", name);
 	_ring_destroy(ipc_shm_name);
+
+	if (pktio_entry->s.ipc.type == PKTIO_TYPE_IPC_MASTER)
+		snprintf(ipc_shm_name, sizeof(ipc_shm_name), "%s_m_cons",
+			 name);
+	else
+		snprintf(ipc_shm_name, sizeof(ipc_shm_name), "%s_s_cons",
+			 name);
+	_ring_destroy(ipc_shm_name);
 	_ring_destroy("ipc_rx_cache");
 
+	odp_mb_release();
+	if (odp_atomic_fetch_dec_u32(&zc->refs) == 1)
+		_ipc_zc_release(zc);
+	else
+		ODP_DBG("%s: remote pool in use by zero-copy packets\n", dev);
+
 	return 0;
 }
 
 static int ipc_pktio_init_global(void)
 {
+	const char *env;
+	odp_shm_t shm;
+	int i;
+
 	_ring_tailq_init();
-	ODP_PRINT("PKTIO: initialized ipc interface.\n");
+
+	shm = odp_shm_reserve("_odp_pktio_ipc_global", sizeof(ipc_global_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("shm reserve failed\n");
+		return -1;
+	}
+
+	ipc_global = odp_shm_addr(shm);
+	memset(ipc_global, 0, sizeof(ipc_global_t));
+	ipc_global->shm = shm;
+
+	for (i = 0; i < ODP_CONFIG_PKTIO_ENTRIES; i++)
+		odp_atomic_init_u32(&ipc_global->zc[i].refs, 0);
+
+	env = getenv("ODP_PKTIO_IPC_ZERO_COPY");
+	if (env && atoi(env) > 0) {
+		_odp_ipc_zero_copy = 1;
+		ODP_PRINT("PKTIO: initialized ipc interface (zero-copy).\n");
+	} else {
+		ODP_PRINT("PKTIO: initialized ipc interface,"
+			  " use export ODP_PKTIO_IPC_ZERO_COPY=1 to receive"
+			  " without copy.\n");
+	}
+	return 0;
+}
+
+static int ipc_pktio_term_global(void)
+{
+	if (odp_shm_free(ipc_global->shm)) {
+		ODP_ERR("shm free failed\n");
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -779,7 +1000,7 @@ const pktio_if_ops_t ipc_pktio_ops = {
 	.print = NULL,
 	.init_global = ipc_pktio_init_global,
 	.init_local = NULL,
-	.term = NULL,
+	.term = ipc_pktio_term_global,
 	.open = ipc_pktio_open,
 	.close = ipc_close,
 	.recv =  ipc_pktio_recv,
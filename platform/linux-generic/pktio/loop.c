@@ -80,6 +80,8 @@ static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 	odp_packet_t pkt;
 	odp_time_t ts_val;
 	odp_time_t *ts = NULL;
+	odp_pool_t new_pool[QUEUE_MULTI_MAX];
+	int cls_enabled = pktio_cls_enabled(pktio_entry);
 	int num_rx = 0;
 	int failed = 0;
 
@@ -97,46 +99,66 @@ static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 		ts = &ts_val;
 	}
 
-	for (i = 0; i < nbr; i++) {
-		uint32_t pkt_len;
-
-		pkt = packet_from_buf_hdr(hdr_tbl[i]);
-		pkt_len = odp_packet_len(pkt);
-		pkt_hdr = packet_hdr(pkt);
+	if (cls_enabled) {
+		const uint8_t *pkt_addr[QUEUE_MULTI_MAX];
+		uint32_t pkt_len[QUEUE_MULTI_MAX];
+		uint32_t seg_len[QUEUE_MULTI_MAX];
+		odp_packet_hdr_t *pkt_hdrs[QUEUE_MULTI_MAX];
+		uint8_t buf[QUEUE_MULTI_MAX][PACKET_PARSE_SEG_LEN];
 
-		packet_parse_reset(pkt_hdr);
-		if (pktio_cls_enabled(pktio_entry)) {
-			odp_packet_t new_pkt;
-			odp_pool_t new_pool;
-			uint8_t *pkt_addr;
-			uint8_t buf[PACKET_PARSE_SEG_LEN];
-			int ret;
-			uint32_t seg_len = odp_packet_seg_len(pkt);
+		for (i = 0; i < nbr; i++) {
+			pkt = packet_from_buf_hdr(hdr_tbl[i]);
+			pkt_len[i] = odp_packet_len(pkt);
+			seg_len[i] = odp_packet_seg_len(pkt);
+			pkt_hdrs[i] = packet_hdr(pkt);
 
 			/* Make sure there is enough data for the packet
 			 * parser in the case of a segmented packet. */
-			if (odp_unlikely(seg_len < PACKET_PARSE_SEG_LEN &&
-					 pkt_len > PACKET_PARSE_SEG_LEN)) {
+			if (odp_unlikely(seg_len[i] < PACKET_PARSE_SEG_LEN &&
+					 pkt_len[i] > PACKET_PARSE_SEG_LEN)) {
 				odp_packet_copy_to_mem(pkt, 0,
 						       PACKET_PARSE_SEG_LEN,
-						       buf);
-				seg_len = PACKET_PARSE_SEG_LEN;
-				pkt_addr = buf;
+						       buf[i]);
+				seg_len[i] = PACKET_PARSE_SEG_LEN;
+				pkt_addr[i] = buf[i];
 			} else {
-				pkt_addr = odp_packet_data(pkt);
+				pkt_addr[i] = odp_packet_data(pkt);
 			}
+		}
+
+		cls_classify_packet_multi(pktio_entry, pkt_addr, pkt_len,
+					  seg_len, new_pool, pkt_hdrs, NULL,
+					  nbr);
+	} else {
+		odp_packet_hdr_t *pkt_hdrs[QUEUE_MULTI_MAX];
+
+		for (i = 0; i < nbr; i++) {
+			pkt_hdrs[i] = packet_hdr(packet_from_buf_hdr(hdr_tbl[i]));
+			packet_parse_reset(pkt_hdrs[i]);
+		}
 
-			ret = cls_classify_packet(pktio_entry, pkt_addr,
-						  pkt_len, seg_len,
-						  &new_pool, pkt_hdr);
-			if (ret) {
+		packet_parse_layer_multi(pkt_hdrs, nbr,
+					 pktio_entry->s.config.parser.layer);
+	}
+
+	for (i = 0; i < nbr; i++) {
+		uint32_t pkt_len;
+
+		pkt = packet_from_buf_hdr(hdr_tbl[i]);
+		pkt_len = odp_packet_len(pkt);
+		pkt_hdr = packet_hdr(pkt);
+
+		if (cls_enabled) {
+			odp_packet_t new_pkt;
+
+			if (new_pool[i] == ODP_POOL_INVALID) {
 				failed++;
 				odp_packet_free(pkt);
 				continue;
 			}
 
-			if (new_pool != odp_packet_pool(pkt)) {
-				new_pkt = odp_packet_copy(pkt, new_pool);
+			if (new_pool[i] != odp_packet_pool(pkt)) {
+				new_pkt = odp_packet_copy(pkt, new_pool[i]);
 
 				odp_packet_free(pkt);
 
@@ -145,10 +167,8 @@ static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 					continue;
 				}
 				pkt = new_pkt;
+				pkt_hdr = packet_hdr(pkt);
 			}
-		} else {
-			packet_parse_layer(pkt_hdr,
-					   pktio_entry->s.config.parser.layer);
 		}
 
 		packet_set_ts(pkt_hdr, ts);
@@ -156,8 +176,8 @@ static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 
 		/* Try IPsec inline processing */
 		if (pktio_entry->s.config.inbound_ipsec &&
-		    !pkt_hdr->p.error_flags.ip_err &&
-		    _odp_packet_has_ipsec(pkt))
+		    _odp_packet_has_ipsec(pkt) &&
+		    !pkt_hdr->p.error_flags.ip_err)
 			_odp_ipsec_try_inline(&pkt);
 
 		pktio_entry->s.stats.in_octets += pkt_len;
@@ -218,6 +238,9 @@ static int loopback_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 		packet_subtype_set(pkt_tbl[i], ODP_EVENT_PACKET_BASIC);
 	}
 
+	if (odp_unlikely(pktio_entry->s.chksum_insert_ena))
+		_odp_pktio_chksum_insert(pktio_entry, pkt_tbl, nb_tx);
+
 	odp_ticketlock_lock(&pktio_entry->s.txl);
 
 	queue = queue_fn->from_ext(pktio_entry->s.pkt_loop.loopq);
@@ -267,6 +290,12 @@ static int loopback_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktout.bit.ipv4_chksum_ena = 1;
+	capa->config.pktout.bit.udp_chksum_ena = 1;
+	capa->config.pktout.bit.tcp_chksum_ena = 1;
+	capa->config.pktout.bit.ipv4_chksum = 1;
+	capa->config.pktout.bit.udp_chksum = 1;
+	capa->config.pktout.bit.tcp_chksum = 1;
 	capa->config.inbound_ipsec = 1;
 	capa->config.outbound_ipsec = 1;
 
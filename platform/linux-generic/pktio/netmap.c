@@ -620,7 +620,6 @@ static inline int netmap_pkt_to_odp(pktio_entry_t *pktio_entry,
 	odp_packet_t pkt;
 	odp_pool_t pool = pktio_entry->s.pkt_nm.pool;
 	odp_packet_hdr_t *pkt_hdr;
-	odp_packet_hdr_t parsed_hdr;
 	int i;
 	int num;
 	int alloc_len;
@@ -639,13 +638,6 @@ static inline int netmap_pkt_to_odp(pktio_entry_t *pktio_entry,
 
 		odp_prefetch(slot.buf);
 
-		if (pktio_cls_enabled(pktio_entry)) {
-			if (cls_classify_packet(pktio_entry,
-						(const uint8_t *)slot.buf, len,
-						len, &pool, &parsed_hdr))
-				goto fail;
-		}
-
 		pkt = pkt_tbl[i];
 		pkt_hdr = packet_hdr(pkt);
 		pull_tail(pkt_hdr, alloc_len - len);
@@ -656,13 +648,7 @@ static inline int netmap_pkt_to_odp(pktio_entry_t *pktio_entry,
 			goto fail;
 
 		pkt_hdr->input = pktio_entry->s.handle;
-
-		if (pktio_cls_enabled(pktio_entry))
-			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
-		else
-			packet_parse_layer(pkt_hdr,
-					   pktio_entry->s.config.parser.layer);
-
+		packet_parse_layer(pkt_hdr, pktio_entry->s.config.parser.layer);
 		packet_set_ts(pkt_hdr, ts);
 	}
 
@@ -673,6 +659,87 @@ fail:
 	return i;
 }
 
+/**
+ * Classify netmap packets and create ODP packets from them
+ *
+ * Packets are allocated from the pools of their destination CoSes. Slots
+ * are classified in bursts and packets of the same pool are allocated
+ * together.
+ *
+ * @param pktio_entry    Packet IO entry
+ * @param pkt_tbl        Array for new ODP packet handles
+ * @param slot_tbl       Array of netmap ring slots
+ * @param slot_num       Number of netmap ring slots
+ * @param ts             Pointer to pktin timestamp
+ *
+ * @retval Number of created packets
+ */
+static inline int netmap_pkt_to_odp_cls(pktio_entry_t *pktio_entry,
+					odp_packet_t pkt_tbl[],
+					netmap_slot_t slot_tbl[],
+					int16_t slot_num, odp_time_t *ts)
+{
+	odp_packet_hdr_t parsed_hdr[CLS_BURST_MAX];
+	odp_packet_hdr_t *parsed[CLS_BURST_MAX];
+	const uint8_t *base[CLS_BURST_MAX];
+	uint32_t len[CLS_BURST_MAX];
+	odp_pool_t pool[CLS_BURST_MAX];
+	uint16_t order[CLS_BURST_MAX];
+	odp_packet_t pkt[CLS_BURST_MAX];
+	odp_packet_hdr_t *pkt_hdr;
+	int alloc_len = pktio_entry->s.pkt_nm.mtu;
+	int first, num, num_cls, run, num_alloc, i, j, idx;
+	int num_rx = 0;
+
+	for (i = 0; i < CLS_BURST_MAX; i++)
+		parsed[i] = &parsed_hdr[i];
+
+	for (first = 0; first < slot_num; first += num) {
+		num = slot_num - first;
+		if (num > CLS_BURST_MAX)
+			num = CLS_BURST_MAX;
+
+		for (i = 0; i < num; i++) {
+			base[i] = (const uint8_t *)slot_tbl[first + i].buf;
+			len[i] = slot_tbl[first + i].len;
+		}
+
+		num_cls = cls_classify_packet_multi(pktio_entry, base, len,
+						    len, pool, parsed, order,
+						    num);
+
+		for (i = 0; i < num_cls; i += run) {
+			for (run = 1; i + run < num_cls; run++)
+				if (pool[order[i + run]] != pool[order[i]])
+					break;
+
+			num_alloc = packet_alloc_multi(pool[order[i]],
+						       alloc_len, pkt, run);
+
+			for (j = 0; j < num_alloc; j++) {
+				idx = order[i + j];
+				pkt_hdr = packet_hdr(pkt[j]);
+				pull_tail(pkt_hdr, alloc_len - len[idx]);
+
+				if (_odp_packet_copy_from_mem(pkt[j], 0,
+							      len[idx],
+							      base[idx])) {
+					odp_packet_free(pkt[j]);
+					continue;
+				}
+
+				pkt_hdr->input = pktio_entry->s.handle;
+				copy_packet_cls_metadata(&parsed_hdr[idx],
+							 pkt_hdr);
+				packet_set_ts(pkt_hdr, ts);
+				pkt_tbl[num_rx++] = pkt[j];
+			}
+		}
+	}
+
+	return num_rx;
+}
+
 static inline int netmap_recv_desc(pktio_entry_t *pktio_entry,
 				   struct nm_desc *desc,
 				   odp_packet_t pkt_table[], int num)
@@ -719,6 +786,9 @@ static inline int netmap_recv_desc(pktio_entry_t *pktio_entry,
 	if (num_rx) {
 		if (ts != NULL)
 			ts_val = odp_time_global();
+		if (pktio_cls_enabled(pktio_entry))
+			return netmap_pkt_to_odp_cls(pktio_entry, pkt_table,
+						     slot_tbl, num_rx, ts);
 		return netmap_pkt_to_odp(pktio_entry, pkt_table, slot_tbl,
 					 num_rx, ts);
 	}
@@ -610,6 +610,11 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 	const int sockfd = pkt_sock->sockfd;
 	struct mmsghdr msgvec[num];
 	struct iovec iovecs[num][MAX_SEGS];
+	const uint8_t *base_tbl[num];
+	uint32_t len_tbl[num];
+	uint32_t seg_len_tbl[num];
+	odp_pool_t pool_tbl[num];
+	odp_packet_hdr_t *hdr_tbl[num];
 	int nb_rx = 0;
 	int nb_pkts;
 	int recv_msgs;
@@ -639,7 +644,6 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 		void *base = msgvec[i].msg_hdr.msg_iov->iov_base;
 		struct ethhdr *eth_hdr = base;
 		odp_packet_t pkt = pkt_table[i];
-		odp_packet_hdr_t *pkt_hdr = packet_hdr(pkt);
 		uint16_t pkt_len = msgvec[i].msg_len;
 		int ret;
 
@@ -648,19 +652,6 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			ODP_DBG("dropped truncated packet\n");
 			continue;
 		}
-		if (pktio_cls_enabled(pktio_entry)) {
-			uint16_t seg_len =  pkt_len;
-
-			if (msgvec[i].msg_hdr.msg_iov->iov_len < pkt_len)
-				seg_len = msgvec[i].msg_hdr.msg_iov->iov_len;
-
-			if (cls_classify_packet(pktio_entry, base, pkt_len,
-						seg_len, &pool, pkt_hdr)) {
-				ODP_ERR("cls_classify_packet failed");
-				odp_packet_free(pkt);
-				continue;
-			}
-		}
 
 		/* Don't receive packets sent by ourselves */
 		if (odp_unlikely(ethaddrs_equal(pkt_sock->if_mac,
@@ -677,15 +668,12 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			continue;
 		}
 
-		pkt_hdr->input = pktio_entry->s.handle;
-
-		if (!pktio_cls_enabled(pktio_entry))
-			packet_parse_layer(pkt_hdr,
-					   pktio_entry->s.config.parser.layer);
-
-		pkt_hdr->input = pktio_entry->s.handle;
-		packet_set_ts(pkt_hdr, ts);
-
+		base_tbl[nb_rx] = base;
+		len_tbl[nb_rx] = pkt_len;
+		seg_len_tbl[nb_rx] = pkt_len;
+		if (msgvec[i].msg_hdr.msg_iov->iov_len < pkt_len)
+			seg_len_tbl[nb_rx] = msgvec[i].msg_hdr.msg_iov->iov_len;
+		hdr_tbl[nb_rx] = packet_hdr(pkt);
 		pkt_table[nb_rx++] = pkt;
 	}
 
@@ -693,6 +681,31 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 	for (; i < nb_pkts; i++)
 		odp_packet_free(pkt_table[i]);
 
+	if (pktio_cls_enabled(pktio_entry)) {
+		cls_classify_packet_multi(pktio_entry, base_tbl, len_tbl,
+					  seg_len_tbl, pool_tbl, hdr_tbl, NULL,
+					  nb_rx);
+		num = nb_rx;
+		nb_rx = 0;
+		for (i = 0; i < num; i++) {
+			if (odp_unlikely(pool_tbl[i] == ODP_POOL_INVALID)) {
+				ODP_ERR("cls_classify_packet failed");
+				odp_packet_free(pkt_table[i]);
+				continue;
+			}
+			hdr_tbl[nb_rx] = hdr_tbl[i];
+			pkt_table[nb_rx++] = pkt_table[i];
+		}
+	} else {
+		packet_parse_layer_multi(hdr_tbl, nb_rx,
+					 pktio_entry->s.config.parser.layer);
+	}
+
+	for (i = 0; i < nb_rx; i++) {
+		hdr_tbl[i]->input = pktio_entry->s.handle;
+		packet_set_ts(hdr_tbl[i], ts);
+	}
+
 	odp_ticketlock_unlock(&pktio_entry->s.rxl);
 
 	return nb_rx;
@@ -813,6 +826,9 @@ static int sock_mmsg_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 	int sockfd;
 	int n, i;
 
+	if (odp_unlikely(pktio_entry->s.chksum_insert_ena))
+		_odp_pktio_chksum_insert(pktio_entry, pkt_table, num);
+
 	odp_ticketlock_lock(&pktio_entry->s.txl);
 
 	sockfd = pkt_sock->sockfd;
@@ -902,6 +918,12 @@ static int sock_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktout.bit.ipv4_chksum_ena = 1;
+	capa->config.pktout.bit.udp_chksum_ena = 1;
+	capa->config.pktout.bit.tcp_chksum_ena = 1;
+	capa->config.pktout.bit.ipv4_chksum = 1;
+	capa->config.pktout.bit.udp_chksum = 1;
+	capa->config.pktout.bit.tcp_chksum = 1;
 	return 0;
 }
 
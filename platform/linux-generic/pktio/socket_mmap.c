@@ -48,18 +48,39 @@
 /* Maximum number of packets to store in each RX/TX block */
 #define MAX_PKTS_PER_BLOCK 512
 
+/* Number of blocks in a TPACKET_V3 RX ring. Blocks are divided between RX
+ * queues of an interface. */
+#define RX_V3_BLOCKS 4
+
+/* Minimum number of blocks in a TPACKET_V3 RX queue ring. Kernel fills one
+ * block while user reads another. */
+#define RX_V3_BLOCKS_MIN 2
+
+/* Timeout in msec after which kernel passes a partially filled TPACKET_V3
+ * block to user space */
+#define RX_V3_BLOCK_TMO_MS 1
+
+ODP_STATIC_ASSERT(PKT_MMAP_MAX_QUEUES <= PKTIO_MAX_QUEUES,
+		  "PKT_MMAP_MAX_QUEUES_TOO_LARGE");
+
 static int disable_pktio; /** !0 this pktio disabled, 0 enabled */
 
-static int set_pkt_sock_fanout_mmap(pkt_sock_mmap_t *const pkt_sock,
+/* Default fanout mode which distributes packets to RX queues */
+static int fanout_mode = PACKET_FANOUT_HASH;
+
+/* RX ring version. TPACKET_V3 blocks reduce per packet overhead, but add up
+ * to RX_V3_BLOCK_TMO_MS latency when traffic rate is low. */
+static int rx_version = TPACKET_V2;
+
+static int set_pkt_sock_fanout_mmap(int sockfd, int mode,
 				    int sock_group_idx)
 {
-	int sockfd = pkt_sock->sockfd;
 	int val;
 	int err;
 	uint16_t fanout_group;
 
 	fanout_group = (uint16_t)(sock_group_idx & 0xffff);
-	val = (PACKET_FANOUT_HASH << 16) | fanout_group;
+	val = (mode << 16) | fanout_group;
 
 	err = setsockopt(sockfd, SOL_PACKET, PACKET_FANOUT, &val, sizeof(val));
 	if (err != 0) {
@@ -81,11 +102,9 @@ union frame_map {
 	void *raw;
 };
 
-static int mmap_pkt_socket(void)
+static int mmap_pkt_socket(int ver, uint16_t protocol)
 {
-	int ver = TPACKET_V2;
-
-	int ret, sock = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	int ret, sock = socket(PF_PACKET, SOCK_RAW, protocol);
 
 	if (sock == -1) {
 		__odp_errno = errno;
@@ -96,7 +115,10 @@ static int mmap_pkt_socket(void)
 	ret = setsockopt(sock, SOL_PACKET, PACKET_VERSION, &ver, sizeof(ver));
 	if (ret == -1) {
 		__odp_errno = errno;
-		ODP_ERR("setsockopt(PACKET_VERSION): %s\n", strerror(errno));
+		/* Caller falls back to TPACKET_V2 */
+		if (ver != TPACKET_V3)
+			ODP_ERR("setsockopt(PACKET_VERSION): %s\n",
+				strerror(errno));
 		close(sock);
 		return -1;
 	}
@@ -162,113 +184,247 @@ static inline unsigned next_frame(unsigned cur_frame, unsigned frame_count)
 	return odp_unlikely(cur_frame + 1 >= frame_count) ? 0 : cur_frame + 1;
 }
 
+/* Received frames which are not yet copied into packets. Frames stay owned
+ * by the application until the batch has been flushed. */
+typedef struct {
+	const uint8_t *buf[CLS_BURST_MAX];
+	uint32_t len[CLS_BURST_MAX];
+	odp_time_t ts;
+	int num;
+} mmap_rx_batch_t;
+
+/* Add a received frame into a batch, or drop it */
+static inline void mmap_rx_frame(pkt_sock_mmap_t *pkt_sock,
+				 mmap_rx_batch_t *batch, uint8_t *pkt_buf,
+				 int pkt_len, uint16_t mac_offset,
+				 int vlan_valid, uint16_t vlan_tci,
+				 uint8_t pkttype, odp_time_t *ts)
+{
+	struct ethhdr *eth_hdr;
+
+	if (odp_unlikely(pkt_len > pkt_sock->mtu)) {
+		ODP_DBG("dropped oversized packet\n");
+		return;
+	}
+
+	/* Don't receive packets sent through the interface, or sent by
+	 * ourselves and looped back */
+	if (odp_unlikely(pkttype == PACKET_OUTGOING))
+		return;
+
+	eth_hdr = (struct ethhdr *)pkt_buf;
+	if (odp_unlikely(ethaddrs_equal(pkt_sock->if_mac, eth_hdr->h_source)))
+		return;
+
+	if (vlan_valid)
+		pkt_buf = pkt_mmap_vlan_insert(pkt_buf, mac_offset, vlan_tci,
+					       &pkt_len);
+
+	if (ts != NULL && batch->num == 0)
+		batch->ts = odp_time_global();
+
+	batch->buf[batch->num] = pkt_buf;
+	batch->len[batch->num] = pkt_len;
+	batch->num++;
+}
+
+/* Copy frames of a batch into new packets. Returns number of packets stored
+ * into 'pkt_table'. */
+static inline unsigned mmap_rx_flush(pktio_entry_t *pktio_entry,
+				     pkt_sock_mmap_t *pkt_sock,
+				     mmap_rx_batch_t *batch, odp_time_t *ts,
+				     odp_packet_t pkt_table[])
+{
+	odp_packet_hdr_t parsed_hdr[CLS_BURST_MAX];
+	odp_packet_hdr_t *parsed[CLS_BURST_MAX];
+	odp_packet_hdr_t *hdr_tbl[CLS_BURST_MAX];
+	odp_pool_t pool[CLS_BURST_MAX];
+	uint16_t order[CLS_BURST_MAX];
+	odp_packet_hdr_t *hdr;
+	odp_packet_t pkt;
+	int cls_enabled = pktio_cls_enabled(pktio_entry);
+	int num = batch->num;
+	int i, idx;
+	unsigned nb_rx = 0;
+
+	if (num == 0)
+		return 0;
+
+	batch->num = 0;
+
+	if (cls_enabled) {
+		for (i = 0; i < num; i++)
+			parsed[i] = &parsed_hdr[i];
+
+		num = cls_classify_packet_multi(pktio_entry, batch->buf,
+						batch->len, batch->len, pool,
+						parsed, order, num);
+	} else {
+		for (i = 0; i < num; i++) {
+			pool[i] = pkt_sock->pool;
+			order[i] = i;
+		}
+	}
+
+	if (ts != NULL)
+		*ts = batch->ts;
+
+	for (i = 0; i < num; i++) {
+		idx = order[i];
+
+		if (odp_unlikely(packet_alloc_multi(pool[idx], batch->len[idx],
+						    &pkt, 1) != 1))
+			continue;
+
+		hdr = packet_hdr(pkt);
+		if (_odp_packet_copy_from_mem(pkt, 0, batch->len[idx],
+					      batch->buf[idx]) != 0) {
+			odp_packet_free(pkt);
+			continue;
+		}
+		hdr->input = pktio_entry->s.handle;
+
+		if (cls_enabled)
+			copy_packet_cls_metadata(&parsed_hdr[idx], hdr);
+
+		packet_set_ts(hdr, ts);
+		hdr_tbl[nb_rx] = hdr;
+		pkt_table[nb_rx++] = pkt;
+	}
+
+	if (!cls_enabled)
+		packet_parse_layer_multi(hdr_tbl, nb_rx,
+					 pktio_entry->s.config.parser.layer);
+
+	return nb_rx;
+}
+
 static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 				      pkt_sock_mmap_t *pkt_sock,
-				      odp_packet_t pkt_table[], unsigned num,
-				      unsigned char if_mac[])
+				      struct ring *ring,
+				      odp_packet_t pkt_table[], unsigned num)
 {
 	union frame_map ppd;
+	mmap_rx_batch_t batch;
+	struct tpacket2_hdr *frame[CLS_BURST_MAX];
 	odp_time_t ts_val;
 	odp_time_t *ts = NULL;
-	unsigned frame_num, next_frame_num;
-	uint8_t *pkt_buf;
-	int pkt_len;
-	struct ethhdr *eth_hdr;
-	unsigned i;
-	unsigned nb_rx;
-	struct ring *ring;
-	int ret;
+	unsigned frame_num;
+	unsigned i, j;
+	unsigned nb_frame = 0;
+	unsigned nb_rx = 0;
 
 	if (pktio_entry->s.config.pktin.bit.ts_all ||
 	    pktio_entry->s.config.pktin.bit.ts_ptp)
 		ts = &ts_val;
 
-	ring  = &pkt_sock->rx_ring;
+	batch.num = 0;
 	frame_num = ring->frame_num;
 
-	for (i = 0, nb_rx = 0; i < num; i++) {
-		odp_packet_hdr_t *hdr;
-		odp_packet_hdr_t parsed_hdr;
-		odp_pool_t pool = pkt_sock->pool;
-		int pkts;
+	for (i = 0; i < num; i++) {
+		ppd.raw = ring->rd[frame_num].iov_base;
 
-		if (!mmap_rx_kernel_ready(ring->rd[frame_num].iov_base))
+		if (!mmap_rx_kernel_ready(ppd.raw))
 			break;
 
-		if (ts != NULL)
-			ts_val = odp_time_global();
+		mmap_rx_frame(pkt_sock, &batch,
+			      (uint8_t *)ppd.raw + ppd.v2->tp_h.tp_mac,
+			      ppd.v2->tp_h.tp_snaplen,
+			      ppd.v2->tp_h.tp_mac,
+			      ppd.v2->tp_h.tp_status & TP_STATUS_VLAN_VALID,
+			      ppd.v2->tp_h.tp_vlan_tci,
+			      ppd.v2->s_ll.sll_pkttype, ts);
+
+		frame[nb_frame++] = ppd.raw;
+		frame_num = next_frame(frame_num, ring->rd_num);
+
+		if (nb_frame == CLS_BURST_MAX) {
+			nb_rx += mmap_rx_flush(pktio_entry, pkt_sock, &batch,
+					       ts, &pkt_table[nb_rx]);
+			for (j = 0; j < nb_frame; j++)
+				mmap_rx_user_ready(frame[j]);
+			nb_frame = 0;
+		}
+	}
 
-		ppd.raw = ring->rd[frame_num].iov_base;
-		next_frame_num = next_frame(frame_num, ring->rd_num);
+	nb_rx += mmap_rx_flush(pktio_entry, pkt_sock, &batch, ts,
+			       &pkt_table[nb_rx]);
+	for (j = 0; j < nb_frame; j++)
+		mmap_rx_user_ready(frame[j]);
 
-		pkt_buf = (uint8_t *)ppd.raw + ppd.v2->tp_h.tp_mac;
-		pkt_len = ppd.v2->tp_h.tp_snaplen;
+	ring->frame_num = frame_num;
+	return nb_rx;
+}
 
-		if (odp_unlikely(pkt_len > pkt_sock->mtu)) {
-			mmap_rx_user_ready(ppd.raw);
-			frame_num = next_frame_num;
-			ODP_DBG("dropped oversized packet\n");
-			continue;
-		}
+/* TPACKET_V3 ring consists of blocks of variable size frames. A block is
+ * returned to kernel after its last frame has been read. */
+static inline unsigned pkt_mmap_v3_rx(pktio_entry_t *pktio_entry,
+				      pkt_sock_mmap_t *pkt_sock,
+				      struct ring *ring,
+				      odp_packet_t pkt_table[], unsigned num)
+{
+	struct tpacket_block_desc *bd;
+	struct tpacket3_hdr *tp_hdr;
+	struct sockaddr_ll *s_ll;
+	mmap_rx_batch_t batch;
+	odp_time_t ts_val;
+	odp_time_t *ts = NULL;
+	unsigned block_num;
+	unsigned i;
+	unsigned nb_rx = 0;
 
-		/* Don't receive packets sent by ourselves */
-		eth_hdr = (struct ethhdr *)pkt_buf;
-		if (odp_unlikely(ethaddrs_equal(if_mac,
-						eth_hdr->h_source))) {
-			mmap_rx_user_ready(ppd.raw); /* drop */
-			frame_num = next_frame_num;
-			continue;
-		}
+	if (pktio_entry->s.config.pktin.bit.ts_all ||
+	    pktio_entry->s.config.pktin.bit.ts_ptp)
+		ts = &ts_val;
 
-		if (ppd.v2->tp_h.tp_status & TP_STATUS_VLAN_VALID)
-			pkt_buf = pkt_mmap_vlan_insert(pkt_buf,
-						       ppd.v2->tp_h.tp_mac,
-						       ppd.v2->tp_h.tp_vlan_tci,
-						       &pkt_len);
-
-		if (pktio_cls_enabled(pktio_entry)) {
-			if (cls_classify_packet(pktio_entry, pkt_buf, pkt_len,
-						pkt_len, &pool, &parsed_hdr)) {
-				mmap_rx_user_ready(ppd.raw); /* drop */
-				frame_num = next_frame_num;
-				continue;
-			}
-		}
+	batch.num = 0;
+	block_num = ring->frame_num;
+	bd = ring->rd[block_num].iov_base;
 
-		pkts = packet_alloc_multi(pool, pkt_len, &pkt_table[nb_rx], 1);
+	for (i = 0; i < num; i++) {
+		if (ring->block_pkts == 0) {
+			if (!(bd->hdr.bh1.block_status & TP_STATUS_USER))
+				break;
 
-		if (odp_unlikely(pkts != 1)) {
-			pkt_table[nb_rx] = ODP_PACKET_INVALID;
-			mmap_rx_user_ready(ppd.raw); /* drop */
-			frame_num = next_frame_num;
-			continue;
-		}
-		hdr = packet_hdr(pkt_table[nb_rx]);
-		ret = _odp_packet_copy_from_mem(pkt_table[nb_rx], 0,
-						pkt_len, pkt_buf);
-		if (ret != 0) {
-			odp_packet_free(pkt_table[nb_rx]);
-			mmap_rx_user_ready(ppd.raw); /* drop */
-			frame_num = next_frame_num;
-			continue;
+			/* Read block contents after the status */
+			__sync_synchronize();
+			ring->block_pkts = bd->hdr.bh1.num_pkts;
+			ring->next_pkt = (uint8_t *)bd +
+					 bd->hdr.bh1.offset_to_first_pkt;
 		}
-		hdr->input = pktio_entry->s.handle;
-
-		if (pktio_cls_enabled(pktio_entry))
-			copy_packet_cls_metadata(&parsed_hdr, hdr);
-		else
-			packet_parse_layer(hdr,
-					   pktio_entry->s.config.parser.layer);
 
-		packet_set_ts(hdr, ts);
+		if (odp_likely(ring->block_pkts)) {
+			tp_hdr = (struct tpacket3_hdr *)ring->next_pkt;
+			ring->next_pkt += tp_hdr->tp_next_offset;
+			ring->block_pkts--;
+			s_ll = (struct sockaddr_ll *)((uint8_t *)tp_hdr +
+				TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+
+			mmap_rx_frame(pkt_sock, &batch,
+				      (uint8_t *)tp_hdr + tp_hdr->tp_mac,
+				      tp_hdr->tp_snaplen, tp_hdr->tp_mac,
+				      tp_hdr->tp_status & TP_STATUS_VLAN_VALID,
+				      tp_hdr->hv1.tp_vlan_tci,
+				      s_ll->sll_pkttype, ts);
+		}
 
-		mmap_rx_user_ready(ppd.raw);
-		frame_num = next_frame_num;
+		/* Frames must be copied before their block is returned */
+		if (ring->block_pkts == 0 || batch.num == CLS_BURST_MAX)
+			nb_rx += mmap_rx_flush(pktio_entry, pkt_sock, &batch,
+					       ts, &pkt_table[nb_rx]);
 
-		nb_rx++;
+		if (ring->block_pkts == 0) {
+			bd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+			__sync_synchronize();
+			block_num = next_frame(block_num, ring->rd_num);
+			bd = ring->rd[block_num].iov_base;
+		}
 	}
 
-	ring->frame_num = frame_num;
+	nb_rx += mmap_rx_flush(pktio_entry, pkt_sock, &batch, ts,
+			       &pkt_table[nb_rx]);
+
+	ring->frame_num = block_num;
 	return nb_rx;
 }
 
@@ -386,7 +542,8 @@ static inline unsigned pkt_mmap_v2_tx(int sock, struct ring *ring,
 	return nb_tx;
 }
 
-static void mmap_fill_ring(struct ring *ring, odp_pool_t pool_hdl, int fanout)
+static void mmap_fill_ring(struct ring *ring, odp_pool_t pool_hdl,
+			   unsigned num_blocks)
 {
 	uint32_t num_frames;
 	int pz = getpagesize();
@@ -410,35 +567,41 @@ static void mmap_fill_ring(struct ring *ring, odp_pool_t pool_hdl, int fanout)
 	ring->req.tp_block_size = (ring->req.tp_frame_size * num_frames +
 				   (pz - 1)) & (-pz);
 
-	if (!fanout) {
-		/* Single socket is in use. Use 1 block with buf_num frames. */
-		ring->req.tp_block_nr = 1;
-	} else {
-		/* Fanout is in use, more likely taffic split accodring to
-		 * number of cpu threads. Use cpu blocks and buf_num frames. */
-		ring->req.tp_block_nr = odp_cpu_count();
-	}
+	ring->req.tp_block_nr = num_blocks;
 
 	ring->req.tp_frame_nr = ring->req.tp_block_size /
 				ring->req.tp_frame_size * ring->req.tp_block_nr;
 
 	ring->mm_len = ring->req.tp_block_size * ring->req.tp_block_nr;
-	ring->rd_num = ring->req.tp_frame_nr;
-	ring->flen = ring->req.tp_frame_size;
+
+	if (ring->version == TPACKET_V3) {
+		/* Frame size is only an upper limit. Ring is read one block
+		 * at a time. */
+		ring->req3.tp_retire_blk_tov = RX_V3_BLOCK_TMO_MS;
+		ring->req3.tp_sizeof_priv = 0;
+		ring->req3.tp_feature_req_word = 0;
+		ring->rd_num = ring->req.tp_block_nr;
+		ring->flen = ring->req.tp_block_size;
+	} else {
+		ring->rd_num = ring->req.tp_frame_nr;
+		ring->flen = ring->req.tp_frame_size;
+	}
 }
 
 static int mmap_setup_ring(int sock, struct ring *ring, int type,
-			   odp_pool_t pool_hdl, int fanout)
+			   odp_pool_t pool_hdl, unsigned num_blocks, int ver)
 {
 	int ret = 0;
+	socklen_t len;
 
 	ring->sock = sock;
 	ring->type = type;
-	ring->version = TPACKET_V2;
+	ring->version = ver;
 
-	mmap_fill_ring(ring, pool_hdl, fanout);
+	mmap_fill_ring(ring, pool_hdl, num_blocks);
 
-	ret = setsockopt(sock, SOL_PACKET, type, &ring->req, sizeof(ring->req));
+	len = ver == TPACKET_V3 ? sizeof(ring->req3) : sizeof(ring->req);
+	ret = setsockopt(sock, SOL_PACKET, type, &ring->req, len);
 	if (ret == -1) {
 		__odp_errno = errno;
 		ODP_ERR("setsockopt(pkt mmap): %s\n", strerror(errno));
@@ -456,70 +619,44 @@ static int mmap_setup_ring(int sock, struct ring *ring, int type,
 	return 0;
 }
 
-static int mmap_sock(pkt_sock_mmap_t *pkt_sock)
+static int mmap_ring(struct ring *ring)
 {
 	int i;
-	int sock = pkt_sock->sockfd;
+	uint8_t *mm_space;
 
-	/* map rx + tx buffer to userspace : they are in this order */
-	pkt_sock->mmap_len =
-		pkt_sock->rx_ring.req.tp_block_size *
-		pkt_sock->rx_ring.req.tp_block_nr +
-		pkt_sock->tx_ring.req.tp_block_size *
-		pkt_sock->tx_ring.req.tp_block_nr;
+	mm_space = mmap(NULL, ring->mm_len, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_LOCKED | MAP_POPULATE, ring->sock, 0);
 
-	pkt_sock->mmap_base =
-		mmap(NULL, pkt_sock->mmap_len, PROT_READ | PROT_WRITE,
-		     MAP_SHARED | MAP_LOCKED | MAP_POPULATE, sock, 0);
-
-	if (pkt_sock->mmap_base == MAP_FAILED) {
+	if (mm_space == MAP_FAILED) {
 		__odp_errno = errno;
-		ODP_ERR("mmap rx&tx buffer failed: %s\n", strerror(errno));
+		ODP_ERR("mmap ring failed: %s\n", strerror(errno));
 		return -1;
 	}
 
-	pkt_sock->rx_ring.mm_space = pkt_sock->mmap_base;
-	memset(pkt_sock->rx_ring.rd, 0, pkt_sock->rx_ring.rd_len);
-	for (i = 0; i < pkt_sock->rx_ring.rd_num; ++i) {
-		pkt_sock->rx_ring.rd[i].iov_base =
-			pkt_sock->rx_ring.mm_space
-			+ (i * pkt_sock->rx_ring.flen);
-		pkt_sock->rx_ring.rd[i].iov_len = pkt_sock->rx_ring.flen;
+	ring->mm_space = mm_space;
+	memset(ring->rd, 0, ring->rd_len);
+	for (i = 0; i < ring->rd_num; ++i) {
+		ring->rd[i].iov_base = ring->mm_space + (i * ring->flen);
+		ring->rd[i].iov_len = ring->flen;
 	}
 
-	pkt_sock->tx_ring.mm_space =
-		pkt_sock->mmap_base + pkt_sock->rx_ring.mm_len;
-	memset(pkt_sock->tx_ring.rd, 0, pkt_sock->tx_ring.rd_len);
-	for (i = 0; i < pkt_sock->tx_ring.rd_num; ++i) {
-		pkt_sock->tx_ring.rd[i].iov_base =
-			pkt_sock->tx_ring.mm_space
-			+ (i * pkt_sock->tx_ring.flen);
-		pkt_sock->tx_ring.rd[i].iov_len = pkt_sock->tx_ring.flen;
-	}
+	ring->frame_num  = 0;
+	ring->block_pkts = 0;
 
 	return 0;
 }
 
-static int mmap_unmap_sock(pkt_sock_mmap_t *pkt_sock)
-{
-	free(pkt_sock->rx_ring.rd);
-	free(pkt_sock->tx_ring.rd);
-	return munmap(pkt_sock->mmap_base, pkt_sock->mmap_len);
-}
-
-static int mmap_bind_sock(pkt_sock_mmap_t *pkt_sock, const char *netdev)
+static int mmap_bind_sock(int sockfd, int if_idx, uint16_t protocol)
 {
+	struct sockaddr_ll ll;
 	int ret;
 
-	pkt_sock->ll.sll_family = PF_PACKET;
-	pkt_sock->ll.sll_protocol = htons(ETH_P_ALL);
-	pkt_sock->ll.sll_ifindex = if_nametoindex(netdev);
-	pkt_sock->ll.sll_hatype = 0;
-	pkt_sock->ll.sll_pkttype = 0;
-	pkt_sock->ll.sll_halen = 0;
+	memset(&ll, 0, sizeof(ll));
+	ll.sll_family = PF_PACKET;
+	ll.sll_protocol = protocol;
+	ll.sll_ifindex = if_idx;
 
-	ret = bind(pkt_sock->sockfd, (struct sockaddr *)&pkt_sock->ll,
-		   sizeof(pkt_sock->ll));
+	ret = bind(sockfd, (struct sockaddr *)&ll, sizeof(ll));
 	if (ret == -1) {
 		__odp_errno = errno;
 		ODP_ERR("bind(to IF): %s\n", strerror(errno));
@@ -529,44 +666,188 @@ static int mmap_bind_sock(pkt_sock_mmap_t *pkt_sock, const char *netdev)
 	return 0;
 }
 
+static int mmap_queue_close(pkt_mmap_queue_t *queue)
+{
+	int ret = 0;
+
+	free(queue->ring.rd);
+	queue->ring.rd = NULL;
+
+	if (queue->ring.mm_space != NULL &&
+	    munmap(queue->ring.mm_space, queue->ring.mm_len) != 0) {
+		__odp_errno = errno;
+		ODP_ERR("munmap(): %s\n", strerror(errno));
+		ret = -1;
+	}
+	queue->ring.mm_space = NULL;
+
+	if (queue->sockfd != -1 && close(queue->sockfd) != 0) {
+		__odp_errno = errno;
+		ODP_ERR("close(sockfd): %s\n", strerror(errno));
+		ret = -1;
+	}
+	queue->sockfd = -1;
+
+	return ret;
+}
+
+/* Rings are locked into memory. Queues of an interface share the blocks of
+ * a single queue ring, so that locked memory does not grow with the number
+ * of queues. */
+static unsigned queue_num_blocks(unsigned num_blocks, unsigned num_queues,
+				 unsigned min_blocks)
+{
+	num_blocks /= num_queues;
+
+	return num_blocks < min_blocks ? min_blocks : num_blocks;
+}
+
+/* RX queue socket joins the fanout group of the interface. TPACKET_V2 is
+ * used when kernel does not support TPACKET_V3. */
+static int mmap_rx_queue_open(pkt_sock_mmap_t *pkt_sock,
+			      pkt_mmap_queue_t *queue, unsigned num_queues)
+{
+	int ver = TPACKET_V3;
+	unsigned num_blocks;
+
+	num_blocks = queue_num_blocks(RX_V3_BLOCKS, num_queues,
+				      RX_V3_BLOCKS_MIN);
+
+	queue->sockfd = -1;
+	if (rx_version == TPACKET_V3)
+		queue->sockfd = mmap_pkt_socket(TPACKET_V3, htons(ETH_P_ALL));
+
+	if (queue->sockfd == -1) {
+		ver = TPACKET_V2;
+		num_blocks = queue_num_blocks(odp_cpu_count(), num_queues, 1);
+		queue->sockfd = mmap_pkt_socket(TPACKET_V2, htons(ETH_P_ALL));
+		if (queue->sockfd == -1)
+			return -1;
+	}
+
+	if (mmap_bind_sock(queue->sockfd, pkt_sock->if_idx, htons(ETH_P_ALL)))
+		return -1;
+
+	if (mmap_setup_ring(queue->sockfd, &queue->ring, PACKET_RX_RING,
+			    pkt_sock->pool, num_blocks, ver))
+		return -1;
+
+	if (mmap_ring(&queue->ring))
+		return -1;
+
+	return set_pkt_sock_fanout_mmap(queue->sockfd, pkt_sock->fanout_mode,
+					pkt_sock->if_idx);
+}
+
+/* TX queue socket does not receive packets (protocol zero) and bypasses
+ * the qdisc layer */
+static int mmap_tx_queue_open(pkt_sock_mmap_t *pkt_sock,
+			      pkt_mmap_queue_t *queue, unsigned num_queues)
+{
+	unsigned num_blocks = queue_num_blocks(odp_cpu_count(), num_queues, 1);
+	int val = 1;
+
+	queue->sockfd = mmap_pkt_socket(TPACKET_V2, 0);
+	if (queue->sockfd == -1)
+		return -1;
+
+	if (setsockopt(queue->sockfd, SOL_PACKET, PACKET_QDISC_BYPASS,
+		       &val, sizeof(val)))
+		ODP_DBG("setsockopt(PACKET_QDISC_BYPASS): %s\n",
+			strerror(errno));
+
+	if (mmap_bind_sock(queue->sockfd, pkt_sock->if_idx, 0))
+		return -1;
+
+	if (mmap_setup_ring(queue->sockfd, &queue->ring, PACKET_TX_RING,
+			    pkt_sock->pool, num_blocks, TPACKET_V2))
+		return -1;
+
+	return mmap_ring(&queue->ring);
+}
+
+static int mmap_rx_queues_open(pkt_sock_mmap_t *pkt_sock, unsigned num)
+{
+	unsigned i;
+	int ret = 0;
+
+	for (i = 0; i < pkt_sock->num_rx_queues; i++)
+		ret |= mmap_queue_close(&pkt_sock->rx_queue[i]);
+
+	pkt_sock->num_rx_queues = num;
+
+	for (i = 0; i < num; i++)
+		ret |= mmap_rx_queue_open(pkt_sock, &pkt_sock->rx_queue[i],
+					  num);
+
+	return ret;
+}
+
+static int mmap_tx_queues_open(pkt_sock_mmap_t *pkt_sock, unsigned num)
+{
+	unsigned i;
+	int ret = 0;
+
+	for (i = 0; i < pkt_sock->num_tx_queues; i++)
+		ret |= mmap_queue_close(&pkt_sock->tx_queue[i]);
+
+	pkt_sock->num_tx_queues = num;
+
+	for (i = 0; i < num; i++)
+		ret |= mmap_tx_queue_open(pkt_sock, &pkt_sock->tx_queue[i],
+					  num);
+
+	return ret;
+}
+
 static int sock_mmap_close(pktio_entry_t *entry)
 {
 	pkt_sock_mmap_t *const pkt_sock = &entry->s.pkt_sock_mmap;
-	int ret;
+	unsigned i;
+	int ret = 0;
 
-	ret = mmap_unmap_sock(pkt_sock);
-	if (ret != 0) {
-		ODP_ERR("mmap_unmap_sock() %s\n", strerror(errno));
-		return -1;
-	}
+	for (i = 0; i < pkt_sock->num_rx_queues; i++)
+		ret |= mmap_queue_close(&pkt_sock->rx_queue[i]);
+
+	for (i = 0; i < pkt_sock->num_tx_queues; i++)
+		ret |= mmap_queue_close(&pkt_sock->tx_queue[i]);
+
+	pkt_sock->num_rx_queues = 0;
+	pkt_sock->num_tx_queues = 0;
 
 	if (pkt_sock->sockfd != -1 && close(pkt_sock->sockfd) != 0) {
 		__odp_errno = errno;
 		ODP_ERR("close(sockfd): %s\n", strerror(errno));
-		return -1;
+		ret = -1;
 	}
+	pkt_sock->sockfd = -1;
 
-	return 0;
+	return ret ? -1 : 0;
 }
 
 static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 			  pktio_entry_t *pktio_entry,
 			  const char *netdev, odp_pool_t pool)
 {
-	int if_idx;
 	int ret = 0;
+	int i;
 	odp_pktio_stats_t cur_stats;
 
 	if (disable_pktio)
 		return -1;
 
 	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
-	int fanout = 1;
 
 	/* Init pktio entry */
 	memset(pkt_sock, 0, sizeof(*pkt_sock));
 	/* set sockfd to -1, because a valid socked might be initialized to 0 */
 	pkt_sock->sockfd = -1;
+	for (i = 0; i < PKT_MMAP_MAX_QUEUES; i++) {
+		pkt_sock->rx_queue[i].sockfd = -1;
+		pkt_sock->tx_queue[i].sockfd = -1;
+		odp_ticketlock_init(&pkt_sock->rx_queue[i].lock);
+		odp_ticketlock_init(&pkt_sock->tx_queue[i].lock);
+	}
 
 	if (pool == ODP_POOL_INVALID)
 		return -1;
@@ -575,27 +856,23 @@ static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 	pkt_sock->frame_offset = 0;
 
 	pkt_sock->pool = pool;
-	pkt_sock->sockfd = mmap_pkt_socket();
-	if (pkt_sock->sockfd == -1)
-		goto error;
-
-	ret = mmap_bind_sock(pkt_sock, netdev);
-	if (ret != 0)
-		goto error;
-
-	ret = mmap_setup_ring(pkt_sock->sockfd, &pkt_sock->tx_ring,
-			      PACKET_TX_RING, pool, fanout);
-	if (ret != 0)
-		goto error;
+	pkt_sock->fanout_mode = fanout_mode;
 
-	ret = mmap_setup_ring(pkt_sock->sockfd, &pkt_sock->rx_ring,
-			      PACKET_RX_RING, pool, fanout);
-	if (ret != 0)
+	/* Control socket for ioctls and stats. Packets are received and sent
+	 * through per queue sockets. */
+	pkt_sock->sockfd = socket(PF_PACKET, SOCK_RAW, 0);
+	if (pkt_sock->sockfd == -1) {
+		__odp_errno = errno;
+		ODP_ERR("socket(SOCK_RAW): %s\n", strerror(errno));
 		goto error;
+	}
 
-	ret = mmap_sock(pkt_sock);
-	if (ret != 0)
+	pkt_sock->if_idx = if_nametoindex(netdev);
+	if (pkt_sock->if_idx == 0) {
+		__odp_errno = errno;
+		ODP_ERR("if_nametoindex(): %s\n", strerror(errno));
 		goto error;
+	}
 
 	ret = mac_addr_get_fd(pkt_sock->sockfd, netdev, pkt_sock->if_mac);
 	if (ret != 0)
@@ -605,19 +882,13 @@ static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 	if (!pkt_sock->mtu)
 		goto error;
 
-	if_idx = if_nametoindex(netdev);
-	if (if_idx == 0) {
-		__odp_errno = errno;
-		ODP_ERR("if_nametoindex(): %s\n", strerror(errno));
+	/* Open one queue of each direction already here, so that failures
+	 * are detected before another pktio type is tried */
+	if (mmap_rx_queues_open(pkt_sock, 1))
 		goto error;
-	}
 
-	pkt_sock->fanout = fanout;
-	if (fanout) {
-		ret = set_pkt_sock_fanout_mmap(pkt_sock, if_idx);
-		if (ret != 0)
-			goto error;
-	}
+	if (mmap_tx_queues_open(pkt_sock, 1))
+		goto error;
 
 	ret = ethtool_stats_get_fd(pktio_entry->s.pkt_sock_mmap.sockfd,
 				   pktio_entry->s.name,
@@ -647,30 +918,78 @@ error:
 	return -1;
 }
 
-static int sock_mmap_fd_set(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
-			    fd_set *readfds)
+static int sock_mmap_input_queues_config(pktio_entry_t *pktio_entry,
+					 const odp_pktin_queue_param_t *p)
 {
 	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	unsigned num_queues = pktio_entry->s.num_in_queue;
+
+	/* Flow hashing overrides the default fanout mode */
+	if (p->hash_enable && num_queues > 1)
+		pkt_sock->fanout_mode = PACKET_FANOUT_HASH;
+	else
+		pkt_sock->fanout_mode = fanout_mode;
+
+	if (pktio_entry->s.param.in_mode == ODP_PKTIN_MODE_SCHED)
+		pkt_sock->lockless_rx = 1;
+	else
+		pkt_sock->lockless_rx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	if (mmap_rx_queues_open(pkt_sock, num_queues)) {
+		ODP_ERR("Failed to open %u RX queues\n", num_queues);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int sock_mmap_output_queues_config(pktio_entry_t *pktio_entry,
+					  const odp_pktout_queue_param_t *p)
+{
+	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	unsigned num_queues = pktio_entry->s.num_out_queue;
+
+	pkt_sock->lockless_tx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	if (mmap_tx_queues_open(pkt_sock, num_queues)) {
+		ODP_ERR("Failed to open %u TX queues\n", num_queues);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int sock_mmap_fd_set(pktio_entry_t *pktio_entry, int index,
+			    fd_set *readfds)
+{
+	pkt_mmap_queue_t *queue = &pktio_entry->s.pkt_sock_mmap.rx_queue[index];
 	int fd;
 
-	odp_ticketlock_lock(&pktio_entry->s.rxl);
-	fd = pkt_sock->sockfd;
+	fd = queue->sockfd;
 	FD_SET(fd, readfds);
-	odp_ticketlock_unlock(&pktio_entry->s.rxl);
 
 	return fd;
 }
 
-static int sock_mmap_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+static int sock_mmap_recv(pktio_entry_t *pktio_entry, int index,
 			  odp_packet_t pkt_table[], int num)
 {
 	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	pkt_mmap_queue_t *queue = &pkt_sock->rx_queue[index];
 	int ret;
 
-	odp_ticketlock_lock(&pktio_entry->s.rxl);
-	ret = pkt_mmap_v2_rx(pktio_entry, pkt_sock, pkt_table, num,
-			     pkt_sock->if_mac);
-	odp_ticketlock_unlock(&pktio_entry->s.rxl);
+	if (!pkt_sock->lockless_rx)
+		odp_ticketlock_lock(&queue->lock);
+
+	if (queue->ring.version == TPACKET_V3)
+		ret = pkt_mmap_v3_rx(pktio_entry, pkt_sock, &queue->ring,
+				     pkt_table, num);
+	else
+		ret = pkt_mmap_v2_rx(pktio_entry, pkt_sock, &queue->ring,
+				     pkt_table, num);
+
+	if (!pkt_sock->lockless_rx)
+		odp_ticketlock_unlock(&queue->lock);
 
 	return ret;
 }
@@ -748,16 +1067,23 @@ static int sock_mmap_recv_mq_tmo(pktio_entry_t *pktio_entry[], int index[],
 	return 0;
 }
 
-static int sock_mmap_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+static int sock_mmap_send(pktio_entry_t *pktio_entry, int index,
 			  const odp_packet_t pkt_table[], int num)
 {
-	int ret;
 	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	pkt_mmap_queue_t *queue = &pkt_sock->tx_queue[index];
+	int ret;
 
-	odp_ticketlock_lock(&pktio_entry->s.txl);
-	ret = pkt_mmap_v2_tx(pkt_sock->tx_ring.sock, &pkt_sock->tx_ring,
-			     pkt_table, num);
-	odp_ticketlock_unlock(&pktio_entry->s.txl);
+	if (odp_unlikely(pktio_entry->s.chksum_insert_ena))
+		_odp_pktio_chksum_insert(pktio_entry, pkt_table, num);
+
+	if (!pkt_sock->lockless_tx)
+		odp_ticketlock_lock(&queue->lock);
+
+	ret = pkt_mmap_v2_tx(queue->sockfd, &queue->ring, pkt_table, num);
+
+	if (!pkt_sock->lockless_tx)
+		odp_ticketlock_unlock(&queue->lock);
 
 	return ret;
 }
@@ -798,13 +1124,19 @@ static int sock_mmap_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
 {
 	memset(capa, 0, sizeof(odp_pktio_capability_t));
 
-	capa->max_input_queues  = 1;
-	capa->max_output_queues = 1;
+	capa->max_input_queues  = PKT_MMAP_MAX_QUEUES;
+	capa->max_output_queues = PKT_MMAP_MAX_QUEUES;
 	capa->set_op.op.promisc_mode = 1;
 
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktout.bit.ipv4_chksum_ena = 1;
+	capa->config.pktout.bit.udp_chksum_ena = 1;
+	capa->config.pktout.bit.tcp_chksum_ena = 1;
+	capa->config.pktout.bit.ipv4_chksum = 1;
+	capa->config.pktout.bit.udp_chksum = 1;
+	capa->config.pktout.bit.tcp_chksum = 1;
 	return 0;
 }
 
@@ -835,6 +1167,18 @@ static int sock_mmap_stats_reset(pktio_entry_t *pktio_entry)
 
 static int sock_mmap_init_global(void)
 {
+	const char *mode = getenv("ODP_PKTIO_SOCKET_MMAP_FANOUT");
+
+	if (mode != NULL && !strcmp(mode, "cpu"))
+		fanout_mode = PACKET_FANOUT_CPU;
+	else if (mode != NULL && !strcmp(mode, "qm"))
+		fanout_mode = PACKET_FANOUT_QM;
+	else
+		fanout_mode = PACKET_FANOUT_HASH;
+
+	if (getenv("ODP_PKTIO_SOCKET_MMAP_V3"))
+		rx_version = TPACKET_V3;
+
 	if (getenv("ODP_PKTIO_DISABLE_SOCKET_MMAP")) {
 		ODP_PRINT("PKTIO: socket mmap skipped,"
 				" enabled export ODP_PKTIO_DISABLE_SOCKET_MMAP=1.\n");
@@ -842,6 +1186,15 @@ static int sock_mmap_init_global(void)
 	} else  {
 		ODP_PRINT("PKTIO: initialized socket mmap,"
 				" use export ODP_PKTIO_DISABLE_SOCKET_MMAP=1 to disable.\n");
+		ODP_PRINT("PKTIO: socket mmap fanout mode %s,"
+			  " use export ODP_PKTIO_SOCKET_MMAP_FANOUT="
+			  "hash|cpu|qm to change.\n",
+			  fanout_mode == PACKET_FANOUT_CPU ? "cpu" :
+			  fanout_mode == PACKET_FANOUT_QM ? "qm" : "hash");
+		ODP_PRINT("PKTIO: socket mmap rx uses TPACKET_%s,"
+			  " use export ODP_PKTIO_SOCKET_MMAP_V3=1 for"
+			  " block mode.\n",
+			  rx_version == TPACKET_V3 ? "V3" : "V2");
 	}
 	return 0;
 }
@@ -873,6 +1226,6 @@ const pktio_if_ops_t sock_mmap_pktio_ops = {
 	.pktin_ts_res = NULL,
 	.pktin_ts_from_ns = NULL,
 	.config = NULL,
-	.input_queues_config = NULL,
-	.output_queues_config = NULL,
+	.input_queues_config = sock_mmap_input_queues_config,
+	.output_queues_config = sock_mmap_output_queues_config,
 };
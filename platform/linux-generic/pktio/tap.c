@@ -342,6 +342,9 @@ static int tap_pktio_send_lockless(pktio_entry_t *pktio_entry,
 	uint8_t buf[BUF_SIZE];
 	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
 
+	if (odp_unlikely(pktio_entry->s.chksum_insert_ena))
+		_odp_pktio_chksum_insert(pktio_entry, pkts, num);
+
 	for (i = 0; i < num; i++) {
 		pkt_len = odp_packet_len(pkts[i]);
 
@@ -459,6 +462,12 @@ static int tap_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktout.bit.ipv4_chksum_ena = 1;
+	capa->config.pktout.bit.udp_chksum_ena = 1;
+	capa->config.pktout.bit.tcp_chksum_ena = 1;
+	capa->config.pktout.bit.ipv4_chksum = 1;
+	capa->config.pktout.bit.udp_chksum = 1;
+	capa->config.pktout.bit.tcp_chksum = 1;
 	return 0;
 }
 
@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# Copyright (c) 2018, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+# Script that runs odp_scheduling test with different scheduler
+# configurations when launched by 'make check'. Settings are read by the
+# default scheduler at global init, the script is run only when the default
+# scheduler is built.
+
+TEST_DIR="${TEST_DIR:-$(dirname $0)}"
+PERFORMANCE="$TEST_DIR/../../../../test/performance"
+ret=0
+
+run()
+{
+	echo odp_scheduling_run_config starts with $@
+	echo =====================================================
+
+	env "$@" $PERFORMANCE/odp_scheduling${EXEEXT} -c 2 || ret=1
+}
+
+# Smallest and largest values of the settings
+run ODP_SCHED_SPREAD=1 ODP_SCHED_PREFER_RATIO=1 ODP_SCHED_GROUPS=8 \
+    ODP_SCHED_PKTIO_CMD_QUEUES=1 ODP_SCHED_ORDERED_STASH=1 \
+    ODP_SCHED_PREFETCH=0
+run ODP_SCHED_SPREAD=8 ODP_SCHED_PREFER_RATIO=256 ODP_SCHED_GROUPS=256 \
+    ODP_SCHED_PKTIO_CMD_QUEUES=64 ODP_SCHED_ORDERED_STASH=4096
+
+exit $ret
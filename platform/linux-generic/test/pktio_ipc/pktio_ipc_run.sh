@@ -85,11 +85,20 @@ run()
 		ls -l /dev/shm/${UID}/odp* 2> /dev/null
 		echo "Second stage PASSED"
 	fi
+}
+
+run_all()
+{
+	run
+
+	echo "==== zero-copy receive ===="
+	export ODP_PKTIO_IPC_ZERO_COPY=1
+	run
 
 	echo "!!!PASSED!!!"
 	exit 0
 }
 
 case "$1" in
-	*)       run ;;
+	*)       run_all ;;
 esac
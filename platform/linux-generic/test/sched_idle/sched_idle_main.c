@@ -0,0 +1,166 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "config.h"
+
+#include <sys/resource.h>
+
+#include <odp_api.h>
+#include <odp_cunit_common.h>
+
+/* Checks that threads waiting for events sleep in the kernel instead of
+ * spinning. This is implementation behavior, not API behavior. The scalable
+ * scheduler does not sleep. */
+
+#define POOL_NAME	"sched_idle_pool"
+#define QUEUE_NAME	"sched_idle_queue"
+#define NUM_BUF		8
+#define WAKEUP_DELAY_NS	(100 * ODP_TIME_MSEC_IN_NS)
+#define WAKEUP_TMO_NS	(5 * ODP_TIME_SEC_IN_NS)
+
+static pthrd_arg thr_arg;
+
+static int sched_idle_suite_init(void)
+{
+	odp_pool_param_t params;
+	odp_queue_param_t qp;
+	odp_pool_t pool;
+	odp_queue_t queue;
+
+	odp_pool_param_init(&params);
+	params.type      = ODP_POOL_BUFFER;
+	params.buf.size  = 64;
+	params.buf.num   = NUM_BUF;
+
+	pool = odp_pool_create(POOL_NAME, &params);
+	if (pool == ODP_POOL_INVALID)
+		return -1;
+
+	odp_queue_param_init(&qp);
+	qp.type        = ODP_QUEUE_TYPE_SCHED;
+	qp.sched.sync  = ODP_SCHED_SYNC_PARALLEL;
+	qp.sched.prio  = ODP_SCHED_PRIO_NORMAL;
+	qp.sched.group = ODP_SCHED_GROUP_ALL;
+
+	queue = odp_queue_create(QUEUE_NAME, &qp);
+	if (queue == ODP_QUEUE_INVALID)
+		return -1;
+
+	return 0;
+}
+
+static int sched_idle_suite_term(void)
+{
+	odp_queue_t queue = odp_queue_lookup(QUEUE_NAME);
+	odp_pool_t pool = odp_pool_lookup(POOL_NAME);
+
+	if (queue == ODP_QUEUE_INVALID || odp_queue_destroy(queue))
+		return -1;
+
+	if (pool == ODP_POOL_INVALID || odp_pool_destroy(pool))
+		return -1;
+
+	return 0;
+}
+
+static void drain_events(void)
+{
+	odp_event_t ev;
+
+	odp_schedule_pause();
+
+	while ((ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT)) !=
+	       ODP_EVENT_INVALID)
+		odp_event_free(ev);
+
+	odp_schedule_resume();
+}
+
+static int sleep_thread(void *arg ODP_UNUSED)
+{
+	odp_event_t ev;
+	struct rusage ru;
+	long nvcsw;
+
+	CU_ASSERT_FATAL(getrusage(RUSAGE_THREAD, &ru) == 0);
+	nvcsw = ru.ru_nvcsw;
+
+	ev = odp_schedule(NULL, odp_schedule_wait_time(WAKEUP_TMO_NS));
+	CU_ASSERT(ev != ODP_EVENT_INVALID);
+
+	/* The thread blocked instead of spinning through the whole delay */
+	CU_ASSERT_FATAL(getrusage(RUSAGE_THREAD, &ru) == 0);
+	CU_ASSERT(ru.ru_nvcsw > nvcsw);
+
+	if (ev != ODP_EVENT_INVALID)
+		odp_event_free(ev);
+
+	drain_events();
+
+	return 0;
+}
+
+static void sched_idle_test_sleep(void)
+{
+	odp_queue_t queue = odp_queue_lookup(QUEUE_NAME);
+	odp_pool_t pool = odp_pool_lookup(POOL_NAME);
+	odp_buffer_t buf;
+	odp_time_t delay;
+
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	thr_arg.numthrds = 1;
+	odp_cunit_thread_create(sleep_thread, &thr_arg);
+
+	/* Let the thread spin and go to sleep */
+	delay = odp_time_local_from_ns(WAKEUP_DELAY_NS);
+	odp_time_wait_until(odp_time_sum(odp_time_local(), delay));
+
+	buf = odp_buffer_alloc(pool);
+	CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+
+	if (odp_queue_enq(queue, odp_buffer_to_event(buf)))
+		odp_buffer_free(buf);
+
+	odp_cunit_thread_exit(&thr_arg);
+}
+
+static int sched_idle_check_sleep(void)
+{
+#ifdef ODP_SCHEDULE_SCALABLE
+	return ODP_TEST_INACTIVE;
+#else
+	return ODP_TEST_ACTIVE;
+#endif
+}
+
+static odp_testinfo_t sched_idle_suite[] = {
+	ODP_TEST_INFO_CONDITIONAL(sched_idle_test_sleep,
+				  sched_idle_check_sleep),
+	ODP_TEST_INFO_NULL,
+};
+
+static odp_suiteinfo_t sched_idle_suites[] = {
+	{"scheduler idle", sched_idle_suite_init, sched_idle_suite_term,
+		sched_idle_suite},
+	ODP_SUITE_INFO_NULL
+};
+
+int main(int argc, char *argv[])
+{
+	int ret;
+
+	if (odp_cunit_parse_options(argc, argv))
+		return -1;
+
+	ret = odp_cunit_register(sched_idle_suites);
+
+	if (ret == 0)
+		ret = odp_cunit_run();
+
+	return ret;
+}
@@ -0,0 +1,456 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "config.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+
+#include <odp_api.h>
+#include <odp_cunit_common.h>
+
+/* Stresses scheduler synchronization with more worker threads than there
+ * are CPUs on small hosts. Threads are created directly, so that the number
+ * of threads does not depend on the worker CPU mask. Preemption of a thread
+ * in the middle of a schedule call exposes races between threads that
+ * exchange queues, e.g. the work-stealing scheduler. Workers yield the CPU
+ * while holding a scheduling context to force such preemption. */
+
+#define NUM_WORKERS	4
+#define NUM_EVENTS	2000
+#define NUM_GRP_EVENTS	1000
+#define PARK_TIME_NS	(100 * ODP_TIME_MSEC_IN_NS)
+#define TEST_TMO_NS	(60 * ODP_TIME_SEC_IN_NS)
+#define ATOMIC_YIELD	8
+#define ORDERED_YIELD	64
+#define POOL_NAME	"sched_stress_pool"
+
+typedef struct {
+	uint32_t seq;
+	int thr;
+} stress_msg_t;
+
+typedef struct {
+	odp_instance_t instance;
+	odp_pool_t pool;
+	odp_queue_t src_queue;
+	odp_queue_t dst_queue;
+	odp_schedule_group_t group;
+	odp_barrier_t barrier;
+	odp_atomic_u32_t num_done;
+	odp_atomic_u32_t in_atomic;
+	odp_atomic_u32_t errors;
+	odp_atomic_u32_t timeouts;
+	uint32_t next_seq;
+	int member_thr;
+	void (*worker_fn)(int worker);
+} stress_global_t;
+
+static stress_global_t global;
+
+static int sched_stress_global_init(odp_instance_t *inst)
+{
+	if (odp_init_global(inst, NULL, NULL)) {
+		fprintf(stderr, "error: odp_init_global() failed.\n");
+		return -1;
+	}
+
+	if (odp_init_local(*inst, ODP_THREAD_CONTROL)) {
+		fprintf(stderr, "error: odp_init_local() failed.\n");
+		return -1;
+	}
+
+	global.instance = *inst;
+
+	return 0;
+}
+
+static int sched_stress_suite_init(void)
+{
+	odp_pool_param_t params;
+
+	odp_pool_param_init(&params);
+	params.type      = ODP_POOL_BUFFER;
+	params.buf.size  = sizeof(stress_msg_t);
+	params.buf.num   = NUM_EVENTS;
+
+	global.pool = odp_pool_create(POOL_NAME, &params);
+	if (global.pool == ODP_POOL_INVALID)
+		return -1;
+
+	return 0;
+}
+
+static int sched_stress_suite_term(void)
+{
+	if (odp_pool_destroy(global.pool))
+		return -1;
+
+	return 0;
+}
+
+static odp_queue_t create_queue(const char *name, odp_schedule_sync_t sync,
+				odp_schedule_group_t group)
+{
+	odp_queue_param_t qp;
+
+	odp_queue_param_init(&qp);
+	qp.type        = ODP_QUEUE_TYPE_SCHED;
+	qp.sched.sync  = sync;
+	qp.sched.prio  = ODP_SCHED_PRIO_NORMAL;
+	qp.sched.group = group;
+
+	return odp_queue_create(name, &qp);
+}
+
+static void enqueue_events(odp_queue_t queue, uint32_t num)
+{
+	odp_buffer_t buf;
+	stress_msg_t *msg;
+	uint32_t i;
+
+	for (i = 0; i < num; i++) {
+		buf = odp_buffer_alloc(global.pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+
+		msg = odp_buffer_addr(buf);
+		msg->seq = i;
+		msg->thr = -1;
+
+		CU_ASSERT_FATAL(odp_queue_enq(queue,
+					      odp_buffer_to_event(buf)) == 0);
+	}
+}
+
+static void init_counters(void)
+{
+	odp_atomic_init_u32(&global.num_done, 0);
+	odp_atomic_init_u32(&global.in_atomic, 0);
+	odp_atomic_init_u32(&global.errors, 0);
+	odp_atomic_init_u32(&global.timeouts, 0);
+	odp_barrier_init(&global.barrier, NUM_WORKERS);
+	global.next_seq = 0;
+}
+
+/* Returns 1 when the test has run out of time */
+static int test_timeout(odp_time_t end)
+{
+	if (odp_time_cmp(odp_time_local(), end) < 0)
+		return 0;
+
+	odp_atomic_inc_u32(&global.timeouts);
+	return 1;
+}
+
+static void *worker_thread(void *arg)
+{
+	int worker = (int)(uintptr_t)arg;
+	odp_event_t ev;
+
+	if (odp_init_local(global.instance, ODP_THREAD_WORKER)) {
+		odp_atomic_inc_u32(&global.errors);
+		return NULL;
+	}
+
+	global.worker_fn(worker);
+
+	/* Releases the last context and any prefetched events */
+	odp_schedule_pause();
+
+	while ((ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT)) !=
+	       ODP_EVENT_INVALID) {
+		odp_atomic_inc_u32(&global.errors);
+		odp_event_free(ev);
+	}
+
+	odp_schedule_resume();
+
+	if (odp_term_local() < 0)
+		odp_atomic_inc_u32(&global.errors);
+
+	return NULL;
+}
+
+static void run_workers(void (*worker_fn)(int worker))
+{
+	pthread_t thread[NUM_WORKERS];
+	int i, num = 0;
+
+	global.worker_fn = worker_fn;
+
+	for (i = 0; i < NUM_WORKERS; i++) {
+		if (pthread_create(&thread[i], NULL, worker_thread,
+				   (void *)(uintptr_t)i))
+			break;
+		num++;
+	}
+
+	CU_ASSERT(num == NUM_WORKERS);
+
+	/* Workers wait on the barrier, do not leave them blocked */
+	CU_ASSERT_FATAL(num == NUM_WORKERS);
+
+	for (i = 0; i < num; i++)
+		pthread_join(thread[i], NULL);
+
+	CU_ASSERT(odp_atomic_load_u32(&global.timeouts) == 0);
+	CU_ASSERT(odp_atomic_load_u32(&global.errors) == 0);
+}
+
+/* Events flow from an ordered queue to an atomic queue. Order is restored
+ * on enqueue, so the atomic queue must see the original sequence, and only
+ * one thread at a time may hold its context. */
+static void atomic_worker(int worker ODP_UNUSED)
+{
+	odp_time_t end = odp_time_sum(odp_time_local(),
+				      odp_time_local_from_ns(TEST_TMO_NS));
+	odp_queue_t src;
+	odp_event_t ev;
+	stress_msg_t *msg;
+
+	while (odp_atomic_load_u32(&global.num_done) < NUM_EVENTS) {
+		if (test_timeout(end))
+			break;
+
+		ev = odp_schedule(&src, ODP_SCHED_NO_WAIT);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		if (src == global.src_queue) {
+			if (odp_queue_enq(global.dst_queue, ev)) {
+				odp_atomic_inc_u32(&global.errors);
+				odp_event_free(ev);
+			}
+			continue;
+		}
+
+		msg = odp_buffer_addr(odp_buffer_from_event(ev));
+
+		if (odp_atomic_fetch_inc_u32(&global.in_atomic) != 0)
+			odp_atomic_inc_u32(&global.errors);
+
+		if (msg->seq % ATOMIC_YIELD == 0)
+			sched_yield();
+
+		if (msg->seq != global.next_seq)
+			odp_atomic_inc_u32(&global.errors);
+
+		global.next_seq = msg->seq + 1;
+
+		odp_atomic_dec_u32(&global.in_atomic);
+		odp_atomic_inc_u32(&global.num_done);
+		odp_event_free(ev);
+	}
+}
+
+static void sched_stress_test_atomic(void)
+{
+	init_counters();
+
+	global.src_queue = create_queue("stress_ordered",
+					ODP_SCHED_SYNC_ORDERED,
+					ODP_SCHED_GROUP_ALL);
+	global.dst_queue = create_queue("stress_atomic",
+					ODP_SCHED_SYNC_ATOMIC,
+					ODP_SCHED_GROUP_ALL);
+	CU_ASSERT_FATAL(global.src_queue != ODP_QUEUE_INVALID);
+	CU_ASSERT_FATAL(global.dst_queue != ODP_QUEUE_INVALID);
+
+	enqueue_events(global.src_queue, NUM_EVENTS);
+
+	run_workers(atomic_worker);
+
+	CU_ASSERT(odp_atomic_load_u32(&global.num_done) == NUM_EVENTS);
+	CU_ASSERT(odp_queue_destroy(global.src_queue) == 0);
+	CU_ASSERT(odp_queue_destroy(global.dst_queue) == 0);
+}
+
+/* Events of an ordered queue are forwarded to a plain queue in parallel */
+static void ordered_worker(int worker ODP_UNUSED)
+{
+	odp_time_t end = odp_time_sum(odp_time_local(),
+				      odp_time_local_from_ns(TEST_TMO_NS));
+	odp_event_t ev;
+	stress_msg_t *msg;
+
+	while (odp_atomic_load_u32(&global.num_done) < NUM_EVENTS) {
+		if (test_timeout(end))
+			break;
+
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		msg = odp_buffer_addr(odp_buffer_from_event(ev));
+
+		/* Threads that wait for their turn in order may spin through
+		 * their time slice, so yield less often */
+		if (msg->seq % ORDERED_YIELD == 0)
+			sched_yield();
+
+		if (odp_queue_enq(global.dst_queue, ev)) {
+			odp_atomic_inc_u32(&global.errors);
+			odp_event_free(ev);
+			continue;
+		}
+
+		odp_atomic_inc_u32(&global.num_done);
+	}
+}
+
+static void sched_stress_test_ordered(void)
+{
+	odp_queue_param_t qp;
+	odp_event_t ev;
+	stress_msg_t *msg;
+	uint32_t num = 0;
+	int in_order = 1;
+
+	init_counters();
+
+	odp_queue_param_init(&qp);
+	qp.type = ODP_QUEUE_TYPE_PLAIN;
+
+	global.src_queue = create_queue("stress_ordered",
+					ODP_SCHED_SYNC_ORDERED,
+					ODP_SCHED_GROUP_ALL);
+	global.dst_queue = odp_queue_create("stress_plain", &qp);
+	CU_ASSERT_FATAL(global.src_queue != ODP_QUEUE_INVALID);
+	CU_ASSERT_FATAL(global.dst_queue != ODP_QUEUE_INVALID);
+
+	enqueue_events(global.src_queue, NUM_EVENTS);
+
+	run_workers(ordered_worker);
+
+	while ((ev = odp_queue_deq(global.dst_queue)) != ODP_EVENT_INVALID) {
+		msg = odp_buffer_addr(odp_buffer_from_event(ev));
+
+		if (msg->seq != num)
+			in_order = 0;
+
+		num++;
+		odp_event_free(ev);
+	}
+
+	CU_ASSERT(num == NUM_EVENTS);
+	CU_ASSERT(in_order);
+	CU_ASSERT(odp_queue_destroy(global.src_queue) == 0);
+	CU_ASSERT(odp_queue_destroy(global.dst_queue) == 0);
+}
+
+/* Events of a group queue wait until a thread joins the group, and are
+ * then received only by that thread */
+static void group_worker(int worker)
+{
+	odp_time_t end = odp_time_sum(odp_time_local(),
+				      odp_time_local_from_ns(TEST_TMO_NS));
+	odp_time_t park_end;
+	odp_thrmask_t mask;
+	odp_queue_t src;
+	odp_event_t ev;
+	int thr = odp_thread_id();
+
+	park_end = odp_time_sum(odp_time_local(),
+				odp_time_local_from_ns(PARK_TIME_NS));
+
+	/* No thread is a member yet */
+	while (odp_time_cmp(odp_time_local(), park_end) < 0) {
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		odp_atomic_inc_u32(&global.errors);
+		odp_event_free(ev);
+	}
+
+	odp_barrier_wait(&global.barrier);
+
+	if (worker == 0) {
+		global.member_thr = thr;
+		odp_thrmask_zero(&mask);
+		odp_thrmask_set(&mask, thr);
+
+		if (odp_schedule_group_join(global.group, &mask))
+			odp_atomic_inc_u32(&global.errors);
+	}
+
+	odp_barrier_wait(&global.barrier);
+
+	while (odp_atomic_load_u32(&global.num_done) < NUM_GRP_EVENTS) {
+		if (test_timeout(end))
+			break;
+
+		ev = odp_schedule(&src, ODP_SCHED_NO_WAIT);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		if (src != global.src_queue || thr != global.member_thr)
+			odp_atomic_inc_u32(&global.errors);
+
+		odp_atomic_inc_u32(&global.num_done);
+		odp_event_free(ev);
+	}
+
+	if (worker == 0) {
+		if (odp_schedule_group_leave(global.group, &mask))
+			odp_atomic_inc_u32(&global.errors);
+	}
+}
+
+static void sched_stress_test_group(void)
+{
+	odp_thrmask_t mask;
+
+	init_counters();
+
+	odp_thrmask_zero(&mask);
+	global.group = odp_schedule_group_create("stress_group", &mask);
+	CU_ASSERT_FATAL(global.group != ODP_SCHED_GROUP_INVALID);
+
+	global.src_queue = create_queue("stress_group_queue",
+					ODP_SCHED_SYNC_PARALLEL,
+					global.group);
+	CU_ASSERT_FATAL(global.src_queue != ODP_QUEUE_INVALID);
+
+	enqueue_events(global.src_queue, NUM_GRP_EVENTS);
+
+	run_workers(group_worker);
+
+	CU_ASSERT(odp_atomic_load_u32(&global.num_done) == NUM_GRP_EVENTS);
+	CU_ASSERT(odp_queue_destroy(global.src_queue) == 0);
+	CU_ASSERT(odp_schedule_group_destroy(global.group) == 0);
+}
+
+static odp_testinfo_t sched_stress_suite[] = {
+	ODP_TEST_INFO(sched_stress_test_atomic),
+	ODP_TEST_INFO(sched_stress_test_ordered),
+	ODP_TEST_INFO(sched_stress_test_group),
+	ODP_TEST_INFO_NULL,
+};
+
+static odp_suiteinfo_t sched_stress_suites[] = {
+	{"scheduler stress", sched_stress_suite_init, sched_stress_suite_term,
+		sched_stress_suite},
+	ODP_SUITE_INFO_NULL
+};
+
+int main(int argc, char *argv[])
+{
+	int ret;
+
+	if (odp_cunit_parse_options(argc, argv))
+		return -1;
+
+	odp_cunit_register_global_init(sched_stress_global_init);
+
+	ret = odp_cunit_register(sched_stress_suites);
+
+	if (ret == 0)
+		ret = odp_cunit_run();
+
+	return ret;
+}
@@ -0,0 +1,31 @@
+#!/bin/sh
+#
+# Copyright (c) 2018, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+
+# Run crypto validation test with crypto worker threads
+# (ODP_CRYPTO_ASYNC_THREADS), which are not used by default
+
+# directories where crypto_main binary can be found:
+# -in the validation dir when running make check (intree or out of tree)
+# -in the script directory, when running after 'make install', or
+# -in the validation when running standalone intree.
+# -in the current directory.
+# running stand alone out of tree requires setting PATH
+PATH=${TEST_DIR}/api/crypto:$PATH
+PATH=$(dirname $0):$PATH
+PATH=$(dirname $0)/../../../../../../test/validation/api/crypto:$PATH
+PATH=.:$PATH
+
+crypto_main_path=$(which crypto_main${EXEEXT})
+if [ -x "$crypto_main_path" ] ; then
+	echo "running with $crypto_main_path"
+else
+	echo "cannot find crypto_main${EXEEXT}: please set you PATH for it."
+	exit 1
+fi
+
+ODP_CRYPTO_ASYNC_THREADS=2 ODP_CRYPTO_ASYNC_BURST=8 crypto_main${EXEEXT}
@@ -0,0 +1,31 @@
+#!/bin/sh
+#
+# Copyright (c) 2018, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+
+# Run packet validation test with the burst parser
+# (ODP_PACKET_PARSE_BURST), which is not used by default
+
+# directories where packet_main binary can be found:
+# -in the validation dir when running make check (intree or out of tree)
+# -in the script directory, when running after 'make install', or
+# -in the validation when running standalone intree.
+# -in the current directory.
+# running stand alone out of tree requires setting PATH
+PATH=${TEST_DIR}/api/packet:$PATH
+PATH=$(dirname $0):$PATH
+PATH=$(dirname $0)/../../../../../../test/validation/api/packet:$PATH
+PATH=.:$PATH
+
+packet_main_path=$(which packet_main${EXEEXT})
+if [ -x "$packet_main_path" ] ; then
+	echo "running with $packet_main_path"
+else
+	echo "cannot find packet_main${EXEEXT}: please set you PATH for it."
+	exit 1
+fi
+
+ODP_PACKET_PARSE_BURST=1 packet_main${EXEEXT}
@@ -0,0 +1,31 @@
+#!/bin/sh
+#
+# Copyright (c) 2018, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+
+# Run pool validation test with per NUMA node pool rings
+# on four NUMA nodes (ODP_NUMA_NODES), also on hosts with fewer nodes
+
+# directories where pool_main binary can be found:
+# -in the validation dir when running make check (intree or out of tree)
+# -in the script directory, when running after 'make install', or
+# -in the validation when running standalone intree.
+# -in the current directory.
+# running stand alone out of tree requires setting PATH
+PATH=${TEST_DIR}/api/pool:$PATH
+PATH=$(dirname $0):$PATH
+PATH=$(dirname $0)/../../../../../../test/validation/api/pool:$PATH
+PATH=.:$PATH
+
+pool_main_path=$(which pool_main${EXEEXT})
+if [ -x "$pool_main_path" ] ; then
+	echo "running with $pool_main_path"
+else
+	echo "cannot find pool_main${EXEEXT}: please set you PATH for it."
+	exit 1
+fi
+
+ODP_NUMA_NODES=4 pool_main${EXEEXT}
@@ -0,0 +1,42 @@
+#!/bin/sh
+#
+# Copyright (c) 2018, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+
+# Run traffic_mngr validation test with TM systems spread over two service
+# threads (tm_groups)
+
+# directories where traffic_mngr_main binary can be found:
+# -in the validation dir when running make check (intree or out of tree)
+# -in the script directory, when running after 'make install', or
+# -in the validation when running standalone intree.
+# -in the current directory.
+# running stand alone out of tree requires setting PATH
+PATH=${TEST_DIR}/api/traffic_mngr:$PATH
+PATH=$(dirname $0):$PATH
+PATH=$(dirname $0)/../../../../../../test/validation/api/traffic_mngr:$PATH
+PATH=.:$PATH
+
+traffic_mngr_main_path=$(which traffic_mngr_main${EXEEXT})
+if [ -x "$traffic_mngr_main_path" ] ; then
+	echo "running with $traffic_mngr_main_path"
+else
+	echo "cannot find traffic_mngr_main${EXEEXT}: please set you PATH for it."
+	exit 1
+fi
+
+# exit code expected by automake for skipped tests
+TEST_SKIPPED=77
+
+ODP_TM_SERVICE_THREADS=2 traffic_mngr_main${EXEEXT}
+ret=$?
+
+if [ "${CI}" = "true" ] && [ $ret -eq 255 ]; then
+	echo "SKIP: skip due to not isolated environment"
+	exit ${TEST_SKIPPED}
+fi
+
+exit $ret
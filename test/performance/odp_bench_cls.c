@@ -0,0 +1,566 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "config.h"
+
+/**
+ * @file
+ *
+ * @example odp_bench_cls.c  Classifier benchmark with ACL style rule sets
+ *
+ * Packets are looped through a loopback interface with the classifier
+ * enabled. All PMRs are attached to the default CoS and direct matching
+ * packets to a single CoS. Rule sets mix four term/mask shapes which are
+ * typical to ACLs: host and service, subnet and service, source and
+ * destination prefix, and protocol, source port and destination prefix.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <inttypes.h>
+
+#include <test_debug.h>
+
+#include <odp_api.h>
+#include <odp/helper/odph_api.h>
+
+/** Number of packets looped through the interface */
+#define NUM_PKT 256
+
+/** Packet length */
+#define PKT_LEN 64
+
+/** Packet burst size */
+#define BURST_SIZE 32
+
+/** Maximum number of rules */
+#define MAX_RULES 2048
+
+/** Number of rule shapes */
+#define NUM_SHAPE 4
+
+/** Every Nth packet does not match any rule */
+#define MISS_RATIO 8
+
+/** Default number of rounds per rule set */
+#define DEFAULT_ROUNDS 1000
+
+/** Get rid of path in filename - only for unix-type paths using '/' */
+#define NO_PATH(file_name) (strrchr((file_name), '/') ? \
+			    strrchr((file_name), '/') + 1 : (file_name))
+
+/** Rule set sizes */
+static const uint32_t test_rules[] = {0, 8, 64, 256, 1024, MAX_RULES};
+
+/** Number of rule set sizes */
+#define NUM_TEST_RULES (sizeof(test_rules) / sizeof(test_rules[0]))
+
+/** Packet header fields used by the rules */
+typedef struct {
+	uint32_t sip;
+	uint32_t dip;
+	uint16_t sport;
+	uint16_t dport;
+} flow_t;
+
+/** Test global variables */
+typedef struct {
+	uint32_t rounds;
+	odp_pool_t pool;
+	odp_pktio_t pktio;
+	odp_queue_t pktin_queue;
+	odp_pktout_queue_t pktout;
+	odp_queue_t queue[2];
+	odp_cos_t cos[2];
+	odp_pmr_t pmr[MAX_RULES];
+	uint32_t num_pmr;
+	odp_packet_t pkt[NUM_PKT];
+} test_global_t;
+
+static test_global_t global;
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "OpenDataPlane classifier benchmark.\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "  -r, --rounds     Number of rounds per rule set (default %u).\n"
+	       "  -h, --help       Display help and exit.\n\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname), DEFAULT_ROUNDS);
+}
+
+static void parse_args(int argc, char *argv[])
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"rounds", required_argument, NULL, 'r'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts =  "r:h";
+
+	global.rounds = DEFAULT_ROUNDS;
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'r':
+			global.rounds = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (global.rounds == 0)
+		global.rounds = 1;
+
+	optind = 1; /* Reset 'extern optind' from the getopt lib */
+}
+
+/* Flow which matches rule 'rule' */
+static void rule_flow(uint32_t rule, flow_t *flow)
+{
+	uint32_t id = rule / NUM_SHAPE;
+
+	flow->sip = 0xc0a80001;
+	flow->dip = 0xc0000201;
+	flow->sport = 1234;
+	flow->dport = 9;
+
+	switch (rule % NUM_SHAPE) {
+	case 0:
+		/* 10.0.0.0 + id/32, udp dport 80 */
+		flow->dip = 0x0a000000 + id;
+		flow->dport = 80;
+		break;
+	case 1:
+		/* 10.16.0.0 + id/24, udp dport 1024 + id */
+		flow->dip = 0x0a100000 + (id << 8) + 7;
+		flow->dport = 1024 + id;
+		break;
+	case 2:
+		/* sip 172.0.0.0 + id/16, dip 10.32.0.0/16 */
+		flow->sip = 0xac000000 + (id << 16) + 3;
+		flow->dip = 0x0a200005;
+		break;
+	default:
+		/* udp, sport 20000 + id, dip 10.48.0.0/16 */
+		flow->sport = 20000 + id;
+		flow->dip = 0x0a300009;
+		break;
+	}
+}
+
+static void set_term(odp_pmr_param_t *param, odp_cls_pmr_term_t term,
+		     const void *value, const void *mask, uint32_t val_sz)
+{
+	odp_cls_pmr_param_init(param);
+	param->term = term;
+	param->match.value = value;
+	param->match.mask = mask;
+	param->val_sz = val_sz;
+}
+
+static odp_pmr_t rule_create(uint32_t rule)
+{
+	odp_pmr_param_t param[3];
+	flow_t flow;
+	uint32_t dip, dip_mask, sip, sip_mask;
+	uint16_t port;
+	uint16_t port_mask = 0xffff;
+	uint8_t proto = ODPH_IPPROTO_UDP;
+	uint8_t proto_mask = 0xff;
+	int num;
+
+	rule_flow(rule, &flow);
+
+	switch (rule % NUM_SHAPE) {
+	case 0:
+		dip = flow.dip;
+		dip_mask = 0xffffffff;
+		port = flow.dport;
+		set_term(&param[0], ODP_PMR_DIP_ADDR, &dip, &dip_mask, 4);
+		set_term(&param[1], ODP_PMR_UDP_DPORT, &port, &port_mask, 2);
+		num = 2;
+		break;
+	case 1:
+		dip = flow.dip;
+		dip_mask = 0xffffff00;
+		port = flow.dport;
+		set_term(&param[0], ODP_PMR_DIP_ADDR, &dip, &dip_mask, 4);
+		set_term(&param[1], ODP_PMR_UDP_DPORT, &port, &port_mask, 2);
+		num = 2;
+		break;
+	case 2:
+		sip = flow.sip;
+		sip_mask = 0xffff0000;
+		dip = flow.dip;
+		dip_mask = 0xffff0000;
+		set_term(&param[0], ODP_PMR_SIP_ADDR, &sip, &sip_mask, 4);
+		set_term(&param[1], ODP_PMR_DIP_ADDR, &dip, &dip_mask, 4);
+		num = 2;
+		break;
+	default:
+		port = flow.sport;
+		dip = flow.dip;
+		dip_mask = 0xffff0000;
+		set_term(&param[0], ODP_PMR_IPPROTO, &proto, &proto_mask, 1);
+		set_term(&param[1], ODP_PMR_UDP_SPORT, &port, &port_mask, 2);
+		set_term(&param[2], ODP_PMR_DIP_ADDR, &dip, &dip_mask, 4);
+		num = 3;
+		break;
+	}
+
+	return odp_cls_pmr_create(param, num, global.cos[0], global.cos[1]);
+}
+
+static void packet_fill(odp_packet_t pkt, const flow_t *flow)
+{
+	uint8_t *buf = odp_packet_data(pkt);
+	odph_ethhdr_t *eth = (odph_ethhdr_t *)buf;
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(buf + ODPH_ETHHDR_LEN);
+	odph_udphdr_t *udp = (odph_udphdr_t *)(buf + ODPH_ETHHDR_LEN +
+					       ODPH_IPV4HDR_LEN);
+
+	memset(buf, 0, PKT_LEN);
+
+	eth->dst.addr[0] = 0x02;
+	eth->src.addr[0] = 0x02;
+	eth->src.addr[5] = 0x01;
+	eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4);
+
+	ip->ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip->tot_len = odp_cpu_to_be_16(PKT_LEN - ODPH_ETHHDR_LEN);
+	ip->ttl = 64;
+	ip->proto = ODPH_IPPROTO_UDP;
+	ip->src_addr = odp_cpu_to_be_32(flow->sip);
+	ip->dst_addr = odp_cpu_to_be_32(flow->dip);
+
+	udp->src_port = odp_cpu_to_be_16(flow->sport);
+	udp->dst_port = odp_cpu_to_be_16(flow->dport);
+	udp->length = odp_cpu_to_be_16(PKT_LEN - ODPH_ETHHDR_LEN -
+				       ODPH_IPV4HDR_LEN);
+
+	odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+	odph_ipv4_csum_update(pkt);
+}
+
+static int setup(void)
+{
+	odp_pool_param_t pool_param;
+	odp_pktio_param_t pktio_param;
+	odp_pktin_queue_param_t pktin_param;
+	odp_cls_cos_param_t cos_param;
+	odp_queue_param_t queue_param;
+	int i;
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type = ODP_POOL_PACKET;
+	pool_param.pkt.num = 2 * NUM_PKT;
+	pool_param.pkt.len = PKT_LEN;
+	pool_param.pkt.seg_len = PKT_LEN;
+
+	global.pool = odp_pool_create("bench_cls", &pool_param);
+	if (global.pool == ODP_POOL_INVALID) {
+		LOG_ERR("Pool create failed\n");
+		return -1;
+	}
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_QUEUE;
+
+	global.pktio = odp_pktio_open("loop", global.pool, &pktio_param);
+	if (global.pktio == ODP_PKTIO_INVALID) {
+		LOG_ERR("Pktio open failed\n");
+		return -1;
+	}
+
+	odp_pktin_queue_param_init(&pktin_param);
+	pktin_param.classifier_enable = 1;
+
+	if (odp_pktin_queue_config(global.pktio, &pktin_param) ||
+	    odp_pktout_queue_config(global.pktio, NULL)) {
+		LOG_ERR("Pktio queue config failed\n");
+		return -1;
+	}
+
+	if (odp_pktin_event_queue(global.pktio, &global.pktin_queue, 1) != 1 ||
+	    odp_pktout_queue(global.pktio, &global.pktout, 1) != 1) {
+		LOG_ERR("Pktio queues not found\n");
+		return -1;
+	}
+
+	/* Default CoS and the CoS of matching packets */
+	for (i = 0; i < 2; i++) {
+		odp_queue_param_init(&queue_param);
+		global.queue[i] = odp_queue_create(NULL, &queue_param);
+		if (global.queue[i] == ODP_QUEUE_INVALID) {
+			LOG_ERR("Queue create failed\n");
+			return -1;
+		}
+
+		odp_cls_cos_param_init(&cos_param);
+		cos_param.pool = global.pool;
+		cos_param.queue = global.queue[i];
+		global.cos[i] = odp_cls_cos_create(NULL, &cos_param);
+		if (global.cos[i] == ODP_COS_INVALID) {
+			LOG_ERR("CoS create failed\n");
+			return -1;
+		}
+	}
+
+	if (odp_pktio_default_cos_set(global.pktio, global.cos[0])) {
+		LOG_ERR("Default CoS set failed\n");
+		return -1;
+	}
+
+	if (odp_pktio_start(global.pktio)) {
+		LOG_ERR("Pktio start failed\n");
+		return -1;
+	}
+
+	if (odp_packet_alloc_multi(global.pool, PKT_LEN, global.pkt,
+				   NUM_PKT) != NUM_PKT) {
+		LOG_ERR("Packet alloc failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int term(void)
+{
+	int ret = 0;
+	int i;
+
+	odp_packet_free_multi(global.pkt, NUM_PKT);
+
+	if (global.pktio != ODP_PKTIO_INVALID) {
+		odp_pktio_stop(global.pktio);
+		if (odp_pktio_close(global.pktio))
+			ret = -1;
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (global.cos[i] != ODP_COS_INVALID &&
+		    odp_cos_destroy(global.cos[i]))
+			ret = -1;
+		if (global.queue[i] != ODP_QUEUE_INVALID &&
+		    odp_queue_destroy(global.queue[i]))
+			ret = -1;
+	}
+
+	if (global.pool != ODP_POOL_INVALID && odp_pool_destroy(global.pool))
+		ret = -1;
+
+	return ret;
+}
+
+/* Loop all packets once through the classifier. Returns number of matching
+ * packets or -1 on failure. */
+static int loop_packets(void)
+{
+	odp_event_t ev[BURST_SIZE];
+	odp_packet_t *pkt = global.pkt;
+	int sent = 0;
+	int num_rx = 0;
+	int num_match = 0;
+	int retry = 0;
+	int i, j, num;
+
+	while (sent < NUM_PKT) {
+		num = odp_pktout_send(global.pktout, &pkt[sent],
+				      NUM_PKT - sent);
+		if (num < 0)
+			return -1;
+		sent += num;
+	}
+
+	while (num_rx < NUM_PKT) {
+		/* Dequeue from the pktin queue classifies packets into
+		 * CoS queues */
+		odp_queue_deq_multi(global.pktin_queue, ev, BURST_SIZE);
+
+		for (i = 0; i < 2; i++) {
+			num = odp_queue_deq_multi(global.queue[i], ev,
+						  BURST_SIZE);
+			for (j = 0; j < num; j++)
+				pkt[num_rx++] = odp_packet_from_event(ev[j]);
+
+			if (i == 1)
+				num_match += num > 0 ? num : 0;
+		}
+
+		if (num_rx == 0 && ++retry > 1000000)
+			return -1;
+	}
+
+	return num_match;
+}
+
+static int bench_rules(uint32_t num_rule)
+{
+	flow_t flow;
+	uint64_t c1, c2, create_cycles;
+	uint32_t i, round;
+	uint32_t first = global.num_pmr;
+	int num_hit = 0;
+	int ret;
+	double cycles;
+	static double base_cycles;
+
+	c1 = odp_cpu_cycles();
+
+	for (i = global.num_pmr; i < num_rule; i++) {
+		global.pmr[i] = rule_create(i);
+		if (global.pmr[i] == ODP_PMR_INVAL) {
+			LOG_ERR("PMR create failed (rule %" PRIu32 ")\n", i);
+			return -1;
+		}
+		global.num_pmr++;
+	}
+
+	c2 = odp_cpu_cycles();
+	create_cycles = odp_cpu_cycles_diff(c2, c1);
+
+	for (i = 0; i < NUM_PKT; i++) {
+		if (num_rule == 0 || i % MISS_RATIO == 0) {
+			rule_flow(0, &flow);
+			flow.dip = 0xc0000201;
+			flow.dport = 9;
+		} else {
+			rule_flow((i * 2654435761u) % num_rule, &flow);
+			num_hit++;
+		}
+		packet_fill(global.pkt[i], &flow);
+	}
+
+	/* Warm up */
+	if (loop_packets() != num_hit) {
+		LOG_ERR("Unexpected classification result\n");
+		return -1;
+	}
+
+	c1 = odp_cpu_cycles();
+
+	for (round = 0; round < global.rounds; round++) {
+		ret = loop_packets();
+		if (ret != num_hit) {
+			LOG_ERR("Unexpected classification result: %i/%i\n",
+				ret, num_hit);
+			return -1;
+		}
+	}
+
+	c2 = odp_cpu_cycles();
+	cycles = (double)odp_cpu_cycles_diff(c2, c1) /
+		 ((uint64_t)global.rounds * NUM_PKT);
+
+	if (num_rule == 0)
+		base_cycles = cycles;
+
+	printf("  %8" PRIu32 " %12.1f %12.1f %10.1f %16.1f\n", num_rule,
+	       cycles, cycles - base_cycles, 100.0 * num_hit / NUM_PKT,
+	       num_rule > first ?
+	       (double)create_cycles / (num_rule - first) : 0.0);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	odp_instance_t instance;
+	odp_cls_capability_t capa;
+	uint32_t i, num_rule;
+	int ret = 0;
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	memset(&global, 0, sizeof(global));
+	parse_args(argc, argv);
+
+	odp_sys_info_print();
+
+	global.pool = ODP_POOL_INVALID;
+	global.pktio = ODP_PKTIO_INVALID;
+	global.queue[0] = ODP_QUEUE_INVALID;
+	global.queue[1] = ODP_QUEUE_INVALID;
+	global.cos[0] = ODP_COS_INVALID;
+	global.cos[1] = ODP_COS_INVALID;
+
+	if (odp_cls_capability(&capa)) {
+		LOG_ERR("Error: classifier capability failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (setup()) {
+		term();
+		exit(EXIT_FAILURE);
+	}
+
+	printf("Rounds per rule set: %" PRIu32 "\n", global.rounds);
+	printf("Packets per round:   %u\n\n", NUM_PKT);
+	printf("  %8s %12s %12s %10s %16s\n", "rules", "cycles/pkt",
+	       "cls cycles", "match %", "create cyc/rule");
+
+	for (i = 0; i < NUM_TEST_RULES; i++) {
+		num_rule = test_rules[i];
+
+		if (num_rule > capa.available_pmr_terms + global.num_pmr) {
+			printf("  %8" PRIu32 " not supported\n", num_rule);
+			break;
+		}
+
+		if (bench_rules(num_rule)) {
+			ret = -1;
+			break;
+		}
+	}
+
+	for (i = 0; i < global.num_pmr; i++)
+		odp_cls_pmr_destroy(global.pmr[i]);
+
+	if (term())
+		ret = -1;
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		LOG_ERR("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/* Copyright (c) 2018, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "config.h"
+
+/**
+ * @file
+ *
+ * @example odp_bench_hash.c  Microbenchmark for hash functions
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <inttypes.h>
+
+#include <test_debug.h>
+
+#include <odp_api.h>
+
+/** Maximum test data length */
+#define TEST_MAX_LEN (64 * 1024)
+
+/** Number of data bytes to hash per test length */
+#define TEST_BYTES (64 * 1024 * 1024)
+
+/** Get rid of path in filename - only for unix-type paths using '/' */
+#define NO_PATH(file_name) (strrchr((file_name), '/') ? \
+			    strrchr((file_name), '/') + 1 : (file_name))
+
+/** Test data lengths */
+static const uint32_t test_len[] = {4, 8, 13, 64, 256, 1518, 9018,
+				    TEST_MAX_LEN};
+
+/** Number of test data lengths */
+#define NUM_TEST_LEN (sizeof(test_len) / sizeof(test_len[0]))
+
+/** Data alignment offset */
+static uint32_t test_offset;
+
+/** Test data */
+static uint8_t test_data[TEST_MAX_LEN + 8];
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "OpenDataPlane hash function microbenchmark.\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "  -o, --offset     Data offset from 8 byte alignment (0-7).\n"
+	       "  -h, --help       Display help and exit.\n\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname));
+}
+
+static void parse_args(int argc, char *argv[])
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"offset", required_argument, NULL, 'o'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts =  "o:h";
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'o':
+			test_offset = atoi(optarg) & 0x7;
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1; /* Reset 'extern optind' from the getopt lib */
+}
+
+static void bench_crc32c(void)
+{
+	uint32_t i, j, len, rounds;
+	uint64_t c1, c2, cycles, nsec;
+	odp_time_t t1, t2;
+	uint32_t crc = 0;
+	const uint8_t *data = &test_data[test_offset];
+
+	printf("\nodp_hash_crc32c()\n");
+	printf("  %8s %12s %12s %12s\n", "len", "cycles/call", "cycles/byte",
+	       "MB/s");
+
+	for (i = 0; i < NUM_TEST_LEN; i++) {
+		len = test_len[i];
+		rounds = TEST_BYTES / len;
+
+		/* Warm up */
+		crc = odp_hash_crc32c(data, len, crc);
+
+		t1 = odp_time_local();
+		c1 = odp_cpu_cycles();
+
+		for (j = 0; j < rounds; j++)
+			crc = odp_hash_crc32c(data, len, crc);
+
+		c2 = odp_cpu_cycles();
+		t2 = odp_time_local();
+
+		cycles = odp_cpu_cycles_diff(c2, c1);
+		nsec = odp_time_diff_ns(t2, t1);
+
+		printf("  %8" PRIu32 " %12.1f %12.3f %12.1f\n", len,
+		       (double)cycles / rounds,
+		       (double)cycles / ((uint64_t)rounds * len),
+		       nsec ? (double)rounds * len * 1000 / nsec : 0.0);
+	}
+
+	/* Prevent compiler from removing the calls */
+	printf("\n  result 0x%08" PRIx32 "\n", crc);
+}
+
+int main(int argc, char *argv[])
+{
+	odp_instance_t instance;
+	uint32_t i;
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	parse_args(argc, argv);
+
+	odp_sys_info_print();
+
+	printf("Data offset:     %" PRIu32 "\n", test_offset);
+
+	for (i = 0; i < sizeof(test_data); i++)
+		test_data[i] = i * 131 + 7;
+
+	bench_crc32c();
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		LOG_ERR("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
@@ -13,11 +13,14 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <getopt.h>
 #include <unistd.h>
 #include <errno.h>
 #include <inttypes.h>
 #include <signal.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 
 #include <test_debug.h>
 
@@ -65,6 +68,25 @@
 /** Default burst size for *_multi operations */
 #define TEST_DEF_BURST 8
 
+/** Number of packets in the forwarding cache footprint test */
+#define TEST_FWD_NUM 256
+
+/** Number of rounds in the forwarding cache footprint test */
+#define TEST_FWD_ROUNDS 16
+
+/** Memory size used for evicting test data from CPU caches */
+#define TEST_FWD_FLUSH_SIZE (64 * 1024 * 1024)
+
+/** Number of packets in the packet parse test */
+#define TEST_PARSE_NUM TEST_REPEAT_COUNT
+
+/** Number of rounds in the packet parse test, the fastest round is
+ *  reported */
+#define TEST_PARSE_ROUNDS 100
+
+/** Burst size of the packet parse test */
+#define TEST_PARSE_BURST 32
+
 /** Get rid of path in filename - only for unix-type paths using '/' */
 #define NO_PATH(file_name) (strrchr((file_name), '/') ? \
 			    strrchr((file_name), '/') + 1 : (file_name))
@@ -88,6 +110,7 @@ const uint32_t test_packet_len[] = {WARM_UP, TEST_MIN_PKT_SIZE, 128, 256, 512,
 typedef struct {
 	int bench_idx;   /** Benchmark index to run indefinitely */
 	int burst_size;  /** Burst size for *_multi operations */
+	const char *pcap_file; /** Packets for the packet parse test */
 } appl_args_t;
 
 /**
@@ -204,6 +227,614 @@ static void run_indef(args_t *args, int idx)
 	}
 }
 
+/**
+ * Evict test data from CPU caches
+ */
+static void fwd_flush(uint8_t *mem)
+{
+	uint32_t i;
+
+	for (i = 0; i < TEST_FWD_FLUSH_SIZE; i += ODP_CACHE_LINE_SIZE)
+		mem[i]++;
+}
+
+/**
+ * Open L1 data cache load miss counter of the calling thread
+ */
+static int fwd_counter_open(void)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.type           = PERF_TYPE_HW_CACHE;
+	attr.size           = sizeof(attr);
+	attr.config         = PERF_COUNT_HW_CACHE_L1D |
+			      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.exclude_kernel = 1;
+	attr.exclude_hv     = 1;
+
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static uint64_t fwd_counter_read(int fd)
+{
+	uint64_t val;
+
+	if (fd < 0 || read(fd, &val, sizeof(val)) != sizeof(val))
+		return 0;
+
+	return val;
+}
+
+/**
+ * Forward packets as a minimal L2 forwarding application would do
+ *
+ * Receive is emulated with packet reset, which initializes the same metadata
+ * as packet input. MAC addresses are swapped and packets are freed as on
+ * packet output.
+ */
+static void fwd_packets(odp_packet_t pkt[])
+{
+	int i;
+	uint32_t sum = 0;
+
+	for (i = 0; i < TEST_FWD_NUM; i++) {
+		odph_ethhdr_t *eth;
+		odph_ethaddr_t addr;
+
+		if (odp_packet_reset(pkt[i], TEST_MIN_PKT_SIZE))
+			LOG_ABORT("Packet reset failed\n");
+
+		if (odp_unlikely(odp_packet_has_error(pkt[i])))
+			continue;
+
+		if (odp_packet_input(pkt[i]) == ODP_PKTIO_INVALID)
+			sum++;
+
+		eth = odp_packet_data(pkt[i]);
+		addr = eth->dst;
+		eth->dst = eth->src;
+		eth->src = addr;
+
+		sum += odp_packet_len(pkt[i]);
+	}
+
+	odp_packet_free_multi(pkt, TEST_FWD_NUM);
+
+	gbl_args->output_tbl[0] = sum;
+}
+
+/**
+ * Allocate packets for forwarding in a pseudo random order
+ */
+static void fwd_alloc(odp_packet_t pkt[], const uint32_t idx[])
+{
+	odp_packet_t tmp[TEST_FWD_NUM];
+	int i, num = 0;
+
+	while (num < TEST_FWD_NUM) {
+		int ret;
+
+		ret = odp_packet_alloc_multi(gbl_args->pool, TEST_MIN_PKT_SIZE,
+					     &tmp[num], TEST_FWD_NUM - num);
+		if (ret < 0)
+			LOG_ABORT("Allocating test packets failed\n");
+
+		num += ret;
+	}
+
+	for (i = 0; i < TEST_FWD_NUM; i++)
+		pkt[i] = tmp[idx[i]];
+}
+
+/**
+ * Measure cache lines touched per forwarded packet
+ *
+ * Packets are forwarded with cold CPU caches, so that every cache line
+ * read during forwarding (packet metadata, packet data, pool data) is an
+ * L1 data cache miss. Misses are counted with a perf event counter, when
+ * the platform provides one.
+ */
+static void bench_fwd_cache_lines(void)
+{
+	odp_packet_t pkt[TEST_FWD_NUM];
+	uint32_t idx[TEST_FWD_NUM];
+	uint64_t c1, c2, m1, m2;
+	uint64_t cycles = 0, misses = 0;
+	uint8_t *flush_mem;
+	uint32_t seed = 1;
+	int i, j, fd;
+
+	flush_mem = calloc(1, TEST_FWD_FLUSH_SIZE);
+
+	if (flush_mem == NULL) {
+		LOG_ERR("Cache footprint test memory alloc failed\n");
+		return;
+	}
+
+	/* Pseudo random packet order defeats hardware prefetching */
+	for (i = 0; i < TEST_FWD_NUM; i++)
+		idx[i] = i;
+
+	for (i = TEST_FWD_NUM - 1; i > 0; i--) {
+		uint32_t tmp;
+
+		seed = seed * 1103515245 + 12345;
+		j = (seed >> 16) % (i + 1);
+		tmp = idx[i];
+		idx[i] = idx[j];
+		idx[j] = tmp;
+	}
+
+	fd = fwd_counter_open();
+
+	for (i = 0; i < TEST_FWD_ROUNDS; i++) {
+		fwd_alloc(pkt, idx);
+		fwd_flush(flush_mem);
+
+		m1 = fwd_counter_read(fd);
+		c1 = odp_cpu_cycles();
+
+		fwd_packets(pkt);
+
+		c2 = odp_cpu_cycles();
+		m2 = fwd_counter_read(fd);
+
+		cycles += odp_cpu_cycles_diff(c2, c1);
+		misses += m2 - m1;
+	}
+
+	if (fd >= 0)
+		close(fd);
+
+	free(flush_mem);
+
+	printf("L2 forward cache footprint\n"
+	       "--------------------------\n");
+	printf("Cycles per forwarded packet (cold): %8.1f\n",
+	       (double)cycles / (TEST_FWD_ROUNDS * TEST_FWD_NUM));
+
+	if (fd >= 0)
+		printf("Cache lines per forwarded packet:   %8.1f\n\n",
+		       (double)misses / (TEST_FWD_ROUNDS * TEST_FWD_NUM));
+	else
+		printf("Cache lines per forwarded packet:        n/a "
+		       "(no perf event counter)\n\n");
+}
+
+/**
+ * Header flags of a packet parse test packet
+ */
+#define PARSE_VLAN  0x01
+#define PARSE_IPV6  0x02
+#define PARSE_FRAG  0x04
+#define PARSE_IPOPT 0x08
+#define PARSE_ARP   0x10
+
+/**
+ * Packet type of a packet parse test mix
+ */
+typedef struct {
+	uint8_t  hdr;    /** Header flags (PARSE_xxx) */
+	uint8_t  proto;  /** IP protocol */
+	uint16_t len;    /** Packet length */
+	uint16_t weight; /** Relative number of packets in the mix */
+} parse_pkt_t;
+
+/**
+ * Packet parse test mix
+ */
+typedef struct {
+	const char *name;
+	const parse_pkt_t *pkt;
+	int num;
+} parse_mix_t;
+
+/**
+ * Parse results of a packet
+ */
+typedef struct {
+	uint32_t flags;
+	uint32_t l2_offset;
+	uint32_t l3_offset;
+	uint32_t l4_offset;
+} parse_result_t;
+
+static const parse_pkt_t parse_udp64[] = {
+	{0, ODPH_IPPROTO_UDP, 64, 1}
+};
+
+/** IMIX packet lengths with TCP and UDP */
+static const parse_pkt_t parse_imix[] = {
+	{0, ODPH_IPPROTO_TCP, 64, 4},
+	{0, ODPH_IPPROTO_UDP, 64, 3},
+	{0, ODPH_IPPROTO_TCP, 594, 2},
+	{0, ODPH_IPPROTO_UDP, 594, 2},
+	{0, ODPH_IPPROTO_TCP, 1518, 1}
+};
+
+/** Common and exotic headers */
+static const parse_pkt_t parse_mixed[] = {
+	{0, ODPH_IPPROTO_TCP, 128, 4},
+	{PARSE_IPV6, ODPH_IPPROTO_UDP, 128, 2},
+	{PARSE_VLAN, ODPH_IPPROTO_UDP, 128, 2},
+	{PARSE_VLAN | PARSE_IPV6, ODPH_IPPROTO_TCP, 128, 1},
+	{0, ODPH_IPPROTO_ICMPV4, 98, 1},
+	{PARSE_ARP, 0, 64, 1},
+	{PARSE_FRAG, ODPH_IPPROTO_UDP, 594, 1},
+	{PARSE_IPV6 | PARSE_FRAG, ODPH_IPPROTO_UDP, 594, 1},
+	{PARSE_IPOPT, ODPH_IPPROTO_TCP, 128, 1}
+};
+
+#define PARSE_MIX(name, pkt) {name, pkt, sizeof(pkt) / sizeof(pkt[0])}
+
+static const parse_mix_t parse_mix[] = {
+	PARSE_MIX("UDP 64B", parse_udp64),
+	PARSE_MIX("IMIX TCP/UDP", parse_imix),
+	PARSE_MIX("Mixed headers", parse_mixed)
+};
+
+/** Packet flags compared between parse functions */
+static int (*const parse_flag_fn[])(odp_packet_t) = {
+	odp_packet_has_error, odp_packet_has_l2, odp_packet_has_eth,
+	odp_packet_has_eth_bcast, odp_packet_has_eth_mcast,
+	odp_packet_has_jumbo, odp_packet_has_vlan, odp_packet_has_l3,
+	odp_packet_has_arp, odp_packet_has_ipv4, odp_packet_has_ipv6,
+	odp_packet_has_ip_bcast, odp_packet_has_ip_mcast,
+	odp_packet_has_ipfrag, odp_packet_has_ipopt, odp_packet_has_ipsec,
+	odp_packet_has_l4, odp_packet_has_udp, odp_packet_has_tcp,
+	odp_packet_has_icmp
+};
+
+static void parse_put16(uint8_t *ptr, uint16_t val)
+{
+	ptr[0] = val >> 8;
+	ptr[1] = val & 0xff;
+}
+
+/**
+ * Write a test packet of the packet parse test into 'buf'
+ */
+static void parse_pkt_build(uint8_t *buf, const parse_pkt_t *pkt, uint32_t id)
+{
+	uint8_t *ptr = buf;
+	uint8_t *l3;
+	uint8_t ihl = (pkt->hdr & PARSE_IPOPT) ? 6 : 5;
+	uint8_t proto = pkt->proto;
+
+	memset(buf, 0, pkt->len);
+
+	/* Unicast MAC addresses */
+	ptr[5] = 1;
+	ptr[11] = 2;
+	ptr += 2 * ODPH_ETHADDR_LEN;
+
+	if (pkt->hdr & PARSE_VLAN) {
+		parse_put16(ptr, ODPH_ETHTYPE_VLAN);
+		parse_put16(ptr + 2, id & 0xfff);
+		ptr += ODPH_VLANHDR_LEN;
+	}
+
+	if (pkt->hdr & PARSE_ARP) {
+		parse_put16(ptr, ODPH_ETHTYPE_ARP);
+		return;
+	}
+
+	if (pkt->hdr & PARSE_IPV6) {
+		parse_put16(ptr, ODPH_ETHTYPE_IPV6);
+		l3 = ptr + 2;
+		l3[0] = 0x60;
+		parse_put16(&l3[4], pkt->len - (l3 - buf) - ODPH_IPV6HDR_LEN);
+		l3[6] = (pkt->hdr & PARSE_FRAG) ? ODPH_IPPROTO_FRAG : proto;
+		l3[7] = 64;
+		parse_put16(&l3[22], id);
+		l3[39] = 1;
+		ptr = l3 + ODPH_IPV6HDR_LEN;
+
+		if (pkt->hdr & PARSE_FRAG) {
+			/* Fragment header with the more fragments flag */
+			ptr[0] = proto;
+			ptr[3] = 1;
+			ptr += 8;
+		}
+	} else {
+		parse_put16(ptr, ODPH_ETHTYPE_IPV4);
+		l3 = ptr + 2;
+		l3[0] = 0x40 | ihl;
+		parse_put16(&l3[2], pkt->len - (l3 - buf));
+		if (pkt->hdr & PARSE_FRAG)
+			parse_put16(&l3[6], 0x2000); /* More fragments */
+		l3[8] = 64;
+		l3[9] = proto;
+		l3[12] = 10;
+		parse_put16(&l3[14], id);
+		l3[16] = 10;
+		l3[19] = 1;
+		ptr = l3 + 4 * ihl;
+	}
+
+	if (proto == ODPH_IPPROTO_TCP) {
+		parse_put16(&ptr[0], 1024 + (id & 0xff));
+		parse_put16(&ptr[2], 80);
+		ptr[12] = 0x50;
+	} else if (proto == ODPH_IPPROTO_UDP) {
+		parse_put16(&ptr[0], 1024 + (id & 0xff));
+		parse_put16(&ptr[2], 2152);
+		parse_put16(&ptr[4], pkt->len - (ptr - buf));
+	} else {
+		/* ICMP echo request */
+		ptr[0] = 8;
+	}
+}
+
+/**
+ * Read test packets of the packet parse test from a pcap file
+ *
+ * Packets are repeated when the file has less than TEST_PARSE_NUM packets.
+ * Returns the number of packets stored into 'data' and 'len'.
+ */
+static int parse_pcap_read(const char *file, uint8_t data[][TEST_MAX_PKT_SIZE],
+			   uint32_t len[])
+{
+	uint32_t hdr[6], rec[4];
+	uint32_t caplen;
+	int swap, num = 0, num_file = 0;
+	FILE *fp = fopen(file, "rb");
+
+	if (fp == NULL) {
+		LOG_ERR("Opening pcap file %s failed\n", file);
+		return 0;
+	}
+
+	if (fread(hdr, sizeof(hdr), 1, fp) != 1)
+		goto error;
+
+	/* Microsecond and nanosecond formats, in either byte order */
+	if (hdr[0] == 0xa1b2c3d4 || hdr[0] == 0xa1b23c4d)
+		swap = 0;
+	else if (hdr[0] == 0xd4c3b2a1 || hdr[0] == 0x4d3cb2a1)
+		swap = 1;
+	else
+		goto error;
+
+	while (num < TEST_PARSE_NUM) {
+		if (fread(rec, sizeof(rec), 1, fp) != 1) {
+			if (num_file == 0)
+				goto error;
+
+			/* Start again from the first packet */
+			num_file = 0;
+			if (fseek(fp, sizeof(hdr), SEEK_SET))
+				goto error;
+			continue;
+		}
+
+		caplen = swap ? __builtin_bswap32(rec[2]) : rec[2];
+
+		if (caplen < ODPH_ETHHDR_LEN || caplen > TEST_MAX_PKT_SIZE) {
+			if (fseek(fp, caplen, SEEK_CUR))
+				goto error;
+			continue;
+		}
+
+		if (fread(data[num], caplen, 1, fp) != 1)
+			goto error;
+
+		len[num++] = caplen;
+		num_file++;
+	}
+
+	fclose(fp);
+	return num;
+
+error:
+	LOG_ERR("Reading pcap file %s failed\n", file);
+	fclose(fp);
+	return 0;
+}
+
+static void parse_result(odp_packet_t pkt, parse_result_t *res)
+{
+	uint32_t i;
+
+	res->flags = 0;
+	for (i = 0; i < sizeof(parse_flag_fn) / sizeof(parse_flag_fn[0]); i++)
+		res->flags |= (parse_flag_fn[i](pkt) != 0) << i;
+
+	res->l2_offset = odp_packet_l2_offset(pkt);
+	res->l3_offset = odp_packet_l3_offset(pkt);
+	res->l4_offset = odp_packet_l4_offset(pkt);
+}
+
+/**
+ * Parse packets one by one, returns cycles per packet
+ */
+static double parse_single(odp_packet_t pkt[], int num,
+			   const odp_packet_parse_param_t *param)
+{
+	uint64_t c1, c2;
+	int i;
+
+	c1 = odp_cpu_cycles();
+
+	for (i = 0; i < num; i++)
+		(void)odp_packet_parse(pkt[i], 0, param);
+
+	c2 = odp_cpu_cycles();
+
+	return (double)odp_cpu_cycles_diff(c2, c1) / num;
+}
+
+/**
+ * Parse packets in bursts, returns cycles per packet
+ */
+static double parse_multi(odp_packet_t pkt[], int num,
+			  const odp_packet_parse_param_t *param)
+{
+	static const uint32_t offset[TEST_PARSE_BURST];
+	uint64_t c1, c2;
+	int i, n, ret;
+
+	c1 = odp_cpu_cycles();
+
+	for (i = 0; i < num; i += ret) {
+		n = num - i;
+		if (n > TEST_PARSE_BURST)
+			n = TEST_PARSE_BURST;
+
+		ret = odp_packet_parse_multi(&pkt[i], offset, n, param);
+
+		/* Skip a packet with parse errors */
+		if (ret < n)
+			ret++;
+	}
+
+	c2 = odp_cpu_cycles();
+
+	return (double)odp_cpu_cycles_diff(c2, c1) / num;
+}
+
+/**
+ * Shuffle packet table into a pseudo random order
+ */
+static void parse_shuffle(odp_packet_t pkt[], int num, uint32_t *seed)
+{
+	odp_packet_t tmp;
+	int i, j;
+
+	for (i = num - 1; i > 0; i--) {
+		*seed = *seed * 1103515245 + 12345;
+		j = (*seed >> 16) % (i + 1);
+		tmp = pkt[i];
+		pkt[i] = pkt[j];
+		pkt[j] = tmp;
+	}
+}
+
+/**
+ * Compare single and burst parsing of test packets stored in data_tbl
+ */
+static void parse_run(const char *name, const uint32_t len[], int num)
+{
+	odp_packet_t *pkt = gbl_args->pkt_tbl;
+	odp_packet_t tbl[TEST_PARSE_NUM];
+	parse_result_t res[TEST_PARSE_NUM];
+	parse_result_t res_multi;
+	odp_packet_parse_param_t param;
+	double single, multi, cycles;
+	uint32_t seed = 1;
+	int i, r, diff = 0;
+
+	for (i = 0; i < num; i++) {
+		pkt[i] = odp_packet_alloc(gbl_args->pool, len[i]);
+
+		if (pkt[i] == ODP_PACKET_INVALID ||
+		    odp_packet_copy_from_mem(pkt[i], 0, len[i],
+					     gbl_args->data_tbl[i]))
+			LOG_ABORT("Creating parse test packets failed\n");
+	}
+
+	memset(&param, 0, sizeof(param));
+	param.proto = ODP_PROTO_ETH;
+	param.last_layer = ODP_PROTO_LAYER_ALL;
+
+	memcpy(tbl, pkt, num * sizeof(odp_packet_t));
+
+	single = parse_single(tbl, num, &param);
+
+	for (i = 0; i < num; i++)
+		parse_result(pkt[i], &res[i]);
+
+	multi = parse_multi(tbl, num, &param);
+
+	/* Alternate between the functions to even out interference. Packet
+	 * order is changed every round, so that branch predictors cannot
+	 * learn the sequence of packet types. */
+	for (r = 1; r < TEST_PARSE_ROUNDS; r++) {
+		parse_shuffle(tbl, num, &seed);
+		cycles = parse_single(tbl, num, &param);
+		if (cycles < single)
+			single = cycles;
+
+		parse_shuffle(tbl, num, &seed);
+		cycles = parse_multi(tbl, num, &param);
+		if (cycles < multi)
+			multi = cycles;
+	}
+
+	for (i = 0; i < num; i++) {
+		parse_result(pkt[i], &res_multi);
+		if (memcmp(&res[i], &res_multi, sizeof(res_multi)))
+			diff++;
+	}
+
+	printf("%-20s %16.1f %16.1f", name, single, multi);
+
+	if (diff) {
+		printf("   %i packets differ\n", diff);
+		gbl_args->bench_failed = 1;
+	} else {
+		printf("\n");
+	}
+
+	odp_packet_free_multi(pkt, num);
+}
+
+/**
+ * Compare odp_packet_parse() and odp_packet_parse_multi() on packet mixes
+ *
+ * Packets of a mix are stored in a pseudo random order, so that the order of
+ * packet types is not predictable. Results of both functions must be equal.
+ */
+static void bench_parse(void)
+{
+	uint32_t len[TEST_PARSE_NUM];
+	uint32_t seed = 1;
+	int i, j, k, m, num;
+
+	printf("Packet parse (cycles per packet)\n"
+	       "--------------------------------\n");
+	printf("%-20s %16s %16s\n", "Packet mix", "single", "burst");
+
+	for (m = 0; m < (int)(sizeof(parse_mix) / sizeof(parse_mix[0])); m++) {
+		const parse_mix_t *mix = &parse_mix[m];
+		const parse_pkt_t *type[TEST_PARSE_NUM];
+
+		for (i = 0; i < TEST_PARSE_NUM;)
+			for (j = 0; j < mix->num; j++)
+				for (k = 0; k < mix->pkt[j].weight &&
+				     i < TEST_PARSE_NUM; k++)
+					type[i++] = &mix->pkt[j];
+
+		for (i = TEST_PARSE_NUM - 1; i > 0; i--) {
+			const parse_pkt_t *tmp;
+
+			seed = seed * 1103515245 + 12345;
+			j = (seed >> 16) % (i + 1);
+			tmp = type[i];
+			type[i] = type[j];
+			type[j] = tmp;
+		}
+
+		for (i = 0; i < TEST_PARSE_NUM; i++) {
+			parse_pkt_build(gbl_args->data_tbl[i], type[i], i);
+			len[i] = type[i]->len;
+		}
+
+		parse_run(mix->name, len, TEST_PARSE_NUM);
+	}
+
+	if (gbl_args->appl.pcap_file) {
+		num = parse_pcap_read(gbl_args->appl.pcap_file,
+				      gbl_args->data_tbl, len);
+		if (num)
+			parse_run(NO_PATH(gbl_args->appl.pcap_file), len, num);
+	}
+
+	printf("\n");
+}
+
 /**
  * Master function for running the microbenchmarks
  */
@@ -301,6 +932,10 @@ static int run_benchmarks(void *arg)
 			printf("%8.1f  ", results[i][j]);
 	}
 	printf("\n\n");
+
+	bench_fwd_cache_lines();
+	bench_parse();
+
 	return 0;
 }
 
@@ -1292,6 +1927,8 @@ static void usage(char *progname)
 	       "\n"
 	       "Optional OPTIONS:\n"
 	       "  -b, --burst      Test packet burst size.\n"
+	       "  -f, --pcap       Pcap file of packets for the packet parse\n"
+	       "                   test, in addition to built-in mixes.\n"
 	       "  -i, --index      Benchmark index to run indefinitely.\n"
 	       "  -h, --help       Display help and exit.\n\n"
 	       "\n", NO_PATH(progname), NO_PATH(progname));
@@ -1310,12 +1947,13 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 	int long_index;
 	static const struct option longopts[] = {
 		{"burst", required_argument, NULL, 'b'},
+		{"pcap", required_argument, NULL, 'f'},
 		{"help", no_argument, NULL, 'h'},
 		{"index", required_argument, NULL, 'i'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts =  "b:i:h";
+	static const char *shortopts =  "b:f:i:h";
 
 	/* Let helper collect its own arguments (e.g. --odph_proc) */
 	odph_parse_options(argc, argv, shortopts, longopts);
@@ -1324,6 +1962,7 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 
 	appl_args->bench_idx = 0; /* Run all benchmarks */
 	appl_args->burst_size = TEST_DEF_BURST;
+	appl_args->pcap_file = NULL;
 
 	while (1) {
 		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
@@ -1335,6 +1974,9 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		case 'b':
 			appl_args->burst_size = atoi(optarg);
 			break;
+		case 'f':
+			appl_args->pcap_file = optarg;
+			break;
 		case 'h':
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -28,7 +28,12 @@
 /** @def POOL_NUM_PKT
  * Number of packets in the pool
  */
-#define POOL_NUM_PKT  64
+#define POOL_NUM_PKT  128
+
+/** @def MAX_BURST
+ * Maximum number of packets per crypto operation call
+ */
+#define MAX_BURST 32
 
 static uint8_t test_iv[16] = "0123456789abcdef";
 
@@ -91,6 +96,12 @@ typedef struct {
 	 */
 	int in_flight;
 
+	/**
+	 * Number of packets passed to one odp_crypto_op() or
+	 * odp_crypto_op_enq() call. Specified through -b or --burst option.
+	 */
+	int burst;
+
 	/**
 	 * Number of iteration to repeat crypto operation to get good
 	 * average number. Specified through -i or --terations option.
@@ -172,8 +183,11 @@ static void usage(char *progname);
 static unsigned int payloads[] = {
 	16,
 	64,
+	128,
 	256,
+	512,
 	1024,
+	1504,
 	8192,
 	16384
 };
@@ -547,6 +561,55 @@ make_packet(odp_pool_t pkt_pool, unsigned int payload_length)
 	return pkt;
 }
 
+/**
+ * Receive all available completion events. Returns the number of packets
+ * received.
+ */
+static int
+receive_packets(crypto_args_t *cargs,
+		crypto_alg_config_t *config,
+		odp_queue_t out_queue,
+		unsigned int payload_length,
+		odp_packet_t *reuse_pkt)
+{
+	odp_event_t ev[MAX_BURST];
+	odp_crypto_packet_result_t result;
+	odp_packet_t out_pkt;
+	void *mem;
+	int num, i;
+	int received = 0;
+
+	do {
+		if (cargs->schedule)
+			num = odp_schedule_multi(NULL, ODP_SCHED_NO_WAIT,
+						 ev, MAX_BURST);
+		else
+			num = odp_queue_deq_multi(out_queue, ev, MAX_BURST);
+
+		for (i = 0; i < num; i++) {
+			out_pkt = odp_crypto_packet_from_event(ev[i]);
+			odp_crypto_result(&result, out_pkt);
+
+			if (cargs->debug_packets) {
+				mem = odp_packet_data(out_pkt);
+				print_mem("Received encrypted packet",
+					  mem,
+					  payload_length +
+					  config->session.auth_digest_len);
+			}
+			if (cargs->reuse_packet)
+				*reuse_pkt = out_pkt;
+			else
+				odp_packet_free(out_pkt);
+		}
+
+		if (num > 0)
+			received += num;
+	} while (num > 0);
+
+	return received;
+}
+
 /**
  * Run measurement iterations for given config and payload size.
  * Result of run returned in 'result' out parameter.
@@ -558,12 +621,13 @@ run_measure_one(crypto_args_t *cargs,
 		unsigned int payload_length,
 		crypto_run_result_t *result)
 {
-	odp_crypto_packet_op_param_t params;
+	odp_crypto_packet_op_param_t params[MAX_BURST];
 
 	odp_pool_t pkt_pool;
 	odp_queue_t out_queue;
-	odp_packet_t pkt = ODP_PACKET_INVALID;
+	odp_packet_t pkt[MAX_BURST];
 	int rc = 0;
+	int i;
 
 	pkt_pool = odp_pool_lookup("packet_pool");
 	if (pkt_pool == ODP_POOL_INVALID) {
@@ -580,8 +644,8 @@ run_measure_one(crypto_args_t *cargs,
 	}
 
 	if (cargs->reuse_packet) {
-		pkt = make_packet(pkt_pool, payload_length);
-		if (ODP_PACKET_INVALID == pkt)
+		pkt[0] = make_packet(pkt_pool, payload_length);
+		if (ODP_PACKET_INVALID == pkt[0])
 			return -1;
 	}
 
@@ -591,114 +655,103 @@ run_measure_one(crypto_args_t *cargs,
 
 	/* Initialize parameters block */
 	memset(&params, 0, sizeof(params));
-	params.session = *session;
+	for (i = 0; i < MAX_BURST; i++) {
+		params[i].session = *session;
 
-	params.cipher_range.offset = 0;
-	params.cipher_range.length = payload_length;
+		params[i].cipher_range.offset = 0;
+		params[i].cipher_range.length = payload_length;
 
-	params.auth_range.offset = 0;
-	params.auth_range.length = payload_length;
-	params.hash_result_offset = payload_length;
+		params[i].auth_range.offset = 0;
+		params[i].auth_range.length = payload_length;
+		params[i].hash_result_offset = payload_length;
+	}
 
 	fill_time_record(&start);
 
 	while ((packets_sent < cargs->iteration_count) ||
 	       (packets_received <  cargs->iteration_count)) {
 		void *mem;
+		int num = cargs->burst;
+
+		if (num > cargs->iteration_count - packets_sent)
+			num = cargs->iteration_count - packets_sent;
 
 		if ((packets_sent < cargs->iteration_count) &&
-		    (packets_sent - packets_received <
+		    (packets_sent - packets_received + num <=
 		     cargs->in_flight)) {
-			odp_packet_t out_pkt;
-
-			if (!cargs->reuse_packet) {
-				pkt = make_packet(pkt_pool, payload_length);
-				if (ODP_PACKET_INVALID == pkt)
-					return -1;
-			}
+			odp_packet_t out_pkt[MAX_BURST];
+
+			for (i = 0; i < num; i++) {
+				if (!cargs->reuse_packet) {
+					pkt[i] = make_packet(pkt_pool,
+							     payload_length);
+					if (ODP_PACKET_INVALID == pkt[i]) {
+						odp_packet_free_multi(pkt, i);
+						return -1;
+					}
+				}
 
-			out_pkt = cargs->in_place ? pkt : ODP_PACKET_INVALID;
+				out_pkt[i] = cargs->in_place ? pkt[i] :
+					     ODP_PACKET_INVALID;
 
-			if (cargs->debug_packets) {
-				mem = odp_packet_data(pkt);
-				print_mem("Packet before encryption:",
-					  mem, payload_length);
+				if (cargs->debug_packets) {
+					mem = odp_packet_data(pkt[i]);
+					print_mem("Packet before encryption:",
+						  mem, payload_length);
+				}
 			}
 
 			if (cargs->schedule || cargs->poll) {
-				rc = odp_crypto_op_enq(&pkt, &out_pkt,
-						       &params, 1);
+				rc = odp_crypto_op_enq(pkt, out_pkt,
+						       params, num);
 				if (rc <= 0) {
 					app_err("failed odp_crypto_packet_op_enq: rc = %d\n",
 						rc);
 					if (!cargs->reuse_packet)
-						odp_packet_free(pkt);
+						odp_packet_free_multi(pkt, num);
 					break;
 				}
+				if (rc < num && !cargs->reuse_packet)
+					odp_packet_free_multi(&pkt[rc],
+							      num - rc);
 				packets_sent += rc;
 			} else {
-				rc = odp_crypto_op(&pkt, &out_pkt,
-						   &params, 1);
+				rc = odp_crypto_op(pkt, out_pkt,
+						   params, num);
 				if (rc <= 0) {
 					app_err("failed odp_crypto_packet_op: rc = %d\n",
 						rc);
 					if (!cargs->reuse_packet)
-						odp_packet_free(pkt);
+						odp_packet_free_multi(pkt, num);
 					break;
 				}
+				if (rc < num && !cargs->reuse_packet)
+					odp_packet_free_multi(&pkt[rc],
+							      num - rc);
 				packets_sent += rc;
-				packets_received++;
-				if (cargs->debug_packets) {
-					mem = odp_packet_data(out_pkt);
+				packets_received += rc;
+				for (i = 0; cargs->debug_packets && i < rc;
+				     i++) {
+					mem = odp_packet_data(out_pkt[i]);
 					print_mem("Immediately encrypted "
-						   "packet",
+						  "packet",
 						  mem,
 						  payload_length +
 						  config->session.
 						   auth_digest_len);
 				}
 				if (cargs->reuse_packet)
-					pkt = out_pkt;
+					pkt[0] = out_pkt[0];
 				else
-					odp_packet_free(out_pkt);
+					odp_packet_free_multi(out_pkt, rc);
 			}
 		}
 
-		if (cargs->schedule || cargs->poll) {
-			odp_event_t ev;
-			odp_crypto_packet_result_t result;
-			odp_packet_t out_pkt;
-
-			if (cargs->schedule)
-				ev = odp_schedule(NULL,
-						  ODP_SCHED_NO_WAIT);
-			else
-				ev = odp_queue_deq(out_queue);
-
-			while (ev != ODP_EVENT_INVALID) {
-				out_pkt = odp_crypto_packet_from_event(ev);
-				odp_crypto_result(&result, out_pkt);
-
-				if (cargs->debug_packets) {
-					mem = odp_packet_data(out_pkt);
-					print_mem("Received encrypted packet",
-						  mem,
-						  payload_length +
-						  config->
-						  session.auth_digest_len);
-				}
-				if (cargs->reuse_packet)
-					pkt = out_pkt;
-				else
-					odp_packet_free(out_pkt);
-				packets_received++;
-				if (cargs->schedule)
-					ev = odp_schedule(NULL,
-							  ODP_SCHED_NO_WAIT);
-				else
-					ev = odp_queue_deq(out_queue);
-			};
-		}
+		if (cargs->schedule || cargs->poll)
+			packets_received += receive_packets(cargs, config,
+							    out_queue,
+							    payload_length,
+							    &pkt[0]);
 	}
 
 	fill_time_record(&end);
@@ -720,7 +773,7 @@ run_measure_one(crypto_args_t *cargs,
 	}
 
 	if (cargs->reuse_packet)
-		odp_packet_free(pkt);
+		odp_packet_free(pkt[0]);
 
 	return rc < 0 ? rc : 0;
 }
@@ -932,6 +985,7 @@ static void parse_args(int argc, char *argv[], crypto_args_t *cargs)
 	int long_index;
 	static const struct option longopts[] = {
 		{"algorithm", optional_argument, NULL, 'a'},
+		{"burst", optional_argument, NULL, 'b'},
 		{"debug",  no_argument, NULL, 'd'},
 		{"flight", optional_argument, NULL, 'f'},
 		{"help", no_argument, NULL, 'h'},
@@ -945,13 +999,14 @@ static void parse_args(int argc, char *argv[], crypto_args_t *cargs)
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts = "+a:c:df:hi:m:nl:spr";
+	static const char *shortopts = "+a:b:c:df:hi:m:nl:spr";
 
 	/* let helper collect its own arguments (e.g. --odph_proc) */
 	odph_parse_options(argc, argv, shortopts, longopts);
 
 	cargs->in_place = 0;
 	cargs->in_flight = 1;
+	cargs->burst = 1;
 	cargs->debug_packets = 0;
 	cargs->iteration_count = 10000;
 	cargs->payload_length = 0;
@@ -977,6 +1032,9 @@ static void parse_args(int argc, char *argv[], crypto_args_t *cargs)
 				exit(-1);
 			}
 			break;
+		case 'b':
+			cargs->burst = atoi(optarg);
+			break;
 		case 'd':
 			cargs->debug_packets = 1;
 			break;
@@ -1025,6 +1083,21 @@ static void parse_args(int argc, char *argv[], crypto_args_t *cargs)
 		usage(argv[0]);
 		exit(-1);
 	}
+
+	if (cargs->burst < 1 || cargs->burst > MAX_BURST) {
+		printf("-b (burst) must be between 1 and %i\n", MAX_BURST);
+		usage(argv[0]);
+		exit(-1);
+	}
+
+	if ((cargs->burst > 1) && cargs->reuse_packet) {
+		printf("-b (burst > 1) and -r (reuse packet) options are not compatible\n");
+		usage(argv[0]);
+		exit(-1);
+	}
+
+	if (cargs->in_flight < cargs->burst)
+		cargs->in_flight = cargs->burst;
 }
 
 /**
@@ -1043,7 +1116,8 @@ static void usage(char *progname)
 	       progname, progname);
 
 	print_config_names("				      ");
-	printf("  -d, --debug	       Enable dump of processed packets.\n"
+	printf("  -b, --burst <number> Number of packets per crypto operation call (default 1)\n"
+	       "  -d, --debug	       Enable dump of processed packets.\n"
 	       "  -f, --flight <number> Max number of packet processed in parallel (default 1)\n"
 	       "  -i, --iterations <number> Number of iterations.\n"
 	       "  -n, --inplace	       Encrypt on place.\n"
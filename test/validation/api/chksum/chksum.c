@@ -6,6 +6,7 @@
 
 #include <odp_api.h>
 #include <odp_cunit_common.h>
+#include <string.h>
 
 #define NUM_IP_HDR   5
 #define IP_HDR_LEN   20
@@ -313,10 +314,46 @@ static void chksum_ones_complement_udp_long(void)
 	CU_ASSERT(res == UDP_LONG_CHKSUM);
 }
 
+/* Test ones complement sum against a reference 16-bit word sum with various
+ * lengths and data alignments */
+static void chksum_ones_complement_len_align(void)
+{
+	uint8_t ODP_ALIGNED(32) data[2 * MAX_UDP_LEN + 4];
+	uint32_t i, len, align;
+	uint32_t ref;
+	uint16_t word;
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = 0xff - (i * 7);
+
+	for (align = 0; align < 4; align++) {
+		for (len = 0; len <= 2 * MAX_UDP_LEN; len++) {
+			ref = 0;
+			for (i = 0; i + 1 < len; i += 2) {
+				memcpy(&word, &data[align + i], 2);
+				ref += word;
+			}
+
+			if (len & 1) {
+				word = 0;
+				memcpy(&word, &data[align + len - 1], 1);
+				ref += word;
+			}
+
+			while (ref >> 16)
+				ref = (ref & 0xffff) + (ref >> 16);
+
+			CU_ASSERT(odp_chksum_ones_comp16(&data[align], len) ==
+				  ref);
+		}
+	}
+}
+
 odp_testinfo_t chksum_suite[] = {
 	ODP_TEST_INFO(chksum_ones_complement_ip),
 	ODP_TEST_INFO(chksum_ones_complement_udp),
 	ODP_TEST_INFO(chksum_ones_complement_udp_long),
+	ODP_TEST_INFO(chksum_ones_complement_len_align),
 	ODP_TEST_INFO_NULL,
 };
 
@@ -11,11 +11,23 @@
 #include <odp_cunit_common.h>
 #include "test_vectors.h"
 
+#include <stdlib.h>
+
 #define MAX_ALG_CAPA 32
 
 #define PKT_POOL_NUM  64
 #define PKT_POOL_LEN  (1 * 1024)
 
+/* Session tests */
+#define SES_THREADS      4
+#define SES_CHURN_ROUNDS 8
+#define SES_CHURN_NUM    300
+#define SES_EXHAUST_MAX  (64 * 1024)
+#define SES_CACHE_NUM    32
+
+/* Packets per odp_crypto_op() call in burst tests */
+#define BURST_NUM 8
+
 struct suite_context_s {
 	odp_bool_t packet;
 	odp_crypto_op_mode_t op_mode;
@@ -26,6 +38,12 @@ struct suite_context_s {
 
 static struct suite_context_s suite_context;
 
+/* Shared between session test threads */
+static struct {
+	odp_barrier_t barrier;
+	odp_atomic_u32_t errors;
+} ses_global;
+
 static int packet_cmp_mem(odp_packet_t pkt, uint32_t offset,
 			  void *s, uint32_t len)
 {
@@ -1114,6 +1132,345 @@ static void crypto_test_check_alg_aes_gmac(void)
 		  false);
 }
 
+/* Create a SYNC encode session with the cipher key of the reference. Session
+ * IV is the IV of the reference, or not set when operations override it. */
+static odp_crypto_session_t session_create_ref(odp_cipher_alg_t cipher_alg,
+					       crypto_test_reference_t *ref,
+					       odp_bool_t ovr_iv)
+{
+	odp_crypto_session_t session;
+	odp_crypto_session_param_t ses_params;
+	odp_crypto_ses_create_err_t status;
+	odp_crypto_key_t cipher_key = {
+		.data = ref->cipher_key,
+		.length = ref->cipher_key_length
+	};
+	odp_crypto_iv_t iv = {
+		.data = ovr_iv ? NULL : ref->iv,
+		.length = ref->iv_length
+	};
+
+	odp_crypto_session_param_init(&ses_params);
+	ses_params.op = ODP_CRYPTO_OP_ENCODE;
+	ses_params.op_mode = ODP_CRYPTO_SYNC;
+	ses_params.cipher_alg = cipher_alg;
+	ses_params.auth_alg = ODP_AUTH_ALG_NULL;
+	ses_params.output_pool = suite_context.pool;
+	ses_params.cipher_key = cipher_key;
+	ses_params.iv = iv;
+
+	if (odp_crypto_session_create(&ses_params, &session, &status))
+		return ODP_CRYPTO_SESSION_INVALID;
+
+	return session;
+}
+
+/* Encode the reference plaintext and compare the result to the reference
+ * ciphertext. Returns 0 on match. */
+static int session_op_check(odp_crypto_session_t session,
+			    crypto_test_reference_t *ref)
+{
+	odp_crypto_packet_op_param_t op_params;
+	odp_crypto_packet_result_t result;
+	odp_packet_t pkt;
+	int ret = -1;
+
+	pkt = odp_packet_alloc(suite_context.pool, ref->length);
+	if (pkt == ODP_PACKET_INVALID)
+		return -1;
+
+	odp_packet_copy_from_mem(pkt, 0, ref->length, ref->plaintext);
+
+	memset(&op_params, 0, sizeof(op_params));
+	op_params.session = session;
+	op_params.cipher_range.offset = 0;
+	op_params.cipher_range.length = ref->length;
+
+	if (odp_crypto_op(&pkt, &pkt, &op_params, 1) == 1 &&
+	    odp_crypto_result(&result, pkt) == 0 && result.ok &&
+	    !packet_cmp_mem(pkt, 0, ref->ciphertext, ref->length))
+		ret = 0;
+
+	odp_packet_free(pkt);
+
+	return ret;
+}
+
+/* A freed session index is reused with different keys. Contexts of the
+ * thread must not use the keys of the freed session. */
+static void crypto_test_session_versions(void)
+{
+	odp_crypto_session_t session;
+	crypto_test_reference_t *ref;
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		ref = &aes_cbc_reference[i % 2];
+
+		session = session_create_ref(ODP_CIPHER_ALG_AES_CBC, ref,
+					     false);
+		CU_ASSERT_FATAL(session != ODP_CRYPTO_SESSION_INVALID);
+
+		CU_ASSERT(session_op_check(session, ref) == 0);
+		CU_ASSERT(session_op_check(session, ref) == 0);
+
+		CU_ASSERT(odp_crypto_session_destroy(session) == 0);
+	}
+}
+
+static int session_churn_thread(void *arg ODP_UNUSED)
+{
+	odp_crypto_session_t session[SES_CHURN_NUM];
+	crypto_test_reference_t *ref;
+	int round, i, num;
+	uint32_t errors = 0;
+
+	for (round = 0; round < SES_CHURN_ROUNDS; round++) {
+		for (num = 0; num < SES_CHURN_NUM; num++) {
+			odp_crypto_session_t ses;
+
+			ref = &aes_cbc_reference[(num + round) % 2];
+			ses = session_create_ref(ODP_CIPHER_ALG_AES_CBC, ref,
+						 false);
+			session[num] = ses;
+			if (ses == ODP_CRYPTO_SESSION_INVALID) {
+				errors++;
+				break;
+			}
+		}
+
+		/* More sessions than context slots, alternate between them */
+		for (i = 0; i < 2 * num; i++) {
+			int idx = i < num ? i : 2 * num - 1 - i;
+
+			ref = &aes_cbc_reference[(idx + round) % 2];
+			if (session_op_check(session[idx], ref))
+				errors++;
+		}
+
+		for (i = 0; i < num; i++)
+			if (odp_crypto_session_destroy(session[i]))
+				errors++;
+	}
+
+	odp_atomic_add_u32(&ses_global.errors, errors);
+
+	return 0;
+}
+
+/* Threads create, use and destroy sessions concurrently. Session indexes
+ * move between threads with different keys. */
+static void crypto_test_session_churn(void)
+{
+	pthrd_arg thrdarg;
+	odp_cpumask_t mask;
+
+	odp_atomic_init_u32(&ses_global.errors, 0);
+
+	thrdarg.numthrds = odp_cpumask_default_worker(&mask, SES_THREADS);
+	CU_ASSERT_FATAL(thrdarg.numthrds > 0);
+
+	odp_cunit_thread_create(session_churn_thread, &thrdarg);
+	CU_ASSERT(odp_cunit_thread_exit(&thrdarg) == 0);
+
+	CU_ASSERT(odp_atomic_load_u32(&ses_global.errors) == 0);
+}
+
+static int session_cache_thread(void *arg ODP_UNUSED)
+{
+	odp_crypto_session_t session[SES_CACHE_NUM];
+	int i, num;
+
+	/* Leave free sessions into the session cache of this thread */
+	for (num = 0; num < SES_CACHE_NUM; num++) {
+		session[num] = session_create_ref(ODP_CIPHER_ALG_AES_CBC,
+						  &aes_cbc_reference[0], false);
+		if (session[num] == ODP_CRYPTO_SESSION_INVALID)
+			break;
+	}
+
+	for (i = 0; i < num; i++)
+		odp_crypto_session_destroy(session[i]);
+
+	/* Main thread allocates all sessions */
+	odp_barrier_wait(&ses_global.barrier);
+	odp_barrier_wait(&ses_global.barrier);
+
+	return 0;
+}
+
+/* All sessions can be created, also those freed by another thread which is
+ * still running */
+static void crypto_test_session_exhaust(void)
+{
+	odp_crypto_capability_t capa;
+	odp_crypto_session_t *session;
+	pthrd_arg thrdarg;
+	uint32_t i, num;
+
+	CU_ASSERT_FATAL(odp_crypto_capability(&capa) == 0);
+	CU_ASSERT_FATAL(capa.max_sessions > 0);
+
+	if (capa.max_sessions > SES_EXHAUST_MAX) {
+		printf("\n    Too many sessions: %" PRIu32 "\n",
+		       capa.max_sessions);
+		return;
+	}
+
+	session = malloc((capa.max_sessions + 1) * sizeof(*session));
+	CU_ASSERT_FATAL(session != NULL);
+
+	odp_barrier_init(&ses_global.barrier, 2);
+	thrdarg.numthrds = 1;
+	odp_cunit_thread_create(session_cache_thread, &thrdarg);
+
+	odp_barrier_wait(&ses_global.barrier);
+
+	for (num = 0; num < capa.max_sessions + 1; num++) {
+		session[num] = session_create_ref(ODP_CIPHER_ALG_AES_CBC,
+						  &aes_cbc_reference[0], false);
+		if (session[num] == ODP_CRYPTO_SESSION_INVALID)
+			break;
+	}
+
+	CU_ASSERT(num == capa.max_sessions);
+
+	/* Last session is usable */
+	if (num)
+		CU_ASSERT(session_op_check(session[num - 1],
+					   &aes_cbc_reference[0]) == 0);
+
+	for (i = 0; i < num; i++)
+		CU_ASSERT(odp_crypto_session_destroy(session[i]) == 0);
+
+	odp_barrier_wait(&ses_global.barrier);
+	CU_ASSERT(odp_cunit_thread_exit(&thrdarg) == 0);
+
+	free(session);
+}
+
+/* Encode bursts of packets with one odp_crypto_op() call. Packets alternate
+ * between the session IV and an override IV, and encode prefixes of
+ * different length of the reference plain text. In CBC mode, cipher text of
+ * a prefix is a prefix of the reference cipher text. The last packet has a
+ * partial block, which fails without affecting other packets. */
+static void crypto_test_enc_burst(odp_cipher_alg_t cipher_alg,
+				  crypto_test_reference_t ref[], size_t count,
+				  uint32_t block_len)
+{
+	odp_crypto_packet_op_param_t param[BURST_NUM];
+	odp_crypto_packet_result_t result;
+	odp_crypto_session_t session;
+	odp_packet_t pkt[BURST_NUM];
+	uint32_t len[BURST_NUM];
+	uint8_t iv[MAX_IV_LEN];
+	uint8_t *plain;
+	size_t idx;
+	int ovr_iv, i, num;
+
+	for (idx = 0; idx < count; idx++) {
+		uint32_t blocks = ref[idx].length / block_len;
+
+		/* Override IV is read from a separate buffer */
+		memcpy(iv, ref[idx].iv, ref[idx].iv_length);
+
+		for (ovr_iv = 0; ovr_iv < 2; ovr_iv++) {
+			session = session_create_ref(cipher_alg, &ref[idx],
+						     ovr_iv);
+			CU_ASSERT_FATAL(session != ODP_CRYPTO_SESSION_INVALID);
+
+			for (i = 0; i < BURST_NUM; i++) {
+				if (i == BURST_NUM - 1)
+					len[i] = ref[idx].length - 1;
+				else
+					len[i] = block_len *
+						 (1 + (i % blocks));
+
+				pkt[i] = odp_packet_alloc(suite_context.pool,
+							  ref[idx].length);
+				CU_ASSERT_FATAL(pkt[i] != ODP_PACKET_INVALID);
+				odp_packet_copy_from_mem(pkt[i], 0,
+							 ref[idx].length,
+							 ref[idx].plaintext);
+
+				memset(&param[i], 0, sizeof(param[i]));
+				param[i].session = session;
+				param[i].cipher_range.offset = 0;
+				param[i].cipher_range.length = len[i];
+				if (ovr_iv || i % 2)
+					param[i].override_iv_ptr = iv;
+			}
+
+			num = odp_crypto_op(pkt, pkt, param, BURST_NUM);
+			CU_ASSERT(num == BURST_NUM);
+
+			for (i = 0; i < num; i++) {
+				CU_ASSERT(odp_crypto_result(&result,
+							    pkt[i]) == 0);
+
+				if (i == BURST_NUM - 1) {
+					CU_ASSERT(!result.ok);
+					continue;
+				}
+
+				CU_ASSERT(result.ok);
+				CU_ASSERT(!packet_cmp_mem(pkt[i], 0,
+							  ref[idx].ciphertext,
+							  len[i]));
+
+				/* Data after the cipher range is intact */
+				plain = &ref[idx].plaintext[len[i]];
+				CU_ASSERT(!packet_cmp_mem(pkt[i], len[i], plain,
+							  ref[idx].length -
+							  len[i]));
+			}
+
+			for (i = 0; i < BURST_NUM; i++)
+				odp_packet_free(pkt[i]);
+
+			CU_ASSERT(odp_crypto_session_destroy(session) == 0);
+		}
+	}
+}
+
+static void crypto_test_enc_alg_3des_cbc_burst(void)
+{
+	crypto_test_enc_burst(ODP_CIPHER_ALG_3DES_CBC, tdes_cbc_reference,
+			      ARRAY_SIZE(tdes_cbc_reference), 8);
+}
+
+static void crypto_test_enc_alg_aes_cbc_burst(void)
+{
+	crypto_test_enc_burst(ODP_CIPHER_ALG_AES_CBC, aes_cbc_reference,
+			      ARRAY_SIZE(aes_cbc_reference), 16);
+}
+
+static void crypto_test_stats(void)
+{
+	odp_crypto_stats_t stats;
+
+	CU_ASSERT_FATAL(odp_crypto_stats(&stats) == 0);
+
+	/* All completions have been received */
+	CU_ASSERT(stats.queue_depth == 0);
+	CU_ASSERT(stats.compl_drop == 0);
+	CU_ASSERT(stats.queue_depth_max <= stats.ops);
+	CU_ASSERT(stats.batches <= stats.ops);
+	CU_ASSERT(stats.batch_max <= stats.ops);
+	CU_ASSERT(stats.latency_avg_ns <= stats.latency_max_ns);
+
+	if (stats.num_threads == 0) {
+		CU_ASSERT(stats.ops == 0);
+		CU_ASSERT(stats.batches == 0);
+	} else if (suite_context.packet &&
+		   suite_context.op_mode == ODP_CRYPTO_ASYNC) {
+		CU_ASSERT(stats.ops > 0);
+		CU_ASSERT(stats.batches > 0);
+	}
+
+	odp_crypto_print();
+}
+
 static int crypto_suite_sync_init(void)
 {
 	suite_context.pool = odp_pool_lookup("packet_pool");
@@ -1223,6 +1580,25 @@ odp_testinfo_t crypto_suite[] = {
 				  check_alg_aes_gmac),
 	ODP_TEST_INFO_CONDITIONAL(crypto_test_check_alg_aes_gmac,
 				  check_alg_aes_gmac),
+	ODP_TEST_INFO(crypto_test_stats),
+	ODP_TEST_INFO_NULL,
+};
+
+odp_testinfo_t crypto_session_suite[] = {
+	ODP_TEST_INFO_CONDITIONAL(crypto_test_session_versions,
+				  check_alg_aes_cbc),
+	ODP_TEST_INFO_CONDITIONAL(crypto_test_session_churn,
+				  check_alg_aes_cbc),
+	ODP_TEST_INFO_CONDITIONAL(crypto_test_session_exhaust,
+				  check_alg_aes_cbc),
+	ODP_TEST_INFO_NULL,
+};
+
+odp_testinfo_t crypto_burst_suite[] = {
+	ODP_TEST_INFO_CONDITIONAL(crypto_test_enc_alg_3des_cbc_burst,
+				  check_alg_3des_cbc),
+	ODP_TEST_INFO_CONDITIONAL(crypto_test_enc_alg_aes_cbc_burst,
+				  check_alg_aes_cbc),
 	ODP_TEST_INFO_NULL,
 };
 
@@ -1249,6 +1625,8 @@ static int crypto_suite_term(void)
 #define ODP_CRYPTO_ASYNC_INP        "odp_crypto_async_inp"
 #define ODP_CRYPTO_PACKET_SYNC_INP  "odp_crypto_packet_sync_inp"
 #define ODP_CRYPTO_PACKET_ASYNC_INP "odp_crypto_packet_async_inp"
+#define ODP_CRYPTO_SESSIONS         "odp_crypto_sessions"
+#define ODP_CRYPTO_PACKET_BURST     "odp_crypto_packet_burst"
 
 odp_suiteinfo_t crypto_suites[] = {
 	{ODP_CRYPTO_SYNC_INP, crypto_suite_sync_init,
@@ -1259,6 +1637,10 @@ odp_suiteinfo_t crypto_suites[] = {
 	 crypto_suite_term, crypto_suite},
 	{ODP_CRYPTO_PACKET_ASYNC_INP, crypto_suite_packet_async_init,
 	 crypto_suite_term, crypto_suite},
+	{ODP_CRYPTO_SESSIONS, crypto_suite_packet_sync_init,
+	 NULL, crypto_session_suite},
+	{ODP_CRYPTO_PACKET_BURST, crypto_suite_packet_sync_init,
+	 NULL, crypto_burst_suite},
 	ODP_SUITE_INFO_NULL,
 };
 
@@ -28,8 +28,30 @@ static void hash_test_crc32c(void)
 	CU_ASSERT(ret == 0xe6e910b0);
 }
 
+/* Long data is hashed in interleaved blocks. Result must match hashing
+ * the same data one 8 byte word at a time. */
+static void hash_test_crc32c_long(void)
+{
+	static uint8_t data[2 * 3 * 8192 + 3 * 256 + 40];
+	uint32_t i, len, crc, ref;
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = i * 151 + 3;
+
+	for (len = 0; len <= sizeof(data); len += 8 * 7 + 8 * (len / 64)) {
+		ref = 0x12345678;
+		for (i = 0; i < len; i += 8)
+			ref = odp_hash_crc32c(&data[i], 8, ref);
+
+		crc = odp_hash_crc32c(data, len, 0x12345678);
+
+		CU_ASSERT(crc == ref);
+	}
+}
+
 odp_testinfo_t hash_suite[] = {
 	ODP_TEST_INFO(hash_test_crc32c),
+	ODP_TEST_INFO(hash_test_crc32c_long),
 	ODP_TEST_INFO_NULL,
 };
 
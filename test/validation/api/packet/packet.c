@@ -25,6 +25,9 @@ ODP_STATIC_ASSERT(PACKET_POOL_NUM_SEG > 1 &&
 /* Number of packets in parse test */
 #define PARSE_TEST_NUM_PKT 10
 
+/* Number of packets in mixed packet type parse test */
+#define PARSE_TEST_MIXED_NUM_PKT 40
+
 static odp_pool_t packet_pool, packet_pool_no_uarea, packet_pool_double_uarea;
 static uint32_t packet_len;
 
@@ -3256,6 +3259,130 @@ static void parse_eth_ipv4_rr_nop_icmp(void)
 	odp_packet_free_multi(pkt, num_pkt);
 }
 
+/* Compare parse results of two packets */
+static void parse_result_compare(odp_packet_t pkt, odp_packet_t ref)
+{
+	CU_ASSERT(odp_packet_has_l2(pkt) == odp_packet_has_l2(ref));
+	CU_ASSERT(odp_packet_has_l3(pkt) == odp_packet_has_l3(ref));
+	CU_ASSERT(odp_packet_has_l4(pkt) == odp_packet_has_l4(ref));
+	CU_ASSERT(odp_packet_has_eth(pkt) == odp_packet_has_eth(ref));
+	CU_ASSERT(odp_packet_has_eth_bcast(pkt) ==
+		  odp_packet_has_eth_bcast(ref));
+	CU_ASSERT(odp_packet_has_eth_mcast(pkt) ==
+		  odp_packet_has_eth_mcast(ref));
+	CU_ASSERT(odp_packet_has_jumbo(pkt) == odp_packet_has_jumbo(ref));
+	CU_ASSERT(odp_packet_has_vlan(pkt) == odp_packet_has_vlan(ref));
+	CU_ASSERT(odp_packet_has_vlan_qinq(pkt) ==
+		  odp_packet_has_vlan_qinq(ref));
+	CU_ASSERT(odp_packet_has_arp(pkt) == odp_packet_has_arp(ref));
+	CU_ASSERT(odp_packet_has_ipv4(pkt) == odp_packet_has_ipv4(ref));
+	CU_ASSERT(odp_packet_has_ipv6(pkt) == odp_packet_has_ipv6(ref));
+	CU_ASSERT(odp_packet_has_ip_bcast(pkt) == odp_packet_has_ip_bcast(ref));
+	CU_ASSERT(odp_packet_has_ip_mcast(pkt) == odp_packet_has_ip_mcast(ref));
+	CU_ASSERT(odp_packet_has_ipfrag(pkt) == odp_packet_has_ipfrag(ref));
+	CU_ASSERT(odp_packet_has_ipopt(pkt) == odp_packet_has_ipopt(ref));
+	CU_ASSERT(odp_packet_has_ipsec(pkt) == odp_packet_has_ipsec(ref));
+	CU_ASSERT(odp_packet_has_udp(pkt) == odp_packet_has_udp(ref));
+	CU_ASSERT(odp_packet_has_tcp(pkt) == odp_packet_has_tcp(ref));
+	CU_ASSERT(odp_packet_has_sctp(pkt) == odp_packet_has_sctp(ref));
+	CU_ASSERT(odp_packet_has_icmp(pkt) == odp_packet_has_icmp(ref));
+	CU_ASSERT(odp_packet_has_error(pkt) == odp_packet_has_error(ref));
+	CU_ASSERT(odp_packet_has_l2_error(pkt) == odp_packet_has_l2_error(ref));
+	CU_ASSERT(odp_packet_has_l3_error(pkt) == odp_packet_has_l3_error(ref));
+	CU_ASSERT(odp_packet_has_l4_error(pkt) == odp_packet_has_l4_error(ref));
+	CU_ASSERT(odp_packet_l2_offset(pkt) == odp_packet_l2_offset(ref));
+	CU_ASSERT(odp_packet_l3_offset(pkt) == odp_packet_l3_offset(ref));
+	CU_ASSERT(odp_packet_l4_offset(pkt) == odp_packet_l4_offset(ref));
+	CU_ASSERT(odp_packet_l3_chksum_status(pkt) ==
+		  odp_packet_l3_chksum_status(ref));
+	CU_ASSERT(odp_packet_l4_chksum_status(pkt) ==
+		  odp_packet_l4_chksum_status(ref));
+}
+
+/* Mixed packet types in one odp_packet_parse_multi() call give the same
+ * results as odp_packet_parse() */
+static void parse_multi_mixed(void)
+{
+	static const struct {
+		const uint8_t *data;
+		uint32_t len;
+	} test_pkt[] = {
+		{ test_packet_arp, sizeof(test_packet_arp) },
+		{ test_packet_ipv4_icmp, sizeof(test_packet_ipv4_icmp) },
+		{ test_packet_ipv4_tcp, sizeof(test_packet_ipv4_tcp) },
+		{ test_packet_ipv4_udp, sizeof(test_packet_ipv4_udp) },
+		{ test_packet_vlan_ipv4_udp, sizeof(test_packet_vlan_ipv4_udp) },
+		{ test_packet_vlan_qinq_ipv4_udp,
+		  sizeof(test_packet_vlan_qinq_ipv4_udp) },
+		{ test_packet_ipv6_icmp, sizeof(test_packet_ipv6_icmp) },
+		{ test_packet_ipv6_tcp, sizeof(test_packet_ipv6_tcp) },
+		{ test_packet_ipv6_udp, sizeof(test_packet_ipv6_udp) },
+		{ test_packet_vlan_ipv6_udp, sizeof(test_packet_vlan_ipv6_udp) },
+		{ test_packet_ipv4_sctp, sizeof(test_packet_ipv4_sctp) },
+		{ test_packet_ipv4_ipsec_ah, sizeof(test_packet_ipv4_ipsec_ah) },
+		{ test_packet_ipv4_ipsec_esp, sizeof(test_packet_ipv4_ipsec_esp) },
+		{ test_packet_ipv6_ipsec_ah, sizeof(test_packet_ipv6_ipsec_ah) },
+		{ test_packet_ipv6_ipsec_esp, sizeof(test_packet_ipv6_ipsec_esp) },
+		{ test_packet_mcast_eth_ipv4_udp,
+		  sizeof(test_packet_mcast_eth_ipv4_udp) },
+		{ test_packet_bcast_eth_ipv4_udp,
+		  sizeof(test_packet_bcast_eth_ipv4_udp) },
+		{ test_packet_mcast_eth_ipv6_udp,
+		  sizeof(test_packet_mcast_eth_ipv6_udp) },
+		{ test_packet_ipv4_udp_first_frag,
+		  sizeof(test_packet_ipv4_udp_first_frag) },
+		{ test_packet_ipv4_udp_last_frag,
+		  sizeof(test_packet_ipv4_udp_last_frag) },
+		{ test_packet_ipv4_rr_nop_icmp,
+		  sizeof(test_packet_ipv4_rr_nop_icmp) }
+	};
+	const odp_proto_layer_t layer[] = { ODP_PROTO_LAYER_L2,
+					    ODP_PROTO_LAYER_L3,
+					    ODP_PROTO_LAYER_ALL };
+	int num_type = sizeof(test_pkt) / sizeof(test_pkt[0]);
+	int num_pkt = PARSE_TEST_MIXED_NUM_PKT;
+	odp_packet_t pkt[num_pkt], ref[num_pkt];
+	uint32_t offset[num_pkt];
+	odp_packet_parse_param_t parse;
+	int i, j, t;
+
+	/* Consecutive packets are of different types. Also bursts of
+	 * several packets of one type are included. */
+	for (i = 0; i < num_pkt; i++) {
+		t = i < num_pkt / 2 ? (i * 5) % num_type : (i / 4) % num_type;
+
+		pkt[i] = odp_packet_alloc(parse_test.pool, test_pkt[t].len);
+		ref[i] = odp_packet_alloc(parse_test.pool, test_pkt[t].len);
+		CU_ASSERT_FATAL(pkt[i] != ODP_PACKET_INVALID);
+		CU_ASSERT_FATAL(ref[i] != ODP_PACKET_INVALID);
+		CU_ASSERT_FATAL(odp_packet_copy_from_mem(pkt[i], 0,
+							 test_pkt[t].len,
+							 test_pkt[t].data) == 0);
+		CU_ASSERT_FATAL(odp_packet_copy_from_mem(ref[i], 0,
+							 test_pkt[t].len,
+							 test_pkt[t].data) == 0);
+		offset[i] = 0;
+	}
+
+	for (j = 0; j < (int)(sizeof(layer) / sizeof(layer[0])); j++) {
+		parse.proto = ODP_PROTO_ETH;
+		parse.last_layer = layer[j];
+		parse.chksums.all_chksum = 0;
+
+		for (i = 0; i < num_pkt; i++)
+			CU_ASSERT(odp_packet_parse(ref[i], 0, &parse) == 0);
+
+		CU_ASSERT(odp_packet_parse_multi(pkt, offset, num_pkt,
+						 &parse) == num_pkt);
+
+		for (i = 0; i < num_pkt; i++)
+			parse_result_compare(pkt[i], ref[i]);
+	}
+
+	odp_packet_free_multi(pkt, num_pkt);
+	odp_packet_free_multi(ref, num_pkt);
+}
+
 odp_testinfo_t packet_suite[] = {
 	ODP_TEST_INFO(packet_test_alloc_free),
 	ODP_TEST_INFO(packet_test_alloc_free_multi),
@@ -3313,6 +3440,7 @@ odp_testinfo_t packet_parse_suite[] = {
 	ODP_TEST_INFO(parse_eth_ipv4_udp_first_frag),
 	ODP_TEST_INFO(parse_eth_ipv4_udp_last_frag),
 	ODP_TEST_INFO(parse_eth_ipv4_rr_nop_icmp),
+	ODP_TEST_INFO(parse_multi_mixed),
 	ODP_TEST_INFO_NULL,
 };
 
@@ -224,11 +224,11 @@ static void pktio_pkt_set_macs(odp_packet_t pkt, odp_pktio_t src, odp_pktio_t ds
 
 /**
  * Creates a test packet from data array and loops it through the test pktio
- * interfaces forcing packet parsing.
+ * interfaces. Packet metadata is not accessed.
  */
-static odp_packet_t loopback_packet(pktio_info_t *pktio_a,
-				    pktio_info_t *pktio_b, const uint8_t *data,
-				    uint32_t len)
+static odp_packet_t send_and_recv_packet(pktio_info_t *pktio_a,
+					 pktio_info_t *pktio_b,
+					 const uint8_t *data, uint32_t len)
 {
 	odp_packet_t pkt;
 	odp_packet_t sent_pkt;
@@ -264,6 +264,21 @@ static odp_packet_t loopback_packet(pktio_info_t *pktio_a,
 	/* and wait for them to arrive back */
 	pkt = recv_and_cmp_packet(pktio_b->pktin, sent_pkt, ODP_TIME_SEC_IN_NS);
 	odp_packet_free(sent_pkt);
+
+	return pkt;
+}
+
+/**
+ * Creates a test packet from data array and loops it through the test pktio
+ * interfaces forcing packet parsing.
+ */
+static odp_packet_t loopback_packet(pktio_info_t *pktio_a,
+				    pktio_info_t *pktio_b, const uint8_t *data,
+				    uint32_t len)
+{
+	odp_packet_t pkt;
+
+	pkt = send_and_recv_packet(pktio_a, pktio_b, data, len);
 	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
 	CU_ASSERT(odp_packet_input(pkt) == pktio_b->hdl);
 	CU_ASSERT(odp_packet_has_error(pkt) == 0);
@@ -339,6 +354,68 @@ static void parser_test_ipv4_udp(void)
 	odp_packet_free(pkt);
 }
 
+/* Reconfigure parser layer of all test interfaces */
+static int parser_layer_config(odp_proto_layer_t layer)
+{
+	odp_pktio_config_t config;
+	int i;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		odp_pktio_t pktio = pktios[i].hdl;
+
+		if (odp_pktio_stop(pktio))
+			return -1;
+
+		odp_pktio_config_init(&config);
+		config.parser.layer = layer;
+		if (odp_pktio_config(pktio, &config))
+			return -1;
+
+		if (odp_pktio_start(pktio))
+			return -1;
+
+		wait_linkup(pktio);
+	}
+
+	return 0;
+}
+
+/* Interfaces parse only L2. Upper layer metadata is parsed on first use. */
+static void parser_test_lazy_ipv4_udp(void)
+{
+	odp_packet_t pkt;
+
+	CU_ASSERT_FATAL(parser_layer_config(ODP_PROTO_LAYER_L2) == 0);
+
+	pkt = send_and_recv_packet(pktio_a, pktio_b, test_packet_ipv4_udp,
+				   sizeof(test_packet_ipv4_udp));
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+
+	/* L4 accessors first, these must trigger parsing of L3 and L4 */
+	CU_ASSERT(odp_packet_has_udp(pkt));
+	CU_ASSERT(odp_packet_l4_offset(pkt) ==
+		  ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN);
+	CU_ASSERT(odp_packet_l3_offset(pkt) == ODPH_ETHHDR_LEN);
+	CU_ASSERT(odp_packet_has_eth(pkt));
+	CU_ASSERT(odp_packet_has_ipv4(pkt));
+	CU_ASSERT(!odp_packet_has_ipv6(pkt));
+	CU_ASSERT(!odp_packet_has_tcp(pkt));
+	CU_ASSERT(!odp_packet_has_error(pkt));
+	odp_packet_free(pkt);
+
+	/* Error check parses all layers before anything else */
+	pkt = send_and_recv_packet(pktio_a, pktio_b, test_packet_ipv4_udp,
+				   sizeof(test_packet_ipv4_udp));
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT(!odp_packet_has_error(pkt));
+	CU_ASSERT(odp_packet_has_udp(pkt));
+	CU_ASSERT(odp_packet_l4_offset(pkt) ==
+		  ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN);
+	odp_packet_free(pkt);
+
+	CU_ASSERT(parser_layer_config(ODP_PROTO_LAYER_ALL) == 0);
+}
+
 static void parser_test_vlan_ipv4_udp(void)
 {
 	odp_packet_t pkt;
@@ -553,6 +630,7 @@ odp_testinfo_t parser_suite[] = {
 	ODP_TEST_INFO(parser_test_ipv4_icmp),
 	ODP_TEST_INFO(parser_test_ipv4_tcp),
 	ODP_TEST_INFO(parser_test_ipv4_udp),
+	ODP_TEST_INFO(parser_test_lazy_ipv4_udp),
 	ODP_TEST_INFO_CONDITIONAL(parser_test_vlan_ipv4_udp, loop_pktio),
 	ODP_TEST_INFO_CONDITIONAL(parser_test_vlan_qinq_ipv4_udp, loop_pktio),
 	ODP_TEST_INFO(parser_test_ipv6_icmp),
@@ -25,6 +25,8 @@
 #define TEST_SEQ_INVALID       ((uint32_t)~0)
 #define TEST_SEQ_MAGIC         0x92749451
 #define TX_BATCH_LEN           4
+#define IPV4_MORE_FRAGS        0x2000
+#define IPV4_FRAG_OFFSET       0x0010
 #define MAX_QUEUES             128
 
 #define PKTIN_TS_INTERVAL      (50 * ODP_TIME_MSEC_IN_NS)
@@ -2077,6 +2079,167 @@ static void pktio_test_pktin_ts(void)
 	}
 }
 
+static int pktio_check_chksum_out(void)
+{
+	odp_pktio_t pktio;
+	odp_pktio_capability_t capa;
+	odp_pktio_param_t pktio_param;
+	int ret;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	pktio = odp_pktio_open(iface_name[0], pool[0], &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID)
+		return ODP_TEST_INACTIVE;
+
+	ret = odp_pktio_capability(pktio, &capa);
+	(void)odp_pktio_close(pktio);
+
+	if (ret < 0 || !capa.config.pktout.bit.ipv4_chksum_ena ||
+	    !capa.config.pktout.bit.udp_chksum_ena)
+		return ODP_TEST_INACTIVE;
+
+	return ODP_TEST_ACTIVE;
+}
+
+/* Check L4 sum of a received packet against a sum over a copy of the data */
+static void check_ones_comp(odp_packet_t pkt)
+{
+	odp_packet_data_range_t range;
+	uint32_t l4_offset = odp_packet_l4_offset(pkt);
+	uint32_t len = odp_packet_len(pkt);
+	uint8_t data[len];
+	uint16_t sum;
+
+	sum = odp_packet_ones_comp(pkt, &range);
+
+	CU_ASSERT(range.offset == l4_offset);
+	CU_ASSERT(range.length == len - l4_offset);
+
+	if (range.length == 0 || range.offset + range.length > len)
+		return;
+
+	CU_ASSERT_FATAL(odp_packet_copy_to_mem(pkt, range.offset,
+					       range.length, data) == 0);
+	CU_ASSERT(sum == odp_chksum_ones_comp16(data, range.length));
+}
+
+static void pktio_test_chksum_out(void)
+{
+	odp_pktio_t pktio_tx, pktio_rx;
+	odp_pktio_t pktio[MAX_NUM_IFACES];
+	pktio_info_t pktio_rx_info;
+	odp_pktio_capability_t capa;
+	odp_pktio_config_t config;
+	odp_pktout_queue_t pktout_queue;
+	odp_packet_t pkt_tbl[TX_BATCH_LEN];
+	uint32_t pkt_seq[TX_BATCH_LEN];
+	odp_packet_t tail;
+	odph_ipv4hdr_t *ip;
+	odph_udphdr_t *udp;
+	uint32_t offset;
+	uint16_t frag;
+	int num_rx;
+	int ret;
+	int i;
+
+	CU_ASSERT_FATAL(num_ifaces >= 1);
+
+	/* Open and configure interfaces */
+	for (i = 0; i < num_ifaces; ++i) {
+		pktio[i] = create_pktio(i, ODP_PKTIN_MODE_DIRECT,
+					ODP_PKTOUT_MODE_DIRECT);
+		CU_ASSERT_FATAL(pktio[i] != ODP_PKTIO_INVALID);
+
+		CU_ASSERT_FATAL(odp_pktio_capability(pktio[i], &capa) == 0);
+		CU_ASSERT_FATAL(capa.config.pktout.bit.ipv4_chksum_ena);
+		CU_ASSERT_FATAL(capa.config.pktout.bit.udp_chksum_ena);
+
+		odp_pktio_config_init(&config);
+		config.pktout.bit.ipv4_chksum_ena = 1;
+		config.pktout.bit.udp_chksum_ena  = 1;
+		config.pktout.bit.ipv4_chksum     = 1;
+		config.pktout.bit.udp_chksum      = 1;
+		CU_ASSERT_FATAL(odp_pktio_config(pktio[i], &config) == 0);
+
+		CU_ASSERT_FATAL(odp_pktio_start(pktio[i]) == 0);
+	}
+
+	for (i = 0; i < num_ifaces; i++)
+		_pktio_wait_linkup(pktio[i]);
+
+	pktio_tx = pktio[0];
+	pktio_rx = (num_ifaces > 1) ? pktio[1] : pktio_tx;
+	pktio_rx_info.id   = pktio_rx;
+	pktio_rx_info.inq  = ODP_QUEUE_INVALID;
+	pktio_rx_info.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	ret = create_packets(pkt_tbl, pkt_seq, TX_BATCH_LEN, pktio_tx,
+			     pktio_rx);
+	CU_ASSERT_FATAL(ret == TX_BATCH_LEN);
+
+	/* Clear checksums. UDP checksum insertion is disabled per packet on
+	 * the second packet. The third and fourth packets are marked as first
+	 * and non-first IPv4 fragments, which must not get a UDP checksum. */
+	for (i = 0; i < TX_BATCH_LEN; i++) {
+		ip  = odp_packet_l3_ptr(pkt_tbl[i], NULL);
+		udp = odp_packet_l4_ptr(pkt_tbl[i], NULL);
+		ip->chksum  = 0;
+		udp->chksum = 0;
+
+		if (i == 2)
+			ip->frag_offset = odp_cpu_to_be_16(IPV4_MORE_FRAGS);
+		else if (i == 3)
+			ip->frag_offset = odp_cpu_to_be_16(IPV4_FRAG_OFFSET);
+
+		/* Add a segment which starts at an odd offset from L4 */
+		offset = odp_packet_l4_offset(pkt_tbl[i]) + ODPH_UDPHDR_LEN + 1;
+		CU_ASSERT_FATAL(odp_packet_split(&pkt_tbl[i], offset,
+						 &tail) >= 0);
+		CU_ASSERT_FATAL(odp_packet_concat(&pkt_tbl[i], tail) >= 0);
+
+		if (i == 1)
+			odp_packet_l4_chksum_insert(pkt_tbl[i], 0);
+	}
+
+	ret = odp_pktout_queue(pktio_tx, &pktout_queue, 1);
+	CU_ASSERT_FATAL(ret > 0);
+
+	send_packets(pktout_queue, pkt_tbl, TX_BATCH_LEN);
+
+	num_rx = wait_for_packets(&pktio_rx_info, pkt_tbl, pkt_seq,
+				  TX_BATCH_LEN, TXRX_MODE_MULTI,
+				  ODP_TIME_SEC_IN_NS);
+	CU_ASSERT(num_rx == TX_BATCH_LEN);
+
+	for (i = 0; i < num_rx; i++) {
+		CU_ASSERT(odph_ipv4_csum_valid(pkt_tbl[i]));
+
+		ip   = odp_packet_l3_ptr(pkt_tbl[i], NULL);
+		udp  = odp_packet_l4_ptr(pkt_tbl[i], NULL);
+		frag = odp_be_to_cpu_16(ip->frag_offset);
+
+		/* Fragments are not modified. Zero UDP checksum is not
+		 * verified. */
+		if (ODPH_IPV4HDR_IS_FRAGMENT(frag)) {
+			CU_ASSERT(udp->chksum == 0);
+		} else {
+			ret = odph_udp_tcp_chksum(pkt_tbl[i],
+						  ODPH_CHKSUM_VERIFY, NULL);
+			CU_ASSERT(ret == ((i == 1) ? 1 : 0));
+		}
+
+		check_ones_comp(pkt_tbl[i]);
+		odp_packet_free(pkt_tbl[i]);
+	}
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT_FATAL(odp_pktio_stop(pktio[i]) == 0);
+		CU_ASSERT_FATAL(odp_pktio_close(pktio[i]) == 0);
+	}
+}
+
 static int create_pool(const char *iface, int num)
 {
 	char pool_name[ODP_POOL_NAME_LEN];
@@ -2219,6 +2382,8 @@ odp_testinfo_t pktio_suite_unsegmented[] = {
 				  pktio_check_statistics_counters),
 	ODP_TEST_INFO_CONDITIONAL(pktio_test_pktin_ts,
 				  pktio_check_pktin_ts),
+	ODP_TEST_INFO_CONDITIONAL(pktio_test_chksum_out,
+				  pktio_check_chksum_out),
 	ODP_TEST_INFO_NULL
 };
 
@@ -2232,6 +2397,8 @@ odp_testinfo_t pktio_suite_segmented[] = {
 	ODP_TEST_INFO(pktio_test_recv_mtu),
 	ODP_TEST_INFO_CONDITIONAL(pktio_test_send_failure,
 				  pktio_check_send_failure),
+	ODP_TEST_INFO_CONDITIONAL(pktio_test_chksum_out,
+				  pktio_check_chksum_out),
 	ODP_TEST_INFO_NULL
 };
 
@@ -11,10 +11,18 @@
 
 #define PKT_LEN 400
 #define PKT_NUM 500
+#define CACHE_TEST_NUM 64
+#define NUMA_TEST_NUM 1000
 
 static const int default_buffer_size = 1500;
 static const int default_buffer_num = 1000;
 
+static struct {
+	odp_pool_t pool;
+	odp_buffer_t buf[NUMA_TEST_NUM];
+	int num;
+} numa_test;
+
 static void pool_create_destroy(odp_pool_param_t *param)
 {
 	odp_pool_t pool;
@@ -270,6 +278,261 @@ static void pool_test_info_data_range(void)
 	CU_ASSERT(odp_pool_destroy(pool) == 0);
 }
 
+static void alloc_all_buffers_param(odp_pool_param_t *param)
+{
+	odp_pool_t pool;
+	odp_buffer_t buf[default_buffer_num];
+	int i, num, round;
+
+	pool = odp_pool_create(NULL, param);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	/* Buffers freed into the thread local cache must be available for
+	 * allocation again */
+	for (round = 0; round < 2; round++) {
+		num = 0;
+		for (i = 0; i < default_buffer_num; i++) {
+			buf[num] = odp_buffer_alloc(pool);
+			if (buf[num] == ODP_BUFFER_INVALID)
+				break;
+			num++;
+		}
+
+		CU_ASSERT(num == default_buffer_num);
+		CU_ASSERT(odp_buffer_alloc(pool) == ODP_BUFFER_INVALID);
+
+		for (i = 0; i < num; i++)
+			odp_buffer_free(buf[i]);
+	}
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
+static void alloc_all_buffers(uint32_t cache_size)
+{
+	odp_pool_param_t param;
+
+	odp_pool_param_init(&param);
+
+	param.type           = ODP_POOL_BUFFER;
+	param.buf.size       = default_buffer_size;
+	param.buf.num        = default_buffer_num;
+	param.buf.cache_size = cache_size;
+
+	alloc_all_buffers_param(&param);
+}
+
+static void pool_test_buf_cache_size(void)
+{
+	odp_pool_capability_t capa;
+	odp_pool_param_t param;
+
+	CU_ASSERT_FATAL(odp_pool_capability(&capa) == 0);
+	CU_ASSERT(capa.buf.min_cache_size <= capa.buf.max_cache_size);
+
+	odp_pool_param_init(&param);
+	CU_ASSERT(param.buf.cache_size >= capa.buf.min_cache_size);
+	CU_ASSERT(param.buf.cache_size <= capa.buf.max_cache_size);
+
+	alloc_all_buffers(capa.buf.min_cache_size);
+	alloc_all_buffers(param.buf.cache_size);
+	alloc_all_buffers(capa.buf.max_cache_size);
+}
+
+static void free_multi_small_cache(odp_pool_param_t *param)
+{
+	odp_pool_t pool;
+	odp_buffer_t buf[CACHE_TEST_NUM];
+	odp_packet_t pkt[CACHE_TEST_NUM];
+	int i, n, num, round;
+
+	pool = odp_pool_create(NULL, param);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	for (round = 0; round < 2; round++) {
+		for (num = 0; num < CACHE_TEST_NUM; num++) {
+			if (param->type == ODP_POOL_BUFFER) {
+				buf[num] = odp_buffer_alloc(pool);
+				if (buf[num] == ODP_BUFFER_INVALID)
+					break;
+			} else {
+				pkt[num] = odp_packet_alloc(pool, PKT_LEN);
+				if (pkt[num] == ODP_PACKET_INVALID)
+					break;
+			}
+		}
+
+		CU_ASSERT_FATAL(num == CACHE_TEST_NUM);
+
+		/* Free in bursts of growing size, so that multi-frees hit
+		 * a cache which is partially full */
+		for (i = 0, n = 1; i < num; i += n, n = (n % 9) + 1) {
+			if (n > num - i)
+				n = num - i;
+
+			if (param->type == ODP_POOL_BUFFER) {
+				if (n == 1)
+					odp_buffer_free(buf[i]);
+				else
+					odp_buffer_free_multi(&buf[i], n);
+			} else {
+				if (n == 1)
+					odp_packet_free(pkt[i]);
+				else
+					odp_packet_free_multi(&pkt[i], n);
+			}
+		}
+	}
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
+static void pool_test_free_multi_small_cache(void)
+{
+	odp_pool_capability_t capa;
+	odp_pool_param_t param;
+	uint32_t cache_size[] = {1, 2, 5, 8, 16};
+	int num_cache = sizeof(cache_size) / sizeof(cache_size[0]);
+	int i;
+
+	CU_ASSERT_FATAL(odp_pool_capability(&capa) == 0);
+
+	for (i = 0; i < num_cache; i++) {
+		odp_pool_param_init(&param);
+		param.type = ODP_POOL_BUFFER;
+		param.buf.size = default_buffer_size;
+		param.buf.num  = CACHE_TEST_NUM;
+		param.buf.cache_size = cache_size[i];
+
+		if (cache_size[i] >= capa.buf.min_cache_size &&
+		    cache_size[i] <= capa.buf.max_cache_size)
+			free_multi_small_cache(&param);
+
+		odp_pool_param_init(&param);
+		param.type = ODP_POOL_PACKET;
+		param.pkt.len = PKT_LEN;
+		param.pkt.num = CACHE_TEST_NUM;
+		param.pkt.cache_size = cache_size[i];
+
+		if (cache_size[i] >= capa.pkt.min_cache_size &&
+		    cache_size[i] <= capa.pkt.max_cache_size)
+			free_multi_small_cache(&param);
+	}
+}
+
+static void pool_test_buf_numa(void)
+{
+	odp_pool_param_t param;
+
+	odp_pool_param_init(&param);
+	CU_ASSERT(param.numa.node == ODP_POOL_NUMA_ANY);
+	CU_ASSERT(param.numa.per_node == 0);
+
+	param.type     = ODP_POOL_BUFFER;
+	param.buf.size = default_buffer_size;
+	param.buf.num  = default_buffer_num;
+
+	/* Node hint */
+	param.numa.node = 0;
+	alloc_all_buffers_param(&param);
+
+	/* All buffers must be available also when divided between nodes */
+	param.numa.node     = ODP_POOL_NUMA_ANY;
+	param.numa.per_node = 1;
+	alloc_all_buffers_param(&param);
+}
+
+/* Allocates all buffers, returns the number of unique buffers */
+static int numa_alloc_all(void)
+{
+	int i, num = 0, unique = 0;
+
+	while (num < NUMA_TEST_NUM) {
+		numa_test.buf[num] = odp_buffer_alloc(numa_test.pool);
+		if (numa_test.buf[num] == ODP_BUFFER_INVALID)
+			break;
+
+		*(int *)odp_buffer_addr(numa_test.buf[num]) = num;
+		num++;
+	}
+
+	/* A buffer allocated twice holds the index of its last allocation */
+	for (i = 0; i < num; i++)
+		unique += *(int *)odp_buffer_addr(numa_test.buf[i]) == i;
+
+	numa_test.num = num;
+	return unique;
+}
+
+static void numa_free_all(void)
+{
+	int i;
+
+	for (i = 0; i < numa_test.num; i++)
+		odp_buffer_free(numa_test.buf[i]);
+
+	numa_test.num = 0;
+}
+
+/* Frees buffers of the main thread and allocates them again. Threads may be
+ * on different NUMA nodes, e.g. when the node count is overridden for
+ * testing (ODP_NUMA_NODES on linux-generic). */
+static int numa_free_alloc_thread(void *arg ODP_UNUSED)
+{
+	numa_free_all();
+
+	CU_ASSERT(numa_alloc_all() == NUMA_TEST_NUM);
+
+	return 0;
+}
+
+static void numa_free_alloc(uint32_t cache_size)
+{
+	odp_pool_param_t param;
+	pthrd_arg thr_arg;
+
+	odp_pool_param_init(&param);
+	param.type           = ODP_POOL_BUFFER;
+	param.buf.size       = default_buffer_size;
+	param.buf.num        = NUMA_TEST_NUM;
+	param.buf.cache_size = cache_size;
+	param.numa.per_node  = 1;
+
+	numa_test.pool = odp_pool_create(NULL, &param);
+	CU_ASSERT_FATAL(numa_test.pool != ODP_POOL_INVALID);
+
+	CU_ASSERT(numa_alloc_all() == NUMA_TEST_NUM);
+
+	/* Buffers are freed and allocated by another thread, and then freed
+	 * by this thread. All must return to the pool. */
+	thr_arg.numthrds = 1;
+	CU_ASSERT_FATAL(odp_cunit_thread_create(numa_free_alloc_thread,
+						&thr_arg) == 1);
+	CU_ASSERT(odp_cunit_thread_exit(&thr_arg) == 0);
+
+	CU_ASSERT(numa_test.num == NUMA_TEST_NUM);
+	numa_free_all();
+
+	CU_ASSERT(numa_alloc_all() == NUMA_TEST_NUM);
+	CU_ASSERT(odp_buffer_alloc(numa_test.pool) == ODP_BUFFER_INVALID);
+	numa_free_all();
+
+	CU_ASSERT(odp_pool_destroy(numa_test.pool) == 0);
+}
+
+static void pool_test_buf_numa_threads(void)
+{
+	odp_pool_capability_t capa;
+
+	CU_ASSERT_FATAL(odp_pool_capability(&capa) == 0);
+
+	if (capa.buf.max_num && capa.buf.max_num < NUMA_TEST_NUM)
+		return;
+
+	numa_free_alloc(0);
+	numa_free_alloc(capa.buf.max_cache_size);
+}
+
 odp_testinfo_t pool_suite[] = {
 	ODP_TEST_INFO(pool_test_create_destroy_buffer),
 	ODP_TEST_INFO(pool_test_create_destroy_packet),
@@ -279,6 +542,10 @@ odp_testinfo_t pool_suite[] = {
 	ODP_TEST_INFO(pool_test_info_packet),
 	ODP_TEST_INFO(pool_test_lookup_info_print),
 	ODP_TEST_INFO(pool_test_info_data_range),
+	ODP_TEST_INFO(pool_test_buf_cache_size),
+	ODP_TEST_INFO(pool_test_free_multi_small_cache),
+	ODP_TEST_INFO(pool_test_buf_numa),
+	ODP_TEST_INFO(pool_test_buf_numa_threads),
 	ODP_TEST_INFO_NULL,
 };
 
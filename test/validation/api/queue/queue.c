@@ -13,6 +13,8 @@
 #define MSG_POOL_SIZE           (4 * 1024 * 1024)
 #define CONFIG_MAX_ITERATION    (100)
 #define MAX_QUEUES              (64 * 1024)
+#define MAX_QUEUE_SIZE          (1000)
+#define FULL_QUEUE_SIZE         (100)
 
 static int queue_context = 0xff;
 static odp_pool_t pool;
@@ -32,6 +34,7 @@ static int queue_suite_init(void)
 {
 	odp_pool_param_t params;
 
+	odp_pool_param_init(&params);
 	params.buf.size  = 0;
 	params.buf.align = ODP_CACHE_LINE_SIZE;
 	params.buf.num   = 1024 * 10;
@@ -259,6 +262,138 @@ static void queue_test_param(void)
 	CU_ASSERT(odp_queue_destroy(queue) == 0);
 }
 
+static void queue_test_size(void)
+{
+	odp_queue_capability_t capa;
+	odp_queue_param_t param;
+	odp_pool_t msg_pool;
+	odp_queue_t queue;
+	odp_buffer_t buf;
+	odp_event_t ev[MAX_QUEUE_SIZE];
+	uint32_t size, i, num;
+
+	CU_ASSERT_FATAL(odp_queue_capability(&capa) == 0);
+
+	size = MAX_QUEUE_SIZE;
+	if (capa.plain.max_size && capa.plain.max_size < size)
+		size = capa.plain.max_size;
+
+	msg_pool = odp_pool_lookup("msg_pool");
+	CU_ASSERT_FATAL(msg_pool != ODP_POOL_INVALID);
+
+	odp_queue_param_init(&param);
+	param.type = ODP_QUEUE_TYPE_PLAIN;
+	param.size = size;
+
+	queue = odp_queue_create("test_queue_size", &param);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	/* Queue must hold at least size events */
+	for (num = 0; num < size; num++) {
+		buf = odp_buffer_alloc(msg_pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+		ev[num] = odp_buffer_to_event(buf);
+
+		if (odp_queue_enq(queue, ev[num])) {
+			odp_event_free(ev[num]);
+			break;
+		}
+	}
+
+	CU_ASSERT(num == size);
+
+	/* Events are dequeued in FIFO order */
+	for (i = 0; i < num; i++) {
+		odp_event_t deq = odp_queue_deq(queue);
+
+		CU_ASSERT(deq == ev[i]);
+		if (deq != ODP_EVENT_INVALID)
+			odp_event_free(deq);
+	}
+
+	CU_ASSERT(odp_queue_deq(queue) == ODP_EVENT_INVALID);
+	CU_ASSERT(odp_queue_destroy(queue) == 0);
+}
+
+static void queue_test_full(void)
+{
+	odp_queue_capability_t capa;
+	odp_queue_param_t param;
+	odp_pool_t msg_pool;
+	odp_queue_t queue;
+	odp_buffer_t buf;
+	odp_event_t ev[MAX_QUEUE_SIZE];
+	odp_event_t extra, deq;
+	uint32_t size, i, num;
+
+	CU_ASSERT_FATAL(odp_queue_capability(&capa) == 0);
+
+	/* Queues without a size limit do not get full */
+	if (capa.plain.max_size == 0) {
+		printf("\n    No plain queue size limit\n");
+		return;
+	}
+
+	size = FULL_QUEUE_SIZE;
+	if (capa.plain.max_size < size)
+		size = capa.plain.max_size;
+
+	msg_pool = odp_pool_lookup("msg_pool");
+	CU_ASSERT_FATAL(msg_pool != ODP_POOL_INVALID);
+
+	odp_queue_param_init(&param);
+	param.type = ODP_QUEUE_TYPE_PLAIN;
+	param.size = size;
+
+	queue = odp_queue_create("test_queue_full", &param);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	buf = odp_buffer_alloc(msg_pool);
+	CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+	extra = odp_buffer_to_event(buf);
+
+	/* Fill the queue. It may store more than size events. */
+	for (num = 0; num < MAX_QUEUE_SIZE; num++) {
+		buf = odp_buffer_alloc(msg_pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+		ev[num] = odp_buffer_to_event(buf);
+
+		if (odp_queue_enq(queue, ev[num])) {
+			odp_event_free(ev[num]);
+			break;
+		}
+	}
+
+	CU_ASSERT(num >= size);
+	CU_ASSERT_FATAL(num < MAX_QUEUE_SIZE);
+
+	/* Full queue does not accept more events */
+	CU_ASSERT(odp_queue_enq(queue, extra) != 0);
+	CU_ASSERT(odp_queue_enq_multi(queue, &extra, 1) <= 0);
+
+	/* Space of a dequeued event can be used again */
+	deq = odp_queue_deq(queue);
+	CU_ASSERT(deq == ev[0]);
+	CU_ASSERT(odp_queue_enq(queue, extra) == 0);
+	CU_ASSERT(odp_queue_enq(queue, deq) != 0);
+	odp_event_free(deq);
+
+	for (i = 1; i < num; i++) {
+		deq = odp_queue_deq(queue);
+		CU_ASSERT(deq == ev[i]);
+		if (deq != ODP_EVENT_INVALID)
+			odp_event_free(deq);
+	}
+
+	deq = odp_queue_deq(queue);
+	CU_ASSERT(deq == extra);
+	if (deq != ODP_EVENT_INVALID)
+		odp_event_free(deq);
+
+	CU_ASSERT(odp_queue_deq(queue) == ODP_EVENT_INVALID);
+	CU_ASSERT(odp_queue_destroy(queue) == 0);
+}
+
 static void queue_test_info(void)
 {
 	odp_queue_t q_plain, q_order;
@@ -324,11 +459,65 @@ static void queue_test_info(void)
 	CU_ASSERT(odp_queue_destroy(q_order) == 0);
 }
 
+static void queue_test_stats(void)
+{
+	odp_queue_stats_t stats;
+	odp_queue_t queue;
+	odp_buffer_t buf;
+	odp_event_t ev;
+	int i, num;
+
+	queue = odp_queue_create("test_q_stats", NULL);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	/* Statistics are optional */
+	if (odp_queue_stats(queue, &stats)) {
+		CU_ASSERT(odp_queue_destroy(queue) == 0);
+		return;
+	}
+
+	/* Counters are reset on create */
+	CU_ASSERT(stats.enq == 0);
+	CU_ASSERT(stats.enq_fail == 0);
+	CU_ASSERT(stats.deq == 0);
+	CU_ASSERT(stats.deq_empty == 0);
+
+	for (num = 0; num < MAX_BUFFER_QUEUE; num++) {
+		buf = odp_buffer_alloc(pool);
+		if (buf == ODP_BUFFER_INVALID)
+			break;
+
+		if (odp_queue_enq(queue, odp_buffer_to_event(buf))) {
+			odp_buffer_free(buf);
+			break;
+		}
+	}
+
+	for (i = 0; i < num; i++) {
+		ev = odp_queue_deq(queue);
+		CU_ASSERT_FATAL(ev != ODP_EVENT_INVALID);
+		odp_event_free(ev);
+	}
+
+	CU_ASSERT(odp_queue_deq(queue) == ODP_EVENT_INVALID);
+
+	CU_ASSERT(odp_queue_stats(queue, &stats) == 0);
+	CU_ASSERT(stats.enq == (uint64_t)num);
+	CU_ASSERT(stats.enq_fail == 0);
+	CU_ASSERT(stats.deq == (uint64_t)num);
+	CU_ASSERT(stats.deq_empty >= 1);
+
+	CU_ASSERT(odp_queue_destroy(queue) == 0);
+}
+
 odp_testinfo_t queue_suite[] = {
 	ODP_TEST_INFO(queue_test_capa),
 	ODP_TEST_INFO(queue_test_mode),
 	ODP_TEST_INFO(queue_test_param),
+	ODP_TEST_INFO(queue_test_size),
+	ODP_TEST_INFO(queue_test_full),
 	ODP_TEST_INFO(queue_test_info),
+	ODP_TEST_INFO(queue_test_stats),
 	ODP_TEST_INFO_NULL,
 };
 
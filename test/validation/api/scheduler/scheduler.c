@@ -50,6 +50,15 @@
 #define CHAOS_NDX_TO_PTR(n) ((void *)(uintptr_t)n)
 
 #define ODP_WAIT_TOLERANCE	(60 * ODP_TIME_MSEC_IN_NS)
+#define WAKEUP_DELAY_NS		(100 * ODP_TIME_MSEC_IN_NS)
+#define WAKEUP_TMO_NS		(5 * ODP_TIME_SEC_IN_NS)
+
+/* Reorder test sends many more events than fit into a reorder window, and
+ * outputs every REORDER_OUT_RATIO'th event */
+#define REORDER_NUM_EVENTS	512
+#define REORDER_OUT_RATIO	16
+#define REORDER_IDLE_NS		(100 * ODP_TIME_MSEC_IN_NS)
+#define REORDER_TMO_NS		(10 * ODP_TIME_SEC_IN_NS)
 
 /* Test global variables */
 typedef struct {
@@ -63,6 +72,10 @@ typedef struct {
 		odp_queue_t handle;
 		char name[ODP_QUEUE_NAME_LEN];
 	} chaos_q[CHAOS_NUM_QUEUES];
+	struct {
+		odp_queue_t out_queue;
+		odp_atomic_u32_t done;
+	} reorder;
 } test_globals_t;
 
 typedef struct {
@@ -192,6 +205,309 @@ static void scheduler_test_wait_time(void)
 	CU_ASSERT_FATAL(odp_queue_destroy(queue) == 0);
 }
 
+static int wait_wakeup_thread(void *arg ODP_UNUSED)
+{
+	odp_queue_t from;
+	odp_event_t ev;
+	odp_time_t start, diff;
+
+	/* Spin and sleep until the main thread enqueues an event. The wait
+	 * time catches a lost wake up without hanging the test. */
+	from  = ODP_QUEUE_INVALID;
+	start = odp_time_local();
+	ev    = odp_schedule(&from, odp_schedule_wait_time(WAKEUP_TMO_NS));
+	diff  = odp_time_diff(odp_time_local(), start);
+
+	CU_ASSERT(ev != ODP_EVENT_INVALID);
+	CU_ASSERT(from != ODP_QUEUE_INVALID);
+	CU_ASSERT(odp_time_to_ns(diff) < WAKEUP_TMO_NS);
+
+	if (ev != ODP_EVENT_INVALID)
+		odp_event_free(ev);
+
+	CU_ASSERT(exit_schedule_loop() == 0);
+
+	return 0;
+}
+
+static void scheduler_test_wait_wakeup(void)
+{
+	odp_queue_param_t qp;
+	odp_queue_t queue;
+	odp_buffer_t buf;
+	odp_shm_t shm;
+	thread_args_t *args;
+	odp_time_t delay;
+
+	shm = odp_shm_lookup(SHM_THR_ARGS_NAME);
+	CU_ASSERT_FATAL(shm != ODP_SHM_INVALID);
+	args = odp_shm_addr(shm);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(args);
+
+	pool = odp_pool_lookup(MSG_POOL_NAME);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	odp_queue_param_init(&qp);
+	qp.type        = ODP_QUEUE_TYPE_SCHED;
+	qp.sched.sync  = ODP_SCHED_SYNC_PARALLEL;
+	qp.sched.prio  = ODP_SCHED_PRIO_NORMAL;
+	qp.sched.group = ODP_SCHED_GROUP_ALL;
+	queue = odp_queue_create("wait_wakeup_queue", &qp);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	args->cu_thr.numthrds = 1;
+	odp_cunit_thread_create(wait_wakeup_thread, &args->cu_thr);
+
+	/* Let the thread spin and go to sleep */
+	delay = odp_time_local_from_ns(WAKEUP_DELAY_NS);
+	odp_time_wait_until(odp_time_sum(odp_time_local(), delay));
+
+	buf = odp_buffer_alloc(pool);
+	CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+
+	if (odp_queue_enq(queue, odp_buffer_to_event(buf)))
+		odp_buffer_free(buf);
+
+	odp_cunit_thread_exit(&args->cu_thr);
+
+	CU_ASSERT(drain_queues() == 0);
+	CU_ASSERT_FATAL(odp_queue_destroy(queue) == 0);
+}
+
+/* Output every REORDER_OUT_RATIO'th event, and free others */
+static void reorder_event(test_globals_t *globals, odp_event_t ev)
+{
+	buf_contents *bctx = odp_buffer_addr(odp_buffer_from_event(ev));
+
+	if (bctx->sequence % REORDER_OUT_RATIO == 0) {
+		if (odp_queue_enq(globals->reorder.out_queue, ev)) {
+			CU_FAIL("enqueue failed");
+			odp_event_free(ev);
+		}
+	} else {
+		odp_event_free(ev);
+	}
+
+	odp_atomic_inc_u32(&globals->reorder.done);
+}
+
+static void reorder_loop(test_globals_t *globals)
+{
+	uint64_t wait = odp_schedule_wait_time(REORDER_IDLE_NS);
+	odp_time_t end;
+	odp_event_t ev;
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(REORDER_TMO_NS));
+
+	while (odp_atomic_load_u32(&globals->reorder.done) <
+	       REORDER_NUM_EVENTS &&
+	       odp_time_cmp(end, odp_time_local()) > 0) {
+		ev = odp_schedule(NULL, wait);
+
+		if (ev != ODP_EVENT_INVALID)
+			reorder_event(globals, ev);
+	}
+}
+
+static int reorder_window_thread(void *arg ODP_UNUSED)
+{
+	odp_shm_t shm;
+	test_globals_t *globals;
+
+	shm = odp_shm_lookup(GLOBALS_SHM_NAME);
+	CU_ASSERT_FATAL(shm != ODP_SHM_INVALID);
+	globals = odp_shm_addr(shm);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(globals);
+
+	reorder_loop(globals);
+
+	CU_ASSERT(exit_schedule_loop() == 0);
+
+	return 0;
+}
+
+/* Main thread holds the first ordered context while workers release
+ * following contexts out of order, until they stall. Events output from the
+ * contexts must still be in the original order. */
+static void scheduler_test_reorder_window(void)
+{
+	odp_queue_param_t qp;
+	odp_queue_t queue, from;
+	odp_buffer_t buf;
+	odp_event_t ev, first;
+	odp_shm_t shm;
+	test_globals_t *globals;
+	thread_args_t *args;
+	buf_contents *bctx;
+	odp_time_t end;
+	uint32_t done, prev;
+	uint64_t seq;
+	int i, num;
+
+	shm = odp_shm_lookup(GLOBALS_SHM_NAME);
+	CU_ASSERT_FATAL(shm != ODP_SHM_INVALID);
+	globals = odp_shm_addr(shm);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(globals);
+
+	shm = odp_shm_lookup(SHM_THR_ARGS_NAME);
+	CU_ASSERT_FATAL(shm != ODP_SHM_INVALID);
+	args = odp_shm_addr(shm);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(args);
+
+	pool = odp_pool_lookup(MSG_POOL_NAME);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	odp_queue_param_init(&qp);
+	qp.type        = ODP_QUEUE_TYPE_SCHED;
+	qp.sched.sync  = ODP_SCHED_SYNC_ORDERED;
+	qp.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
+	qp.sched.group = ODP_SCHED_GROUP_ALL;
+	queue = odp_queue_create("reorder_window_queue", &qp);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	odp_queue_param_init(&qp);
+	qp.type = ODP_QUEUE_TYPE_PLAIN;
+	globals->reorder.out_queue = odp_queue_create("reorder_window_out",
+						      &qp);
+	CU_ASSERT_FATAL(globals->reorder.out_queue != ODP_QUEUE_INVALID);
+	odp_atomic_init_u32(&globals->reorder.done, 0);
+
+	for (i = 0; i < REORDER_NUM_EVENTS; i++) {
+		buf = odp_buffer_alloc(pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+		bctx = odp_buffer_addr(buf);
+		bctx->sequence = i;
+		ev = odp_buffer_to_event(buf);
+
+		if (odp_queue_enq(queue, ev)) {
+			odp_event_free(ev);
+			CU_FAIL_FATAL("enqueue failed");
+		}
+	}
+
+	/* Hold the first context */
+	from  = ODP_QUEUE_INVALID;
+	first = odp_schedule(&from, odp_schedule_wait_time(REORDER_TMO_NS));
+	CU_ASSERT_FATAL(first != ODP_EVENT_INVALID);
+	CU_ASSERT(from == queue);
+
+	args->cu_thr.numthrds = globals->num_workers;
+	odp_cunit_thread_create(reorder_window_thread, &args->cu_thr);
+
+	/* Wait until workers stop making progress */
+	end  = odp_time_sum(odp_time_local(),
+			    odp_time_local_from_ns(REORDER_TMO_NS));
+	prev = 0;
+
+	while (odp_time_cmp(end, odp_time_local()) > 0) {
+		odp_time_wait_ns(REORDER_IDLE_NS);
+		done = odp_atomic_load_u32(&globals->reorder.done);
+
+		if (done == prev || done == REORDER_NUM_EVENTS - 1)
+			break;
+
+		prev = done;
+	}
+
+	/* Releasing the first context retires all stored contexts */
+	reorder_event(globals, first);
+	odp_schedule_release_ordered();
+
+	reorder_loop(globals);
+	CU_ASSERT(exit_schedule_loop() == 0);
+
+	odp_cunit_thread_exit(&args->cu_thr);
+
+	CU_ASSERT(odp_atomic_load_u32(&globals->reorder.done) ==
+		  REORDER_NUM_EVENTS);
+
+	seq = 0;
+	num = 0;
+	while ((ev = odp_queue_deq(globals->reorder.out_queue)) !=
+	       ODP_EVENT_INVALID) {
+		bctx = odp_buffer_addr(odp_buffer_from_event(ev));
+		CU_ASSERT(bctx->sequence == seq);
+		seq = bctx->sequence + REORDER_OUT_RATIO;
+		odp_event_free(ev);
+		num++;
+	}
+
+	CU_ASSERT(num == REORDER_NUM_EVENTS / REORDER_OUT_RATIO);
+
+	CU_ASSERT(drain_queues() == 0);
+	CU_ASSERT_FATAL(odp_queue_destroy(queue) == 0);
+	CU_ASSERT_FATAL(odp_queue_destroy(globals->reorder.out_queue) == 0);
+}
+
+static void scheduler_test_print(void)
+{
+	odp_schedule_print();
+}
+
+static void scheduler_test_stats(void)
+{
+	odp_schedule_stats_t before, after;
+	odp_queue_param_t qp;
+	odp_queue_t queue, from;
+	odp_buffer_t buf;
+	odp_event_t ev;
+	odp_pool_t pool;
+	uint64_t wait;
+	int i, num;
+
+	/* Statistics are optional */
+	if (odp_schedule_stats(&before))
+		return;
+
+	wait = odp_schedule_wait_time(ODP_TIME_SEC_IN_NS);
+
+	pool = odp_pool_lookup(MSG_POOL_NAME);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	odp_queue_param_init(&qp);
+	qp.type        = ODP_QUEUE_TYPE_SCHED;
+	qp.sched.sync  = ODP_SCHED_SYNC_ATOMIC;
+	qp.sched.prio  = ODP_SCHED_PRIO_NORMAL;
+	qp.sched.group = ODP_SCHED_GROUP_ALL;
+	queue = odp_queue_create("stats_queue", &qp);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	for (i = 0; i < BUFS_PER_QUEUE; i++) {
+		buf = odp_buffer_alloc(pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+
+		if (odp_queue_enq(queue, odp_buffer_to_event(buf))) {
+			odp_buffer_free(buf);
+			break;
+		}
+	}
+
+	for (num = 0; num < i; num++) {
+		ev = odp_schedule(&from, wait);
+		if (ev == ODP_EVENT_INVALID)
+			break;
+
+		CU_ASSERT(from == queue);
+		odp_event_free(ev);
+	}
+
+	CU_ASSERT(num == i);
+	odp_schedule_release_atomic();
+
+	CU_ASSERT_FATAL(odp_schedule_stats(&after) == 0);
+	CU_ASSERT(after.events - before.events >= (uint64_t)num);
+	CU_ASSERT(after.polls - before.polls >= (uint64_t)num);
+	CU_ASSERT(after.empty_polls <= after.polls);
+	CU_ASSERT(after.atomic_ctx > before.atomic_ctx);
+	CU_ASSERT(after.pktin_hits <= after.pktin_polls);
+
+	odp_schedule_stats_print();
+
+	CU_ASSERT(drain_queues() == 0);
+	CU_ASSERT_FATAL(odp_queue_destroy(queue) == 0);
+}
+
 static void scheduler_test_num_prio(void)
 {
 	int prio;
@@ -1683,6 +1999,9 @@ static int scheduler_suite_term(void)
 
 odp_testinfo_t scheduler_suite[] = {
 	ODP_TEST_INFO(scheduler_test_wait_time),
+	ODP_TEST_INFO(scheduler_test_wait_wakeup),
+	ODP_TEST_INFO(scheduler_test_print),
+	ODP_TEST_INFO(scheduler_test_stats),
 	ODP_TEST_INFO(scheduler_test_num_prio),
 	ODP_TEST_INFO(scheduler_test_queue_destroy),
 	ODP_TEST_INFO(scheduler_test_groups),
@@ -1691,6 +2010,7 @@ odp_testinfo_t scheduler_suite[] = {
 	ODP_TEST_INFO(scheduler_test_parallel),
 	ODP_TEST_INFO(scheduler_test_atomic),
 	ODP_TEST_INFO(scheduler_test_ordered),
+	ODP_TEST_INFO(scheduler_test_reorder_window),
 	ODP_TEST_INFO(scheduler_test_chaos),
 	ODP_TEST_INFO(scheduler_test_1q_1t_n),
 	ODP_TEST_INFO(scheduler_test_1q_1t_a),
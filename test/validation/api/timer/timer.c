@@ -166,6 +166,7 @@ static void timer_test_odp_timer_cancel(void)
 	if (odp_timer_capability(ODP_CLOCK_CPU, &timer_capa))
 		CU_FAIL_FATAL("Get timer capability failed")
 
+	odp_timer_pool_param_init(&tparam);
 	tparam.res_ns	  = MAX(100 * ODP_TIME_MSEC_IN_NS,
 				timer_capa.highest_res_ns);
 	tparam.min_tmo    = 1   * ODP_TIME_SEC_IN_NS;
@@ -502,8 +503,8 @@ static int worker_entrypoint(void *arg TEST_UNUSED)
 	return CU_get_number_of_failures();
 }
 
-/* @private Timer test case entrypoint */
-static void timer_test_odp_timer_all(void)
+/* @private Timer test case body, run with the given expiration method */
+static void timer_test_all(odp_timer_expire_t expire)
 {
 	int rc;
 	odp_pool_param_t params;
@@ -546,12 +547,14 @@ static void timer_test_odp_timer_all(void)
 	if (odp_timer_capability(ODP_CLOCK_CPU, &timer_capa))
 		CU_FAIL("Error: get timer capacity failed.\n");
 
+	odp_timer_pool_param_init(&tparam);
 	tparam.res_ns = MAX(RES, timer_capa.highest_res_ns);
 	tparam.min_tmo = MIN_TMO;
 	tparam.max_tmo = MAX_TMO;
 	tparam.num_timers = num_workers * NTIMERS;
 	tparam.priv = 0;
 	tparam.clk_src = ODP_CLOCK_CPU;
+	tparam.expire = expire;
 	tp = odp_timer_pool_create(NAME, &tparam);
 	if (tp == ODP_TIMER_POOL_INVALID)
 		CU_FAIL_FATAL("Timer pool create failed");
@@ -616,11 +619,24 @@ static void timer_test_odp_timer_all(void)
 	CU_PASS("ODP timer test");
 }
 
+/* @private Timer test case entrypoint */
+static void timer_test_odp_timer_all(void)
+{
+	timer_test_all(ODP_TIMER_EXPIRE_DEFAULT);
+}
+
+/* @private Timer test case entrypoint, timing wheel expiration */
+static void timer_test_odp_timer_all_wheel(void)
+{
+	timer_test_all(ODP_TIMER_EXPIRE_WHEEL);
+}
+
 odp_testinfo_t timer_suite[] = {
 	ODP_TEST_INFO(timer_test_timeout_pool_alloc),
 	ODP_TEST_INFO(timer_test_timeout_pool_free),
 	ODP_TEST_INFO(timer_test_odp_timer_cancel),
 	ODP_TEST_INFO(timer_test_odp_timer_all),
+	ODP_TEST_INFO(timer_test_odp_timer_all_wheel),
 	ODP_TEST_INFO_NULL,
 };
 
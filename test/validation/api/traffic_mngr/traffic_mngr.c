@@ -42,6 +42,19 @@
 #define NUM_THRESH_TEST_PROFILES 8
 #define NUM_WRED_TEST_PROFILES   8
 
+#define ENQ_MULTI_BURST          16
+
+#define STRESS_NUM_QUEUES        512
+#define STRESS_NUM_ROUNDS        4
+
+#define FN_MAX_TM_SYSTEMS        8
+#define FN_NUM_TM_SYSTEMS        4
+#define FN_NUM_PRODUCERS         4
+#define FN_PKTS_PER_PRODUCER     1000
+#define FN_GROUP_NUM_PKTS        100
+#define FN_PKT_LEN               64
+#define FN_WAIT_NS               (10 * BILLION)
+
 #define ODP_NUM_PKT_COLORS       ODP_NUM_PACKET_COLORS
 #define PKT_GREEN                ODP_PACKET_GREEN
 #define PKT_YELLOW               ODP_PACKET_YELLOW
@@ -330,6 +343,28 @@ static odph_ethaddr_t dst_mac;
 static uint32_t cpu_unique_id;
 static uint32_t cpu_tcp_seq_num;
 
+/* Header written into the pkts of the egress function tests */
+typedef struct {
+	uint32_t tm_idx;
+	uint32_t producer;
+	uint32_t seq;
+} fn_pkt_hdr_t;
+
+/* TM system with an egress function. Receive side is updated only by the
+ * service thread of the TM system. */
+typedef struct {
+	odp_tm_t         odp_tm;
+	odp_tm_node_t    tm_node;
+	odp_tm_queue_t   tm_queue;
+	uint32_t         rcv_seq[FN_NUM_PRODUCERS];
+	odp_atomic_u32_t rcv_pkts;
+	odp_atomic_u32_t order_errors;
+} fn_tm_t;
+
+static fn_tm_t          fn_tm[FN_MAX_TM_SYSTEMS];
+static odp_atomic_u32_t fn_bad_pkts;
+static odp_atomic_u32_t fn_next_producer;
+
 static void busy_wait(uint64_t nanoseconds)
 {
 	odp_time_t start_time, end_time;
@@ -1106,6 +1141,43 @@ static uint32_t send_pkts(odp_tm_queue_t tm_queue, uint32_t num_pkts)
 	return pkts_sent;
 }
 
+static uint32_t send_pkts_multi(odp_tm_queue_t tm_queue, uint32_t num_pkts)
+{
+	xmt_pkt_desc_t *xmt_pkt_desc;
+	uint32_t        idx, xmt_pkt_idx, pkts_sent, burst;
+	int             rc;
+
+	/* Send the pkts in bursts of ENQ_MULTI_BURST. Pkts which are not
+	 * accepted remain owned by the caller and are freed here. */
+	pkts_sent = 0;
+	while (num_pkts != 0) {
+		xmt_pkt_idx = num_pkts_sent;
+		burst       = MIN(num_pkts, ENQ_MULTI_BURST);
+		rc = odp_tm_enq_multi(tm_queue, &xmt_pkts[xmt_pkt_idx], burst);
+		if (rc < 0)
+			rc = 0;
+
+		for (idx = 0; idx < burst; idx++) {
+			xmt_pkt_desc = &xmt_pkt_descs[xmt_pkt_idx + idx];
+			xmt_pkt_desc->xmt_idx = xmt_pkt_idx + idx;
+			if (idx < (uint32_t)rc) {
+				xmt_pkt_desc->xmt_time = odp_time_local();
+				xmt_pkt_desc->tm_queue = tm_queue;
+				pkts_sent++;
+			} else {
+				odp_packet_free(xmt_pkts[xmt_pkt_idx + idx]);
+				xmt_pkts[xmt_pkt_idx + idx] =
+					ODP_PACKET_INVALID;
+			}
+		}
+
+		num_pkts_sent += burst;
+		num_pkts      -= burst;
+	}
+
+	return pkts_sent;
+}
+
 static uint32_t pkts_rcvd_in_send_order(void)
 {
 	xmt_pkt_desc_t *xmt_pkt_desc;
@@ -1595,7 +1667,8 @@ static int create_tm_system(void)
 	odp_tm_requirements_init(&requirements);
 	odp_tm_egress_init(&egress);
 
-	requirements.max_tm_queues              = NUM_TM_QUEUES + 1;
+	requirements.max_tm_queues              = NUM_TM_QUEUES +
+						  STRESS_NUM_QUEUES + 1;
 	requirements.num_levels                 = NUM_LEVELS;
 	requirements.tm_queue_shaper_needed     = true;
 	requirements.tm_queue_wred_needed       = true;
@@ -3807,6 +3880,523 @@ static int test_fanin_info(const char *node_name)
 	return walk_tree_backwards(node_desc->node);
 }
 
+static tm_node_desc_t *create_stress_subtree(odp_tm_t odp_tm)
+{
+	odp_tm_node_params_t   node_params;
+	odp_tm_queue_params_t  queue_params;
+	tm_queue_desc_t       *queue_desc;
+	tm_node_desc_t        *node_desc;
+	odp_tm_queue_t         tm_queue;
+	odp_tm_node_t          tm_node;
+	uint32_t               queue_desc_size, queue_idx;
+
+	odp_tm_node_params_init(&node_params);
+	node_params.shaper_profile           = ODP_TM_INVALID;
+	node_params.threshold_profile        = ODP_TM_INVALID;
+	node_params.wred_profile[PKT_GREEN]  = ODP_TM_INVALID;
+	node_params.wred_profile[PKT_YELLOW] = ODP_TM_INVALID;
+	node_params.wred_profile[PKT_RED]    = ODP_TM_INVALID;
+	node_params.max_fanin = STRESS_NUM_QUEUES;
+	node_params.level     = 0;
+
+	tm_node = odp_tm_node_create(odp_tm, "stress_node", &node_params);
+	if (tm_node == ODP_TM_INVALID) {
+		LOG_ERR("odp_tm_node_create() failed\n");
+		return NULL;
+	}
+
+	if (odp_tm_node_connect(tm_node, ODP_TM_ROOT) != 0) {
+		LOG_ERR("odp_tm_node_connect() failed\n");
+		odp_tm_node_destroy(tm_node);
+		return NULL;
+	}
+
+	node_desc = malloc(sizeof(tm_node_desc_t));
+	memset(node_desc, 0, sizeof(tm_node_desc_t));
+	node_desc->node        = tm_node;
+	node_desc->parent_node = ODP_TM_ROOT;
+	node_desc->node_name   = strdup("stress_node");
+
+	queue_desc_size = sizeof(tm_queue_desc_t) +
+			  sizeof(odp_tm_queue_t) * STRESS_NUM_QUEUES;
+	queue_desc = malloc(queue_desc_size);
+	memset(queue_desc, 0, queue_desc_size);
+	queue_desc->num_queues = STRESS_NUM_QUEUES;
+	node_desc->queue_desc  = queue_desc;
+
+	/* All of the tm_queues feed the same scheduler priority of the same
+	 * tm_node, so that their head pkts all end up in one sorted list. */
+	odp_tm_queue_params_init(&queue_params);
+	queue_params.priority = 0;
+	for (queue_idx = 0; queue_idx < STRESS_NUM_QUEUES; queue_idx++) {
+		tm_queue = odp_tm_queue_create(odp_tm, &queue_params);
+		if (tm_queue == ODP_TM_INVALID) {
+			LOG_ERR("odp_tm_queue_create() failed "
+				"idx=%" PRIu32 "\n", queue_idx);
+			destroy_tm_subtree(node_desc);
+			return NULL;
+		}
+
+		queue_desc->tm_queues[queue_idx] = tm_queue;
+		if (odp_tm_queue_connect(tm_queue, tm_node) != 0) {
+			LOG_ERR("odp_tm_queue_connect() failed "
+				"idx=%" PRIu32 "\n", queue_idx);
+			destroy_tm_subtree(node_desc);
+			return NULL;
+		}
+	}
+
+	return node_desc;
+}
+
+static int test_enq_multi(const char *shaper_name,
+			  const char *node_name,
+			  uint8_t     priority)
+{
+	odp_tm_queue_t tm_queue;
+	pkt_info_t     pkt_info;
+	uint32_t       num_pkts, pkts_sent, pkts_rcvd_in_order;
+
+	/* Send bursts of pkts to one tm_queue with odp_tm_enq_multi() and
+	 * check that they all come back, and in the order sent. */
+	tm_queue = find_tm_queue(0, node_name, priority);
+	if (set_shaper(node_name, shaper_name, 10 * MBPS, 10000) != 0)
+		return -1;
+
+	init_xmt_pkts(&pkt_info);
+	num_pkts           = 100;
+	pkt_info.pkt_class = 1;
+	if (make_pkts(num_pkts, 128, &pkt_info) != 0)
+		return -1;
+
+	pkts_sent = send_pkts_multi(tm_queue, num_pkts);
+	CU_ASSERT(pkts_sent == num_pkts);
+
+	num_rcv_pkts = receive_pkts(odp_tm_systems[0], rcv_pktin, pkts_sent,
+				    10 * MBPS);
+	pkts_rcvd_in_order = pkts_rcvd_in_send_order();
+	CU_ASSERT(num_rcv_pkts == pkts_sent);
+	CU_ASSERT(pkts_rcvd_in_order == pkts_sent);
+
+	/* Disable the shaper, so as to not affect other tests. */
+	set_shaper(node_name, shaper_name, 0, 0);
+	flush_leftover_pkts(odp_tm_systems[0], rcv_pktin);
+	CU_ASSERT(odp_tm_is_idle(odp_tm_systems[0]));
+
+	return num_rcv_pkts == pkts_sent ? 0 : -1;
+}
+
+static int test_enq_multi_full(const char *threshold_name,
+			       const char *shaper_name,
+			       const char *node_name,
+			       uint8_t     priority)
+{
+	odp_tm_threshold_params_t threshold_params;
+	odp_tm_queue_t            tm_queue;
+	pkt_info_t                pkt_info;
+	uint32_t                  num_pkts, idx;
+	int                       num_enq, rc;
+
+	/* Fill the tm_queue over its threshold behind a slow shaper. Then a
+	 * burst of drop eligible pkts must enqueue nothing, which is not a
+	 * failure. */
+	odp_tm_threshold_params_init(&threshold_params);
+	threshold_params.max_pkts        = 4;
+	threshold_params.enable_max_pkts = true;
+
+	tm_queue = find_tm_queue(0, node_name, priority);
+	if (set_queue_thresholds(tm_queue, threshold_name,
+				 &threshold_params) != 0) {
+		LOG_ERR("set_queue_thresholds failed\n");
+		return -1;
+	}
+
+	set_shaper(node_name, shaper_name, 256 * 1000, 8 * 256);
+
+	init_xmt_pkts(&pkt_info);
+	pkt_info.drop_eligible = true;
+	pkt_info.pkt_class     = 1;
+	num_pkts = 2 * ENQ_MULTI_BURST;
+	if (make_pkts(num_pkts, 256, &pkt_info) != 0)
+		return -1;
+
+	/* Thresholds are checked before the burst is counted */
+	num_enq = odp_tm_enq_multi(tm_queue, xmt_pkts, ENQ_MULTI_BURST);
+	CU_ASSERT(num_enq == ENQ_MULTI_BURST);
+	if (num_enq < 0)
+		num_enq = 0;
+
+	rc = odp_tm_enq_multi(tm_queue, &xmt_pkts[num_enq],
+			      num_pkts - num_enq);
+	CU_ASSERT(rc == 0);
+	if (rc > 0)
+		num_enq += rc;
+
+	for (idx = num_enq; idx < num_pkts; idx++) {
+		odp_packet_free(xmt_pkts[idx]);
+		xmt_pkts[idx] = ODP_PACKET_INVALID;
+	}
+
+	/* Disable the shaper and the thresholds, so as to not affect other
+	 * tests. */
+	set_shaper(node_name, shaper_name, 0, 0);
+	flush_leftover_pkts(odp_tm_systems[0], rcv_pktin);
+	CU_ASSERT(odp_tm_is_idle(odp_tm_systems[0]));
+	CU_ASSERT(odp_tm_queue_threshold_config(tm_queue,
+						ODP_TM_INVALID) == 0);
+
+	return rc == 0 ? 0 : -1;
+}
+
+static int test_fanin_stress(void)
+{
+	odp_tm_shaper_params_t shaper_params;
+	odp_tm_shaper_t        shaper_profile;
+	tm_queue_desc_t       *queue_desc;
+	tm_node_desc_t        *node_desc;
+	pkt_info_t             pkt_info;
+	odp_time_t             start_time, enq_time, end_time;
+	uint64_t               enq_ns, drain_ns;
+	uint32_t               num_pkts, pkts_sent, pkt_idx, iter;
+	odp_tm_t               odp_tm;
+	int                    ret;
+
+	odp_tm    = odp_tm_systems[0];
+	node_desc = create_stress_subtree(odp_tm);
+	if (node_desc == NULL)
+		return -1;
+
+	queue_desc = node_desc->queue_desc;
+	odp_tm_shaper_params_init(&shaper_params);
+	shaper_params.commit_bps   = MIN_COMMIT_BW;
+	shaper_params.commit_burst = MIN_COMMIT_BURST;
+	shaper_profile = odp_tm_shaper_create("stress_shaper", &shaper_params);
+	if (shaper_profile == ODP_TM_INVALID) {
+		destroy_tm_subtree(node_desc);
+		return -1;
+	}
+
+	shaper_profiles[num_shaper_profiles++] = shaper_profile;
+
+	ret      = 0;
+	num_pkts = MIN(STRESS_NUM_QUEUES, MAX_PKTS);
+	enq_ns   = 0;
+	drain_ns = 0;
+	for (iter = 0; iter < STRESS_NUM_ROUNDS; iter++) {
+		init_xmt_pkts(&pkt_info);
+		pkt_info.pkt_class = 1;
+		if (make_pkts(num_pkts, 128, &pkt_info) != 0) {
+			ret = -1;
+			break;
+		}
+
+		/* Hold back the node output with a slow shaper, so that the
+		 * head pkt of every tm_queue has to wait in the node's sorted
+		 * list, then let them all drain at once. */
+		shaper_params.commit_bps = MIN_COMMIT_BW;
+		odp_tm_shaper_params_update(shaper_profile, &shaper_params);
+		odp_tm_node_shaper_config(node_desc->node, shaper_profile);
+
+		pkts_sent  = 0;
+		start_time = odp_time_local();
+		for (pkt_idx = 0; pkt_idx < num_pkts; pkt_idx++)
+			pkts_sent += send_pkts(queue_desc->tm_queues[pkt_idx],
+					       1);
+
+		enq_time = odp_time_local();
+		shaper_params.commit_bps = 0;
+		odp_tm_shaper_params_update(shaper_profile, &shaper_params);
+		num_rcv_pkts = receive_pkts(odp_tm, rcv_pktin, pkts_sent,
+					    10 * MBPS);
+		CU_ASSERT(pkts_sent == num_pkts);
+		CU_ASSERT(num_rcv_pkts == pkts_sent);
+		if (num_rcv_pkts == 0 || num_rcv_pkts > MAX_PKTS) {
+			ret = -1;
+			break;
+		}
+
+		/* Drain time ends with the last pkt received, not when the
+		 * TM system goes idle. */
+		end_time  = rcv_pkt_descs[num_rcv_pkts - 1].rcv_time;
+		enq_ns   += odp_time_diff_ns(enq_time, start_time);
+		drain_ns += odp_time_diff_ns(end_time, enq_time);
+		flush_leftover_pkts(odp_tm, rcv_pktin);
+		CU_ASSERT(odp_tm_is_idle(odp_tm));
+	}
+
+	if (ret == 0)
+		printf("\n    %" PRIu32 " tm_queues/node: enq %" PRIu64
+		       " ns/pkt, drain %" PRIu64 " ns/pkt\n",
+		       (uint32_t)STRESS_NUM_QUEUES,
+		       enq_ns / (STRESS_NUM_ROUNDS * num_pkts),
+		       drain_ns / (STRESS_NUM_ROUNDS * num_pkts));
+
+	free_rcvd_pkts();
+	if (destroy_tm_subtree(node_desc) != 0)
+		return -1;
+
+	return ret;
+}
+
+static void fn_egress(odp_packet_t pkt)
+{
+	fn_pkt_hdr_t hdr;
+	fn_tm_t *tm;
+
+	if (odp_packet_copy_to_mem(pkt, 0, sizeof(hdr), &hdr) != 0 ||
+	    hdr.tm_idx >= FN_MAX_TM_SYSTEMS ||
+	    hdr.producer >= FN_NUM_PRODUCERS) {
+		odp_atomic_inc_u32(&fn_bad_pkts);
+		odp_packet_free(pkt);
+		return;
+	}
+
+	/* Pkts of one producer leave in the order they were enqueued */
+	tm = &fn_tm[hdr.tm_idx];
+	if (hdr.seq != tm->rcv_seq[hdr.producer])
+		odp_atomic_inc_u32(&tm->order_errors);
+
+	tm->rcv_seq[hdr.producer] = hdr.seq + 1;
+	odp_atomic_inc_u32(&tm->rcv_pkts);
+	odp_packet_free(pkt);
+}
+
+static int create_fn_tm_system(uint32_t tm_idx)
+{
+	odp_tm_requirements_t requirements;
+	odp_tm_node_params_t  node_params;
+	odp_tm_queue_params_t queue_params;
+	odp_tm_egress_t       egress;
+	fn_tm_t              *tm = &fn_tm[tm_idx];
+	char                  tm_name[TM_NAME_LEN];
+
+	memset(tm->rcv_seq, 0, sizeof(tm->rcv_seq));
+	odp_atomic_init_u32(&tm->rcv_pkts, 0);
+	odp_atomic_init_u32(&tm->order_errors, 0);
+
+	odp_tm_requirements_init(&requirements);
+	requirements.max_tm_queues = 64;
+	requirements.num_levels    = 1;
+	requirements.per_level[0].max_num_tm_nodes   = 1;
+	requirements.per_level[0].max_fanin_per_node = 1;
+	requirements.per_level[0].max_priority       = 0;
+
+	odp_tm_egress_init(&egress);
+	egress.egress_kind = ODP_TM_EGRESS_FN;
+	egress.egress_fcn  = fn_egress;
+
+	snprintf(tm_name, sizeof(tm_name), "fn_tm_%" PRIu32, tm_idx);
+	tm->odp_tm = odp_tm_create(tm_name, &requirements, &egress);
+	if (tm->odp_tm == ODP_TM_INVALID) {
+		LOG_ERR("odp_tm_create() failed\n");
+		return -1;
+	}
+
+	odp_tm_node_params_init(&node_params);
+	node_params.max_fanin = 1;
+	node_params.level     = 0;
+	tm->tm_node = odp_tm_node_create(tm->odp_tm, NULL, &node_params);
+	if (tm->tm_node == ODP_TM_INVALID ||
+	    odp_tm_node_connect(tm->tm_node, ODP_TM_ROOT) != 0) {
+		LOG_ERR("tm_node create failed\n");
+		return -1;
+	}
+
+	odp_tm_queue_params_init(&queue_params);
+	queue_params.priority = 0;
+	tm->tm_queue = odp_tm_queue_create(tm->odp_tm, &queue_params);
+	if (tm->tm_queue == ODP_TM_INVALID ||
+	    odp_tm_queue_connect(tm->tm_queue, tm->tm_node) != 0) {
+		LOG_ERR("tm_queue create failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int destroy_fn_tm_system(uint32_t tm_idx)
+{
+	fn_tm_t *tm = &fn_tm[tm_idx];
+
+	if (odp_tm_queue_disconnect(tm->tm_queue) != 0 ||
+	    odp_tm_queue_destroy(tm->tm_queue) != 0 ||
+	    odp_tm_node_disconnect(tm->tm_node) != 0 ||
+	    odp_tm_node_destroy(tm->tm_node) != 0 ||
+	    odp_tm_destroy(tm->odp_tm) != 0) {
+		LOG_ERR("destroy_fn_tm_system() failed\n");
+		return -1;
+	}
+
+	tm->odp_tm = ODP_TM_INVALID;
+	return 0;
+}
+
+/* Send pkts numbered in sequence. Pkts which are not accepted are retried,
+ * so that the sequence has no gaps. */
+static uint32_t fn_send_pkts(uint32_t tm_idx, uint32_t producer,
+			     uint32_t num_pkts)
+{
+	odp_packet_t pkts[ENQ_MULTI_BURST];
+	fn_pkt_hdr_t hdr;
+	odp_time_t   end_time;
+	uint32_t     seq, num, pkts_sent;
+	int          idx, rc;
+
+	hdr.tm_idx   = tm_idx;
+	hdr.producer = producer;
+	end_time = odp_time_sum(odp_time_local(),
+				odp_time_local_from_ns(FN_WAIT_NS));
+	pkts_sent = 0;
+	seq       = 0;
+	num       = 0;
+	while (pkts_sent < num_pkts) {
+		if (odp_time_cmp(odp_time_local(), end_time) > 0)
+			break;
+
+		/* Pkts are freed by the egress function, so the pool may be
+		 * temporarily empty */
+		while (num < ENQ_MULTI_BURST && seq < num_pkts) {
+			pkts[num] = odp_packet_alloc(pools[0], FN_PKT_LEN);
+			if (pkts[num] == ODP_PACKET_INVALID)
+				break;
+
+			hdr.seq = seq++;
+			odp_packet_copy_from_mem(pkts[num], 0, sizeof(hdr),
+						 &hdr);
+			num++;
+		}
+
+		if (num == 0)
+			continue;
+
+		rc = odp_tm_enq_multi(fn_tm[tm_idx].tm_queue, pkts, num);
+		if (rc < 0)
+			break;
+
+		for (idx = 0; idx < (int)num - rc; idx++)
+			pkts[idx] = pkts[rc + idx];
+
+		num       -= rc;
+		pkts_sent += rc;
+	}
+
+	if (num)
+		odp_packet_free_multi(pkts, num);
+
+	return pkts_sent;
+}
+
+static int fn_wait_pkts(uint32_t tm_idx, uint32_t num_pkts)
+{
+	odp_time_t end_time;
+	fn_tm_t   *tm = &fn_tm[tm_idx];
+
+	end_time = odp_time_sum(odp_time_local(),
+				odp_time_local_from_ns(FN_WAIT_NS));
+	while (odp_atomic_load_u32(&tm->rcv_pkts) < num_pkts) {
+		if (odp_time_cmp(odp_time_local(), end_time) > 0)
+			return -1;
+
+		busy_wait(100000);
+	}
+
+	CU_ASSERT(odp_atomic_load_u32(&tm->rcv_pkts) == num_pkts);
+	CU_ASSERT(odp_atomic_load_u32(&tm->order_errors) == 0);
+	return 0;
+}
+
+static int fn_producer(void *arg ODP_UNUSED)
+{
+	uint32_t producer;
+	uint32_t pkts_sent;
+
+	producer  = odp_atomic_fetch_inc_u32(&fn_next_producer);
+	pkts_sent = fn_send_pkts(0, producer, FN_PKTS_PER_PRODUCER);
+	CU_ASSERT(pkts_sent == FN_PKTS_PER_PRODUCER);
+
+	return 0;
+}
+
+static int test_enq_multi_producers(void)
+{
+	odp_cpumask_t mask;
+	pthrd_arg     thr_args;
+	uint32_t      producer, num_producers;
+	int           ret;
+
+	odp_atomic_init_u32(&fn_bad_pkts, 0);
+	odp_atomic_init_u32(&fn_next_producer, 0);
+	if (create_fn_tm_system(0) != 0)
+		return -1;
+
+	/* Worker threads and this thread enqueue concurrently into the same
+	 * tm_queue */
+	memset(&thr_args, 0, sizeof(thr_args));
+	thr_args.numthrds = odp_cpumask_default_worker(&mask,
+						       FN_NUM_PRODUCERS - 1);
+	num_producers = thr_args.numthrds + 1;
+	odp_cunit_thread_create(fn_producer, &thr_args);
+	fn_producer(NULL);
+	odp_cunit_thread_exit(&thr_args);
+
+	ret = fn_wait_pkts(0, num_producers * FN_PKTS_PER_PRODUCER);
+	CU_ASSERT(ret == 0);
+	CU_ASSERT(odp_atomic_load_u32(&fn_bad_pkts) == 0);
+	for (producer = 0; producer < num_producers; producer++)
+		CU_ASSERT(fn_tm[0].rcv_seq[producer] ==
+			  FN_PKTS_PER_PRODUCER);
+
+	if (destroy_fn_tm_system(0) != 0)
+		return -1;
+
+	return ret;
+}
+
+static int test_service_groups(void)
+{
+	uint32_t tm_idx, round;
+	int      ret = 0;
+
+	odp_atomic_init_u32(&fn_bad_pkts, 0);
+	for (tm_idx = 0; tm_idx < FN_NUM_TM_SYSTEMS; tm_idx++)
+		if (create_fn_tm_system(tm_idx) != 0)
+			return -1;
+
+	/* TM systems join and leave service thread groups (see
+	 * ODP_TM_SERVICE_THREADS in odp-linux) while others keep running.
+	 * Every other TM system is replaced on each round. */
+	for (round = 0; round < 4; round++) {
+		for (tm_idx = 0; tm_idx < FN_NUM_TM_SYSTEMS; tm_idx++)
+			CU_ASSERT(fn_send_pkts(tm_idx, 0, FN_GROUP_NUM_PKTS) ==
+				  FN_GROUP_NUM_PKTS);
+
+		for (tm_idx = 0; tm_idx < FN_NUM_TM_SYSTEMS; tm_idx++)
+			if (fn_wait_pkts(tm_idx, FN_GROUP_NUM_PKTS) != 0)
+				ret = -1;
+
+		for (tm_idx = round % 2; tm_idx < FN_NUM_TM_SYSTEMS;
+		     tm_idx += 2) {
+			if (destroy_fn_tm_system(tm_idx) != 0 ||
+			    create_fn_tm_system(tm_idx) != 0)
+				return -1;
+		}
+
+		for (tm_idx = (round + 1) % 2; tm_idx < FN_NUM_TM_SYSTEMS;
+		     tm_idx += 2) {
+			memset(fn_tm[tm_idx].rcv_seq, 0,
+			       sizeof(fn_tm[tm_idx].rcv_seq));
+			odp_atomic_store_u32(&fn_tm[tm_idx].rcv_pkts, 0);
+		}
+	}
+
+	CU_ASSERT(odp_atomic_load_u32(&fn_bad_pkts) == 0);
+	for (tm_idx = 0; tm_idx < FN_NUM_TM_SYSTEMS; tm_idx++)
+		if (destroy_fn_tm_system(tm_idx) != 0)
+			return -1;
+
+	return ret;
+}
+
 static void traffic_mngr_test_capabilities(void)
 {
 	CU_ASSERT(test_overall_capabilities() == 0);
@@ -3973,6 +4563,28 @@ static void traffic_mngr_test_fanin_info(void)
 	CU_ASSERT(test_fanin_info("node_1_3_7") == 0);
 }
 
+static void traffic_mngr_test_enq_multi(void)
+{
+	CU_ASSERT(test_enq_multi("enq_multi", "node_1_2_1", 0) == 0);
+	CU_ASSERT(test_enq_multi_full("thresh_enq_multi", "enq_multi",
+				      "node_1_2_1", 2) == 0);
+}
+
+static void traffic_mngr_test_fanin_stress(void)
+{
+	CU_ASSERT(test_fanin_stress() == 0);
+}
+
+static void traffic_mngr_test_enq_multi_producers(void)
+{
+	CU_ASSERT(test_enq_multi_producers() == 0);
+}
+
+static void traffic_mngr_test_service_groups(void)
+{
+	CU_ASSERT(test_service_groups() == 0);
+}
+
 static void traffic_mngr_test_destroy(void)
 {
 	CU_ASSERT(destroy_tm_systems() == 0);
@@ -3995,6 +4607,10 @@ odp_testinfo_t traffic_mngr_suite[] = {
 	ODP_TEST_INFO(traffic_mngr_test_query),
 	ODP_TEST_INFO(traffic_mngr_test_marking),
 	ODP_TEST_INFO(traffic_mngr_test_fanin_info),
+	ODP_TEST_INFO(traffic_mngr_test_enq_multi),
+	ODP_TEST_INFO(traffic_mngr_test_fanin_stress),
+	ODP_TEST_INFO(traffic_mngr_test_enq_multi_producers),
+	ODP_TEST_INFO(traffic_mngr_test_service_groups),
 	ODP_TEST_INFO(traffic_mngr_test_destroy),
 	ODP_TEST_INFO_NULL,
 };